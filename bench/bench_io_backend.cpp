@@ -0,0 +1,205 @@
+// io_uring 与 muduo 数据面对比
+//
+// 负载：一个发布端通过 N 条 TCP 连接向同一接收节点扇出 M 条消息（每条 S 字节），
+// 统计全部帧解析完成的耗时、吞吐以及进程 CPU 时间（sys 时间反映系统调用开销）。
+// 精确的系统调用次数可以配合 `strace -c -f ./bench_io_backend` 获得。
+//
+// 用法：bench_io_backend [connections=64] [messages=20000] [payload_bytes=256]
+
+#include "io_uring_backend.h"
+#include "wire_format.h"
+#include <muduo/base/Logging.h>
+#include <muduo/net/EventLoop.h>
+#include <muduo/net/EventLoopThread.h>
+#include <muduo/net/InetAddress.h>
+#include <muduo/net/TcpClient.h>
+#include <muduo/net/TcpServer.h>
+#include <sys/resource.h>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace muduo;
+using namespace muduo::net;
+
+namespace {
+
+struct Workload {
+    int connections = 64;
+    int messages = 20000;
+    size_t payload = 256;
+};
+
+struct Result {
+    double seconds = 0;
+    double user_cpu = 0;
+    double sys_cpu = 0;
+    uint64_t frames = 0;
+};
+
+double cpuSeconds(const timeval& tv) { return tv.tv_sec + tv.tv_usec / 1e6; }
+
+class CpuTimer {
+public:
+    CpuTimer() { getrusage(RUSAGE_SELF, &start_); }
+    void stop(Result* r) const {
+        rusage end;
+        getrusage(RUSAGE_SELF, &end);
+        r->user_cpu = cpuSeconds(end.ru_utime) - cpuSeconds(start_.ru_utime);
+        r->sys_cpu = cpuSeconds(end.ru_stime) - cpuSeconds(start_.ru_stime);
+    }
+private:
+    rusage start_;
+};
+
+bool waitFor(const std::atomic<uint64_t>& counter, uint64_t expected, double timeout_sec) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::duration<double>(timeout_sec);
+    while (counter.load() < expected) {
+        if (std::chrono::steady_clock::now() > deadline) return false;
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+    }
+    return true;
+}
+
+// ---------------- muduo 路径 ----------------
+Result runMuduo(const Workload& w, uint16_t port) {
+    std::atomic<uint64_t> received(0);
+    InetAddress addr("127.0.0.1", port);
+
+    EventLoopThread serverThread;
+    EventLoop* serverLoop = serverThread.startLoop();
+    std::unique_ptr<TcpServer> server;
+    serverLoop->runInLoop([&]() {
+        server.reset(new TcpServer(serverLoop, addr, "BenchServer"));
+        server->setMessageCallback([&](const TcpConnectionPtr&, Buffer* buf, Timestamp) {
+            std::string topic, name, data;
+            while (size_t n = wire::decodeFrame(buf->peek(), buf->readableBytes(), &topic, &name, &data)) {
+                buf->retrieve(n);
+                received.fetch_add(1, std::memory_order_relaxed);
+            }
+        });
+        server->start();
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+    EventLoopThread clientThread;
+    EventLoop* clientLoop = clientThread.startLoop();
+    std::vector<std::unique_ptr<TcpClient>> clients;
+    std::atomic<int> connected(0);
+    for (int i = 0; i < w.connections; ++i) {
+        clients.emplace_back(new TcpClient(clientLoop, addr, "BenchClient"));
+        clients.back()->setConnectionCallback([&](const TcpConnectionPtr& conn) {
+            if (conn->connected()) {
+                conn->setTcpNoDelay(true);
+                ++connected;
+            }
+        });
+        clients.back()->connect();
+    }
+    while (connected.load() < w.connections) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+    std::vector<TcpConnectionPtr> conns;
+    for (auto& c : clients) conns.push_back(c->connection());
+    std::string frame = wire::encodeFrame("bench", "bench.Payload", std::string(w.payload, 'x'));
+    uint64_t expected = static_cast<uint64_t>(w.messages) * w.connections;
+
+    Result r;
+    CpuTimer cpu;
+    auto start = std::chrono::steady_clock::now();
+    for (int m = 0; m < w.messages; ++m) {
+        for (auto& conn : conns) conn->send(frame);
+    }
+    if (!waitFor(received, expected, 60)) fprintf(stderr, "muduo: timeout\n");
+    r.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    cpu.stop(&r);
+    r.frames = received.load();
+
+    for (auto& c : clients) c->disconnect();
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    clientLoop->runInLoop([&]() { clients.clear(); });
+    serverLoop->runInLoop([&]() { server.reset(); });
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    return r;
+}
+
+// ---------------- io_uring 路径 ----------------
+Result runIoUring(const Workload& w, uint16_t port, IoUringBackend::Stats* rx, IoUringBackend::Stats* tx) {
+    std::atomic<uint64_t> received(0);
+    IoUringBackend server;
+    server.setFrameCallback([&](const std::string&, const std::string&, const std::string&) {
+        received.fetch_add(1, std::memory_order_relaxed);
+    });
+    server.start();
+    server.listen("127.0.0.1", port);
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+    IoUringBackend client;
+    client.start();
+    std::vector<int64_t> conns;
+    for (int i = 0; i < w.connections; ++i) {
+        int64_t id = client.connect("127.0.0.1", port);
+        if (id >= 0) conns.push_back(id);
+    }
+
+    std::string frame = wire::encodeFrame("bench", "bench.Payload", std::string(w.payload, 'x'));
+    uint64_t expected = static_cast<uint64_t>(w.messages) * conns.size();
+
+    Result r;
+    CpuTimer cpu;
+    auto start = std::chrono::steady_clock::now();
+    for (int m = 0; m < w.messages; ++m) {
+        for (int64_t id : conns) client.send(id, frame);
+    }
+    if (!waitFor(received, expected, 60)) fprintf(stderr, "io_uring: timeout\n");
+    r.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    cpu.stop(&r);
+    r.frames = received.load();
+
+    *rx = server.stats();
+    *tx = client.stats();
+    client.stop();
+    server.stop();
+    return r;
+}
+
+void printResult(const char* name, const Workload& w, const Result& r) {
+    double mb = static_cast<double>(r.frames) * (w.payload + 32) / (1024.0 * 1024.0);
+    printf("%-9s frames=%-10llu time=%7.3fs  %10.0f msg/s  %8.1f MB/s  cpu user=%.3fs sys=%.3fs\n",
+           name, static_cast<unsigned long long>(r.frames), r.seconds,
+           r.frames / r.seconds, mb / r.seconds, r.user_cpu, r.sys_cpu);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    Logger::setLogLevel(Logger::WARN);
+
+    Workload w;
+    if (argc > 1) w.connections = std::atoi(argv[1]);
+    if (argc > 2) w.messages = std::atoi(argv[2]);
+    if (argc > 3) w.payload = static_cast<size_t>(std::atoll(argv[3]));
+
+    printf("workload: %d connections x %d messages x %zu bytes\n", w.connections, w.messages, w.payload);
+
+    Result muduo_result = runMuduo(w, 61800);
+    printResult("muduo", w, muduo_result);
+
+    if (!IoUringBackend::available()) {
+        printf("io_uring  skipped (build with -DENABLE_IO_URING=ON on kernel >= 6.0)\n");
+        return 0;
+    }
+
+    IoUringBackend::Stats rx, tx;
+    Result uring_result = runIoUring(w, 61801, &rx, &tx);
+    printResult("io_uring", w, uring_result);
+    printf("io_uring  rx: enter=%llu sqe=%llu cqe=%llu | tx: enter=%llu sqe=%llu cqe=%llu\n",
+           static_cast<unsigned long long>(rx.submit_calls), static_cast<unsigned long long>(rx.sqes),
+           static_cast<unsigned long long>(rx.cqes), static_cast<unsigned long long>(tx.submit_calls),
+           static_cast<unsigned long long>(tx.sqes), static_cast<unsigned long long>(tx.cqes));
+    return 0;
+}
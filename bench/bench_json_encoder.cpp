@@ -0,0 +1,133 @@
+// JSON 编码对比：util::MessageToJsonString / 预编译计划的 JsonEncoder
+//
+// 按 FoxgloveBridge::publishJsonMessage 的选项（保留字段名、输出默认值）编码 Odometry 与
+// MarkerArray（markers 个 Marker，每个带 points 个点），统计每条消息的耗时与输出吞吐。
+// JsonEncoder 复用同一个输出缓冲区，与桥接节点的用法一致。
+//
+// 用法：bench_json_encoder [messages=20000] [markers=100] [points=20]
+
+#include "json_encoder.h"
+#include "marker.pb.h"
+#include <google/protobuf/util/json_util.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+using namespace simple_ros;
+
+namespace {
+
+struct Options {
+    int messages = 20000;
+    int markers = 100;
+    int points = 20;
+};
+
+geometry_msgs::Odometry makeOdometry() {
+    geometry_msgs::Odometry odom;
+    odom.mutable_header()->set_frame_id("odom");
+    odom.mutable_header()->mutable_stamp()->set_sec(1700000000);
+    odom.mutable_header()->mutable_stamp()->set_nanosec(123456789);
+    odom.mutable_pose()->mutable_position()->set_x(12.3456);
+    odom.mutable_pose()->mutable_position()->set_y(-7.891);
+    odom.mutable_pose()->mutable_orientation()->set_z(0.3826834);
+    odom.mutable_pose()->mutable_orientation()->set_w(0.9238795);
+    odom.mutable_linear_velocity()->set_x(0.5);
+    odom.mutable_angular_velocity()->set_z(0.12);
+    return odom;
+}
+
+visualization_msgs::MarkerArray makeMarkerArray(const Options& opt) {
+    visualization_msgs::MarkerArray array;
+    for (int i = 0; i < opt.markers; ++i) {
+        auto* marker = array.add_markers();
+        marker->set_ns("bench");
+        marker->set_id(i);
+        marker->set_type(visualization_msgs::LINE_STRIP);
+        marker->mutable_pose()->mutable_position()->set_x(i);
+        marker->mutable_pose()->mutable_orientation()->set_w(1.0);
+        marker->mutable_scale()->set_x(0.1);
+        marker->mutable_color()->set_a(1.0f);
+        marker->mutable_header()->set_frame_id("map");
+        for (int p = 0; p < opt.points; ++p) {
+            auto* pt = marker->add_points();
+            pt->set_x(p * 0.1);
+            pt->set_y(i * 0.1);
+            pt->set_z(0.5);
+        }
+    }
+    return array;
+}
+
+struct Result {
+    double ns_per_msg;
+    size_t bytes;
+};
+
+Result runUtil(const google::protobuf::Message& msg, int messages) {
+    google::protobuf::util::JsonPrintOptions opts;
+    opts.always_print_primitive_fields = true;
+    opts.preserve_proto_field_names = true;
+    std::string out;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < messages; ++i) {
+        out.clear();
+        if (!google::protobuf::util::MessageToJsonString(msg, &out, opts).ok()) {
+            std::fprintf(stderr, "MessageToJsonString failed\n");
+            std::exit(1);
+        }
+    }
+    double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    return {ns / messages, out.size()};
+}
+
+Result runEncoder(const JsonEncoder& encoder, const google::protobuf::Message& msg, int messages) {
+    std::string out;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < messages; ++i) {
+        out.clear();
+        encoder.encode(msg, &out);
+    }
+    double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    return {ns / messages, out.size()};
+}
+
+void report(const char* name, const Result& r) {
+    double mb_per_s = r.bytes / r.ns_per_msg * 1e9 / (1 << 20);
+    std::printf("  %-12s %10.0f ns/msg  %8.1f MB/s  (%zu bytes)\n", name, r.ns_per_msg, mb_per_s, r.bytes);
+}
+
+void compare(const char* title, const google::protobuf::Message& msg, int messages, const JsonEncoder& encoder) {
+    std::printf("%s\n", title);
+    runUtil(msg, messages / 10 + 1);   // 预热
+    runEncoder(encoder, msg, messages / 10 + 1);
+    Result util = runUtil(msg, messages);
+    Result fast = runEncoder(encoder, msg, messages);
+    report("util", util);
+    report("JsonEncoder", fast);
+    std::printf("  speedup      %10.1fx\n", util.ns_per_msg / fast.ns_per_msg);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    Options opt;
+    if (argc > 1) opt.messages = std::atoi(argv[1]);
+    if (argc > 2) opt.markers = std::atoi(argv[2]);
+    if (argc > 3) opt.points = std::atoi(argv[3]);
+
+    JsonEncoder::Options options;
+    options.always_print_primitive_fields = true;
+    options.preserve_proto_field_names = true;
+    JsonEncoder encoder(options);
+
+    compare("Odometry", makeOdometry(), opt.messages, encoder);
+
+    char title[64];
+    std::snprintf(title, sizeof(title), "MarkerArray: %d markers x %d points", opt.markers, opt.points);
+    // MarkerArray 单条较大，按相同总数据量缩减条数
+    compare(title, makeMarkerArray(opt), std::max(1, opt.messages / opt.markers), encoder);
+    return 0;
+}
@@ -0,0 +1,108 @@
+// Marker → SceneEntity 转换耗时：逐点转换 / 批量转换（marker_scene）
+//
+// 构造一个 points 个点、带旋转姿态与逐点颜色的 POINTS Marker 和同样点数的 LINE_STRIP Marker，
+// 分别用逐点 push_back 并对每个点做四元数旋转的朴素实现与 appendMarkerPrimitives 转换，
+// 统计每次转换的耗时与每点耗时。
+//
+// 用法：bench_marker_scene [points=100000] [iterations=50]
+
+#include "marker_scene.h"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+using namespace simple_ros;
+
+namespace {
+
+visualization_msgs::Marker makeMarker(visualization_msgs::MarkerType type, int points) {
+    visualization_msgs::Marker marker;
+    marker.set_type(type);
+    marker.mutable_pose()->mutable_position()->set_x(1.0);
+    marker.mutable_pose()->mutable_orientation()->set_z(std::sin(0.3));
+    marker.mutable_pose()->mutable_orientation()->set_w(std::cos(0.3));
+    marker.mutable_scale()->set_x(0.05);
+    marker.mutable_color()->set_a(1.0f);
+    for (int i = 0; i < points; ++i) {
+        auto* p = marker.add_points();
+        p->set_x(i * 0.01);
+        p->set_y(std::sin(i * 0.01));
+        p->set_z(0.5);
+        auto* c = marker.add_colors();
+        c->set_r((i % 255) / 255.0f);
+        c->set_a(1.0f);
+    }
+    return marker;
+}
+
+// 朴素实现：每个点单独 push_back，并用四元数公式 v' = v + 2w(q×v) + 2q×(q×v) 旋转
+void naiveConvert(const visualization_msgs::Marker& marker, foxglove::schemas::SceneEntity* entity) {
+    const auto& q = marker.pose().orientation();
+    const auto& t = marker.pose().position();
+    if (marker.type() == visualization_msgs::LINE_STRIP) {
+        foxglove::schemas::LinePrimitive line;
+        for (const auto& p : marker.points()) {
+            line.points.push_back(foxglove::schemas::Point3{p.x(), p.y(), p.z()});
+        }
+        for (const auto& c : marker.colors()) {
+            line.colors.push_back(foxglove::schemas::Color{c.r(), c.g(), c.b(), c.a()});
+        }
+        entity->lines.push_back(std::move(line));
+        return;
+    }
+    for (int i = 0; i < marker.points_size(); ++i) {
+        const auto& p = marker.points(i);
+        double cx = q.y() * p.z() - q.z() * p.y();
+        double cy = q.z() * p.x() - q.x() * p.z();
+        double cz = q.x() * p.y() - q.y() * p.x();
+        double ccx = q.y() * cz - q.z() * cy;
+        double ccy = q.z() * cx - q.x() * cz;
+        double ccz = q.x() * cy - q.y() * cx;
+        foxglove::schemas::SpherePrimitive sphere;
+        foxglove::schemas::Pose pose;
+        pose.position = foxglove::schemas::Vector3{p.x() + 2 * (q.w() * cx + ccx) + t.x(),
+                                                   p.y() + 2 * (q.w() * cy + ccy) + t.y(),
+                                                   p.z() + 2 * (q.w() * cz + ccz) + t.z()};
+        pose.orientation = foxglove::schemas::Quaternion{0.0, 0.0, 0.0, 1.0};
+        sphere.pose = pose;
+        sphere.size = foxglove::schemas::Vector3{marker.scale().x(), marker.scale().x(), marker.scale().x()};
+        const auto& c = marker.colors(i);
+        sphere.color = foxglove::schemas::Color{c.r(), c.g(), c.b(), c.a()};
+        entity->spheres.push_back(sphere);
+    }
+}
+
+template <typename Fn>
+double timeIt(int iterations, Fn&& fn) {
+    fn();   // 预热
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i) fn();
+    return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / iterations;
+}
+
+void compare(const char* name, const visualization_msgs::Marker& marker, int iterations) {
+    double naive_us = timeIt(iterations, [&]() {
+        foxglove::schemas::SceneEntity entity;
+        naiveConvert(marker, &entity);
+    });
+    double batched_us = timeIt(iterations, [&]() {
+        foxglove::schemas::SceneEntity entity;
+        appendMarkerPrimitives(marker, &entity);
+    });
+    const double n = marker.points_size();
+    std::printf("%-10s naive %9.1f us (%5.2f ns/pt)   batched %9.1f us (%5.2f ns/pt)   %.2fx\n", name,
+                naive_us, naive_us * 1e3 / n, batched_us, batched_us * 1e3 / n, naive_us / batched_us);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    int points = argc > 1 ? std::atoi(argv[1]) : 100000;
+    int iterations = argc > 2 ? std::atoi(argv[2]) : 50;
+
+    std::printf("%d points per marker, %d iterations\n", points, iterations);
+    compare("POINTS", makeMarker(visualization_msgs::POINTS, points), iterations);
+    compare("LINE_STRIP", makeMarker(visualization_msgs::LINE_STRIP, points), iterations);
+    return 0;
+}
@@ -0,0 +1,121 @@
+// 接收路径消息分配方式对比：堆分配 / 对象池 / 每条消息一个 Arena / 每批帧一个 Arena
+//
+// 按 PollManager 的方式反序列化 MarkerArray（markers 个 Marker，每个带 points 个点）：
+// MsgFactory::createSharedMessage 创建消息，ParseFromString 解析，随后释放 shared_ptr。
+// 统计每条消息的耗时与 operator new 次数。
+//
+// 用法：bench_msg_alloc [messages=20000] [markers=100] [points=20] [batch=16]
+
+#include "msg_factory.h"
+#include "marker.pb.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <string>
+#include <vector>
+
+namespace {
+
+std::atomic<uint64_t> g_allocations{0};
+
+struct Options {
+    int messages = 20000;
+    int markers = 100;
+    int points = 20;
+    int batch = 16;
+};
+
+std::string makePayload(const Options& opt) {
+    visualization_msgs::MarkerArray array;
+    for (int i = 0; i < opt.markers; ++i) {
+        auto* marker = array.add_markers();
+        marker->set_ns("bench");
+        marker->set_id(i);
+        marker->set_type(visualization_msgs::LINE_STRIP);
+        marker->mutable_pose()->mutable_position()->set_x(i);
+        marker->mutable_pose()->mutable_orientation()->set_w(1.0);
+        marker->mutable_scale()->set_x(0.1);
+        marker->mutable_color()->set_a(1.0f);
+        marker->mutable_header()->set_frame_id("map");
+        for (int p = 0; p < opt.points; ++p) {
+            auto* pt = marker->add_points();
+            pt->set_x(p * 0.1);
+            pt->set_y(i * 0.1);
+            pt->set_z(0.5);
+        }
+    }
+    return array.SerializeAsString();
+}
+
+struct Result {
+    double ns_per_msg;
+    double allocs_per_msg;
+};
+
+// batch 为 0 表示不使用 Arena（按 pool_capacity 使用对象池或堆），1 表示每条消息一个 Arena
+Result run(const Options& opt, const std::string& payload, int batch, size_t pool_capacity) {
+    MsgFactory& factory = MsgFactory::instance();
+    factory.setPoolCapacity(pool_capacity);
+    const MsgTypeId type_id = factory.typeId(visualization_msgs::MarkerArray::descriptor()->full_name());
+    std::vector<std::shared_ptr<google::protobuf::Message>> held;
+    held.reserve(opt.batch);
+
+    uint64_t allocs_before = g_allocations.load();
+    auto start = std::chrono::steady_clock::now();
+    for (int done = 0; done < opt.messages;) {
+        // 模拟一次读取解出的一批帧：回调处理完整批后才释放
+        MessageArenaPtr arena;
+        if (batch > 1) arena = std::make_shared<MessageArena>(MessageArena::blockSizeFor(payload.size() * batch));
+        for (int i = 0; i < opt.batch && done < opt.messages; ++i, ++done) {
+            MessageArenaPtr msg_arena = arena;
+            if (batch == 1) msg_arena = std::make_shared<MessageArena>(MessageArena::blockSizeFor(payload.size()));
+            auto msg = factory.createSharedMessage(type_id, msg_arena);
+            if (!msg || !msg->ParseFromString(payload)) {
+                std::fprintf(stderr, "parse failed\n");
+                std::exit(1);
+            }
+            held.push_back(std::move(msg));
+        }
+        held.clear();
+    }
+    double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    uint64_t allocs = g_allocations.load() - allocs_before;
+    return {ns / opt.messages, static_cast<double>(allocs) / opt.messages};
+}
+
+} // namespace
+
+void* operator new(size_t size) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+
+int main(int argc, char* argv[]) {
+    Options opt;
+    if (argc > 1) opt.messages = std::atoi(argv[1]);
+    if (argc > 2) opt.markers = std::atoi(argv[2]);
+    if (argc > 3) opt.points = std::atoi(argv[3]);
+    if (argc > 4) opt.batch = std::atoi(argv[4]);
+
+    MsgFactory::instance().registerMessage<visualization_msgs::MarkerArray>();
+    std::string payload = makePayload(opt);
+    std::printf("MarkerArray: %d markers x %d points, %zu bytes, %d messages\n",
+                opt.markers, opt.points, payload.size(), opt.messages);
+
+    run(opt, payload, 0, 0);   // 预热
+    struct Mode { const char* name; int batch; size_t pool; };
+    const size_t pool = static_cast<size_t>(opt.batch);
+    const Mode modes[] = {{"heap", 0, 0}, {"pool", 0, pool}, {"arena/msg", 1, 0}, {"arena/batch", opt.batch, 0}};
+    for (const auto& mode : modes) {
+        Result r = run(opt, payload, mode.batch, mode.pool);
+        std::printf("%-12s %10.0f ns/msg  %8.1f allocs/msg\n", mode.name, r.ns_per_msg, r.allocs_per_msg);
+    }
+    return 0;
+}
@@ -0,0 +1,119 @@
+// 实时调优前后的定时器唤醒延迟对比
+//
+// 在一个 EventLoop 线程上运行周期定时器，记录每次触发相对截止时间的延迟（TimerEvent::jitter），
+// 同时用 load_threads 个线程制造 CPU 与内存分配负载。先以默认设置运行一轮，
+// 再对定时器线程应用 RealtimeProfile（固定 CPU + SCHED_FIFO + mlockall）运行一轮，比较尾延迟。
+// SCHED_FIFO 与 mlockall 需要 root 或 CAP_SYS_NICE/足够的 RLIMIT_MEMLOCK，权限不足时第二轮只有亲和性生效。
+//
+// 用法：bench_rt_latency [seconds=5] [period_us=1000] [load_threads=nproc] [cpu=last] [priority=80]
+
+#include "realtime_profile.h"
+#include "latency_histogram.h"
+#include "timer.h"
+#include <muduo/base/Logging.h>
+#include <muduo/net/EventLoop.h>
+#include <muduo/net/EventLoopThread.h>
+#include <unistd.h>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace simple_ros;
+
+namespace {
+
+struct Options {
+    double seconds = 5.0;
+    double period_us = 1000.0;
+    int load_threads = 0;
+    int cpu = -1;
+    int priority = 80;
+};
+
+// 计算与分配混合的干扰负载
+void loadLoop(const std::atomic<bool>& running) {
+    std::vector<std::unique_ptr<char[]>> blocks(64);
+    size_t i = 0;
+    volatile double sink = 0;
+    while (running.load(std::memory_order_relaxed)) {
+        for (int k = 0; k < 2000; ++k) sink = sink + k * 0.5;
+        blocks[i % blocks.size()].reset(new char[4096 + (i % 16) * 1024]);
+        blocks[i % blocks.size()][0] = 1;
+        ++i;
+    }
+}
+
+LatencyHistogram runOnce(const Options& opt, const RealtimeProfile* profile) {
+    muduo::net::EventLoopThread::ThreadInitCallback init;
+    if (profile) {
+        init = [profile](muduo::net::EventLoop*) { profile->applyToCurrentThread(ThreadRole::TIMER); };
+    }
+    muduo::net::EventLoopThread loop_thread(init, "RtLatency");
+    muduo::net::EventLoop* loop = loop_thread.startLoop();
+
+    std::atomic<bool> running(true);
+    std::vector<std::thread> load;
+    for (int i = 0; i < opt.load_threads; ++i) {
+        load.emplace_back([&running]() { loadLoop(running); });
+    }
+
+    auto timer = std::make_shared<Timer>(loop, opt.period_us * 1e-6, [](const TimerEvent&) {});
+    timer->start();
+    std::this_thread::sleep_for(std::chrono::duration<double>(opt.seconds));
+    timer->stop();
+    LatencyHistogram hist = timer->getLatencyHistogram();
+
+    running = false;
+    for (auto& t : load) t.join();
+    return hist;
+}
+
+void report(const char* name, const LatencyHistogram& h) {
+    std::printf("%-10s n=%-8llu p50=%8.1fus  p99=%8.1fus  p99.9=%8.1fus  max=%8.1fus\n", name,
+                static_cast<unsigned long long>(h.count()), h.percentile(0.5) * 1e6, h.percentile(0.99) * 1e6,
+                h.percentile(0.999) * 1e6, h.max() * 1e6);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    muduo::Logger::setLogLevel(muduo::Logger::WARN);
+
+    Options opt;
+    long cpus = ::sysconf(_SC_NPROCESSORS_ONLN);
+    opt.load_threads = static_cast<int>(cpus > 0 ? cpus : 1);
+    opt.cpu = static_cast<int>(cpus > 0 ? cpus - 1 : 0);
+    if (argc > 1) opt.seconds = std::atof(argv[1]);
+    if (argc > 2) opt.period_us = std::atof(argv[2]);
+    if (argc > 3) opt.load_threads = std::atoi(argv[3]);
+    if (argc > 4) opt.cpu = std::atoi(argv[4]);
+    if (argc > 5) opt.priority = std::atoi(argv[5]);
+
+    std::printf("timer period %.0fus, %d load thread(s), %.1fs per run\n",
+                opt.period_us, opt.load_threads, opt.seconds);
+
+    LatencyHistogram baseline = runOnce(opt, nullptr);
+
+    RealtimeProfile profile;
+    profile.lock_memory = true;
+    profile.prefault_heap = 16u << 20;
+    profile.prefault_stack = 256u << 10;
+    auto& timer_settings = profile.settings(ThreadRole::TIMER);
+    timer_settings.cpus = {opt.cpu};
+    timer_settings.policy = SchedPolicy::FIFO;
+    timer_settings.priority = opt.priority;
+    bool locked = profile.lockMemory();
+    LatencyHistogram tuned = runOnce(opt, &profile);
+
+    std::printf("\nwakeup latency (actual - deadline)\n");
+    report("default", baseline);
+    report("realtime", tuned);
+    if (!locked) {
+        std::printf("note: mlockall failed; run as root or raise RLIMIT_MEMLOCK for the full profile\n");
+    }
+    return 0;
+}
@@ -0,0 +1,122 @@
+// 分层时间轮与 muduo TimerQueue 对比
+//
+// 负载：N 个活跃定时器（到期时间均匀分布在 [1ms, 60s]），随后执行 M 次"喂狗"操作
+// （取消一个定时器并以新的超时时间重新添加），最后统计时间轮空转与到期处理的每 tick 开销。
+// muduo 一侧在 EventLoop 线程内直接调用 runAfter/cancel（std::set，O(log n)，每次变更可能重设 timerfd）。
+//
+// 用法：bench_timing_wheel [timers=100000] [ops=1000000] [resolution_ms=1]
+
+#include "timing_wheel.h"
+#include <muduo/base/Logging.h>
+#include <muduo/net/EventLoop.h>
+#include <muduo/net/EventLoopThread.h>
+#include <muduo/net/TimerId.h>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <future>
+#include <random>
+#include <vector>
+
+using namespace simple_ros;
+
+namespace {
+
+struct Workload {
+    int timers = 100000;
+    int ops = 1000000;
+    double resolution = 0.001;
+};
+
+using BenchClock = std::chrono::steady_clock;
+
+double nsPerOp(BenchClock::time_point start, BenchClock::time_point end, long ops) {
+    return std::chrono::duration<double, std::nano>(end - start).count() / ops;
+}
+
+std::vector<double> makeDelays(int n, uint32_t seed) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> dist(0.001, 60.0);
+    std::vector<double> delays(n);
+    for (auto& d : delays) d = dist(rng);
+    return delays;
+}
+
+void benchWheel(const Workload& w) {
+    TimingWheel::Options options;
+    options.resolution = w.resolution;
+    TimingWheel wheel(nullptr, options);  // 手动推进，排除 timerfd 唤醒的影响
+
+    auto delays = makeDelays(w.timers, 1);
+    auto feeds = makeDelays(w.ops, 2);
+    uint64_t fired = 0;
+    std::vector<TimingWheel::TimerId> ids(w.timers);
+
+    auto t0 = BenchClock::now();
+    for (int i = 0; i < w.timers; ++i) {
+        ids[i] = wheel.schedule(delays[i], [&fired]() { ++fired; });
+    }
+    auto t1 = BenchClock::now();
+    for (int i = 0; i < w.ops; ++i) {
+        int k = i % w.timers;
+        wheel.cancel(ids[k]);
+        ids[k] = wheel.schedule(feeds[i], [&fired]() { ++fired; });
+    }
+    auto t2 = BenchClock::now();
+
+    // 推进 60s 仿真时长，全部定时器到期
+    uint64_t ticks = static_cast<uint64_t>(60.0 / w.resolution) + 1;
+    for (uint64_t i = 0; i < ticks; ++i) wheel.advance(1);
+    auto t3 = BenchClock::now();
+
+    printf("wheel     schedule %7.1f ns/op   cancel+schedule %7.1f ns/op   tick %7.1f ns/tick  fired=%llu\n",
+           nsPerOp(t0, t1, w.timers), nsPerOp(t1, t2, w.ops), nsPerOp(t2, t3, static_cast<long>(ticks)),
+           static_cast<unsigned long long>(fired));
+}
+
+void benchMuduo(const Workload& w) {
+    muduo::net::EventLoopThread thread;
+    muduo::net::EventLoop* loop = thread.startLoop();
+
+    std::promise<void> done;
+    loop->runInLoop([&]() {
+        auto delays = makeDelays(w.timers, 1);
+        auto feeds = makeDelays(w.ops, 2);
+        std::vector<muduo::net::TimerId> ids(w.timers);
+
+        auto t0 = BenchClock::now();
+        for (int i = 0; i < w.timers; ++i) {
+            ids[i] = loop->runAfter(delays[i], []() {});
+        }
+        auto t1 = BenchClock::now();
+        for (int i = 0; i < w.ops; ++i) {
+            int k = i % w.timers;
+            loop->cancel(ids[k]);
+            ids[k] = loop->runAfter(feeds[i], []() {});
+        }
+        auto t2 = BenchClock::now();
+        for (auto& id : ids) loop->cancel(id);
+
+        printf("muduo     schedule %7.1f ns/op   cancel+schedule %7.1f ns/op\n",
+               nsPerOp(t0, t1, w.timers), nsPerOp(t1, t2, w.ops));
+        done.set_value();
+    });
+    done.get_future().wait();
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    muduo::Logger::setLogLevel(muduo::Logger::WARN);
+
+    Workload w;
+    if (argc > 1) w.timers = std::atoi(argv[1]);
+    if (argc > 2) w.ops = std::atoi(argv[2]);
+    if (argc > 3) w.resolution = std::atof(argv[3]) / 1000.0;
+
+    printf("workload: %d active timers, %d feed ops, resolution %.3f ms\n",
+           w.timers, w.ops, w.resolution * 1000.0);
+    benchWheel(w);
+    benchMuduo(w);
+    return 0;
+}
@@ -1,6 +1,11 @@
 #include "global_init.h"
 #include "node_handle.h"
 #include "geometry_msgs.pb.h"
+#include "rosgraph_msgs.pb.h"
+#include "clock.h"
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
 #include <thread>
 #include <chrono>
 #include <memory>
@@ -19,16 +24,26 @@ struct QuadState {
 
 class QuadSimulator {
 public:
-    QuadSimulator() : counter_(0) {}
+    // speedup > 0 时由本节点驱动仿真时间，以 speedup 倍真实时间运行并发布 /clock
+    explicit QuadSimulator(double speedup = 0.0) : counter_(0), speedup_(speedup) {}
+
+    ~QuadSimulator() {
+        clock_running_ = false;
+        if (clock_thread_.joinable()) clock_thread_.join();
+    }
 
     void run() {
         auto& sys = SystemManager::instance();
         sys.init("quad_simulator");
-        std::this_thread::sleep_for(200ms);
 
         nh_ = std::make_shared<NodeHandle>();
         odom_pub_ = nh_->advertise<geometry_msgs::Odometry>("quad_odometry");
 
+        // 定时器创建前切换到仿真时间，定时器随仿真时间触发
+        if (speedup_ > 0) {
+            startSimClock();
+        }
+
         timer_ = nh_->createTimer(
             0.02,
             std::bind(&QuadSimulator::timerCallback, this, std::placeholders::_1),
@@ -41,9 +56,36 @@ public:
 
 private:
     int counter_;
+    double speedup_;
     std::shared_ptr<NodeHandle> nh_;
     std::shared_ptr<Publisher<geometry_msgs::Odometry>> odom_pub_;
+    std::shared_ptr<Publisher<rosgraph_msgs::Clock>> clock_pub_;
     std::shared_ptr<Timer> timer_;
+    std::thread clock_thread_;
+    std::atomic<bool> clock_running_{false};
+
+    void startSimClock() {
+        simple_ros::Clock::instance().enableSimTime(0.0);
+        clock_pub_ = nh_->advertise<rosgraph_msgs::Clock>(simple_ros::Clock::kClockTopic);
+        clock_running_ = true;
+
+        clock_thread_ = std::thread([this]() {
+            const double step = 0.005;  // 每步推进的仿真时间（秒）
+            auto wall_step = std::chrono::duration<double>(step / speedup_);
+            auto next = std::chrono::steady_clock::now();
+            while (clock_running_) {
+                simple_ros::Clock::instance().advance(step);
+
+                rosgraph_msgs::Clock msg;
+                simple_ros::Clock::toMsg(simple_ros::Clock::instance().now(), msg.mutable_clock());
+                clock_pub_->publish(msg);
+
+                next += std::chrono::duration_cast<std::chrono::steady_clock::duration>(wall_step);
+                std::this_thread::sleep_until(next);
+            }
+        });
+        std::cout << "Simulated clock running at " << speedup_ << "x real time" << std::endl;
+    }
 
     void timerCallback(const TimerEvent& event) {
         double dt = 0.02;
@@ -72,8 +114,10 @@ private:
         // 计算四元数
         QuadState state = computeFlatness(x, y, z, vx, vy, vz, ax, ay, az);
 
-        // 发布Odometry
+        // 发布Odometry，时间戳跟随 Clock（仿真模式下为仿真时间）
         geometry_msgs::Odometry odom_msg;
+        simple_ros::Clock::instance().stamp(odom_msg.mutable_header());
+        odom_msg.mutable_header()->set_frame_id("world");
         odom_msg.mutable_pose()->mutable_position()->set_x(state.x);
         odom_msg.mutable_pose()->mutable_position()->set_y(state.y);
         odom_msg.mutable_pose()->mutable_position()->set_z(state.z);
@@ -122,9 +166,17 @@ private:
     }
 };
 
-int main() {
+int main(int argc, char** argv) {
+    // --speedup N：以 N 倍真实时间运行仿真
+    double speedup = 0.0;
+    for (int i = 1; i + 1 < argc; ++i) {
+        if (std::strcmp(argv[i], "--speedup") == 0) {
+            speedup = std::atof(argv[i + 1]);
+        }
+    }
+
     try {
-        QuadSimulator sim;
+        QuadSimulator sim(speedup);
         sim.run();
     } catch (const std::exception& e) {
         std::cerr << "Error: " << e.what() << std::endl;
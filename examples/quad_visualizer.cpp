@@ -153,6 +153,10 @@ private:
             *marker_array.add_markers() = prop;
         }
 
+        // Marker 时间戳沿用里程计的时间戳，仿真加速运行时与仿真时间一致
+        for (auto& marker : *marker_array.mutable_markers()) {
+            *marker.mutable_header() = odom->header();
+        }
         marker_pub_->publish(marker_array);
 
         // --- 短期轨迹 ---
@@ -173,6 +177,7 @@ private:
             new_pt->set_y(pt.y());
             new_pt->set_z(pt.z());
         }
+        *line_short.mutable_header() = odom->header();
         short_path_pub_->publish(line_short);
 
         // --- 增量轨迹 ---
@@ -200,6 +205,7 @@ private:
             p2->set_y(p.y());
             p2->set_z(p.z());
 
+            *line_inc.mutable_header() = odom->header();
             incremental_path_pub_->publish(line_inc);
         }
 
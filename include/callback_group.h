@@ -0,0 +1,55 @@
+// callback_group.h
+// 回调组：约束订阅与定时器回调在多个 spin 线程中的并发关系
+
+#ifndef simple_ros_CALLBACK_GROUP_H
+#define simple_ros_CALLBACK_GROUP_H
+
+#include <atomic>
+#include <memory>
+
+namespace simple_ros {
+
+enum class CallbackGroupType {
+    MUTUALLY_EXCLUSIVE,  // 组内回调互斥执行（默认）
+    REENTRANT            // 组内回调可在多个线程中并发执行
+};
+
+/**
+ * @brief 回调组，由 MessageQueue 在取出回调前后调用 tryEnter/leave
+ *
+ * 同一互斥组中的订阅回调与定时器回调不会同时执行；
+ * 不同组之间互不影响，可由多个 spin 线程并行处理。
+ */
+class CallbackGroup {
+public:
+    explicit CallbackGroup(CallbackGroupType type = CallbackGroupType::MUTUALLY_EXCLUSIVE)
+        : type_(type) {}
+
+    CallbackGroupType type() const { return type_; }
+
+    // 尝试占用该组，互斥组已被占用时返回 false
+    bool tryEnter() {
+        if (type_ == CallbackGroupType::REENTRANT) return true;
+        bool expected = false;
+        return busy_.compare_exchange_strong(expected, true, std::memory_order_acquire);
+    }
+
+    void leave() {
+        if (type_ == CallbackGroupType::MUTUALLY_EXCLUSIVE) {
+            busy_.store(false, std::memory_order_release);
+        }
+    }
+
+    CallbackGroup(const CallbackGroup&) = delete;
+    CallbackGroup& operator=(const CallbackGroup&) = delete;
+
+private:
+    CallbackGroupType type_;
+    std::atomic<bool> busy_{false};
+};
+
+using CallbackGroupPtr = std::shared_ptr<CallbackGroup>;
+
+} // namespace simple_ros
+
+#endif // simple_ros_CALLBACK_GROUP_H
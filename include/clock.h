@@ -0,0 +1,92 @@
+// clock.h
+// 节点时钟：墙上时间或仿真时间
+
+#ifndef simple_ros_CLOCK_H
+#define simple_ros_CLOCK_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <utility>
+#include <vector>
+#include "std_msgs.pb.h"
+
+namespace simple_ros {
+
+enum class ClockType {
+    WALL,  // 系统时间（默认）
+    SIM    // 仿真时间，由 /clock 话题或 setSimTime 推进
+};
+
+/**
+ * @brief 进程内统一的时间源，Timer、Rate 与消息时间戳都以它为准
+ *
+ * 仿真时间只会向前推进；推进的速度由驱动方决定，可以快于真实时间。
+ * 切换时间源须在创建定时器之前完成。
+ */
+class Clock {
+public:
+    // 仿真时钟话题名
+    static constexpr const char* kClockTopic = "/clock";
+
+    using TimeListener = std::function<void(double)>;
+
+    static Clock& instance();
+
+    // 当前时间（秒）
+    double now() const;
+
+    ClockType type() const;
+    bool isSimTime() const { return type() == ClockType::SIM; }
+
+    // 切换到仿真时间，初始值为 start（秒）
+    void enableSimTime(double start = 0.0);
+    void disableSimTime();
+
+    // 设置仿真时间，早于当前仿真时间的值会被忽略
+    void setSimTime(double t);
+    void advance(double dt);
+
+    /**
+     * @brief 阻塞到时钟到达 t（秒）
+     * @return false 表示被 interrupt() 打断
+     */
+    bool sleepUntil(double t);
+    bool sleepFor(double dt) { return sleepUntil(now() + dt); }
+
+    // 唤醒所有 sleepUntil，用于 shutdown
+    void interrupt();
+
+    /**
+     * @brief 注册仿真时间推进监听，在调用 setSimTime 的线程中执行
+     * @return 监听 id，用于 removeTimeListener
+     */
+    uint64_t addTimeListener(TimeListener listener);
+    void removeTimeListener(uint64_t id);
+
+    // 与 std_msgs::Time 互转
+    static void toMsg(double t, std_msgs::Time* msg);
+    static double fromMsg(const std_msgs::Time& msg);
+
+    // 用当前时间填充消息头
+    void stamp(std_msgs::Header* header) const { toMsg(now(), header->mutable_stamp()); }
+
+    Clock(const Clock&) = delete;
+    Clock& operator=(const Clock&) = delete;
+
+private:
+    Clock() = default;
+
+    mutable std::mutex mutex_;
+    std::condition_variable cond_;
+    ClockType type_ = ClockType::WALL;
+    double simTime_ = 0.0;
+    uint64_t interruptGen_ = 0;
+    uint64_t nextListenerId_ = 1;
+    std::vector<std::pair<uint64_t, TimeListener>> listeners_;
+};
+
+} // namespace simple_ros
+
+#endif // simple_ros_CLOCK_H
@@ -0,0 +1,84 @@
+// component.h
+// 组件：可由容器按名字实例化、与其他节点共享同一进程运行时的节点类
+
+#ifndef simple_ros_COMPONENT_H
+#define simple_ros_COMPONENT_H
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+class NodeHandle;
+
+namespace simple_ros {
+
+/**
+ * @brief 组件基类
+ *
+ * 组件在 onInit 中通过传入的 NodeHandle 创建发布者、订阅者与定时器，并自行持有它们；
+ * NodeHandle 以组件名注册到 Master，生命周期由容器管理，长于组件本身。
+ */
+class Component {
+public:
+    virtual ~Component() = default;
+
+    /**
+     * @param nh 绑定到组件节点名的 NodeHandle
+     * @param params 配置文件中该组件的 "params" 字段，未配置时为空对象
+     */
+    virtual void onInit(NodeHandle& nh, const nlohmann::json& params) = 0;
+};
+
+/**
+ * @brief 组件类型注册表，类型名到工厂函数的映射
+ *
+ * 通常通过 SIMPLE_ROS_REGISTER_COMPONENT 在静态初始化阶段注册；
+ * 以共享库形式提供的组件在 dlopen 时完成注册。
+ */
+class ComponentRegistry {
+public:
+    using Factory = std::function<std::unique_ptr<Component>()>;
+
+    static ComponentRegistry& instance();
+
+    // 注册组件类型，同名类型已存在时返回 false
+    bool add(const std::string& type, Factory factory);
+
+    // 按类型名创建组件，未注册时返回空
+    std::unique_ptr<Component> create(const std::string& type) const;
+
+    bool contains(const std::string& type) const;
+    std::vector<std::string> types() const;
+
+    ComponentRegistry(const ComponentRegistry&) = delete;
+    ComponentRegistry& operator=(const ComponentRegistry&) = delete;
+
+private:
+    ComponentRegistry() = default;
+
+    mutable std::mutex mutex_;
+    std::map<std::string, Factory> factories_;
+};
+
+} // namespace simple_ros
+
+#define SIMPLE_ROS_COMPONENT_CONCAT_(a, b) a##b
+#define SIMPLE_ROS_COMPONENT_CONCAT(a, b) SIMPLE_ROS_COMPONENT_CONCAT_(a, b)
+
+// 以 name 注册组件类 Class（须可默认构造），在 .cpp 文件的命名空间作用域中使用
+#define SIMPLE_ROS_REGISTER_COMPONENT_AS(Class, name)                                        \
+    namespace {                                                                              \
+    const bool SIMPLE_ROS_COMPONENT_CONCAT(simple_ros_component_registered_, __LINE__) =     \
+        ::simple_ros::ComponentRegistry::instance().add(name, []() {                         \
+            return std::unique_ptr<::simple_ros::Component>(new Class());                    \
+        });                                                                                  \
+    }
+
+// 以类名注册组件
+#define SIMPLE_ROS_REGISTER_COMPONENT(Class) SIMPLE_ROS_REGISTER_COMPONENT_AS(Class, #Class)
+
+#endif // simple_ros_COMPONENT_H
@@ -0,0 +1,89 @@
+// component_container.h
+// 组件容器：在一个进程中加载多个命名节点，共享 SystemManager 的运行时
+
+#ifndef simple_ros_COMPONENT_CONTAINER_H
+#define simple_ros_COMPONENT_CONTAINER_H
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <nlohmann/json.hpp>
+#include "component.h"
+#include "node_handle.h"
+
+namespace simple_ros {
+
+/**
+ * @brief 组件容器
+ *
+ * 每个组件拥有以组件名命名的 NodeHandle，所有组件共享进程的监听端点、EventLoop、
+ * 定时器线程与消息队列（由 SystemManager::spin 统一执行回调）；各组件的默认回调组相互独立，
+ * 多线程 spin 时不同组件的回调可以并行。同进程组件之间的消息直接投递，不经过套接字。
+ *
+ * 须在 SystemManager::init 之后使用。加载与卸载不是线程安全的，应在同一线程中完成。
+ *
+ * 配置格式：
+ * @code
+ * {
+ *   "libraries": ["./libmy_components.so"],
+ *   "components": [
+ *     {"type": "QuadSimulator", "name": "quad_sim", "params": {"rate": 200}},
+ *     {"type": "QuadVisualizer", "name": "quad_vis"}
+ *   ]
+ * }
+ * @endcode
+ */
+class ComponentContainer {
+public:
+    ComponentContainer() = default;
+    // 按加载的逆序卸载所有组件
+    ~ComponentContainer();
+
+    ComponentContainer(const ComponentContainer&) = delete;
+    ComponentContainer& operator=(const ComponentContainer&) = delete;
+
+    /**
+     * @brief 创建并初始化一个组件
+     * @param type 注册的组件类型名
+     * @param name 节点名，容器内须唯一
+     * @param params 传给 Component::onInit 的参数
+     * @return false 表示类型未注册、名字重复或 onInit 抛出异常
+     */
+    bool load(const std::string& type, const std::string& name,
+              const nlohmann::json& params = nlohmann::json::object());
+
+    // 卸载组件，其发布者、订阅者与定时器随之销毁，订阅同时在 master 注销
+    bool unload(const std::string& name);
+    void unloadAll();
+
+    /**
+     * @brief 按配置加载共享库与组件
+     * @return 成功加载的组件数
+     */
+    size_t loadConfig(const nlohmann::json& config);
+
+    // 读取 JSON 配置文件并加载，文件不存在或格式错误时返回 0
+    size_t loadConfigFile(const std::string& path);
+
+    // dlopen 组件共享库，库中的 SIMPLE_ROS_REGISTER_COMPONENT 在加载时注册
+    static bool loadLibrary(const std::string& path);
+
+    // 已加载的组件名（按加载顺序）
+    std::vector<std::string> names() const;
+    Component* get(const std::string& name) const;
+    size_t size() const { return entries_.size(); }
+
+private:
+    struct Entry {
+        std::string name;
+        std::string type;
+        std::unique_ptr<NodeHandle> nh;
+        std::unique_ptr<Component> component;
+    };
+
+    std::vector<Entry> entries_;
+};
+
+} // namespace simple_ros
+
+#endif // simple_ros_COMPONENT_CONTAINER_H
@@ -3,8 +3,16 @@
 #include <string>
 #include <memory>
 #include <map>
+#include <set>
+#include <deque>
+#include <vector>
+#include <unordered_map>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
 #include <thread>
 #include <chrono>
+#include <optional>
 
 #include <google/protobuf/message.h>
 #include <foxglove/server.hpp>
@@ -15,10 +23,76 @@
 #include "node_handle.h"
 #include "example.pb.h"
 #include "marker.pb.h"
+#include "bridge_msgs.pb.h"
+#include "message_throttle.h"
+#include "keyed_executor.h"
+#include "marker_delta.h"
+#include "trajectory_buffer.h"
+#include "json_encoder.h"
+#include "message_cache.h"
+#include "marker_scene.h"
+#include "stream_stats.h"
 
 #include <muduo/base/Logging.h>
 #include <nlohmann/json.hpp>
 
+// 话题在 Foxglove 中的编码方式
+enum class FoxgloveEncoding {
+    PROTOBUF,  // 原样转发 protobuf 序列化数据，schema 为 FileDescriptorSet
+    JSON       // 转为 JSON 文本，schema 为 JSON Schema
+};
+
+// 已发送的场景实体，新客户端订阅 scene channel 时补发
+struct CachedSceneEntity {
+    foxglove::schemas::SceneEntity entity;
+    size_t bytes = 0;                                  // 估算的内存占用
+    std::chrono::steady_clock::time_point expires;     // 带 lifetime 的实体到期时间，否则为 max
+};
+
+// 单个话题的输出端：各 channel 与 Marker 转换状态，只由该话题所在的转换线程使用
+struct BridgeTopic {
+    explicit BridgeTopic(simple_ros::CacheBudget* budget)
+        : protobuf_last(budget), json_last(budget), scene_reservation(budget) {}
+
+    std::string name;
+    std::shared_ptr<foxglove::RawChannel> protobuf_channel;
+    std::shared_ptr<foxglove::RawChannel> json_channel;
+    std::shared_ptr<foxglove::schemas::SceneUpdateChannel> scene_channel;
+    bool pinned = false;                     // 单条 Marker 话题：轨迹点逐条累积、删除只发一次，转换任务不可丢弃
+    std::unordered_map<std::string, simple_ros::TrajectoryBuffer> trajectories;  // ns → LINE_STRIP 轨迹
+    simple_ros::MarkerDeltaTracker markers;  // MarkerArray 已发送的实体，只发送变化部分
+    std::atomic<bool> resync{false};         // 缓存不完整时有新客户端订阅，下次须发送全部实体
+    uint64_t latest_stamp_ns = 0;            // 已发送实体的最大时间戳，删除操作的时间戳不早于它
+
+    // 最后状态缓存：原始 channel 的最后一条消息与 scene channel 当前的实体，占用全局缓存预算
+    simple_ros::LastMessageSlot protobuf_last;
+    simple_ros::LastMessageSlot json_last;
+    std::atomic<uint64_t> raw_logged{0};     // 原始 channel 发送过的消息数，补发时据此跳过客户端已收到的消息
+    std::unordered_map<std::string, CachedSceneEntity> scene_cache;  // 实体 id → 实体
+    simple_ros::CacheReservation scene_reservation;
+    bool scene_cache_complete = true;        // 预算不足丢弃过实体后为 false，新客户端改用 resync
+
+    simple_ros::StreamStats stats;           // 各阶段计数与转换耗时，发布在统计话题上
+};
+
+// 流水线各阶段的累计统计
+struct FoxgloveBridgeStats {
+    uint64_t discovery_polls = 0;      // GetTopics 调用次数
+    uint64_t discovery_failures = 0;   // GetTopics 失败次数
+    double discovery_rpc_ms = 0.0;     // 最近一次 GetTopics 耗时
+    uint64_t topics = 0;               // 已创建 channel 的话题数
+    uint64_t received = 0;             // 订阅回调收到的消息
+    uint64_t throttled = 0;            // 限速丢弃的消息
+    uint64_t dispatched = 0;           // 提交到转换线程的消息
+    uint64_t converted = 0;            // 转换并写入 channel 的消息
+    uint64_t conversion_dropped = 0;   // 转换队列满时丢弃的消息
+    uint64_t conversion_failed = 0;    // 转换时抛出异常的任务
+    size_t conversion_pending = 0;     // 转换队列中排队的消息
+    double conversion_busy_s = 0.0;    // 转换线程累计耗时
+    uint64_t replayed = 0;             // 向新订阅的客户端补发的缓存消息
+    size_t cache_bytes = 0;            // 最后状态缓存占用的字节
+};
+
 class FoxgloveBridge {
 public:
     FoxgloveBridge(const std::string& rpc_server_address,
@@ -27,32 +101,107 @@ public:
     ~FoxgloveBridge();
 
     bool init();   // 初始化 Foxglove server 和 RPC client
-    bool start();  // 启动自动发现与订阅线程
+    bool start();  // 启动发现、接收与转换线程
     void stop();   // 停止线程，关闭服务器
 
-    // 消息回调：接收到任意 protobuf 消息时调用
+    // 转换线程数，默认取 CPU 核数的一半（1~4）（须在 start 之前调用）
+    void setConversionThreads(size_t threads) { conversion_threads_ = threads; }
+
+    // 话题发现间隔，默认 1 秒（须在 start 之前调用）
+    void setDiscoveryInterval(std::chrono::milliseconds interval) { discovery_interval_ = interval; }
+
+    // 永久轨迹的分段大小、点数上限与旧分段简化容差（须在 start 之前调用）
+    void setTrajectoryOptions(const simple_ros::TrajectoryBuffer::Options& options) { trajectory_options_ = options; }
+
+    // 最后状态缓存的总字节上限，默认 64 MiB，0 表示不缓存（须在 start 之前调用）
+    void setLastMessageCacheBytes(size_t bytes) { cache_budget_.setMaxBytes(bytes); }
+
+    // 统计话题的发布间隔（秒），默认 1 秒，0 表示不发布（须在 start 之前调用）
+    void setStatsInterval(double seconds) { stats_interval_ = seconds; }
+
+    // 各阶段统计快照，可在任意线程调用
+    FoxgloveBridgeStats stats() const;
+
+    // 桥接节点统计（bridge_msgs.BridgeStats）的话题名，同名的 Foxglove channel 发送相同内容
+    static constexpr const char* kStatsTopic = "/foxglove_bridge/stats";
+
+    // 未单独设置编码的话题使用的编码，默认 PROTOBUF（须在 start 之前调用）
+    void setDefaultEncoding(FoxgloveEncoding encoding) { default_encoding_ = encoding; }
+
+    // 设置单个话题的编码（须在 start 之前调用）
+    void setTopicEncoding(const std::string& topic, FoxgloveEncoding encoding) {
+        topic_encodings_[topic] = encoding;
+    }
+
+    // 未单独设置限速的话题的最大输出频率（Hz），默认 0 不限速（须在 start 之前调用）
+    void setDefaultMaxRate(double hz) { default_max_rate_ = hz; }
+
+    // 设置单个话题的最大输出频率（Hz），0 表示不限速（须在 start 之前调用）
+    void setTopicMaxRate(const std::string& topic, double hz) { topic_max_rates_[topic] = hz; }
+
+    // 话题实际使用的限速：Marker/MarkerArray 是增量更新（ADD/DELETE/DELETEALL），
+    // 被 keep-latest 替换的消息无法由后续消息补回，因此这两类话题不限速，返回 0
+    static double effectiveMaxRate(const std::string& msg_type, double max_rate_hz);
+
+    // 消息回调：接收到任意 protobuf 消息时在接收线程调用，限速后交给转换线程
     void onGenericMessage(const std::string& topic_name,
                           const std::shared_ptr<google::protobuf::Message>& msg);
 
 private:
-    void pollAndSubscribeLoop(); // 自动发现 & 订阅 RPC 话题循环
+    // 流水线：发现线程查询 master，接收线程 spin 并按客户端需求订阅，转换线程池按话题有序转换
+    void discoveryLoop();
+    void pollAndSubscribeLoop(); // 接收线程：创建 channel、调整订阅、spin
+    void createDiscoveredChannels();
+    void logStats();
+    void initStats(NodeHandle& nh);   // 统计话题的发布者与 Foxglove channel
+    void publishStats();              // 按间隔发布各话题的统计（接收线程）
+    bridge_msgs::BridgeStats buildStats(double period);
+
+    // 按需订阅：至少有一个 Foxglove 客户端订阅了话题的某个 channel 时才订阅该话题
+    void createChannels(const std::string& topic, const std::string& msg_type);
+    void registerChannel(uint64_t channel_id, const std::string& topic);
+    void onClientSubscribe(uint64_t channel_id, uint32_t client_id,
+                           std::optional<uint64_t> sink_id);             // 服务器线程
+    void onClientUnsubscribe(uint64_t channel_id, uint32_t client_id);   // 服务器线程
+    void updateSubscriptions(NodeHandle& nh);                            // poll 线程
+    bool subscribeTopic(NodeHandle& nh, const std::string& topic);
+    void unsubscribeTopic(NodeHandle& nh, const std::string& topic);
+
+    FoxgloveEncoding encodingFor(const std::string& topic) const;
+    double maxRateFor(const std::string& topic) const;
+
+    // 提交到话题所在的转换线程（限速检查之后）
+    void dispatchMessage(const std::shared_ptr<BridgeTopic>& topic,
+                         const std::shared_ptr<google::protobuf::Message>& msg);
+    // 转换线程：转换并写入 channel
+    void forwardMessage(BridgeTopic& topic, const std::shared_ptr<google::protobuf::Message>& msg);
+    // 发送限速周期已到的待发送消息
+    void flushThrottled();
+
+    // 最后状态缓存：scene 更新发送后实体移入缓存；新订阅时在转换线程中只向该客户端补发
+    void logScene(BridgeTopic& topic, foxglove::schemas::SceneUpdate& update);
+    void resetSceneCache(BridgeTopic& topic);
+    void replayCached(BridgeTopic& topic, uint64_t channel_id, std::optional<uint64_t> sink_id,
+                      uint64_t raw_logged);
+
+    // protobuf channel 相关
+    std::shared_ptr<foxglove::RawChannel> createOrGetProtobufChannel(const std::string& topic,
+                                                                     const google::protobuf::Descriptor* desc);
+    static std::string buildFileDescriptorSet(const google::protobuf::Descriptor* desc);
+    void publishProtobufMessage(BridgeTopic& topic, const std::shared_ptr<google::protobuf::Message>& msg);
 
     // JSON channel 相关
     std::shared_ptr<foxglove::RawChannel> createOrGetJsonChannel(const std::string& topic,
                                                                     const std::string& msg_type);
     std::string pbFieldTypeToJsonType(const google::protobuf::FieldDescriptor* field);
     std::string buildStableJsonSchema(const google::protobuf::Descriptor* desc);
-    void publishJsonMessage(const std::string& topic,
-                        const std::shared_ptr<google::protobuf::Message>& msg);
+    void publishJsonMessage(BridgeTopic& topic, const std::shared_ptr<google::protobuf::Message>& msg);
 
     // Marker 专用处理
-    void publishCube(const std::shared_ptr<foxglove::schemas::SceneUpdateChannel>& channel,
-                     const std::shared_ptr<visualization_msgs::Marker>& marker);
-    void updateTrajectory(const std::shared_ptr<foxglove::schemas::SceneUpdateChannel>& channel,
+    void onMarkerMessage(BridgeTopic& topic, const std::shared_ptr<visualization_msgs::Marker>& marker);
+    void updateTrajectory(BridgeTopic& topic,
                           const std::shared_ptr<visualization_msgs::Marker>& marker);
-    void publishCylinder(const std::shared_ptr<foxglove::schemas::SceneUpdateChannel>& scene_channel,
-                         const std::shared_ptr<visualization_msgs::Marker>& marker);
-    void onMarkerArrayMessage(const std::string& topic_name,
+    void onMarkerArrayMessage(BridgeTopic& topic,
                               const std::shared_ptr<visualization_msgs::MarkerArray>& marker_array);
 
     // 为每个 topic 创建/获取独立 SceneUpdateChannel
@@ -73,19 +222,88 @@ private:
     // RPC client
     std::unique_ptr<simple_ros::RosRpcClient> rpc_client_;
 
-    // 管理不同消息类型的 JSON channel
+    // 各话题的编码设置
+    FoxgloveEncoding default_encoding_ = FoxgloveEncoding::PROTOBUF;
+    std::map<std::string, FoxgloveEncoding> topic_encodings_;
+
+    // 各话题的输出限速设置，以及限速话题的 keep-latest 状态（poll 线程）
+    double default_max_rate_ = 0.0;
+    std::map<std::string, double> topic_max_rates_;
+    std::map<std::string, simple_ros::LatestMessageThrottle> throttles_;
+
+    // 管理不同 topic 的 protobuf channel 与 JSON channel
+    std::map<std::string, std::shared_ptr<foxglove::RawChannel>> protobuf_channels_;
     std::map<std::string, std::shared_ptr<foxglove::RawChannel>> json_channels_;
 
     // 管理不同 topic 的 SceneUpdateChannel
     std::map<std::string, std::shared_ptr<foxglove::schemas::SceneUpdateChannel>> scene_channels_;
 
-    // 保存订阅者，防止析构
+    // 最后状态缓存的全局预算，须先于各话题的缓存构造、后于它们析构
+    simple_ros::CacheBudget cache_budget_{64u << 20};
+
+    // 已发现的话题及其消息类型、输出端（接收线程）
+    std::map<std::string, std::string> topic_types_;
+    std::map<std::string, std::shared_ptr<BridgeTopic>> topics_;
+
+    // 发现线程最近一次查询到的话题列表 (topic, type)，由接收线程取走并创建 channel
+    std::mutex discovery_mutex_;
+    std::condition_variable discovery_cv_;
+    std::vector<std::pair<std::string, std::string>> discovered_topics_;
+    bool discovered_updated_ = false;
+    std::chrono::milliseconds discovery_interval_{1000};
+    std::thread discovery_thread_;
+
+    // 转换线程池：同一话题的消息在同一线程中按序转换
+    size_t conversion_threads_ = 0;
+    std::unique_ptr<simple_ros::KeyedExecutor> executor_;
+    simple_ros::TrajectoryBuffer::Options trajectory_options_;
+
+    // 统计计数
+    std::atomic<uint64_t> discovery_polls_{0};
+    std::atomic<uint64_t> discovery_failures_{0};
+    std::atomic<int64_t> discovery_rpc_us_{0};
+    std::atomic<uint64_t> topic_count_{0};
+    std::atomic<uint64_t> received_{0};
+    std::atomic<uint64_t> throttled_{0};
+    std::atomic<uint64_t> dispatched_{0};
+    std::atomic<uint64_t> converted_{0};
+    std::atomic<uint64_t> conversion_failed_{0};
+    std::atomic<uint64_t> replayed_{0};
+    FoxgloveBridgeStats last_stats_;                       // 上次打印时的快照（接收线程）
+    std::chrono::steady_clock::time_point last_stats_time_;
+
+    // 统计话题与 channel（接收线程）
+    double stats_interval_ = 1.0;
+    std::shared_ptr<Publisher<bridge_msgs::BridgeStats>> stats_pub_;
+    std::shared_ptr<foxglove::RawChannel> stats_channel_;
+    std::map<std::string, simple_ros::StreamStats::Snapshot> last_stream_stats_;
+    FoxgloveBridgeStats last_published_;
+    std::chrono::steady_clock::time_point last_publish_time_;
+
+    // 保存订阅者，防止析构；只包含当前有客户端订阅的话题
     std::map<std::string, std::shared_ptr<Subscriber>> subscribers_;
 
-    // 控制 poll 线程运行状态
-    bool running_;
+    // 客户端订阅情况：服务器线程在回调中写入，poll 线程据此订阅/取消订阅
+    std::mutex demand_mutex_;
+    std::map<uint64_t, std::string> channel_topics_;   // channel id → 话题（原始 channel 与 scene channel）
+    std::map<std::string, std::set<std::pair<uint64_t, uint32_t>>> topic_clients_;  // 话题 → (channel, client)
+    struct ReplayRequest {
+        std::string topic;
+        uint64_t channel_id;
+        std::optional<uint64_t> sink_id;               // 新客户端的 sink，为空时补发给所有客户端
+        uint64_t raw_logged;                           // 订阅时话题的 raw_logged
+    };
+    std::map<std::string, std::shared_ptr<BridgeTopic>> replay_topics_;  // 与 topics_ 相同，供服务器线程读取
+    std::vector<ReplayRequest> replay_requests_;      // 新订阅，待补发最后状态
+    std::atomic<bool> demand_changed_{false};
+
+    // 控制各线程运行状态
+    std::atomic<bool> running_;
     std::thread poll_thread_;
 
     // 系统对象，用于 spinOnce
     SystemManager& sys_ = SystemManager::instance();
+
+    // JSON channel 的编码器，各转换线程共享编码计划
+    simple_ros::JsonEncoder json_encoder_;
 };
@@ -1,28 +1,65 @@
 #pragma once
 
+#include <atomic>
 #include <memory>
 #include <thread>
 #include <muduo/net/EventLoop.h>
+#include <muduo/net/EventLoopThread.h>
 #include "message_queue.h"
 #include "poll_manager.h"
 #include "ros_rpc_client.h"  // 添加ROS RPC客户端头文件
+#include "io_uring_backend.h"
+#include "timing_wheel.h"
+#include "realtime_profile.h"
+#include <mutex>
 #include <string>
 #include "ros_rpc.pb.h"
 
 using namespace simple_ros;
+
+// IO 线程配置，须在 init 之前设置
+struct IoThreadConfig {
+    int receive_threads = 0;          // PollManager 接收连接的 IO 线程数，0 表示全部在主 EventLoop 中处理
+    bool dedicated_timer_loop = true; // 定时器与发布者连接使用独立的 EventLoop 线程
+    bool timer_callbacks_in_spin = true; // 定时器回调投递到消息队列，由 spin 线程执行而非 EventLoop 线程
+};
+
+// init 各阶段耗时（毫秒）
+struct StartupTimings {
+    double realtime_ms = 0.0;       // 锁定与预触碰内存
+    double port_ms = 0.0;           // 分配监听端口
+    double rpc_client_ms = 0.0;     // 创建 Master RPC 客户端
+    double timer_loop_ms = 0.0;     // 启动定时器线程
+    double listener_ms = 0.0;       // 事件线程创建 EventLoop 并开始监听
+    double clock_subscribe_ms = 0.0; // 仿真时间下订阅 /clock
+    double total_ms = 0.0;
+};
+
 class SystemManager {
 public:
     // 单例入口
     static SystemManager& instance();
 
-    // 初始化系统
+    /**
+     * @brief 初始化系统，返回时 EventLoop 已运行、TCP/UDP/Unix 监听均已就绪
+     *
+     * port 为 0 时由内核分配端口，可通过 getNodeInfo().port() 读取。
+     */
     void init();
     void init(int port);
     void init(int port, std::string node_name);
+    // 使用内核分配的端口
     void init(const std::string& node_name);
     // spin 主线程处理消息队列
     void spin();
 
+    /**
+     * @brief 使用 num_threads 个线程（含当前线程）处理消息队列，阻塞直到 shutdown
+     *
+     * 同一互斥回调组中的回调不会并发执行，不同组可并行。
+     */
+    void spin(int num_threads);
+
     void spinOnce();
 
     // 关闭系统
@@ -31,17 +68,77 @@ public:
     // 获取消息队列指针
     std::shared_ptr<MessageQueue> getMessageQueue() const { return messageQueue_; }
 
+    /**
+     * @brief 按当前最小的 deadline 调整周期检查，没有订阅设置 deadline 时不启用
+     *
+     * 由 Subscriber 创建与析构时调用；检查周期为最小 deadline 的一半（不小于 10ms）。
+     */
+    void updateDeadlineCheck();
+
     // 获取 PollManager 指针
     std::shared_ptr<PollManager> getPollManager() const { return pollManager_; }
 
-    // 获取 EventLoop 指针
+    // 获取 EventLoop 指针（PollManager 的监听/接收主循环）
     std::shared_ptr<muduo::net::EventLoop> getEventLoop() const { return eventLoop_; }
 
+    // 定时器与发布者连接所在的 EventLoop，未启用独立线程时与 getEventLoop() 相同
+    muduo::net::EventLoop* getTimerLoop() const { return timerLoop_ ? timerLoop_ : eventLoop_.get(); }
+
+    /**
+     * @brief 节点共享的分层时间轮，首次调用时在定时器 EventLoop 上创建
+     *
+     * 适合大量超时/看门狗定时器（O(1) 添加与取消，共用一个 timerfd）；
+     * 回调在 EventLoop 线程中执行，耗时工作应投递到 MessageQueue::pushTask。须在 init 之后调用。
+     * shutdown 时时间轮与 EventLoop 脱离（TimingWheel::detach），之后仍持有的引用可以安全释放，但定时器不再触发。
+     */
+    std::shared_ptr<TimingWheel> getTimingWheel();
+
+    // 设置时间轮参数（tick 精度等），须在首次 getTimingWheel 之前调用
+    void setTimingWheelOptions(const TimingWheelOptions& options) { timingWheelOptions_ = options; }
+
+    // 设置 IO 线程配置，须在 init 之前调用
+    void setIoThreadConfig(const IoThreadConfig& config) { ioThreadConfig_ = config; }
+    const IoThreadConfig& getIoThreadConfig() const { return ioThreadConfig_; }
+
     // 获取全局RPC客户端
     std::shared_ptr<RosRpcClient> getRpcClient() const { return rpcClient_; }
 
+    /**
+     * @brief 选择节点间 TCP 数据面的 IO 后端，须在 init 之前调用
+     *
+     * 默认 MUDUO；也可通过环境变量 SIMPLE_ROS_IO_BACKEND=io_uring 选择。
+     * IO_URING 不可用（未启用 ENABLE_IO_URING 或内核不支持）时自动回退到 MUDUO。
+     */
+    void setIoBackend(IoBackend backend) { ioBackend_ = backend; }
+
+    /**
+     * @brief 使用仿真时间，须在 init 之前调用
+     *
+     * 启用后 init 会将 Clock 切换到仿真模式并订阅 /clock，定时器、Rate 与时间戳随之推进。
+     * 也可通过环境变量 SIMPLE_ROS_USE_SIM_TIME=1 启用。
+     * 自己驱动仿真时间的节点直接使用 Clock::enableSimTime/setSimTime，无需调用本方法。
+     */
+    void setUseSimTime(bool use) { useSimTime_ = use; }
+    bool useSimTime() const { return useSimTime_; }
+
+    /**
+     * @brief 设置实时调优配置，须在 init 之前调用
+     *
+     * init 时锁定内存，并在事件线程、接收线程、定时器线程、io_uring 线程启动时以及
+     * spin 开始时按角色应用 CPU 亲和性与调度策略。
+     * 也可通过环境变量 SIMPLE_ROS_RT_PROFILE 指定 JSON 配置文件。
+     */
+    void setRealtimeProfile(const RealtimeProfile& profile) { rtProfile_ = profile; }
+    const RealtimeProfile& getRealtimeProfile() const { return rtProfile_; }
+
+    // io_uring 后端，未启用时为空
+    std::shared_ptr<IoUringBackend> getIoUringBackend() const { return ioUring_; }
+
     NodeInfo getNodeInfo() const { return nodeInfo_; }
 
+    // 最近一次 init 的各阶段耗时
+    const StartupTimings& getStartupTimings() const { return startupTimings_; }
+
     // 禁止拷贝
     SystemManager(const SystemManager&) = delete;
     SystemManager& operator=(const SystemManager&) = delete;
@@ -51,13 +148,28 @@ private:
     SystemManager();
     ~SystemManager();
 
-    int findAvailablePort(int start_port = 60000, int end_port = 61000);
+    // 由内核分配 TCP 端口（同号 UDP 端口也须空闲），*reserved_fd 保持绑定直到监听就绪；失败返回 -1
+    int reservePort(int* reserved_fd);
 
     std::shared_ptr<MessageQueue> messageQueue_;
     std::shared_ptr<PollManager> pollManager_;
     std::shared_ptr<muduo::net::EventLoop> eventLoop_;
     std::shared_ptr<RosRpcClient> rpcClient_;  // 全局RPC客户端
+    IoBackend ioBackend_ = IoBackend::MUDUO;
+    std::shared_ptr<IoUringBackend> ioUring_;
     std::thread eventThread_;
+    IoThreadConfig ioThreadConfig_;
+    std::unique_ptr<muduo::net::EventLoopThread> timerThread_; // 定时器与发布者连接线程
+    muduo::net::EventLoop* timerLoop_ = nullptr;
+    std::mutex deadlineCheckMutex_;
+    muduo::net::TimerId deadlineCheckTimer_;
+    double deadlineCheckPeriod_ = 0.0;  // 当前检查周期，0 表示未启用
+    std::mutex timingWheelMutex_;
+    std::shared_ptr<TimingWheel> timingWheel_;
+    TimingWheelOptions timingWheelOptions_;
+    RealtimeProfile rtProfile_;
     NodeInfo nodeInfo_;  // 节点信息
-    bool running_ = true;
+    StartupTimings startupTimings_;
+    bool useSimTime_ = false;
+    std::atomic<bool> running_{true};  // shutdown 与 spin 线程并发读写
 };
@@ -0,0 +1,73 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+
+// ================= 可选 io_uring 数据面 =================
+// 编译选项 ENABLE_IO_URING（默认关闭）启用后，PollManager 的 TCP 接收与
+// Publisher 的 TCP 发送可以切换到 io_uring：
+//   - 接收：multishot accept + multishot recv，数据落在内核直接挑选的 provided buffer ring 中；
+//   - 发送：同一连接排队的帧合并为一次提交，优先拷入预注册的固定缓冲区（write_fixed）；
+//   - 所有 SQE 在一次 io_uring_submit_and_wait 中批量提交。
+// 未启用编译选项或内核不支持时 available() 返回 false，系统继续使用 muduo epoll。
+
+enum class IoBackend {
+    MUDUO,     // 默认：muduo epoll
+    IO_URING   // 需要 ENABLE_IO_URING 且内核 >= 6.0
+};
+
+struct IoUringOptions {
+    unsigned queue_depth = 512;          // SQ/CQ 深度
+    unsigned recv_buffer_count = 512;    // provided buffer 数量（2 的幂）
+    unsigned recv_buffer_size = 16 * 1024;
+    unsigned send_slab_count = 64;       // 注册的固定发送缓冲区数量
+    unsigned send_slab_size = 64 * 1024;
+};
+
+class IoUringBackend {
+public:
+    using FrameCallback = std::function<void(const std::string& topic,
+                                             const std::string& msg_name,
+                                             const std::string& data)>;
+
+    struct Stats {
+        uint64_t submit_calls = 0;  // io_uring_enter 次数
+        uint64_t sqes = 0;          // 提交的 SQE 数
+        uint64_t cqes = 0;          // 处理的 CQE 数
+        uint64_t bytes_in = 0;
+        uint64_t bytes_out = 0;
+        uint64_t frames_in = 0;
+    };
+
+    // 编译时启用且当前内核支持：实际注册 provided buffer ring 并提交一次 multishot recv 探测
+    static bool available();
+
+    explicit IoUringBackend(const IoUringOptions& options = IoUringOptions());
+    ~IoUringBackend();
+
+    // 接收路径：监听 TCP 端口，完整帧通过回调交付（在 io_uring 线程中调用）
+    bool listen(const std::string& ip, uint16_t port);
+    void setFrameCallback(FrameCallback cb);
+
+    // 发送路径：在 io_uring 线程中异步建立连接，立即返回连接 ID，参数无效时返回 -1。
+    // 连接建立前 send 的帧排队，建立后依次发出
+    int64_t connect(const std::string& ip, uint16_t port);
+    // 线程安全，帧进入队列后由 io_uring 线程批量发送；连接已失败或关闭时返回 false，调用方应丢弃该 ID
+    bool send(int64_t conn_id, std::string frame);
+    bool isConnected(int64_t conn_id) const;
+    void close(int64_t conn_id);
+
+    // io_uring 线程启动时在该线程中调用，须在 start 之前设置
+    void setThreadInitCallback(std::function<void()> cb);
+
+    // 构造时初始化失败（如内核缺少某项能力）返回 false，调用方应回退到 muduo
+    bool start();
+    void stop();
+
+    Stats stats() const;
+
+private:
+    class Impl;
+    std::unique_ptr<Impl> impl_;
+};
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <google/protobuf/descriptor.h>
+#include <google/protobuf/message.h>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace simple_ros {
+
+/**
+ * @brief 按消息类型预编译的 protobuf → JSON 编码器
+ *
+ * 每个消息类型第一次编码时遍历一次 descriptor，生成编码计划（转义好的字段键、字段类别、
+ * 嵌套类型的计划指针），之后按计划直接读取字段并追加到调用方复用的缓冲区，
+ * 数字用 std::to_chars 格式化。输出与 util::MessageToJsonString 语义一致：
+ * 64 位整数为字符串、枚举为名称、bytes 为 base64、NaN/Infinity 为字符串；
+ * google.protobuf 下的 well-known 类型交给 MessageToJsonString 处理。
+ * 编码计划在多线程间共享，encode 可并发调用。
+ */
+class JsonEncoder {
+public:
+    struct Options {
+        bool always_print_primitive_fields = false;  // 输出未设置的标量与空的 repeated/map 字段
+        bool preserve_proto_field_names = false;     // 使用 .proto 中的字段名，否则使用 lowerCamelCase
+        std::unordered_set<std::string> skip_fields; // 不输出的字段全名，如 "visualization_msgs.Marker.points"
+    };
+
+    JsonEncoder();
+    explicit JsonEncoder(Options options);
+    ~JsonEncoder();
+
+    JsonEncoder(const JsonEncoder&) = delete;
+    JsonEncoder& operator=(const JsonEncoder&) = delete;
+
+    // 将 msg 编码后追加到 out 末尾
+    void encode(const google::protobuf::Message& msg, std::string* out) const;
+    std::string encode(const google::protobuf::Message& msg) const;
+
+    const Options& options() const { return options_; }
+
+    // 已生成编码计划的类型数
+    size_t planCount() const;
+
+private:
+    struct MessagePlan;
+    struct FieldPlan;
+
+    const MessagePlan* plan(const google::protobuf::Descriptor* descriptor) const;
+    const MessagePlan* buildLocked(const google::protobuf::Descriptor* descriptor) const;
+
+    void encodeMessage(const MessagePlan& plan, const google::protobuf::Message& msg, std::string* out) const;
+    void encodeValue(const FieldPlan& field, const google::protobuf::Message& msg, int index,
+                     std::string* out) const;
+    void encodeMap(const FieldPlan& field, const google::protobuf::Message& msg, std::string* out) const;
+
+    Options options_;
+    mutable std::shared_mutex mutex_;
+    mutable std::unordered_map<const google::protobuf::Descriptor*, std::unique_ptr<MessagePlan>> plans_;
+};
+
+} // namespace simple_ros
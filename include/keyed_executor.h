@@ -0,0 +1,104 @@
+// keyed_executor.h
+// 按 key 分片的线程池：同一 key 的任务按提交顺序串行执行，不同 key 的任务并行执行
+
+#ifndef simple_ros_KEYED_EXECUTOR_H
+#define simple_ros_KEYED_EXECUTOR_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace simple_ros {
+
+/**
+ * @brief 按 key 分片的工作线程池
+ *
+ * key 的哈希决定任务所在的工作线程，每个线程一个 FIFO 队列，因此同一 key 的任务
+ * 始终按提交顺序执行，无需额外加锁；不同 key 分散到各线程并行处理。
+ * 单个 key 排队的任务达到上限时丢弃该 key 最早的任务，提交方不会被阻塞，
+ * 同一线程上的其他 key 不受影响；用 submitPinned 提交的任务不会被丢弃，丢弃时跳过它们。
+ * 任务抛出的异常被捕获并计入 failedCount，不会终止工作线程。
+ */
+class KeyedExecutor {
+public:
+    using Task = std::function<void()>;
+
+    /**
+     * @param threads 工作线程数，0 按 1 处理
+     * @param queue_limit 每个 key 最多排队的任务数，0 表示不限
+     */
+    explicit KeyedExecutor(size_t threads, size_t queue_limit = 1024);
+    ~KeyedExecutor();
+
+    KeyedExecutor(const KeyedExecutor&) = delete;
+    KeyedExecutor& operator=(const KeyedExecutor&) = delete;
+
+    /**
+     * @brief 提交任务；该 key 的队列已满、丢弃了任务时返回 false
+     * @param on_drop 可选，该任务因队列已满被丢弃时在提交方线程中调用（stop 时未执行的任务不调用）
+     */
+    bool submit(const std::string& key, Task task, Task on_drop = nullptr);
+
+    /**
+     * @brief 提交不可丢弃的任务（执行结果依赖此前任务、丢失后无法恢复的状态更新）
+     *
+     * 队列已满时改为丢弃该 key 最早的可丢弃任务；该 key 排队的全是不可丢弃的任务时超出上限排队，
+     * 排队数每达到上限的 2、4、8…… 倍输出一次警告。返回值与 submit 相同。
+     */
+    bool submitPinned(const std::string& key, Task task);
+
+    // 停止并回收线程，正在执行的任务完成后返回，未执行的任务被丢弃
+    void stop();
+
+    size_t threadCount() const { return workers_.size(); }
+    size_t pending() const;                  // 所有线程排队中的任务数
+    uint64_t executedCount() const { return executed_.load(std::memory_order_relaxed); }
+    uint64_t droppedCount() const { return dropped_.load(std::memory_order_relaxed); }
+    uint64_t failedCount() const { return failed_.load(std::memory_order_relaxed); }   // 抛出异常的任务
+    double busySeconds() const;              // 所有线程执行任务的累计耗时
+
+private:
+    struct Entry {
+        std::string key;
+        Task task;
+        Task on_drop;
+        bool pinned = false;
+    };
+
+    // 单个 key 在某个线程队列中的排队情况
+    struct KeyState {
+        size_t queued = 0;
+        size_t warn_at = 0;   // 不可丢弃的任务超出上限时，下一次输出警告的排队数
+    };
+
+    struct Worker {
+        std::mutex mutex;
+        std::condition_variable cv;
+        std::deque<Entry> tasks;
+        std::unordered_map<std::string, KeyState> keys;
+        std::thread thread;
+    };
+
+    bool enqueue(const std::string& key, Entry entry);
+    void run(Worker& worker);
+
+    size_t queue_limit_;
+    std::vector<std::unique_ptr<Worker>> workers_;
+    std::atomic<bool> running_{true};
+    std::atomic<uint64_t> executed_{0};
+    std::atomic<uint64_t> dropped_{0};
+    std::atomic<uint64_t> failed_{0};
+    std::atomic<uint64_t> busy_ns_{0};
+};
+
+} // namespace simple_ros
+
+#endif // simple_ros_KEYED_EXECUTOR_H
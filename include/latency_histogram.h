@@ -0,0 +1,55 @@
+// latency_histogram.h
+// 对数分桶的延迟直方图，用于定时器抖动、转换耗时等统计
+
+#ifndef simple_ros_LATENCY_HISTOGRAM_H
+#define simple_ros_LATENCY_HISTOGRAM_H
+
+#include <array>
+#include <cstdint>
+#include <string>
+
+namespace simple_ros {
+
+/**
+ * @brief 以微秒为单位的延迟直方图
+ *
+ * 第 i 个桶统计 [2^(i-1), 2^i) 微秒的样本（第 0 个桶为 < 1us），
+ * 记录为 O(1) 且无内存分配，适合在回调热路径中使用。非线程安全。
+ */
+class LatencyHistogram {
+public:
+    static constexpr size_t kBucketCount = 32;
+
+    void record(double seconds);
+    void reset();
+
+    uint64_t count() const { return count_; }
+    double min() const { return count_ ? min_ : 0.0; }   // 秒
+    double max() const { return max_; }                  // 秒
+    double mean() const { return count_ ? sum_ / count_ : 0.0; }
+
+    /**
+     * @brief 估算分位数（返回所在桶的上界，单位秒）
+     * @param p 分位，取值 [0, 1]
+     */
+    double percentile(double p) const;
+
+    const std::array<uint64_t, kBucketCount>& buckets() const { return buckets_; }
+
+    // 桶 i 的上界（秒）
+    static double bucketUpperBound(size_t i);
+
+    // 形如 "n=1000 mean=12.3us p50=16us p99=64us max=80.1us"
+    std::string summary() const;
+
+private:
+    std::array<uint64_t, kBucketCount> buckets_{};
+    uint64_t count_ = 0;
+    double sum_ = 0.0;
+    double min_ = 0.0;
+    double max_ = 0.0;
+};
+
+} // namespace simple_ros
+
+#endif // simple_ros_LATENCY_HISTOGRAM_H
@@ -0,0 +1,59 @@
+// marker_delta.h
+// MarkerArray 增量跟踪：按 ns_id 缓存已发送的 Marker，只报告变化的部分
+
+#ifndef simple_ros_MARKER_DELTA_H
+#define simple_ros_MARKER_DELTA_H
+
+#include <chrono>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "marker.pb.h"
+
+namespace simple_ros {
+
+// 一条 MarkerArray 相对已发送状态的变化
+struct MarkerDelta {
+    bool delete_all = false;                                // 先删除全部实体（DELETEALL）
+    std::vector<std::string> deleted;                       // 需删除的实体 ID
+    std::vector<const visualization_msgs::Marker*> changed; // 新增或内容变化的 Marker，指向输入消息
+
+    bool empty() const { return !delete_all && deleted.empty() && changed.empty(); }
+};
+
+/**
+ * @brief 单个话题的 Marker 缓存
+ *
+ * 以 "ns_id" 为键保存每个 Marker 的内容指纹（序列化结果，不含 header.stamp），
+ * 内容未变的 Marker 不再发送。lifetime > 0 的 Marker 在生命周期过半时即使未变化也重新发送，
+ * 避免客户端中的实体过期消失。按 Marker 顺序处理 DELETE/DELETEALL，与 rviz 语义一致。
+ * 非线程安全，由处理该话题的线程独占使用。
+ */
+class MarkerDeltaTracker {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    MarkerDelta apply(const visualization_msgs::MarkerArray& array, Clock::time_point now);
+
+    // 实体 ID：ns + "_" + id
+    static std::string entityId(const visualization_msgs::Marker& marker);
+
+    size_t size() const { return entries_.size(); }
+    void clear() { entries_.clear(); }
+
+private:
+    struct Entry {
+        std::string fingerprint;
+        Clock::time_point sent;
+        double lifetime = 0.0;
+    };
+
+    void fingerprint(const visualization_msgs::Marker& marker, std::string* out);
+
+    std::unordered_map<std::string, Entry> entries_;
+    visualization_msgs::Marker scratch_;  // 去掉 header.stamp 的副本，复用内存
+};
+
+} // namespace simple_ros
+
+#endif // simple_ros_MARKER_DELTA_H
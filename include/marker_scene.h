@@ -0,0 +1,37 @@
+// marker_scene.h
+// Marker → Foxglove SceneEntity 图元转换，覆盖 visualization_msgs::MarkerType 的全部类型
+
+#ifndef simple_ros_MARKER_SCENE_H
+#define simple_ros_MARKER_SCENE_H
+
+#include <vector>
+#include <foxglove/schemas.hpp>
+#include "marker.pb.h"
+
+namespace simple_ros {
+
+/**
+ * @brief 把 Marker 的几何内容追加为 entity 的图元
+ *
+ * 只填写图元，不设置实体的 id、时间戳、坐标系与生命周期。各类型的对应关系：
+ * CUBE/SPHERE/CYLINDER → 同名图元；ARROW → ArrowPrimitive（有两个点时按起止点，否则按 pose 与 scale）；
+ * LINE_STRIP → LinePrimitive（points 位于 Marker 的 pose 坐标系中）；
+ * POINTS → 每个点一个球体，点坐标批量变换到实体坐标系；TEXT_VIEW_FACING → 始终朝向相机的 TextPrimitive；
+ * MESH_RESOURCE → ModelPrimitive。colors 与 points 数量相同时按点着色，否则使用 color。
+ * 未设置的姿态（四元数全为 0）按单位四元数处理。
+ * @return 类型未知时返回 false，entity 不变
+ */
+bool appendMarkerPrimitives(const visualization_msgs::Marker& marker, foxglove::schemas::SceneEntity* entity);
+
+// Marker 姿态，四元数为 0 或非单位时归一化
+foxglove::schemas::Pose toScenePose(const geometry_msgs::Pose& pose);
+
+// 批量转换点与颜色：一次分配目标数组，逐元素直接写入
+void convertPoints(const google::protobuf::RepeatedPtrField<geometry_msgs::Point>& points,
+                   std::vector<foxglove::schemas::Point3>* out);
+void convertColors(const google::protobuf::RepeatedPtrField<visualization_msgs::ColorRGBA>& colors,
+                   std::vector<foxglove::schemas::Color>* out);
+
+} // namespace simple_ros
+
+#endif // simple_ros_MARKER_SCENE_H
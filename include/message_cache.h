@@ -0,0 +1,84 @@
+// message_cache.h
+// 带全局字节预算的最后一条消息缓存，用于向新加入的客户端补发
+
+#ifndef simple_ros_MESSAGE_CACHE_H
+#define simple_ros_MESSAGE_CACHE_H
+
+#include <atomic>
+#include <cstddef>
+#include <string>
+
+namespace simple_ros {
+
+/**
+ * @brief 多个缓存共享的字节预算
+ *
+ * 各缓存在写入前申请字节数，超出上限的申请失败，由调用方放弃缓存。线程安全。
+ */
+class CacheBudget {
+public:
+    explicit CacheBudget(size_t max_bytes = 0) : max_bytes_(max_bytes) {}
+
+    CacheBudget(const CacheBudget&) = delete;
+    CacheBudget& operator=(const CacheBudget&) = delete;
+
+    bool tryReserve(size_t bytes);
+    void release(size_t bytes);
+
+    // 修改上限只影响之后的申请，已占用的字节在缓存更新或释放时归还
+    void setMaxBytes(size_t max_bytes) { max_bytes_.store(max_bytes, std::memory_order_relaxed); }
+    size_t maxBytes() const { return max_bytes_.load(std::memory_order_relaxed); }
+    size_t usedBytes() const { return used_bytes_.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<size_t> max_bytes_;
+    std::atomic<size_t> used_bytes_{0};
+};
+
+/**
+ * @brief 从 CacheBudget 中占用的一段字节，析构时归还
+ *
+ * 非线程安全，由持有它的缓存所在线程使用。
+ */
+class CacheReservation {
+public:
+    explicit CacheReservation(CacheBudget* budget) : budget_(budget) {}
+    ~CacheReservation() { resize(0); }
+
+    CacheReservation(const CacheReservation&) = delete;
+    CacheReservation& operator=(const CacheReservation&) = delete;
+
+    // 调整占用的字节数；增加部分超出预算时不做修改并返回 false
+    bool resize(size_t bytes);
+    size_t bytes() const { return bytes_; }
+
+private:
+    CacheBudget* budget_;
+    size_t bytes_ = 0;
+};
+
+/**
+ * @brief 单个 channel 的最后一条已编码消息
+ *
+ * store 复用已有缓冲区的容量；预算不足时清空缓存，新客户端收不到补发，
+ * 但不会影响正常转发。非线程安全，只由该 channel 所在的转换线程使用。
+ */
+class LastMessageSlot {
+public:
+    explicit LastMessageSlot(CacheBudget* budget) : reservation_(budget) {}
+
+    bool store(const void* data, size_t size);
+    void clear();
+
+    bool empty() const { return !valid_; }
+    const std::string& data() const { return data_; }
+
+private:
+    CacheReservation reservation_;
+    std::string data_;
+    bool valid_ = false;
+};
+
+} // namespace simple_ros
+
+#endif // simple_ros_MESSAGE_CACHE_H
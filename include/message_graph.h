@@ -7,6 +7,7 @@
 #include <mutex>
 #include <grpcpp/grpcpp.h>
 #include "ros_rpc.grpc.pb.h"
+#include "qos.h"
 namespace simple_ros
 {
 
@@ -57,6 +58,9 @@ namespace simple_ros
         // 该节点发布/订阅的 (topic,msg)
         std::unordered_set<TopicKey, TopicKeyHash> publishes;
         std::unordered_set<TopicKey, TopicKeyHash> subscribes;
+        // 每个发布/订阅关系的 QoS
+        std::unordered_map<TopicKey, QoSProfile, TopicKeyHash> publish_qos;
+        std::unordered_map<TopicKey, QoSProfile, TopicKeyHash> subscribe_qos;
     };
 
     class MessageGraph
@@ -65,9 +69,9 @@ namespace simple_ros
         // 新增或更新节点信息
         void UpsertNode(const NodeInfo &info);
 
-        // 维护 topic/msg 到 发布者/订阅者 的索引，并即时建边
-        void AddPublisher(const NodeInfo &node, const TopicKey &k);
-        void AddSubscriber(const NodeInfo &node, const TopicKey &k);
+        // 维护 topic/msg 到 发布者/订阅者 的索引，并即时建边（仅在 QoS 兼容时建边）
+        void AddPublisher(const NodeInfo &node, const TopicKey &k, const QoSProfile &qos = QoSProfile());
+        void AddSubscriber(const NodeInfo &node, const TopicKey &k, const QoSProfile &qos = QoSProfile());
 
         // 删除发布/订阅关系，并相应删边；必要时清理孤立点
         void RemovePublisher(const NodeInfo &node, const TopicKey &k);
@@ -76,6 +80,14 @@ namespace simple_ros
         std::vector<NodeInfo> GetSubscribersByTopic(const std::string &topic) const;
         std::vector<NodeInfo> GetPublishersByTopic(const std::string &topic) const;
 
+        // 与指定发布者/订阅者 QoS 兼容的对端（即图中存在边的对端）
+        std::vector<NodeInfo> GetCompatibleSubscribers(const std::string &pub_node, const TopicKey &k) const;
+        std::vector<NodeInfo> GetCompatiblePublishers(const std::string &sub_node, const TopicKey &k) const;
+
+        // 查询节点在某话题上登记的 QoS，不存在时返回 false
+        bool GetPublisherQoS(const std::string &node_name, const TopicKey &k, QoSProfile *qos) const;
+        bool GetSubscriberQoS(const std::string &node_name, const TopicKey &k, QoSProfile *qos) const;
+
         // 通过节点名获取节点信息
         bool GetNodeByName(const std::string &node_name, NodeInfo *node_info) const
         {
@@ -1,20 +1,34 @@
 #pragma once
+#include <algorithm>
 #include <functional>
 #include <unordered_map>
+#include <unordered_set>
+#include <list>
+#include <vector>
 #include <queue>
+#include <deque>
 #include <mutex>
+#include <condition_variable>
 #include <string>
+#include <atomic>
+#include <chrono>
 #include <google/protobuf/message.h>
 #include <muduo/base/Logging.h>
+#include "callback_group.h"
 
 
 class MessageQueue {
 public:
     using Callback = std::function<void(const std::shared_ptr<google::protobuf::Message>&)>;
+    using Task = std::function<void()>;
 
     // 构造函数，可以设置默认队列大小
     MessageQueue(uint32_t default_max_queue_size = 1000) 
-        : default_max_queue_size_(default_max_queue_size) {}
+        : default_max_queue_size_(default_max_queue_size),
+          default_group_(std::make_shared<simple_ros::CallbackGroup>()) {}
+
+    // 未指定回调组的订阅与任务使用的互斥组
+    const simple_ros::CallbackGroupPtr& defaultCallbackGroup() const { return default_group_; }
 
     // 设置主题的最大队列大小
     void setTopicMaxQueueSize(const std::string& topic, uint32_t max_size) {
@@ -22,21 +36,168 @@ public:
         topic_max_queue_sizes_[topic] = max_size;
     }
 
-    // 添加订阅者
-    void addSubscriber(const std::string& topic, Callback cb) {
+    // 设置主题的消息有效期和期望最大间隔（秒），0 表示不限制
+    void setTopicTiming(const std::string& topic, double lifespan, double deadline) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto& timing = topic_timings_[topic];
+        timing.lifespan = lifespan;
+        timing.deadline = deadline;
+    }
+
+    // 获取主题错过 deadline 的次数
+    uint64_t getDeadlineMissedCount(const std::string& topic) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = topic_timings_.find(topic);
+        return it == topic_timings_.end() ? 0 : it->second.deadline_missed;
+    }
+
+    // 所有主题中最小的 deadline（秒），没有设置 deadline 的主题时为 0
+    double minDeadline() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        double result = 0.0;
+        for (const auto& entry : topic_timings_) {
+            double deadline = entry.second.deadline;
+            if (deadline > 0 && (result == 0.0 || deadline < result)) result = deadline;
+        }
+        return result;
+    }
+
+    /**
+     * @brief 检查所有设置了 deadline 的主题，收到首条消息后每个 deadline 周期内没有新消息记一次错过
+     *
+     * 由定时器周期调用（见 SystemManager::updateDeadlineCheck），发布者停止发布时也能及时发现。
+     */
+    void checkDeadlines() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto now = Clock::now();
+        for (auto& entry : topic_timings_) {
+            if (entry.second.deadline > 0) checkDeadlineLocked(entry.first, entry.second, now);
+        }
+    }
+
+    /**
+     * @brief 添加订阅者，group 为空时使用默认组
+     *
+     * 同一主题的多个订阅者可以属于不同的组（如同进程的多个组件），
+     * 消息只在所有相关组都空闲时分发。
+     * @return 订阅者 id，用于 removeSubscriber(topic, id)
+     */
+    uint64_t addSubscriber(const std::string& topic, Callback cb,
+                           simple_ros::CallbackGroupPtr group = nullptr) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        uint64_t id = next_subscriber_id_++;
+        subscribers_[topic].push_back({id, std::move(cb), group ? std::move(group) : default_group_});
+        last_subscriber_id_.store(id, std::memory_order_release);
+        return id;
+    }
+
+    // 最近添加的订阅者 id（单调递增），不加锁；发布者据此发现新加入的本进程订阅者
+    uint64_t lastSubscriberId() const { return last_subscriber_id_.load(std::memory_order_acquire); }
+
+    // 主题中 id 大于 after 的订阅者
+    std::vector<uint64_t> subscribersAfter(const std::string& topic, uint64_t after) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::vector<uint64_t> ids;
+        auto it = subscribers_.find(topic);
+        if (it == subscribers_.end()) return ids;
+        for (const auto& sub : it->second) {
+            if (sub.id > after) ids.push_back(sub.id);
+        }
+        return ids;
+    }
+
+    /**
+     * @brief 只投递给一个订阅者，如向新加入的订阅者补发锁存消息，其他订阅者不会重复收到
+     *
+     * 作为任务在该订阅者的回调组中执行；订阅者已移除时忽略。
+     */
+    void pushToSubscriber(const std::string& topic, uint64_t id, std::shared_ptr<google::protobuf::Message> msg) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto it = subscribers_.find(topic);
+            if (it == subscribers_.end()) return;
+            auto sub = std::find_if(it->second.begin(), it->second.end(),
+                                    [id](const SubscriberEntry& entry) { return entry.id == id; });
+            if (sub == it->second.end()) return;
+            Callback cb = sub->cb;
+            tasks_.push_back({[cb, msg]() { cb(msg); }, sub->group});
+        }
+        cond_.notify_one();
+    }
+
+    // 主题是否有本进程内的订阅者
+    bool hasSubscribers(const std::string& topic) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = subscribers_.find(topic);
+        return it != subscribers_.end() && !it->second.empty();
+    }
+
+    /**
+     * @brief 设置主题的直接处理函数：消息到达时在接收线程中立即调用，不进入队列
+     *
+     * 用于 /clock 等不能等待 spin 的系统话题，处理函数须足够轻量。
+     */
+    void setInlineHandler(const std::string& topic, Callback cb) {
         std::lock_guard<std::mutex> lock(mutex_);
-        subscribers_[topic].push_back(std::move(cb));
+        inline_handlers_[topic] = std::move(cb);
+    }
+
+    /**
+     * @brief 主题的消息不在接收端反序列化，而是以 simple_ros::SerializedMessage 原样交给订阅者
+     *
+     * 用于只转发字节的订阅者（如 Foxglove 桥接）；同进程发布者投递的消息仍是原对象。
+     */
+    void setSerializedDelivery(const std::string& topic, bool on) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (on) {
+            serialized_topics_.insert(topic);
+        } else {
+            serialized_topics_.erase(topic);
+        }
+        serialized_topic_count_.store(serialized_topics_.size(), std::memory_order_relaxed);
+    }
+
+    bool serializedDelivery(const std::string& topic) {
+        // 没有任何此类主题时不加锁
+        if (serialized_topic_count_.load(std::memory_order_relaxed) == 0) return false;
+        std::lock_guard<std::mutex> lock(mutex_);
+        return serialized_topics_.count(topic) > 0;
+    }
+
+    // 投递一个任务（如定时器回调），由 spin 线程按回调组约束执行
+    void pushTask(Task task, simple_ros::CallbackGroupPtr group = nullptr) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            tasks_.push_back({std::move(task), group ? std::move(group) : default_group_});
+        }
+        cond_.notify_one();
+    }
+
+    // 等待新的消息/任务或回调组释放，最多等待 timeout
+    void waitForWork(std::chrono::milliseconds timeout) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cond_.wait_for(lock, timeout);
+    }
+
+    // 移除单个订阅者，主题的最后一个订阅者移除时一并清理该主题
+    void removeSubscriber(const std::string& topic, uint64_t id) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = subscribers_.find(topic);
+        if (it == subscribers_.end()) return;
+        auto& subs = it->second;
+        for (auto sub_it = subs.begin(); sub_it != subs.end(); ++sub_it) {
+            if (sub_it->id == id) {
+                subs.erase(sub_it);
+                break;
+            }
+        }
+        if (subs.empty()) removeTopicLocked(topic);
     }
 
-    // 移除订阅者
-// 移除整个 topic 的所有订阅者
+    // 移除整个 topic 的所有订阅者
     void removeSubscriber(const std::string& topic) {
         std::lock_guard<std::mutex> lock(mutex_);
-        subscribers_.erase(topic);
-        message_queues_.erase(topic);
-        topic_max_queue_sizes_.erase(topic);
-        registered_topics_.erase(topic);
-        LOG_INFO << "Removed topic and all its subscribers: " << topic;
+        removeTopicLocked(topic);
     }
 
 
@@ -50,7 +211,14 @@ public:
     }
 
     void push(const std::string& topic, std::shared_ptr<google::protobuf::Message> msg) {
-        std::lock_guard<std::mutex> lock(mutex_);
+        std::unique_lock<std::mutex> lock(mutex_);
+        auto inline_it = inline_handlers_.find(topic);
+        if (inline_it != inline_handlers_.end()) {
+            Callback handler = inline_it->second;
+            lock.unlock();
+            handler(msg);
+            return;
+        }
         if (registered_topics_.find(topic) == registered_topics_.end()) {
             LOG_WARN << "Received message for unregistered topic: " << topic;
             return;
@@ -60,50 +228,196 @@ public:
         auto it = topic_max_queue_sizes_.find(topic);
         uint32_t max_size = (it != topic_max_queue_sizes_.end()) ? it->second : default_max_queue_size_;
 
+        auto now = Clock::now();
+        auto timing_it = topic_timings_.find(topic);
+        if (timing_it != topic_timings_.end() && timing_it->second.deadline > 0) {
+            auto& timing = timing_it->second;
+            // checkDeadlines 尚未记录的最后一段超时在此补记
+            checkDeadlineLocked(topic, timing, now);
+            timing.window_start = now;
+        }
+
         // 队列已满，移除最早的消息
-        if (message_queues_[topic].size() >= max_size) {
-            message_queues_[topic].pop_front();
+        auto& queue = message_queues_[topic];
+        while (!queue.empty() && queue.size() >= max_size) {
+            queue.pop_front();
         }
 
         // 添加新消息到队列
-        message_queues_[topic].push_back(msg);
+        queue.push_back({std::move(msg), now});
+        lock.unlock();
+        cond_.notify_one();
     }
 
-    void processCallbacks() {
-        std::lock_guard<std::mutex> lock(mutex_);
+    /**
+     * @brief 每次只处理一条消息或一个任务，返回是否执行了回调
+     *
+     * 回调在锁外执行，接收线程 push 不会被用户回调阻塞。可由多个 spin 线程并发调用：
+     * 所属回调组被占用的消息/任务会被跳过，留给组释放后的下一次调用。
+     */
+    bool processCallbacks() {
+        std::shared_ptr<google::protobuf::Message> msg;
+        std::vector<Callback> callbacks;
+        Task task;
+        std::vector<simple_ros::CallbackGroupPtr> groups;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
 
-        // 遍历所有主题的消息队列
-        for (auto& topic_entry : message_queues_) {
-            const std::string& topic = topic_entry.first;
-            auto& queue = topic_entry.second;
-
-            // 如果队列不为空
-            if (!queue.empty()) {
-                // 获取队首消息
-                auto msg = queue.front();
-                // 移除处理后的消息
-                queue.pop_front();
-
-                // 查找该主题的订阅者
-                auto sub_it = subscribers_.find(topic);
-                if (sub_it != subscribers_.end()) {
-                    // 通知所有订阅者处理消息
-                    for (const auto& callback : sub_it->second) {
-                        callback(msg);
+            // 定时器等任务优先，按投递顺序取第一个可执行的
+            for (auto it = tasks_.begin(); it != tasks_.end(); ++it) {
+                if (it->group->tryEnter()) {
+                    task = std::move(it->fn);
+                    groups.push_back(std::move(it->group));
+                    tasks_.erase(it);
+                    break;
+                }
+            }
+
+            // 遍历所有主题的消息队列
+            for (auto& topic_entry : message_queues_) {
+                if (!groups.empty()) break;
+                const std::string& topic = topic_entry.first;
+                auto& queue = topic_entry.second;
+
+                // 丢弃超过有效期的消息
+                auto timing_it = topic_timings_.find(topic);
+                if (timing_it != topic_timings_.end() && timing_it->second.lifespan > 0) {
+                    auto now = Clock::now();
+                    while (!queue.empty() &&
+                           std::chrono::duration<double>(now - queue.front().receive_time).count() >
+                               timing_it->second.lifespan) {
+                        queue.pop_front();
                     }
                 }
 
-                // 只处理一个消息就返回
-                return;
+                // 如果队列不为空且订阅者所属的回调组全部空闲
+                if (!queue.empty()) {
+                    auto sub_it = subscribers_.find(topic);
+                    if (sub_it == subscribers_.end() || sub_it->second.empty()) {
+                        queue.clear();
+                        continue;
+                    }
+                    if (!enterGroupsLocked(sub_it->second, &groups)) continue;
+
+                    // 获取队首消息并移除
+                    msg = std::move(queue.front().msg);
+                    queue.pop_front();
+
+                    // 拷贝该主题的订阅者，避免回调期间持锁
+                    callbacks.reserve(sub_it->second.size());
+                    for (const auto& sub : sub_it->second) {
+                        callbacks.push_back(sub.cb);
+                    }
+                }
+            }
+        }
+
+        if (groups.empty()) return false;
+
+        // 回调抛出异常时也要释放回调组，否则该组之后的消息/任务再也不会被执行
+        struct GroupRelease {
+            MessageQueue* queue;
+            const std::vector<simple_ros::CallbackGroupPtr>& groups;
+            ~GroupRelease() {
+                for (const auto& group : groups) {
+                    group->leave();
+                }
+                // 组释放后，其他等待中的 spin 线程可以处理被跳过的消息/任务
+                queue->cond_.notify_all();
             }
+        } release{this, groups};
+
+        if (task) {
+            task();
         }
+        // 通知所有订阅者处理消息
+        for (const auto& callback : callbacks) {
+            callback(msg);
+        }
+        return true;
     }
 
 private:
+    using Clock = std::chrono::steady_clock;
+
+    struct SubscriberEntry {
+        uint64_t id;
+        Callback cb;
+        simple_ros::CallbackGroupPtr group;
+    };
+
+    // 占用订阅者涉及的所有回调组，任一组被占用时回退已占用的组并返回 false（调用方持有 mutex_）
+    static bool enterGroupsLocked(const std::vector<SubscriberEntry>& subs,
+                                  std::vector<simple_ros::CallbackGroupPtr>* entered) {
+        for (const auto& sub : subs) {
+            bool seen = false;
+            for (const auto& group : *entered) {
+                if (group == sub.group) { seen = true; break; }
+            }
+            if (seen) continue;
+            if (!sub.group->tryEnter()) {
+                for (const auto& group : *entered) group->leave();
+                entered->clear();
+                return false;
+            }
+            entered->push_back(sub.group);
+        }
+        return true;
+    }
+
+    void removeTopicLocked(const std::string& topic) {
+        subscribers_.erase(topic);
+        message_queues_.erase(topic);
+        topic_max_queue_sizes_.erase(topic);
+        topic_timings_.erase(topic);
+        registered_topics_.erase(topic);
+        serialized_topics_.erase(topic);
+        serialized_topic_count_.store(serialized_topics_.size(), std::memory_order_relaxed);
+        LOG_INFO << "Removed topic and all its subscribers: " << topic;
+    }
+
+    struct QueuedMessage {
+        std::shared_ptr<google::protobuf::Message> msg;
+        Clock::time_point receive_time;   // 入队时间，用于 lifespan
+    };
+
+    struct QueuedTask {
+        Task fn;
+        simple_ros::CallbackGroupPtr group;
+    };
+
+    struct TopicTiming {
+        double lifespan = 0.0;
+        double deadline = 0.0;
+        Clock::time_point window_start;   // 当前 deadline 周期的起点：上一条消息或上一次记录错过的时刻
+        uint64_t deadline_missed = 0;
+    };
+
+    // 从 window_start 起每满一个 deadline 周期记一次错过，已记录的周期不再重复计数（调用方持有 mutex_）
+    static void checkDeadlineLocked(const std::string& topic, TopicTiming& timing, Clock::time_point now) {
+        if (timing.window_start == Clock::time_point()) return;
+        auto period = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(timing.deadline));
+        if (period <= Clock::duration::zero() || now - timing.window_start <= period) return;
+        auto missed = static_cast<uint64_t>((now - timing.window_start) / period);
+        timing.deadline_missed += missed;
+        timing.window_start += period * static_cast<int64_t>(missed);
+        LOG_WARN << "Deadline missed on topic " << topic
+                 << " (total " << timing.deadline_missed << ")";
+    }
+
     uint32_t default_max_queue_size_;                            // 默认队列大小
     std::unordered_set<std::string> registered_topics_;          // 已注册的主题
     std::unordered_map<std::string, uint32_t> topic_max_queue_sizes_; // 主题最大队列大小
-    std::unordered_map<std::string, std::list<std::shared_ptr<google::protobuf::Message>>> message_queues_; // 消息队列
-    std::unordered_map<std::string, std::vector<Callback>> subscribers_; // 订阅者
+    std::unordered_map<std::string, TopicTiming> topic_timings_;       // 主题 lifespan/deadline
+    std::unordered_map<std::string, std::list<QueuedMessage>> message_queues_; // 消息队列
+    std::unordered_map<std::string, std::vector<SubscriberEntry>> subscribers_; // 订阅者及其回调组
+    uint64_t next_subscriber_id_ = 1;
+    std::atomic<uint64_t> last_subscriber_id_{0};
+    std::unordered_map<std::string, Callback> inline_handlers_;  // 接收线程中直接处理的主题
+    std::unordered_set<std::string> serialized_topics_;          // 不反序列化、原样转交的主题
+    std::atomic<size_t> serialized_topic_count_{0};
+    std::deque<QueuedTask> tasks_;                               // 待执行的任务（定时器回调等）
+    simple_ros::CallbackGroupPtr default_group_;                 // 默认互斥组
     std::mutex mutex_; // 互斥锁
+    std::condition_variable cond_;
 };
\ No newline at end of file
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <google/protobuf/message.h>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+
+namespace simple_ros {
+
+/**
+ * @brief 单个话题的输出限速，周期内只保留最新一条未发送的消息（keep-latest）
+ *
+ * offer 判断一条消息能否立即发送；不能时它替换之前未发送的消息，被替换的消息直接丢弃，
+ * 不做任何转换。调用方定期调用 takeDue 取出到期的待发送消息，保证最后一条消息不会滞留。
+ * 非线程安全，由转发该话题的线程独占使用。
+ */
+class LatestMessageThrottle {
+public:
+    using Clock = std::chrono::steady_clock;
+    using MessagePtr = std::shared_ptr<google::protobuf::Message>;
+
+    // max_rate_hz <= 0 表示不限速
+    explicit LatestMessageThrottle(double max_rate_hz = 0.0);
+
+    void setMaxRate(double max_rate_hz);
+    double maxRate() const { return max_rate_hz_; }
+    bool limited() const { return period_ > Clock::duration::zero(); }
+
+    // 可以立即发送时返回 true；否则将 msg 存为待发送消息并返回 false
+    bool offer(MessagePtr msg, Clock::time_point now);
+
+    // 待发送消息已到期时取出，否则返回空
+    MessagePtr takeDue(Clock::time_point now);
+
+    // 丢弃待发送消息（取消订阅时）
+    void reset();
+
+    bool hasPending() const { return pending_ != nullptr; }
+    Clock::time_point nextDue() const { return next_due_; }
+    uint64_t droppedCount() const { return dropped_; }
+
+private:
+    double max_rate_hz_ = 0.0;
+    Clock::duration period_{};
+    Clock::time_point next_due_{};
+    MessagePtr pending_;
+    uint64_t dropped_ = 0;
+};
+
+} // namespace simple_ros
@@ -1,11 +1,91 @@
 #pragma once
 
+#include <google/protobuf/arena.h>
 #include <google/protobuf/message.h>
 #include <google/protobuf/descriptor.h>
 #include <google/protobuf/dynamic_message.h>
+#include <atomic>
 #include <memory>
+#include <mutex>
+#include <shared_mutex>
 #include <string>
 #include <unordered_map>
+#include <vector>
+
+// 接收路径上消息的内存分配方式
+enum class ArenaMode {
+    NONE,         // 每条消息及其嵌套字段逐个在堆上分配
+    PER_MESSAGE,  // 每条消息一个 Arena，随最后一个 shared_ptr 释放
+    PER_BATCH     // 一次读取中解出的所有帧共用一个 Arena，全部消息释放后才回收
+};
+
+/**
+ * @brief 一个 protobuf Arena 及其首块内存
+ *
+ * 消息的 shared_ptr 以别名构造持有 MessageArena，回调持有消息期间 Arena 一直有效；
+ * 嵌套消息、repeated 字段与字符串都从首块中顺序分配，整条消息只需一次 malloc。
+ */
+class MessageArena {
+public:
+    explicit MessageArena(size_t initial_block_size);
+
+    MessageArena(const MessageArena&) = delete;
+    MessageArena& operator=(const MessageArena&) = delete;
+
+    google::protobuf::Arena* get() { return &arena_; }
+    uint64_t spaceUsed() const { return arena_.SpaceUsed(); }
+
+    // 按序列化数据大小估算首块大小：反序列化后的对象通常比线上格式大
+    static size_t blockSizeFor(size_t payload_size);
+
+private:
+    static google::protobuf::ArenaOptions makeOptions(char* block, size_t size);
+
+    std::unique_ptr<char[]> block_;   // 须先于 arena_ 构造、后于 arena_ 析构
+    google::protobuf::Arena arena_;
+};
+
+using MessageArenaPtr = std::shared_ptr<MessageArena>;
+
+// 类型 ID：注册或首次解析类型名时分配，之后按 ID 直接索引，不再对类型名求哈希
+using MsgTypeId = uint32_t;
+constexpr MsgTypeId kInvalidMsgTypeId = 0;
+
+/**
+ * @brief 单个消息类型的对象池
+ *
+ * acquire 返回的 shared_ptr 在最后一个引用释放时 Clear() 消息并放回池中，
+ * Clear 保留 repeated 字段与字符串已分配的容量，稳定运行时接收路径不再重新分配。
+ * 池满时直接释放；池中对象保留历史上最大一条消息的容量。
+ */
+class MessagePool : public std::enable_shared_from_this<MessagePool> {
+public:
+    MessagePool(const google::protobuf::Message* prototype, size_t capacity);
+    ~MessagePool();
+
+    MessagePool(const MessagePool&) = delete;
+    MessagePool& operator=(const MessagePool&) = delete;
+
+    std::shared_ptr<google::protobuf::Message> acquire();
+
+    // 最多保留的空闲对象数，0 表示不回收
+    void setCapacity(size_t capacity);
+    size_t capacity() const { return capacity_.load(std::memory_order_relaxed); }
+    size_t idleCount() const;
+
+    uint64_t createdCount() const { return created_.load(std::memory_order_relaxed); }
+    uint64_t reusedCount() const { return reused_.load(std::memory_order_relaxed); }
+
+private:
+    void release(google::protobuf::Message* msg);
+
+    const google::protobuf::Message* prototype_;
+    std::atomic<size_t> capacity_;
+    std::atomic<uint64_t> created_{0};
+    std::atomic<uint64_t> reused_{0};
+    mutable std::mutex mutex_;
+    std::vector<google::protobuf::Message*> idle_;
+};
 
 class MsgFactory {
 public:
@@ -13,33 +93,115 @@ public:
     static MsgFactory& instance();
 
     // ------------------------------
-    // 注册消息类型（模板函数必须在头文件）
+    // 注册消息类型（模板函数必须在头文件），返回类型 ID
     // ------------------------------
     template<typename MsgType>
-    void registerMessage() {
-        factory_[MsgType::descriptor()->full_name()] = &MsgType::default_instance();
+    MsgTypeId registerMessage() {
+        return registerPrototype(MsgType::descriptor()->full_name(), &MsgType::default_instance());
     }
 
+    // ------------------------------
+    // 类型名 → 类型 ID，未注册时尝试通过 DescriptorPool 自动检测，未知类型返回 kInvalidMsgTypeId
+    // 需要对类型名求哈希，热路径应缓存结果（见 MsgTypeIdCache）
+    // ------------------------------
+    MsgTypeId typeId(const std::string& name);
+
+    // 类型 ID 对应的完整类型名，ID 无效时返回空字符串
+    const std::string& typeName(MsgTypeId id) const;
+
     // ------------------------------
     // 创建 unique_ptr<Message>
     // 如果未注册，尝试通过 DescriptorPool 自动检测
     // ------------------------------
     std::unique_ptr<google::protobuf::Message> createMessage(const std::string& name);
 
+    // ------------------------------
+    // 创建共享消息：arena 非空时在 arena 上创建，返回的 shared_ptr 同时持有 arena；
+    // 否则从类型的对象池获取（池容量为 0 时在堆上创建）
+    // ------------------------------
+    std::shared_ptr<google::protobuf::Message> createSharedMessage(MsgTypeId id, const MessageArenaPtr& arena);
+    std::shared_ptr<google::protobuf::Message> createSharedMessage(const std::string& name,
+                                                                   const MessageArenaPtr& arena);
+
+    // ------------------------------
+    // 在 arena 上构造具体类型的消息（发布者预先构造大消息时使用）
+    // ------------------------------
+    template<typename MsgType>
+    static std::shared_ptr<MsgType> createOnArena(const MessageArenaPtr& arena) {
+        MsgType* msg = google::protobuf::Arena::CreateMessage<MsgType>(arena->get());
+        return std::shared_ptr<MsgType>(arena, msg);
+    }
+
+    template<typename MsgType>
+    static std::shared_ptr<MsgType> createOnArena(size_t initial_block_size = 4096) {
+        return createOnArena<MsgType>(std::make_shared<MessageArena>(initial_block_size));
+    }
+
     // ------------------------------
     // 将 unique_ptr 转换为 shared_ptr
     // ------------------------------
     std::shared_ptr<google::protobuf::Message> makeSharedMessage(std::unique_ptr<google::protobuf::Message> msg);
 
+    // 接收路径的分配方式，默认 NONE；也可通过环境变量 SIMPLE_ROS_MSG_ARENA=message|batch 设置
+    void setArenaMode(ArenaMode mode) { arenaMode_.store(mode, std::memory_order_relaxed); }
+    ArenaMode arenaMode() const { return arenaMode_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief 设置每个类型对象池保留的空闲消息数（默认 16），0 表示不使用对象池
+     *
+     * 对已创建和之后创建的池都生效；也可通过环境变量 SIMPLE_ROS_MSG_POOL 设置。
+     */
+    void setPoolCapacity(size_t capacity);
+    size_t poolCapacity() const { return poolCapacity_.load(std::memory_order_relaxed); }
+
+    // 类型的对象池，ID 无效时返回空
+    std::shared_ptr<MessagePool> pool(MsgTypeId id) const;
+
+    static constexpr size_t kMaxTypes = 4096;
+
 private:
-    MsgFactory() = default;
+    MsgFactory();
     ~MsgFactory() = default;
 
     // 禁止拷贝
     MsgFactory(const MsgFactory&) = delete;
     MsgFactory& operator=(const MsgFactory&) = delete;
 
-    // 缓存消息原型
-    std::unordered_map<std::string, const google::protobuf::Message*> factory_;
+    struct TypeEntry {
+        std::string name;
+        const google::protobuf::Message* prototype;
+        std::shared_ptr<MessagePool> pool;
+    };
+
+    MsgTypeId registerPrototype(const std::string& name, const google::protobuf::Message* prototype);
+    MsgTypeId registerLocked(const std::string& name, const google::protobuf::Message* prototype);
+    const TypeEntry* entry(MsgTypeId id) const;
+
+    // 动态类型的原型归它所有，须最后析构（池析构时释放的空闲消息仍引用原型）
     google::protobuf::DynamicMessageFactory dynamic_factory_;
+    // 类型名 → ID，仅在注册与解析类型名时查询
+    std::unordered_map<std::string, MsgTypeId> ids_;
+    // ID → 类型信息，按 ID 无锁读取；重新注册同名类型时替换，旧条目保留到退出（已借出的消息仍引用它的池）
+    std::unique_ptr<std::atomic<const TypeEntry*>[]> entries_;
+    std::vector<std::unique_ptr<TypeEntry>> allEntries_;
+    MsgTypeId nextId_ = 1;
+    mutable std::shared_mutex mutex_;  // 保护 ids_、allEntries_ 与 dynamic_factory_
+    std::atomic<ArenaMode> arenaMode_{ArenaMode::NONE};
+    std::atomic<size_t> poolCapacity_{16};
+};
+
+/**
+ * @brief 每个接收线程持有的类型名 → ID 小缓存
+ *
+ * 一个线程上的连接通常只承载少数几种类型，按长度与内容比较命中，不求哈希；未命中时查询 MsgFactory 并轮换替换。
+ */
+class MsgTypeIdCache {
+public:
+    MsgTypeId lookup(const std::string& name);
+
+private:
+    static constexpr size_t kSlots = 8;
+    std::string names_[kSlots];
+    MsgTypeId ids_[kSlots] = {};
+    size_t next_ = 0;
 };
@@ -3,10 +3,14 @@
 #include <string>
 #include <memory>
 #include <functional>
+#include <utility>
+#include <vector>
 #include "subscriber.h"
 #include "publisher.h"
 #include "ros_rpc.pb.h"  // 添加protobuf头文件
 #include "timer.h"       // 添加timer头文件
+#include "qos.h"
+#include "callback_group.h"
 
 using namespace simple_ros;
 
@@ -21,6 +25,15 @@ public:
      */
     NodeHandle();
 
+    /**
+     * @brief 以指定节点名创建，用于同一进程中运行多个节点（组件）
+     *
+     * 各节点以自己的名字向 Master 注册发布与订阅，共享进程的监听端点、EventLoop 与消息队列；
+     * 同进程节点之间的消息直接投递到消息队列，不经过套接字。
+     * @param node_name 节点名，进程内须唯一
+     */
+    explicit NodeHandle(const std::string& node_name);
+
     /**
      * @brief 析构函数
      */
@@ -47,6 +60,21 @@ public:
                                          uint32_t queue_size, 
                                          std::function<void(const std::shared_ptr<MsgType>&)> callback);
 
+    /**
+     * @brief 创建订阅者(QoS 版本)
+     * @tparam MsgType 消息类型
+     * @param topic 主题名称
+     * @param qos QoS 配置，depth 作为接收队列大小
+     * @param callback 回调函数
+     * @param group 回调组，为空时使用 NodeHandle 的默认互斥组
+     * @return Subscriber实例的共享指针
+     */
+    template<typename MsgType>
+    std::shared_ptr<Subscriber> subscribe(const std::string& topic,
+                                         const simple_ros::QoSProfile& qos,
+                                         std::function<void(const std::shared_ptr<MsgType>&)> callback,
+                                         const simple_ros::CallbackGroupPtr& group = nullptr);
+
     /**
      * @brief 创建订阅者(类成员函数版本)
      * @tparam MsgType 消息类型
@@ -76,26 +104,86 @@ public:
                                          const std::string& msg_type_name, 
                                          MessageQueue::Callback callback);
 
+    /**
+     * @brief 创建订阅者(非模板 QoS 版本)
+     */
+    std::shared_ptr<Subscriber> subscribe(const std::string& topic,
+                                         const simple_ros::QoSProfile& qos,
+                                         const std::string& msg_type_name,
+                                         MessageQueue::Callback callback,
+                                         const simple_ros::CallbackGroupPtr& group = nullptr);
+
+    /**
+     * @brief 在 master 注销本节点对话题的订阅，master 随即通知发布者断开到本节点的连接
+     *
+     * 不影响本进程中已创建的 Subscriber，调用方应先释放对应的 Subscriber。
+     * @return RPC 成功返回 true
+     */
+    bool unsubscribe(const std::string& topic, const std::string& msg_type_name);
+
+    /**
+     * @brief 在 master 注销本 NodeHandle 通过 subscribe 登记过的所有订阅
+     *
+     * 用于组件卸载：同进程其他节点仍在运行，发布者须断开到已卸载节点的连接。
+     */
+    void unsubscribeAll();
+
     /**
      * @brief 创建发布者
      * @tparam MsgType protobuf消息类型
      * @param topic 主题名称
+     * @param latch 是否锁存，锁存话题会向后加入的订阅者补发最近的消息
+     * @param latch_depth 锁存保留的最近消息数
+     * @return Publisher<MsgType> 的共享指针
+     */
+    template<typename MsgType>
+    std::shared_ptr<Publisher<MsgType>> advertise(const std::string& topic,
+                                                  bool latch = false,
+                                                  uint32_t latch_depth = 1);
+
+    /**
+     * @brief 创建发布者(QoS 版本)
+     * @tparam MsgType protobuf消息类型
+     * @param topic 主题名称
+     * @param qos QoS 配置
      * @return Publisher<MsgType> 的共享指针
      */
     template<typename MsgType>
-    std::shared_ptr<Publisher<MsgType>> advertise(const std::string& topic);
+    std::shared_ptr<Publisher<MsgType>> advertise(const std::string& topic,
+                                                  const simple_ros::QoSProfile& qos);
 
     /**
      * @brief 创建定时器
+     *
+     * 默认（IoThreadConfig::timer_callbacks_in_spin）回调投递到消息队列，由 spin 线程执行，
+     * 与同组的订阅回调互斥；关闭后回调直接在定时器 EventLoop 线程中执行。
      * @param period 定时器周期（秒）
      * @param callback 回调函数
      * @param oneshot 是否为一次性定时器
+     * @param group 回调组，为空时使用 NodeHandle 的默认互斥组
      * @return Timer实例的共享指针
      */
-    std::shared_ptr<Timer> createTimer(double period, const TimerCallback& callback, bool oneshot = false);
+    std::shared_ptr<Timer> createTimer(double period, const TimerCallback& callback, bool oneshot = false,
+                                       const simple_ros::CallbackGroupPtr& group = nullptr);
+
+    /**
+     * @brief 创建回调组，传给 subscribe/createTimer 以控制回调的并发关系
+     */
+    simple_ros::CallbackGroupPtr createCallbackGroup(
+        simple_ros::CallbackGroupType type = simple_ros::CallbackGroupType::MUTUALLY_EXCLUSIVE);
+
+    // 本 NodeHandle 创建的订阅与定时器默认所属的互斥组
+    const simple_ros::CallbackGroupPtr& defaultCallbackGroup() const { return defaultGroup_; }
+
+    const std::string& getNodeName() const { return nodeInfo_.node_name(); }
 
 private:
+    // 记录在 master 登记成功的订阅，供 unsubscribeAll 注销
+    void recordSubscription(const std::string& topic, const std::string& msg_type_name);
+
     NodeInfo nodeInfo_;  // 节点信息
+    std::vector<std::pair<std::string, std::string>> subscriptions_;  // (话题, 消息类型)
+    simple_ros::CallbackGroupPtr defaultGroup_;  // 默认互斥回调组
 };
 
 // 模板方法实现
@@ -10,20 +10,30 @@ template<typename MsgType>
 std::shared_ptr<Subscriber> NodeHandle::subscribe(const std::string& topic, 
                                                 uint32_t queue_size, 
                                                 std::function<void(const std::shared_ptr<MsgType>&)> callback) {
+    return subscribe<MsgType>(topic, simple_ros::QoSProfile(queue_size), std::move(callback));
+}
+
+template<typename MsgType>
+std::shared_ptr<Subscriber> NodeHandle::subscribe(const std::string& topic,
+                                                const simple_ros::QoSProfile& qos,
+                                                std::function<void(const std::shared_ptr<MsgType>&)> callback,
+                                                const simple_ros::CallbackGroupPtr& group) {
     // 获取消息类型名称
     std::string msg_type_name = MsgType::descriptor()->full_name();
-    LOG_INFO << "Subscribe to topic=" << topic << ", type=" << msg_type_name;
+    LOG_INFO << "Subscribe to topic=" << topic << ", type=" << msg_type_name
+             << ", qos=" << qos.toString();
 
     // 创建订阅者实例
-    auto subscriber = std::make_shared<Subscriber>(topic, queue_size, callback);
+    auto subscriber = std::make_shared<Subscriber>(topic, qos, callback, group ? group : defaultGroup_);
 
     // 调用RPC订阅
     auto rpc_client = SystemManager::instance().getRpcClient();
     if (rpc_client) {
         SubscribeResponse response;
-        bool success = rpc_client->Subscribe(topic, msg_type_name, nodeInfo_, &response);
+        bool success = rpc_client->Subscribe(topic, msg_type_name, nodeInfo_, &response, qos.toMsg());
         if (success) {
             LOG_INFO << "Subscribe RPC successful for topic: " << topic;
+            recordSubscription(topic, msg_type_name);
         } else {
             LOG_ERROR << "Subscribe RPC failed for topic: " << topic;
         }
@@ -40,41 +50,33 @@ std::shared_ptr<Subscriber> NodeHandle::subscribe(const std::string& topic,
                                                 void(Class::*callback)(const std::shared_ptr<MsgType>&), 
                                                 Class* instance) {
     // 创建一个包装类成员函数的lambda表达式
-    auto wrapped_callback = [callback, instance](const std::shared_ptr<MsgType>& msg) {
-        (instance->*callback)(msg);
-    };
-    std::string msg_type_name = MsgType::descriptor()->full_name();
-    LOG_INFO << "Subscribe to topic=" << topic << ", type=" << msg_type_name;
-
-    // 创建订阅者实例
-    auto subscriber = std::make_shared<Subscriber>(topic, queue_size, wrapped_callback);
-
-    // 调用RPC订阅
-    auto rpc_client = SystemManager::instance().getRpcClient();
-    if (rpc_client) {
-        SubscribeResponse response;
-        bool success = rpc_client->Subscribe(topic, msg_type_name, nodeInfo_, &response);
-        if (success) {
-            LOG_INFO << "Subscribe RPC successful for topic: " << topic;
-        } else {
-            LOG_ERROR << "Subscribe RPC failed for topic: " << topic;
-        }
-    } else {
-        LOG_ERROR << "Global RPC client not initialized";
-    }
+    std::function<void(const std::shared_ptr<MsgType>&)> wrapped_callback =
+        [callback, instance](const std::shared_ptr<MsgType>& msg) {
+            (instance->*callback)(msg);
+        };
+    return subscribe<MsgType>(topic, simple_ros::QoSProfile(queue_size), std::move(wrapped_callback));
+}
 
-    return subscriber;
+template<typename MsgType>
+std::shared_ptr<Publisher<MsgType>> NodeHandle::advertise(const std::string& topic,
+                                                          bool latch,
+                                                          uint32_t latch_depth)
+{
+    return advertise<MsgType>(topic, latch ? simple_ros::QoSProfile::latched(latch_depth)
+                                           : simple_ros::QoSProfile());
 }
 
 template<typename MsgType>
-std::shared_ptr<Publisher<MsgType>> NodeHandle::advertise(const std::string& topic)
+std::shared_ptr<Publisher<MsgType>> NodeHandle::advertise(const std::string& topic,
+                                                          const simple_ros::QoSProfile& qos)
 {
     // 获取消息类型名称
     std::string msg_type_name = MsgType::descriptor()->full_name();
-    LOG_INFO << "Advertise topic=" << topic << ", type=" << msg_type_name;
+    LOG_INFO << "Advertise topic=" << topic << ", type=" << msg_type_name
+             << ", qos=" << qos.toString();
 
     // 创建发布者实例
-    auto publisher = std::make_shared<Publisher<MsgType>>(topic);
+    auto publisher = std::make_shared<Publisher<MsgType>>(topic, qos, nodeInfo_);
     LOG_INFO << "Debug: nodeInfo_ details - node_name: '" << nodeInfo_.node_name() 
              << "', ip: '" << nodeInfo_.ip() 
              << "', port: " << nodeInfo_.port();
@@ -82,7 +84,7 @@ std::shared_ptr<Publisher<MsgType>> NodeHandle::advertise(const std::string& top
     auto rpc_client = SystemManager::instance().getRpcClient();
     if (rpc_client) {
         RegisterPublisherResponse response;
-        bool success = rpc_client->RegisterPublisher(topic, msg_type_name, nodeInfo_, &response);
+        bool success = rpc_client->RegisterPublisher(topic, msg_type_name, nodeInfo_, &response, qos.toMsg());
         if (success) {
             LOG_INFO << "RegisterPublisher RPC successful for topic: " << topic;
         } else {
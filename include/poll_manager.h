@@ -6,7 +6,17 @@
 #include <muduo/base/Timestamp.h>
 #include <string>
 #include <functional>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
 #include "ros_rpc.pb.h"
+#include "udp_transport.h"
+#include "unix_transport.h"
+#include "io_uring_backend.h"
+#include "msg_factory.h"
 
 using namespace simple_ros;
 
@@ -22,24 +32,79 @@ struct NodeInfoEqual {
     }
 };
 
+// 订阅节点的身份：同一进程内的多个节点共用监听端点，按节点名区分各自的订阅
+struct NodeIdentityHash {
+    size_t operator()(const NodeInfo& n) const {
+        return NodeInfoHash()(n) ^ (std::hash<std::string>()(n.node_name()) << 2);
+    }
+};
+
+struct NodeIdentityEqual {
+    bool operator()(const NodeInfo& a, const NodeInfo& b) const {
+        return NodeInfoEqual()(a, b) && a.node_name() == b.node_name();
+    }
+};
+
 class PollManager {
 public:
-    PollManager(muduo::net::EventLoop* loop, const muduo::net::InetAddress& listenAddr);
+    /**
+     * @param unixPath 同时监听的 Unix 域套接字路径，为空则只监听 TCP/UDP
+     */
+    PollManager(muduo::net::EventLoop* loop, const muduo::net::InetAddress& listenAddr,
+                const std::string& unixPath = std::string());
     void start();
 
+    // 设置接收 IO 线程数（须在 start 之前调用），每个连接固定在一个线程上
+    void setThreadNum(int num_threads);
+
+    // 接收 IO 线程启动时在该线程中调用（须在 start 之前设置），用于设置亲和性与调度策略
+    void setThreadInitCallback(std::function<void()> cb);
+
+    // 使用 io_uring 接收 TCP 数据（须在 start 之前调用），监听失败或设置了多个接收线程时仍使用 muduo
+    void useIoUring(std::shared_ptr<IoUringBackend> backend) { ioUring_ = std::move(backend); }
+
+    // UDP 接收端是否可用（BEST_EFFORT 话题走 UDP）
+    bool udpEnabled() const { return udpEnabled_; }
+
     // 设置接收消息的回调
     void setMessageCallback(std::function<void(const std::string&, const std::string&)> cb) {
         messageCallback_ = std::move(cb);
     }
 
-
+    // 订阅该话题的监听端点（按 ip:port 去重）
     std::unordered_set<NodeInfo, NodeInfoHash, NodeInfoEqual> getTargets(const std::string& topic) const;
 
+    // 监听某个 topic 的目标节点变化（在 EventLoop 线程中回调），返回监听 ID
+    uint64_t addTargetsListener(const std::string& topic, std::function<void()> cb);
+    // 移除监听；若该监听正在其他线程中执行，等待其返回后才返回，之后不会再被调用
+    void removeTargetsListener(const std::string& topic, uint64_t id);
+
 private:
     void onConnection(const muduo::net::TcpConnectionPtr& conn);
     void onMessage(const muduo::net::TcpConnectionPtr& conn, muduo::net::Buffer* buf, muduo::Timestamp time);
-    void handleMessage(const std::string& topic, const std::string& msg_name, const std::string& data);
+    // batch_arena 非空时消息分配在该 Arena 上（PER_BATCH），否则按 MsgFactory::arenaMode 分配
+    void handleMessage(const std::string& topic, const std::string& msg_name, const std::string& data,
+                       const MessageArenaPtr& batch_arena = nullptr);
+
+    struct TargetsListener {
+        uint64_t id;
+        std::function<void()> cb;
+        int inflight = 0;       // 正在执行的回调数
+        bool removed = false;   // 已移除，不再调用
+    };
+    using TargetsListenerPtr = std::shared_ptr<TargetsListener>;
     muduo::net::TcpServer server_;
+    muduo::net::InetAddress listenAddr_;
+    std::shared_ptr<IoUringBackend> ioUring_;
+    UdpReceiver udpReceiver_;   // 与 TCP 监听同一端口
+    bool udpEnabled_ = false;
+    int numThreads_ = 0;        // 接收 IO 线程数，0 表示在主 EventLoop 中接收
+    std::unique_ptr<UnixServer> unixServer_;  // 同机节点的 Unix 域套接字入口
     std::function<void(const std::string&, const std::string&)> messageCallback_;
-    std::unordered_map<std::string, std::unordered_set<NodeInfo, NodeInfoHash, NodeInfoEqual>> topic_targets_;
+    // 按节点身份记录：某个节点取消订阅时，同一端点上的其他节点仍保留
+    std::unordered_map<std::string, std::unordered_set<NodeInfo, NodeIdentityHash, NodeIdentityEqual>> topic_targets_;
+    std::unordered_map<std::string, std::vector<TargetsListenerPtr>> targets_listeners_;
+    uint64_t next_listener_id_ = 1;
+    mutable std::mutex targets_mutex_; // 保护 topic_targets_ 和 targets_listeners_
+    std::condition_variable listeners_idle_; // 某个监听回调执行完毕
 };
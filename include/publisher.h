@@ -6,9 +6,17 @@
 #include "global_init.h"
 #include <google/protobuf/message.h>
 #include <arpa/inet.h> // htons, htonl
+#include <algorithm>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
+#include <deque>
+#include <mutex>
+#include <chrono>
 #include "ros_rpc.pb.h"
+#include "qos.h"
+#include "udp_transport.h"
+#include "unix_transport.h"
 
 using namespace simple_ros;
 
@@ -16,23 +24,83 @@ using namespace simple_ros;
 template <typename T>
 class Publisher {
 public:
-    Publisher(const std::string& topic);
+    /**
+     * @param topic 主题名称
+     * @param latch 是否为锁存(transient-local)话题，新连接建立时会补发最近的消息
+     * @param latch_depth 锁存保留的最近消息帧数
+     */
+    Publisher(const std::string& topic, bool latch = false, uint32_t latch_depth = 1);
+
+    /**
+     * @param topic 主题名称
+     * @param qos QoS 配置：RELIABLE 走 TCP，BEST_EFFORT 走 UDP；TRANSIENT_LOCAL 时保留最近 depth 条消息
+     */
+    Publisher(const std::string& topic, const simple_ros::QoSProfile& qos);
+
+    /**
+     * @param node_info 发布者所属节点，同进程多个节点（组件）共享监听端点但各自以节点名注册
+     */
+    Publisher(const std::string& topic, const simple_ros::QoSProfile& qos, const NodeInfo& node_info);
+
+    const simple_ros::QoSProfile& qos() const { return qos_; }
 
     // 发布 protobuf 消息
     void publish(const T& msg);
+
+    /**
+     * @brief 发布已构造好的共享消息，同进程订阅者直接共享该对象而不拷贝
+     *
+     * 发布后不得再修改 msg。与 newMessage 配合使用时，大消息的构造与进程内投递都不逐字段 malloc。
+     */
+    void publish(const std::shared_ptr<T>& msg);
+
+    /**
+     * @brief 在新的 protobuf Arena 上构造一条消息，Arena 随最后一个 shared_ptr 释放
+     * @param initial_block_size Arena 首块大小，按预计的消息大小设置可避免追加分配
+     */
+    std::shared_ptr<T> newMessage(size_t initial_block_size = 4096);
     void unregister();
     ~Publisher();
 
 private:
     void updateTargets();
     void createClient(const NodeInfo& nodeInfo);
+    bool createUnixClient(const NodeInfo& nodeInfo, const std::string& conn_id);
+    bool createIoUringClient(const NodeInfo& nodeInfo, const std::string& conn_id);
+    void onConnection(const std::string& conn_id, const muduo::net::TcpConnectionPtr& conn);
     std::string getConnectionId(const NodeInfo& nodeInfo);
+    std::string serializeFrame(const T& msg);
+    void publishShared(const T& msg, std::shared_ptr<T> shared);
+    void updateUdpTargets(const std::vector<NodeInfo>& targets);
+    void removeStaleClients(const std::unordered_set<std::string>& wanted);
+    void dropIoUringConns(const std::vector<int64_t>& ids);
+    std::vector<std::string> collectLatchedFrames();
+    bool isLocalEndpoint(const NodeInfo& nodeInfo) const;
+    void setLocalDelivery(bool on);
 
     std::string topic_;
     std::string msgType_;
     NodeInfo nodeInfo_;  // 节点信息
     std::unordered_map<std::string, std::unique_ptr<muduo::net::TcpClient>> clients_;
+    std::unordered_map<std::string, std::unique_ptr<UnixClient>> unixClients_; // 同机目标
+    std::unordered_map<std::string, int64_t> ioUringConns_; // io_uring 连接，同时持有 clientsMutex_ 与 mutex_ 时写入
     std::unordered_map<std::string, muduo::net::TcpConnectionPtr> connections_;
+    uint64_t targetsListenerId_ = 0;  // PollManager 目标变化监听 ID
+    std::mutex clientsMutex_;         // 保护 clients_/unixClients_（publish 线程与 EventLoop 线程都会创建客户端）
+
+    struct LatchedFrame {
+        std::string data;                              // 已序列化的完整帧
+        std::chrono::steady_clock::time_point stamp;   // 发布时间，用于 lifespan
+    };
+
+    simple_ros::QoSProfile qos_;                    // QoS 配置
+    bool latch_;                                    // 是否锁存（TRANSIENT_LOCAL）
+    std::deque<LatchedFrame> latched_frames_;       // 最近已发布的帧
+    std::unique_ptr<UdpSender> udpSender_;          // BEST_EFFORT 话题的 UDP 发送端
+    std::unordered_map<std::string, sockaddr_in> udpTargets_; // UDP 目标地址
+    bool localDelivery_ = false;                    // 本进程有订阅者，消息直接投递到消息队列
+    uint64_t localReplayedUpTo_ = 0;                // 已补发过锁存消息的本进程订阅者 id 上界
+    std::mutex mutex_;                              // 保护 connections_、latched_frames_、udpTargets_ 和进程内投递状态
 };
 
 // 引入模板实现
@@ -7,21 +7,48 @@
 #include <muduo/net/TcpClient.h>
 #include "global_init.h"
 #include "msg_factory.h"
+#include "wire_format.h"
 
 using namespace simple_ros;
 // 构造函数
 
 template <typename T>
-Publisher<T>::Publisher(const std::string& topic) : topic_(topic) {
+Publisher<T>::Publisher(const std::string& topic, bool latch, uint32_t latch_depth)
+    : Publisher(topic, latch ? simple_ros::QoSProfile::latched(latch_depth) : simple_ros::QoSProfile()) {
+}
+
+template <typename T>
+Publisher<T>::Publisher(const std::string& topic, const simple_ros::QoSProfile& qos)
+    : Publisher(topic, qos, SystemManager::instance().getNodeInfo()) {
+}
+
+template <typename T>
+Publisher<T>::Publisher(const std::string& topic, const simple_ros::QoSProfile& qos, const NodeInfo& node_info)
+    : topic_(topic), nodeInfo_(node_info), qos_(qos),
+      latch_(qos.durability == simple_ros::Durability::TRANSIENT_LOCAL) {
+    if (qos_.depth == 0) qos_.depth = 1;
+
     // 获取消息类型
     msgType_ = T::descriptor()->full_name();
-    LOG_INFO << "Creating publisher for topic: " << topic_ << ", type: " << msgType_;
+    LOG_INFO << "Creating publisher for topic: " << topic_ << ", type: " << msgType_
+             << ", qos: " << qos_.toString();
 
-    // 从系统管理器获取节点信息
-    nodeInfo_ = SystemManager::instance().getNodeInfo();
+    // 尽力而为的话题走 UDP，避免 TCP 队头阻塞
+    if (qos_.reliability == simple_ros::Reliability::BEST_EFFORT) {
+        udpSender_ = std::make_unique<UdpSender>();
+        if (!udpSender_->valid()) {
+            LOG_WARN << "UDP sender unavailable, topic " << topic_ << " falls back to TCP";
+            udpSender_.reset();
+        }
+    }
 
     // 初始化时更新目标节点
     updateTargets();
+
+    // 订阅者变化时立即建立连接，锁存话题即使不再发布也能补发给后加入的订阅者
+    if (auto poll_manager = SystemManager::instance().getPollManager()) {
+        targetsListenerId_ = poll_manager->addTargetsListener(topic_, [this]() { updateTargets(); });
+    }
 }
 
 // 析构函数
@@ -51,53 +78,155 @@ void Publisher<T>::unregister() {
         LOG_ERROR << "Global RPC client not initialized";
     }
 
+    if (targetsListenerId_ != 0) {
+        if (auto poll_manager = SystemManager::instance().getPollManager()) {
+            poll_manager->removeTargetsListener(topic_, targetsListenerId_);
+        }
+        targetsListenerId_ = 0;
+    }
+
     // 清理客户端连接
-    clients_.clear();
+    {
+        std::lock_guard<std::mutex> lock(clientsMutex_);
+        clients_.clear();
+        unixClients_.clear();
+        std::lock_guard<std::mutex> conn_lock(mutex_);
+        if (auto io_uring = SystemManager::instance().getIoUringBackend()) {
+            for (const auto& item : ioUringConns_) io_uring->close(item.second);
+        }
+        ioUringConns_.clear();
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
     connections_.clear();
+    latched_frames_.clear();
+    udpTargets_.clear();
+    localDelivery_ = false;
 }
 
 // 发布消息
 
 template <typename T>
 void Publisher<T>::publish(const T& msg) {
+    publishShared(msg, nullptr);
+}
+
+template <typename T>
+void Publisher<T>::publish(const std::shared_ptr<T>& msg) {
+    if (!msg) return;
+    publishShared(*msg, msg);
+}
+
+template <typename T>
+std::shared_ptr<T> Publisher<T>::newMessage(size_t initial_block_size) {
+    return MsgFactory::createOnArena<T>(initial_block_size);
+}
+
+// shared 非空时本进程订阅者直接共享它，否则拷贝 msg
+
+template <typename T>
+void Publisher<T>::publishShared(const T& msg, std::shared_ptr<T> shared) {
     // 确保目标节点是最新的
     updateTargets();
 
+    // 只有进程内订阅者时无需序列化
+    bool local = false;
+    bool remote = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        local = localDelivery_;
+        remote = latch_ || !connections_.empty() || !ioUringConns_.empty() || !udpTargets_.empty();
+    }
+    if (local) {
+        // 同进程订阅者共享这份拷贝，不经过序列化与套接字
+        if (auto msg_queue = SystemManager::instance().getMessageQueue()) {
+            msg_queue->push(topic_, shared ? std::move(shared) : std::make_shared<T>(msg));
+        }
+    }
+    if (!remote) return;
+
+    std::string buffer = serializeFrame(msg);
+    if (buffer.empty()) return;
+
+    // 锁存帧与连接快照在同一把锁内完成，保证新连接不会漏收也不会重复收到这一帧
+    std::vector<muduo::net::TcpConnectionPtr> targets;
+    std::vector<sockaddr_in> udp_targets;
+    std::vector<int64_t> io_uring_targets;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (latch_) {
+            latched_frames_.push_back({buffer, std::chrono::steady_clock::now()});
+            while (latched_frames_.size() > qos_.depth) {
+                latched_frames_.pop_front();
+            }
+        }
+        udp_targets.reserve(udpTargets_.size());
+        for (const auto& target : udpTargets_) {
+            udp_targets.push_back(target.second);
+        }
+        // BEST_EFFORT 话题中不支持 UDP 的订阅者仍走 TCP
+        targets.reserve(connections_.size());
+        for (const auto& conn_pair : connections_) {
+            targets.push_back(conn_pair.second);
+        }
+        for (const auto& item : ioUringConns_) {
+            io_uring_targets.push_back(item.second);
+        }
+    }
+
+    if (!io_uring_targets.empty()) {
+        // 由 io_uring 线程合并同一连接的排队帧后批量提交
+        if (auto io_uring = SystemManager::instance().getIoUringBackend()) {
+            std::vector<int64_t> failed;
+            for (int64_t id : io_uring_targets) {
+                if (!io_uring->send(id, buffer)) failed.push_back(id);
+            }
+            // 连接已断开：丢弃 ID，下一次 updateTargets 重新连接
+            if (!failed.empty()) dropIoUringConns(failed);
+        }
+    }
+
+    if (udpSender_ && !udp_targets.empty()) {
+        udpSender_->send(buffer, udp_targets);
+    }
+
+    // 为每个连接发送消息
+    for (const auto& conn : targets) {
+        if (conn && conn->connected()) {
+            conn->send(buffer);
+        }
+    }
+}
+
+// 按照协议格式构建完整消息：topic_name_len(2B) + topic_name + msg_name_len(2B) + msg_name + msg_data_len(4B) + msg_data
+
+template <typename T>
+std::string Publisher<T>::serializeFrame(const T& msg) {
     // 序列化消息
     std::string msg_data;
     if (!msg.SerializeToString(&msg_data)) {
         LOG_ERROR << "Failed to serialize message of type: " << msgType_;
-        return;
+        return std::string();
     }
 
-    // 按照协议格式构建完整消息：topic_name_len(2B) + topic_name + msg_name_len(2B) + msg_name + msg_data_len(4B) + msg_data
-    std::string buffer;
-    
-    // 1. 写入 topic 名称长度和 topic 名称
-    uint16_t topic_len = htons(static_cast<uint16_t>(topic_.size()));
-    buffer.append(reinterpret_cast<const char*>(&topic_len), sizeof(topic_len));
-    buffer.append(topic_);
-    
-    // 2. 写入消息名称长度和消息名称
-    uint16_t msg_name_len = htons(static_cast<uint16_t>(msgType_.size()));
-    buffer.append(reinterpret_cast<const char*>(&msg_name_len), sizeof(msg_name_len));
-    buffer.append(msgType_);
-    
-    // 3. 写入消息数据长度和消息数据
-    uint32_t msg_data_len = htonl(static_cast<uint32_t>(msg_data.size()));
-    buffer.append(reinterpret_cast<const char*>(&msg_data_len), sizeof(msg_data_len));
-    buffer.append(msg_data);
+    return wire::encodeFrame(topic_, msgType_, msg_data);
+}
+
+// 收集尚未过期的锁存帧（调用方持有 mutex_）
 
-    // 为每个连接发送消息
-    for (const auto& conn_pair : connections_) {
-        if (conn_pair.second && conn_pair.second->connected()) {
-            // 增加调试信息，打印目标端口
-            // LOG_INFO << "Publishing message to topic: " << topic_ 
-            //          << ", target port: " << conn_pair.second->peerAddress().port()
-            //          << ", message type: " << msgType_;
-            conn_pair.second->send(buffer);
+template <typename T>
+std::vector<std::string> Publisher<T>::collectLatchedFrames() {
+    std::vector<std::string> replay;
+    if (!latch_) return replay;
+    auto now = std::chrono::steady_clock::now();
+    for (const auto& frame : latched_frames_) {
+        // 超过 lifespan 的历史消息不再补发
+        if (qos_.lifespan > 0 &&
+            std::chrono::duration<double>(now - frame.stamp).count() > qos_.lifespan) {
+            continue;
         }
+        replay.push_back(frame.data);
     }
+    return replay;
 }
 
 // 更新目标节点
@@ -113,39 +242,206 @@ void Publisher<T>::updateTargets() {
     // 获取订阅该主题的所有节点
 
     auto targets_set = poll_manager->getTargets(topic_);
-    std::vector<NodeInfo> targets(targets_set.begin(), targets_set.end());
+    std::vector<NodeInfo> targets;
+    bool local = false;
+    for (const auto& node_info : targets_set) {
+        // 同进程的订阅者（包括组件容器中的其他节点）走进程内投递，不连接自己的监听端口
+        if (isLocalEndpoint(node_info)) {
+            local = true;
+            continue;
+        }
+        targets.push_back(node_info);
+    }
+    setLocalDelivery(local);
+
+    if (udpSender_) {
+        // 订阅节点在 NodeInfo 中声明了 UDP 接收能力才走 UDP，旧节点或 UDP 不可用的节点回退到 TCP
+        std::vector<NodeInfo> udp_capable;
+        std::vector<NodeInfo> tcp_only;
+        for (auto& node_info : targets) {
+            (node_info.udp() ? udp_capable : tcp_only).push_back(std::move(node_info));
+        }
+        updateUdpTargets(udp_capable);
+        targets.swap(tcp_only);
+    }
+    std::lock_guard<std::mutex> lock(clientsMutex_);
+    // io_uring 连接失败或被对端关闭后 ID 不再可用，移除后在下面重新连接
+    if (!ioUringConns_.empty()) {
+        if (auto io_uring = SystemManager::instance().getIoUringBackend()) {
+            std::lock_guard<std::mutex> conn_lock(mutex_);
+            for (auto it = ioUringConns_.begin(); it != ioUringConns_.end();) {
+                if (io_uring->isConnected(it->second)) { ++it; continue; }
+                LOG_INFO << "io_uring connection for " << it->first << " on topic " << topic_ << " lost";
+                it = ioUringConns_.erase(it);
+            }
+        }
+    }
+    // 连接数多于目标数时说明有订阅者已取消订阅，断开这些连接，不再向其发送
+    if (clients_.size() + unixClients_.size() + ioUringConns_.size() > targets.size()) {
+        std::unordered_set<std::string> wanted;
+        for (const auto& node_info : targets) wanted.insert(getConnectionId(node_info));
+        removeStaleClients(wanted);
+    }
     // 为每个新节点创建客户端
     for (const auto& node_info : targets) {
         std::string conn_id = getConnectionId(node_info);
-        if (clients_.find(conn_id) == clients_.end()) {
+        if (clients_.find(conn_id) == clients_.end() &&
+            unixClients_.find(conn_id) == unixClients_.end() &&
+            ioUringConns_.find(conn_id) == ioUringConns_.end()) {
             createClient(node_info);
         }
     }
 }
 
-// 创建TCP客户端
+// 断开不在 wanted 中的目标，调用方持有 clientsMutex_
+
+template <typename T>
+void Publisher<T>::removeStaleClients(const std::unordered_set<std::string>& wanted) {
+    std::vector<std::unique_ptr<muduo::net::TcpClient>> dropped_tcp;
+    std::vector<std::unique_ptr<UnixClient>> dropped_unix;
+    for (auto it = clients_.begin(); it != clients_.end();) {
+        if (wanted.count(it->first)) { ++it; continue; }
+        LOG_INFO << "Dropping TCP client for " << it->first << " on topic " << topic_;
+        dropped_tcp.push_back(std::move(it->second));
+        it = clients_.erase(it);
+    }
+    for (auto it = unixClients_.begin(); it != unixClients_.end();) {
+        if (wanted.count(it->first)) { ++it; continue; }
+        LOG_INFO << "Dropping Unix socket client for " << it->first << " on topic " << topic_;
+        dropped_unix.push_back(std::move(it->second));
+        it = unixClients_.erase(it);
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto io_uring = SystemManager::instance().getIoUringBackend();
+        for (auto it = ioUringConns_.begin(); it != ioUringConns_.end();) {
+            if (wanted.count(it->first)) { ++it; continue; }
+            LOG_INFO << "Closing io_uring connection for " << it->first << " on topic " << topic_;
+            if (io_uring) io_uring->close(it->second);
+            it = ioUringConns_.erase(it);
+        }
+        for (auto it = connections_.begin(); it != connections_.end();) {
+            if (wanted.count(it->first)) ++it;
+            else it = connections_.erase(it);
+        }
+    }
+    // 客户端在 mutex_ 之外析构：断开回调会在 EventLoop 线程中获取 mutex_
+}
+
+// 移除发送失败的 io_uring 连接 ID
+
+template <typename T>
+void Publisher<T>::dropIoUringConns(const std::vector<int64_t>& ids) {
+    std::lock_guard<std::mutex> lock(clientsMutex_);
+    std::lock_guard<std::mutex> conn_lock(mutex_);
+    for (auto it = ioUringConns_.begin(); it != ioUringConns_.end();) {
+        if (std::find(ids.begin(), ids.end(), it->second) == ids.end()) { ++it; continue; }
+        LOG_INFO << "io_uring send to " << it->first << " on topic " << topic_ << " failed, will reconnect";
+        it = ioUringConns_.erase(it);
+    }
+}
+
+// 目标是否为本进程的监听端点
+
+template <typename T>
+bool Publisher<T>::isLocalEndpoint(const NodeInfo& nodeInfo) const {
+    return nodeInfo.port() == nodeInfo_.port() && nodeInfo.ip() == nodeInfo_.ip();
+}
+
+// 切换进程内投递；开启期间每个新加入的本进程订阅者单独补发锁存消息，与 TCP 按连接补发一致
+
+template <typename T>
+void Publisher<T>::setLocalDelivery(bool on) {
+    auto msg_queue = SystemManager::instance().getMessageQueue();
+    bool enabled = false;
+    std::vector<uint64_t> fresh;
+    std::vector<std::string> replay;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        enabled = on && !localDelivery_;
+        localDelivery_ = on;
+        // 订阅者 id 单调递增，没有新订阅者时不查询消息队列
+        if (on && latch_ && msg_queue && msg_queue->lastSubscriberId() > localReplayedUpTo_) {
+            uint64_t last = msg_queue->lastSubscriberId();
+            fresh = msg_queue->subscribersAfter(topic_, localReplayedUpTo_);
+            for (uint64_t id : fresh) last = std::max(last, id);
+            localReplayedUpTo_ = last;
+            if (!fresh.empty()) replay = collectLatchedFrames();
+        }
+    }
+    if (enabled) {
+        LOG_INFO << "Intra-process delivery enabled for topic " << topic_;
+    }
+
+    for (const auto& frame : replay) {
+        std::string topic, msg_name, msg_data;
+        if (wire::decodeFrame(frame.data(), frame.size(), &topic, &msg_name, &msg_data) != frame.size()) {
+            continue;
+        }
+        auto msg = std::make_shared<T>();
+        if (!msg->ParseFromString(msg_data)) continue;
+        for (uint64_t id : fresh) {
+            msg_queue->pushToSubscriber(topic_, id, msg);
+        }
+    }
+}
+
+// 同步 UDP 目标地址，新目标立即补发锁存消息
+
+template <typename T>
+void Publisher<T>::updateUdpTargets(const std::vector<NodeInfo>& targets) {
+    std::vector<std::pair<sockaddr_in, std::vector<std::string>>> replays;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::unordered_map<std::string, sockaddr_in> updated;
+        for (const auto& node_info : targets) {
+            std::string conn_id = getConnectionId(node_info);
+            auto it = udpTargets_.find(conn_id);
+            if (it != udpTargets_.end()) {
+                updated.emplace(conn_id, it->second);
+                continue;
+            }
+            LOG_INFO << "Adding UDP target for topic " << topic_ << ": " << conn_id;
+            sockaddr_in addr = UdpSender::makeAddr(node_info.ip(), static_cast<uint16_t>(node_info.port()));
+            updated.emplace(conn_id, addr);
+            auto replay = collectLatchedFrames();
+            if (!replay.empty()) replays.emplace_back(addr, std::move(replay));
+        }
+        udpTargets_.swap(updated);
+    }
+
+    for (const auto& r : replays) {
+        for (const auto& frame : r.second) {
+            udpSender_->sendTo(frame, r.first);
+        }
+    }
+}
+
+// 创建客户端：启用 io_uring 时使用 io_uring 数据面；否则同机目标优先使用 Unix 域套接字，失败时回退到 TCP
 
 template <typename T>
 void Publisher<T>::createClient(const NodeInfo& nodeInfo) {
     std::string conn_id = getConnectionId(nodeInfo);
+    if (SystemManager::instance().getIoUringBackend() && createIoUringClient(nodeInfo, conn_id)) {
+        return;
+    }
+    if (!nodeInfo.unix_path().empty() && !nodeInfo_.host_id().empty() &&
+        nodeInfo.host_id() == nodeInfo_.host_id() && createUnixClient(nodeInfo, conn_id)) {
+        return;
+    }
+
     LOG_INFO << "Creating TCP client for: " << conn_id;
 
     muduo::net::InetAddress server_addr(nodeInfo.ip().c_str(), nodeInfo.port());
     auto client = std::make_unique<muduo::net::TcpClient>(
-        SystemManager::instance().getEventLoop().get(),
+        SystemManager::instance().getTimerLoop(),
         server_addr,
         "PublisherClient"
     );
 
     // 设置连接回调
     client->setConnectionCallback([this, conn_id](const muduo::net::TcpConnectionPtr& conn) {
-        if (conn->connected()) {
-            LOG_INFO << "Connected to " << conn_id;
-            connections_[conn_id] = conn;
-        } else {
-            LOG_INFO << "Disconnected from " << conn_id;
-            connections_.erase(conn_id);
-        }
+        onConnection(conn_id, conn);
     });
 
     // 连接服务器
@@ -153,6 +449,76 @@ void Publisher<T>::createClient(const NodeInfo& nodeInfo) {
     clients_[conn_id] = std::move(client);
 }
 
+// 创建 Unix 域套接字客户端
+
+template <typename T>
+bool Publisher<T>::createUnixClient(const NodeInfo& nodeInfo, const std::string& conn_id) {
+    auto client = std::make_unique<UnixClient>(
+        SystemManager::instance().getTimerLoop(),
+        nodeInfo.unix_path(),
+        "PublisherClient"
+    );
+    client->setConnectionCallback([this, conn_id](const muduo::net::TcpConnectionPtr& conn) {
+        onConnection(conn_id, conn);
+    });
+    if (!client->connect()) {
+        LOG_WARN << "Unix socket " << nodeInfo.unix_path() << " unreachable, falling back to TCP for " << conn_id;
+        return false;
+    }
+    LOG_INFO << "Created Unix socket client for: " << conn_id << " (" << nodeInfo.unix_path() << ")";
+    unixClients_[conn_id] = std::move(client);
+    return true;
+}
+
+// 通过 io_uring 后端建立连接
+
+template <typename T>
+bool Publisher<T>::createIoUringClient(const NodeInfo& nodeInfo, const std::string& conn_id) {
+    auto io_uring = SystemManager::instance().getIoUringBackend();
+    int64_t id = io_uring->connect(nodeInfo.ip(), static_cast<uint16_t>(nodeInfo.port()));
+    if (id < 0) return false;
+    LOG_INFO << "Created io_uring connection for: " << conn_id;
+
+    std::vector<std::string> replay;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ioUringConns_[conn_id] = id;
+        replay = collectLatchedFrames();
+    }
+    for (auto& frame : replay) {
+        io_uring->send(id, std::move(frame));
+    }
+    return true;
+}
+
+// 连接建立/断开回调（TCP 与 Unix 域套接字共用）
+
+template <typename T>
+void Publisher<T>::onConnection(const std::string& conn_id, const muduo::net::TcpConnectionPtr& conn) {
+    if (conn->connected()) {
+        LOG_INFO << "Connected to " << conn_id;
+
+        std::vector<std::string> replay;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            connections_[conn_id] = conn;
+            replay = collectLatchedFrames();
+        }
+        // 锁存话题：仅向新建立的连接补发最近的消息
+        for (const auto& frame : replay) {
+            conn->send(frame);
+        }
+        if (!replay.empty()) {
+            LOG_INFO << "Replayed " << replay.size() << " latched message(s) on topic "
+                     << topic_ << " to " << conn_id;
+        }
+    } else {
+        LOG_INFO << "Disconnected from " << conn_id;
+        std::lock_guard<std::mutex> lock(mutex_);
+        connections_.erase(conn_id);
+    }
+}
+
 // 获取连接ID
 
 template <typename T>
@@ -0,0 +1,70 @@
+// qos.h
+// 话题服务质量(QoS)配置
+
+#ifndef simple_ros_QOS_H
+#define simple_ros_QOS_H
+
+#include <cstdint>
+#include <string>
+#include "ros_rpc.pb.h"
+
+namespace simple_ros {
+
+// 可靠性：决定传输方式
+enum class Reliability {
+    RELIABLE,     // 可靠传输（TCP），消息不丢失
+    BEST_EFFORT   // 尽力而为，拥塞时丢弃消息以保证低延迟
+};
+
+// 持久性：决定后加入的订阅者能否收到历史消息
+enum class Durability {
+    VOLATILE,        // 只接收订阅之后的消息
+    TRANSIENT_LOCAL  // 发布者保留最近 depth 条消息并补发
+};
+
+/**
+ * @brief 话题 QoS 配置，advertise/subscribe 时传入
+ *
+ * 发布者的 reliability 决定传输方式，订阅者的 depth/lifespan/deadline 决定
+ * 接收队列行为；Master 在建立发布/订阅关系前检查两端 QoS 是否兼容。
+ */
+struct QoSProfile {
+    Reliability reliability = Reliability::RELIABLE;
+    Durability durability = Durability::VOLATILE;
+    uint32_t depth = 10;     // 历史深度（队列长度 / 锁存条数）
+    double deadline = 0.0;   // 相邻消息最大间隔（秒），0 表示不检查
+    double lifespan = 0.0;   // 消息有效期（秒），0 表示永久有效
+
+    QoSProfile() = default;
+    explicit QoSProfile(uint32_t history_depth) : depth(history_depth) {}
+
+    // 链式设置
+    QoSProfile& reliable() { reliability = Reliability::RELIABLE; return *this; }
+    QoSProfile& bestEffort() { reliability = Reliability::BEST_EFFORT; return *this; }
+    QoSProfile& transientLocal() { durability = Durability::TRANSIENT_LOCAL; return *this; }
+    QoSProfile& durabilityVolatile() { durability = Durability::VOLATILE; return *this; }
+    QoSProfile& keepLast(uint32_t d) { depth = d; return *this; }
+    QoSProfile& setDeadline(double seconds) { deadline = seconds; return *this; }
+    QoSProfile& setLifespan(double seconds) { lifespan = seconds; return *this; }
+
+    // 常用预设
+    static QoSProfile sensorData();     // 高频传感器：尽力而为，深度 5
+    static QoSProfile command();        // 控制指令：可靠，深度 10
+    static QoSProfile latched(uint32_t d = 1); // 静态数据：可靠 + 锁存
+
+    // 与 proto 互转
+    QoSPolicy toMsg() const;
+    static QoSProfile fromMsg(const QoSPolicy& msg);
+
+    /**
+     * @brief 检查发布者与订阅者 QoS 是否兼容
+     * @param reason 不兼容时写入原因，可为空
+     */
+    static bool isCompatible(const QoSProfile& pub, const QoSProfile& sub, std::string* reason = nullptr);
+
+    std::string toString() const;
+};
+
+} // namespace simple_ros
+
+#endif // simple_ros_QOS_H
@@ -0,0 +1,42 @@
+// rate.h
+// 固定频率循环辅助类，类似 ros::Rate
+
+#ifndef simple_ros_RATE_H
+#define simple_ros_RATE_H
+
+namespace simple_ros {
+
+/**
+ * @brief 按固定频率休眠，时间以 Clock 为准（仿真时间下跟随 /clock 推进）
+ *
+ * 第 k 次 sleep 的唤醒时刻为 start + k * period，循环体耗时不会累积漂移；
+ * 若已落后超过一个周期，则从当前时刻重新对齐。
+ */
+class Rate {
+public:
+    explicit Rate(double frequency);
+
+    /**
+     * @brief 休眠到下一个周期
+     * @return 本周期是否按时完成（循环体耗时未超过周期）
+     */
+    bool sleep();
+
+    // 以当前时刻重新开始计时
+    void reset();
+
+    // 期望周期（秒）
+    double expectedCycleTime() const { return period_; }
+
+    // 上一个周期中循环体实际耗时（秒）
+    double cycleTime() const { return actualCycleTime_; }
+
+private:
+    double period_;
+    double start_;
+    double actualCycleTime_ = 0.0;
+};
+
+} // namespace simple_ros
+
+#endif // simple_ros_RATE_H
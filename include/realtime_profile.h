@@ -0,0 +1,95 @@
+// realtime_profile.h
+// 实时调优配置：按线程角色设置 CPU 亲和性、调度策略/优先级，并锁定进程内存
+
+#ifndef simple_ros_REALTIME_PROFILE_H
+#define simple_ros_REALTIME_PROFILE_H
+
+#include <array>
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+namespace simple_ros {
+
+// 框架创建的线程角色
+enum class ThreadRole {
+    EVENT,     // PollManager 监听/接收主循环
+    RECEIVE,   // PollManager 接收 IO 线程池
+    TIMER,     // 定时器与发布者连接 EventLoop
+    SPIN,      // 执行消息队列回调的 spin 线程
+    IO_URING   // io_uring 数据面线程
+};
+
+constexpr size_t kThreadRoleCount = 5;
+
+enum class SchedPolicy {
+    OTHER,  // 普通分时调度（默认）
+    FIFO,   // SCHED_FIFO
+    RR      // SCHED_RR
+};
+
+// 单个线程角色的设置
+struct ThreadRtSettings {
+    std::vector<int> cpus;               // 允许运行的 CPU，为空表示不修改亲和性
+    SchedPolicy policy = SchedPolicy::OTHER;
+    int priority = 0;                    // FIFO/RR 优先级，1-99
+
+    bool configured() const { return !cpus.empty() || policy != SchedPolicy::OTHER; }
+};
+
+/**
+ * @brief 实时调优配置，须在 SystemManager::init 之前通过 setRealtimeProfile 设置，
+ *        或通过环境变量 SIMPLE_ROS_RT_PROFILE 指定 JSON 配置文件
+ *
+ * 配置格式：
+ * @code
+ * {
+ *   "lock_memory": true,
+ *   "prefault_heap_mb": 64,
+ *   "prefault_stack_kb": 256,
+ *   "threads": {
+ *     "timer": {"cpus": [3], "policy": "fifo", "priority": 85},
+ *     "event": {"cpus": [2], "policy": "fifo", "priority": 80},
+ *     "spin":  {"cpus": [4, 5], "policy": "rr", "priority": 70}
+ *   }
+ * }
+ * @endcode
+ *
+ * FIFO/RR 需要 CAP_SYS_NICE 或足够的 RLIMIT_RTPRIO，mlockall 需要足够的 RLIMIT_MEMLOCK；
+ * 权限不足时记录警告并继续以普通方式运行。
+ */
+struct RealtimeProfile {
+    bool lock_memory = false;       // mlockall(MCL_CURRENT | MCL_FUTURE)
+    size_t prefault_heap = 0;       // 锁定后预先触碰的堆字节数，之后的分配不再缺页
+    size_t prefault_stack = 0;      // 每个线程预先触碰的栈字节数
+    std::array<ThreadRtSettings, kThreadRoleCount> threads;
+
+    ThreadRtSettings& settings(ThreadRole role) { return threads[static_cast<size_t>(role)]; }
+    const ThreadRtSettings& settings(ThreadRole role) const { return threads[static_cast<size_t>(role)]; }
+
+    // 是否有任何需要应用的设置
+    bool enabled() const;
+
+    // 在当前线程上应用 role 对应的亲和性、调度策略与栈预触碰，全部成功返回 true
+    bool applyToCurrentThread(ThreadRole role) const;
+
+    // 锁定进程内存并预触碰堆，lock_memory 为 false 时直接返回 true
+    bool lockMemory() const;
+
+    /**
+     * @brief 从 JSON 解析配置
+     * @param error 解析失败时的原因
+     */
+    static bool fromJson(const nlohmann::json& json, RealtimeProfile* out, std::string* error = nullptr);
+    static bool loadFile(const std::string& path, RealtimeProfile* out, std::string* error = nullptr);
+};
+
+const char* threadRoleName(ThreadRole role);
+
+// 在当前线程上应用设置，role_name 仅用于日志
+bool applyThreadRtSettings(const ThreadRtSettings& settings, const char* role_name);
+
+} // namespace simple_ros
+
+#endif // simple_ros_REALTIME_PROFILE_H
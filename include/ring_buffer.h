@@ -0,0 +1,61 @@
+// ring_buffer.h
+// 固定容量环形缓冲区，写满后覆盖最旧的元素
+
+#ifndef simple_ros_RING_BUFFER_H
+#define simple_ros_RING_BUFFER_H
+
+#include <cstddef>
+#include <vector>
+
+namespace simple_ros {
+
+/**
+ * @brief 固定容量的环形缓冲区
+ *
+ * 存储在构造时一次分配，push_back 为 O(1) 且不再分配内存；写满后覆盖最旧的元素。
+ * 下标 0 为最旧的元素。非线程安全。
+ */
+template <typename T>
+class RingBuffer {
+public:
+    explicit RingBuffer(size_t capacity = 0) : data_(capacity) {}
+
+    void push_back(const T& value) {
+        if (data_.empty()) return;
+        data_[(head_ + size_) % data_.size()] = value;
+        if (size_ < data_.size()) {
+            ++size_;
+        } else {
+            head_ = (head_ + 1) % data_.size();
+        }
+    }
+
+    const T& operator[](size_t i) const { return data_[(head_ + i) % data_.size()]; }
+    const T& front() const { return (*this)[0]; }
+    const T& back() const { return (*this)[size_ - 1]; }
+
+    size_t size() const { return size_; }
+    size_t capacity() const { return data_.size(); }
+    bool empty() const { return size_ == 0; }
+    bool full() const { return size_ == data_.size(); }
+
+    void clear() {
+        head_ = 0;
+        size_ = 0;
+    }
+
+    // 按从旧到新的顺序追加到 out
+    template <typename Container>
+    void copyTo(Container& out) const {
+        for (size_t i = 0; i < size_; ++i) out.push_back((*this)[i]);
+    }
+
+private:
+    std::vector<T> data_;
+    size_t head_ = 0;
+    size_t size_ = 0;
+};
+
+} // namespace simple_ros
+
+#endif // simple_ros_RING_BUFFER_H
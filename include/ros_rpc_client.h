@@ -17,13 +17,15 @@ public:
     bool Subscribe(const std::string& topic_name,
                    const std::string& msg_type,
                    const NodeInfo& node_info,
-                   SubscribeResponse* response);
+                   SubscribeResponse* response,
+                   const QoSPolicy& qos = QoSPolicy());
                     
     // 调用RegisterPublisher RPC
     bool RegisterPublisher(const std::string& topic_name,
                           const std::string& msg_type,
                           const NodeInfo& node_info,
-                          RegisterPublisherResponse* response);
+                          RegisterPublisherResponse* response,
+                          const QoSPolicy& qos = QoSPolicy());
 
     bool Unsubscribe(const std::string& topic_name,
                      const std::string& msg_type,
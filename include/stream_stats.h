@@ -0,0 +1,90 @@
+// stream_stats.h
+// 可视化桥接中单个话题的代价统计：输入输出消息数与字节数、丢弃数与转换耗时
+
+#ifndef simple_ros_STREAM_STATS_H
+#define simple_ros_STREAM_STATS_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include "latency_histogram.h"
+
+namespace simple_ros {
+
+// 单个输出 channel 的累计计数
+struct ChannelCounter {
+    std::atomic<uint64_t> messages{0};
+    std::atomic<uint64_t> bytes{0};   // 编码后写入 channel 的字节数
+
+    void add(size_t n) {
+        messages.fetch_add(1, std::memory_order_relaxed);
+        bytes.fetch_add(n, std::memory_order_relaxed);
+    }
+};
+
+/**
+ * @brief 一个桥接话题的累计统计
+ *
+ * 接收线程记录收到、限速丢弃与分发的消息，转换线程记录转换结果、输入字节与各 channel 的输出；
+ * 统计线程定期取快照。计数均为原子变量，转换耗时直方图由互斥锁保护
+ * （只有该话题的转换线程与统计线程访问，几乎没有竞争）。
+ */
+class StreamStats {
+public:
+    struct Snapshot {
+        uint64_t received = 0;       // 订阅回调收到的消息
+        uint64_t throttled = 0;      // 限速丢弃的消息
+        uint64_t dispatched = 0;     // 提交到转换线程的消息
+        uint64_t dropped = 0;        // 转换队列满时丢弃的消息
+        uint64_t converted = 0;      // 转换完成的消息
+        uint64_t failed = 0;         // 转换时出错的消息
+        uint64_t input_bytes = 0;    // 转换前的序列化字节数
+        uint64_t raw_messages = 0;   // protobuf/JSON channel 输出
+        uint64_t raw_bytes = 0;
+        uint64_t scene_messages = 0; // scene channel 输出
+        uint64_t scene_bytes = 0;
+        LatencyHistogram conversion; // 上次 takeSnapshot 以来的转换耗时
+
+        // 已分发、尚未转换、丢弃或失败的消息
+        uint64_t pending() const {
+            uint64_t done = converted + dropped + failed;
+            return dispatched > done ? dispatched - done : 0;
+        }
+    };
+
+    // 接收线程
+    void onReceived() { received_.fetch_add(1, std::memory_order_relaxed); }
+    void onThrottled(uint64_t count) { throttled_.fetch_add(count, std::memory_order_relaxed); }
+    void onDispatched() { dispatched_.fetch_add(1, std::memory_order_relaxed); }
+    void onDropped() { dropped_.fetch_add(1, std::memory_order_relaxed); }
+
+    // 转换线程：一条消息转换完成，seconds 为转换耗时，input_bytes 为转换前的序列化大小
+    void onConverted(double seconds, size_t input_bytes);
+    // 转换线程：一条消息转换出错
+    void onFailed() { failed_.fetch_add(1, std::memory_order_release); }
+
+    ChannelCounter raw_out;
+    ChannelCounter scene_out;
+
+    // 取快照；takeSnapshot 同时清空转换耗时直方图，使其只反映一个统计周期
+    Snapshot snapshot() const;
+    Snapshot takeSnapshot();
+
+private:
+    void fillCounters(Snapshot* out) const;
+
+    std::atomic<uint64_t> received_{0};
+    std::atomic<uint64_t> throttled_{0};
+    std::atomic<uint64_t> dispatched_{0};
+    std::atomic<uint64_t> dropped_{0};
+    std::atomic<uint64_t> converted_{0};
+    std::atomic<uint64_t> failed_{0};
+    std::atomic<uint64_t> input_bytes_{0};
+    mutable std::mutex hist_mutex_;
+    LatencyHistogram conversion_;
+};
+
+} // namespace simple_ros
+
+#endif // simple_ros_STREAM_STATS_H
@@ -7,6 +7,8 @@
 #include "global_init.h"  // 添加这个以获取SystemManager
 #include "message_queue.h"
 #include "ros_rpc.pb.h"  // 添加protobuf头文件
+#include "qos.h"
+#include "callback_group.h"
 
 // 前向声明
 class SystemManager;
@@ -28,6 +30,18 @@ public:
                uint32_t queue_size, 
                MessageQueue::Callback callback);
 
+    /**
+     * @brief 按 QoS 配置创建订阅，depth 作为队列大小，lifespan/deadline 作用于接收队列
+     * @param topic 主题名称
+     * @param qos QoS 配置
+     * @param callback 回调函数
+     * @param group 回调组，为空时使用消息队列的默认组
+     */
+    Subscriber(const std::string& topic,
+               const simple_ros::QoSProfile& qos,
+               MessageQueue::Callback callback,
+               simple_ros::CallbackGroupPtr group = nullptr);
+
     /**
      * @brief 类型安全的模板构造函数
      * @tparam MsgType 消息类型
@@ -40,6 +54,17 @@ public:
                 uint32_t queue_size, 
                 std::function<void(const std::shared_ptr<MsgType>&)> typed_callback);
 
+    /**
+     * @brief 类型安全的模板构造函数（QoS 版本）
+     */
+    template<typename MsgType>
+    Subscriber(const std::string& topic,
+                const simple_ros::QoSProfile& qos,
+                std::function<void(const std::shared_ptr<MsgType>&)> typed_callback,
+                simple_ros::CallbackGroupPtr group = nullptr);
+
+    const simple_ros::QoSProfile& qos() const { return qos_; }
+
     /**
      * @brief 析构函数，自动取消订阅
      */
@@ -54,12 +79,18 @@ public:
     Subscriber& operator=(Subscriber&&) noexcept = delete;
 
 private:
+    // 向消息队列注册主题和回调
+    void attach();
+
     std::string topic_;                 // 主题名称
     uint32_t queue_size_;               // 队列大小
     MessageQueue::Callback callback_;   // 回调函数
     std::weak_ptr<MessageQueue> msg_queue_; // 弱引用，避免循环引用
     std::string msg_type_;              // 消息类型
     simple_ros::NodeInfo node_info_;      // 节点信息
+    simple_ros::QoSProfile qos_;          // QoS 配置
+    simple_ros::CallbackGroupPtr group_;  // 回调组
+    uint64_t subscriberId_ = 0;           // 消息队列中的订阅者 id
 };
 
 
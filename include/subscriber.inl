@@ -7,17 +7,42 @@ template<typename MsgType>
 Subscriber::Subscriber(const std::string& topic,
                        uint32_t queue_size,
                        std::function<void(const std::shared_ptr<MsgType>&)> typed_callback)
-    : topic_(topic), queue_size_(queue_size)
+    : Subscriber(topic, simple_ros::QoSProfile(queue_size), std::move(typed_callback))
 {
-    // 类型擦除回调，直接使用 MsgType 指针，无需 dynamic_pointer_cast
+}
+
+template<typename MsgType>
+Subscriber::Subscriber(const std::string& topic,
+                       const simple_ros::QoSProfile& qos,
+                       std::function<void(const std::shared_ptr<MsgType>&)> typed_callback,
+                       simple_ros::CallbackGroupPtr group)
+    : topic_(topic), queue_size_(qos.depth), qos_(qos), group_(std::move(group))
+{
+    // 注册具体类型，网络收到的消息直接以 MsgType 创建（可在 Arena 上），回调无需再拷贝
+    MsgFactory::instance().registerMessage<MsgType>();
+
+    // 类型擦除回调
     callback_ = [typed_callback](const std::shared_ptr<google::protobuf::Message>& msg_base) {
-        // 创建 MsgType 实例
+        // 进程内发布的消息本身就是 MsgType，直接共享，不再序列化
+        if (auto typed = std::dynamic_pointer_cast<MsgType>(msg_base)) {
+            typed_callback(typed);
+            return;
+        }
+
+        // 类型未注册时网络消息由 DynamicMessageFactory 创建，创建 MsgType 实例
         auto typed_msg = std::make_shared<MsgType>();
         
-        // 将收到的 Message 数据序列化后再解析到具体类型
-        std::string serialized;
-        msg_base->SerializeToString(&serialized);
-        if (!typed_msg->ParseFromString(serialized)) {
+        // 将收到的 Message 数据序列化后再解析到具体类型；未反序列化的消息直接解析其数据
+        bool parsed;
+        if (msg_base->GetDescriptor() == simple_ros::SerializedMessage::descriptor()) {
+            parsed = typed_msg->ParseFromString(
+                static_cast<const simple_ros::SerializedMessage&>(*msg_base).data());
+        } else {
+            std::string serialized;
+            msg_base->SerializeToString(&serialized);
+            parsed = typed_msg->ParseFromString(serialized);
+        }
+        if (!parsed) {
             LOG_ERROR << "Failed to parse message to " << MsgType::descriptor()->full_name();
             return;
         }
@@ -25,22 +50,7 @@ Subscriber::Subscriber(const std::string& topic,
         typed_callback(typed_msg);
     };
 
-
-    // 获取消息队列
-    auto msg_queue = SystemManager::instance().getMessageQueue();
-    if (!msg_queue) {
-        LOG_ERROR << "MessageQueue not initialized when creating Subscriber for topic: " << topic;
-        return;
-    }
-
-    msg_queue_ = msg_queue;
-
-    // 注册 Topic
-    msg_queue->registerTopic(topic);
-    msg_queue->setTopicMaxQueueSize(topic, queue_size);
-
-    // 添加订阅者回调
-    msg_queue->addSubscriber(topic, callback_);
+    attach();
 
     LOG_INFO << "Subscriber created for topic: " << topic
              << ", message type: " << MsgType::descriptor()->full_name();
@@ -6,6 +6,7 @@
 #include <string>
 
 #include "node_handle.h"   // NodeHandle & Subscriber
+#include "qos.h"
 #include "msg_factory.h"   // MsgFactory
 #include "example.pb.h"
 #include "marker.pb.h"
@@ -19,6 +20,18 @@ public:
     template<typename MsgType>
     void registerHandler();
 
+    /**
+     * @brief 通用订阅（Foxglove 桥接、rostopic echo）使用的 QoS
+     *
+     * 尽力而为 + VOLATILE，对发布者不提出任何要求，与 BEST_EFFORT（sensorData/UDP）
+     * 和锁存话题的发布者都兼容；默认的 RELIABLE 订阅会被 Master 判为不兼容而收不到消息。
+     */
+    static simple_ros::QoSProfile genericQoS() {
+        simple_ros::QoSProfile qos(10);
+        qos.bestEffort();
+        return qos;
+    }
+
     // 创建订阅（带默认回调）
     std::shared_ptr<Subscriber> createSubscription(NodeHandle& nh,
                                                    const std::string& topic_name,
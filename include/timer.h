@@ -6,23 +6,43 @@
 
 #include <functional>
 #include <memory>
-#include "muduo/net/TimerId.h"
 #include "muduo/net/EventLoop.h"
+#include "latency_histogram.h"
 #include <cmath>
 
 namespace simple_ros {
 
 // TimerEvent类，类似于ROS的TimerEvent，包含定时器事件信息
 struct TimerEvent {
-    double current_real;    // 当前时间
-    double last_real;       // 上一次触发时间
-    double expected_real;   // 期望触发时间
-    int32_t last_duration;  // 上一次回调执行时间（毫秒）
+    double current_real;     // 当前时间（Clock 时间，仿真模式下为仿真时间）
+    double last_real;        // 上一次触发时间
+    double expected_real;    // 本次期望触发时间（绝对截止时间）
+    int32_t last_duration;   // 上一次回调执行时间（毫秒）
+    double jitter;           // 实际触发时间与期望时间之差（秒）
+    uint32_t overruns;       // 本次触发前新错过的周期数（CATCH_UP 补齐触发时不重复计入）
+    uint64_t total_overruns; // 累计错过的周期数
 };
 
 // 定时器回调类型
 typedef std::function<void(const TimerEvent&)> TimerCallback;
 
+// 回调派发器：接收一个待执行的闭包，决定在哪个线程执行（如投递到 MessageQueue）
+typedef std::function<void(std::function<void()>)> TimerDispatcher;
+
+// 错过周期时的处理策略
+enum class OverrunPolicy {
+    SKIP,      // 跳过错过的周期，下一次对齐到之后最近的截止时间（默认，适合控制回路）
+    CATCH_UP   // 逐个补齐错过的周期，保证回调次数（适合积分/计数类任务）
+};
+
+/**
+ * @brief 基于 timerfd(CLOCK_MONOTONIC) 的绝对截止时间定时器
+ *
+ * 第 k 次触发的期望时间为 start + k * period，回调执行时间与调度延迟不会累积漂移。
+ * 每个定时器记录触发抖动的直方图。定时器须在其 EventLoop 退出前销毁。
+ * 设置派发器后回调不在 EventLoop 线程中执行，而是交给派发器（见 setDispatcher）。
+ * 创建时 Clock 处于仿真模式的定时器不使用 timerfd，而是随仿真时间推进触发。
+ */
 class Timer {
 public:
     /**
@@ -60,7 +80,7 @@ public:
     void pause();
 
     /**
-     * @brief 恢复定时器
+     * @brief 恢复定时器，剩余时间从暂停时刻保留，之后的截止时间以恢复时刻为基准
      */
     void resume();
 
@@ -82,22 +102,38 @@ public:
      */
     void setPeriod(double period);
 
-private:
     /**
-     * @brief 内部回调函数，会调用用户提供的回调函数
+     * @brief 设置错过周期时的处理策略，默认 SKIP
      */
-    void internalCallback();
-
-    muduo::net::EventLoop* loop_;    // 事件循环
-    double period_;                  // 定时器周期（秒）
-    TimerCallback callback_;         // 用户回调函数
-    muduo::net::TimerId timerId_;    // muduo定时器ID
-    bool isRunning_;                 // 定时器是否运行
-    bool isOneShot_;                 // 是否为一次性定时器
-    bool isPaused_;                  // 是否暂停
-    TimerEvent lastEvent_;           // 上一次事件信息
+    void setOverrunPolicy(OverrunPolicy policy);
+    OverrunPolicy getOverrunPolicy() const;
+
+    /**
+     * @brief 设置回调派发器，须在 start 之前调用
+     *
+     * 为空时回调直接在 EventLoop 线程中执行。jitter 仍在 timerfd 触发时测量；
+     * stop 之后尚未执行的已派发回调会被丢弃。
+     */
+    void setDispatcher(const TimerDispatcher& dispatcher);
+
+    /**
+     * @brief 获取触发抖动直方图的快照
+     */
+    LatencyHistogram getLatencyHistogram() const;
+
+    /**
+     * @brief 获取累计错过的周期数
+     */
+    uint64_t getOverrunCount() const;
+
+private:
+    struct State;  // 与 EventLoop 中注册的 Channel 共享生命周期
+
+    void arm();
+
+    std::shared_ptr<State> state_;
 };
 
 } // namespace simple_ros
 
-#endif // simple_ros_TIMER_H
\ No newline at end of file
+#endif // simple_ros_TIMER_H
@@ -0,0 +1,133 @@
+// timing_wheel.h
+// 分层时间轮：大量超时/看门狗定时器共用一个 timerfd
+
+#ifndef simple_ros_TIMING_WHEEL_H
+#define simple_ros_TIMING_WHEEL_H
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "muduo/net/EventLoop.h"
+#include "muduo/net/Channel.h"
+
+namespace simple_ros {
+
+struct TimingWheelOptions {
+    double resolution = 0.001;  // tick 长度（秒）
+    int slot_bits = 8;          // 每层 2^slot_bits 个槽
+    int levels = 4;             // 层数，可表示 2^(slot_bits*levels) 个 tick
+};
+
+/**
+ * @brief 分层时间轮
+ *
+ * 时间按 resolution 离散为 tick，第 L 层每个槽覆盖 2^(slot_bits*L) 个 tick，
+ * 远期定时器随时间推进逐层下沉（cascade）。schedule/cancel 为 O(1)，与定时器数量无关；
+ * 整个时间轮只使用一个周期性 timerfd，没有定时器时停止 tick。
+ *
+ * 到期精度为一个 tick：回调在截止时间之后的第一个 tick 执行。
+ * 周期定时器按 tick 累加截止时间，不会漂移。
+ * 回调在 EventLoop 线程中执行且不持有内部锁，可以在回调中 schedule/cancel；
+ * 同一 tick 中已经到期的回调不受其他回调中 cancel 的影响。
+ */
+class TimingWheel {
+public:
+    using Callback = std::function<void()>;
+    using TimerId = uint64_t;
+    static constexpr TimerId kInvalidTimer = 0;
+
+    using Options = TimingWheelOptions;
+
+    /**
+     * @param loop 驱动 tick 的事件循环；为空时不创建 timerfd，只能通过 advance 手动推进
+     */
+    explicit TimingWheel(muduo::net::EventLoop* loop, const Options& options = Options());
+    ~TimingWheel();
+
+    /**
+     * @brief 从 EventLoop 注销并停止自动 tick，之后只能通过 advance 推进
+     *
+     * 须在 EventLoop 退出之前调用（析构时自动调用），之后析构不再访问 EventLoop。
+     */
+    void detach();
+
+    TimingWheel(const TimingWheel&) = delete;
+    TimingWheel& operator=(const TimingWheel&) = delete;
+
+    /**
+     * @brief 添加定时器，可在任意线程调用
+     * @param delay 首次触发延迟（秒）
+     * @param cb 回调
+     * @param period 周期（秒），0 表示一次性
+     * @return 定时器 id，用于 cancel
+     */
+    TimerId schedule(double delay, Callback cb, double period = 0.0);
+
+    /**
+     * @brief 取消定时器
+     * @return false 表示定时器不存在（已触发的一次性定时器或已取消）
+     */
+    bool cancel(TimerId id);
+
+    // 活跃定时器数
+    size_t size() const;
+
+    double resolution() const { return resolution_; }
+    uint64_t currentTick() const;
+
+    /**
+     * @brief 手动推进 ticks 个 tick 并执行到期回调
+     * @return 执行的回调数
+     */
+    size_t advance(uint64_t ticks);
+
+private:
+    static constexpr uint32_t kNil = UINT32_MAX;
+
+    struct Node {
+        uint64_t expire = 0;        // 到期 tick
+        uint64_t period = 0;        // 周期（tick），0 表示一次性
+        Callback cb;
+        uint32_t prev = kNil;
+        uint32_t next = kNil;
+        uint32_t slot = kNil;       // 所在槽（level * slots + index），kNil 表示未使用
+        uint32_t generation = 0;    // 槽位复用后旧 id 失效
+    };
+
+    uint64_t ticksFor(double seconds) const;
+    uint64_t realTick() const;
+    uint32_t allocNode();
+    void freeNode(uint32_t idx);
+    // 按到期时间放入对应层的槽，earliest 为允许的最早 tick
+    void link(uint32_t idx, uint64_t earliest);
+    void unlink(uint32_t idx);
+    void cascade(int level, uint64_t index);
+    // 推进一个 tick，把到期的回调追加到 fired；调用方持有 mutex_
+    void tickLocked(std::vector<Callback>* fired);
+    void armLocked(bool on);
+    void handleRead();
+
+    muduo::net::EventLoop* loop_;
+    double resolution_;
+    int slotBits_;
+    int levels_;
+    uint64_t slotMask_;
+
+    mutable std::mutex mutex_;
+    uint64_t current_ = 0;                  // 已处理到的 tick
+    int64_t baseNanos_ = 0;                 // tick 0 对应的 CLOCK_MONOTONIC 时间
+    std::vector<uint32_t> heads_;           // 每个槽的链表头
+    std::vector<Node> nodes_;
+    std::vector<uint32_t> freeList_;
+    size_t active_ = 0;
+    bool armed_ = false;
+
+    int timerfd_ = -1;
+    std::unique_ptr<muduo::net::Channel> channel_;
+};
+
+} // namespace simple_ros
+
+#endif // simple_ros_TIMING_WHEEL_H
@@ -0,0 +1,95 @@
+// trajectory_buffer.h
+// 轨迹点缓存：滑动窗口用环形缓冲区，永久轨迹按分段增量发送，旧分段可做 Douglas–Peucker 简化
+
+#ifndef simple_ros_TRAJECTORY_BUFFER_H
+#define simple_ros_TRAJECTORY_BUFFER_H
+
+#include <cstdint>
+#include <deque>
+#include <vector>
+#include "ring_buffer.h"
+
+namespace simple_ros {
+
+struct TrajectoryPoint {
+    double x = 0.0;
+    double y = 0.0;
+    double z = 0.0;
+};
+
+/**
+ * @brief 单条轨迹的点缓存
+ *
+ * 窗口模式（window > 0）：只保留最近 window 个点，存放在固定容量的环形缓冲区中，每次发送整个窗口。
+ * 永久模式（window == 0）：点先进入尾段，尾段满 chunk_size 个点时封存为一个分段，
+ * 封存的分段只需发送一次，之后每次只发送尾段；下一段以上一段的末点开头，保证折线连续。
+ * 保存的点数超过 max_points 时淘汰最旧的分段。封存时可按 simplify_tolerance 简化分段，
+ * 最新的尾段始终保持完整精度。非线程安全。
+ */
+class TrajectoryBuffer {
+public:
+    struct Options {
+        size_t chunk_size = 256;          // 永久轨迹每段的点数（至少 2）
+        size_t max_points = 10000;        // 永久轨迹保存的最大点数（按简化后的点数计）
+        double simplify_tolerance = 0.0;  // 封存分段时的简化容差（米），0 表示不简化
+    };
+
+    struct Chunk {
+        uint64_t seq = 0;                    // 分段序号，单调递增
+        std::vector<TrajectoryPoint> points;
+        bool sent = false;
+    };
+
+    TrajectoryBuffer(size_t window, const Options& options);
+
+    /**
+     * @brief Marker::lifetime 对应的窗口大小
+     *
+     * lifetime > 0 向上取整为点数（0 < lifetime < 1 只保留最新的一个点，不会落入永久模式），
+     * == 0 只保留最新的一个点，< 0 返回 0 表示永久保留。
+     */
+    static size_t windowForLifetime(double lifetime);
+
+    void append(const TrajectoryPoint& point);
+
+    size_t window() const { return window_; }
+    bool windowed() const { return window_ > 0; }
+
+    // 每次都需发送的部分：窗口模式下为整个窗口，永久模式下为未封存的尾段
+    const std::vector<TrajectoryPoint>& tail();
+
+    /**
+     * @brief 取出自上次调用以来新封存（尚未发送）的分段与已淘汰的分段序号
+     *
+     * 分段指针在下一次 append 之前有效；只报告已经发送过的被淘汰分段。
+     */
+    void takeChanges(std::vector<const Chunk*>* sealed, std::vector<uint64_t>* evicted);
+
+    // 新客户端加入后调用：所有保存的分段在下一次 takeChanges 时重新报告
+    void resendAll();
+
+    // 当前保存的分段中已经发送过的序号
+    std::vector<uint64_t> sentChunks() const;
+
+    // 保存的点数（分段与尾段之和）
+    size_t pointCount() const;
+
+    // Douglas–Peucker 折线简化，保留首尾点及所有偏离超过 tolerance 的点
+    static std::vector<TrajectoryPoint> simplify(const std::vector<TrajectoryPoint>& points, double tolerance);
+
+private:
+    void seal();
+
+    size_t window_;
+    Options options_;
+    RingBuffer<TrajectoryPoint> ring_;   // 窗口模式的点
+    std::vector<TrajectoryPoint> tail_;  // 永久模式的尾段；窗口模式下为发送用的线性副本
+    std::deque<Chunk> chunks_;
+    size_t chunk_points_ = 0;
+    uint64_t next_seq_ = 0;
+    std::vector<uint64_t> evicted_;
+};
+
+} // namespace simple_ros
+
+#endif // simple_ros_TRAJECTORY_BUFFER_H
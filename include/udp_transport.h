@@ -0,0 +1,156 @@
+#pragma once
+#include <muduo/net/EventLoop.h>
+#include <muduo/net/Channel.h>
+#include <muduo/net/InetAddress.h>
+#include <muduo/base/Timestamp.h>
+#include <netinet/in.h>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// ================= UDP 数据报格式 =================
+// 每个数据报 = 分片头(20B，网络字节序) + 分片负载
+//   magic(4B) + stream_id(4B) + seq(4B) + frag_index(2B) + frag_count(2B) + total_len(4B)
+// 负载拼接后即为 wire_format.h 中定义的完整消息帧。
+struct UdpFragmentHeader {
+    uint32_t stream_id;   // 发送端流 ID（每个发布者随机生成，区分进程重启）
+    uint32_t seq;         // 消息序号，同一流内单调递增
+    uint16_t frag_index;  // 分片下标
+    uint16_t frag_count;  // 分片总数
+    uint32_t total_len;   // 完整消息帧长度
+};
+
+namespace udp {
+
+constexpr uint32_t kMagic = 0x53525544;       // "SRUD"
+constexpr size_t kHeaderSize = 20;
+constexpr size_t kMaxFragmentPayload = 1400;  // 以太网 MTU 1500 - IP/UDP 头，留出余量
+constexpr size_t kMaxMessageSize = 64 * 1024 * 1024;
+
+// 将完整消息帧切分为若干数据报
+std::vector<std::string> fragment(uint32_t stream_id, uint32_t seq, const std::string& frame,
+                                  size_t max_payload = kMaxFragmentPayload);
+
+// 解析分片头，校验失败返回 false
+bool parseHeader(const char* data, size_t len, UdpFragmentHeader* header);
+
+} // namespace udp
+
+/**
+ * @brief UDP 分片重组器
+ *
+ * 每个发送流只保留一条正在重组的消息：
+ * - 序号不大于已交付序号的分片视为过期，直接丢弃；
+ * - 收到更新序号的分片时，未完成的旧消息整体丢弃；
+ * - 不重传、不排序，保证最新数据尽快交付；
+ * - 分片数须与消息长度、分片大小一致，且消息不超过上限，否则在分配重组槽位之前丢弃。
+ */
+class UdpReassembler {
+public:
+    /**
+     * @param max_message_size 可重组的最大消息长度
+     * @param max_payload 发送端每个分片的数据长度（最后一个分片除外）
+     */
+    explicit UdpReassembler(size_t max_message_size = udp::kMaxMessageSize,
+                            size_t max_payload = udp::kMaxFragmentPayload)
+        : max_message_size_(max_message_size), max_payload_(max_payload) {}
+
+    struct Stats {
+        uint64_t delivered = 0;          // 已交付的完整消息
+        uint64_t dropped_stale = 0;      // 过期/乱序分片
+        uint64_t dropped_incomplete = 0; // 被更新消息顶替的不完整消息
+        uint64_t dropped_invalid = 0;    // 格式错误的数据报
+    };
+
+    /**
+     * @param source 发送端标识（ip:port）
+     * @param frame 消息完整时写入重组后的帧
+     * @return 是否得到一条完整消息
+     */
+    bool onDatagram(const std::string& source, const char* data, size_t len, std::string* frame);
+
+    const Stats& stats() const { return stats_; }
+
+private:
+    struct StreamState {
+        bool has_delivered = false;
+        uint32_t last_delivered = 0;
+        bool assembling = false;
+        uint32_t seq = 0;
+        uint16_t frag_count = 0;
+        uint16_t received = 0;
+        uint32_t total_len = 0;
+        std::vector<std::string> fragments;
+        std::chrono::steady_clock::time_point last_active;
+    };
+
+    // 序号比较（考虑回绕）
+    static bool seqNewer(uint32_t a, uint32_t b) { return static_cast<int32_t>(a - b) > 0; }
+    void purgeIdleStreams(std::chrono::steady_clock::time_point now);
+
+    size_t max_message_size_;
+    size_t max_payload_;
+    std::unordered_map<std::string, StreamState> streams_;
+    Stats stats_;
+};
+
+/**
+ * @brief UDP 接收端，挂在 PollManager 的 EventLoop 上，与 TCP 监听同一端口
+ */
+class UdpReceiver {
+public:
+    using FrameCallback = std::function<void(const std::string& frame)>;
+
+    UdpReceiver(muduo::net::EventLoop* loop, const muduo::net::InetAddress& listenAddr);
+    ~UdpReceiver();
+
+    // 绑定端口并开始读取，失败返回 false（此时节点仅使用 TCP）
+    bool start();
+    void setFrameCallback(FrameCallback cb) { frameCallback_ = std::move(cb); }
+    const UdpReassembler::Stats& stats() const { return reassembler_.stats(); }
+
+private:
+    void handleRead(muduo::Timestamp receiveTime);
+
+    muduo::net::EventLoop* loop_;
+    muduo::net::InetAddress listenAddr_;
+    int fd_ = -1;
+    std::unique_ptr<muduo::net::Channel> channel_;
+    UdpReassembler reassembler_;
+    FrameCallback frameCallback_;
+    std::vector<char> recvBuf_;
+};
+
+/**
+ * @brief UDP 发送端，每个 BEST_EFFORT 发布者持有一个
+ *
+ * 套接字非阻塞，内核发送缓冲区满时直接丢弃，不在用户态排队。
+ */
+class UdpSender {
+public:
+    UdpSender();
+    ~UdpSender();
+
+    bool valid() const { return fd_ >= 0; }
+
+    // 分配下一个序号并发送到所有目标，返回成功发送的目标数
+    size_t send(const std::string& frame, const std::vector<sockaddr_in>& targets);
+
+    // 向单个目标发送（锁存补发等），同样分配新序号
+    bool sendTo(const std::string& frame, const sockaddr_in& target);
+
+    static sockaddr_in makeAddr(const std::string& ip, uint16_t port);
+
+private:
+    bool sendDatagrams(const std::vector<std::string>& datagrams, const sockaddr_in& target);
+
+    int fd_ = -1;
+    uint32_t streamId_;
+    std::atomic<uint32_t> nextSeq_{1};
+};
@@ -0,0 +1,92 @@
+#pragma once
+#include <muduo/net/EventLoop.h>
+#include <muduo/net/Channel.h>
+#include <muduo/net/TcpConnection.h>
+#include <muduo/net/EventLoopThreadPool.h>
+#include <muduo/base/Timestamp.h>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+// ================= Unix 域套接字传输 =================
+// 同机节点之间绕过 TCP/IP 协议栈。连接建立后复用 muduo::net::TcpConnection
+// 处理缓冲与读写，帧格式与 TCP 完全相同，PollManager 的解析逻辑无需区分来源。
+//
+// 路径约定：以 '@' 开头表示抽象命名空间（不在文件系统中留下文件），
+// 否则为普通文件路径。
+
+namespace unix_transport {
+
+// 本机标识，用于判断对端是否与本节点位于同一主机
+std::string localHostId();
+
+// 节点默认的 Unix 套接字路径（抽象命名空间）
+std::string defaultSocketPath(int port);
+
+} // namespace unix_transport
+
+/**
+ * @brief Unix 域套接字服务端，接口与 muduo::net::TcpServer 保持一致
+ */
+class UnixServer {
+public:
+    UnixServer(muduo::net::EventLoop* loop, const std::string& path, const std::string& name);
+    ~UnixServer();
+
+    // 绑定并开始监听，失败返回 false（对端会回退到 TCP）
+    bool start();
+
+    void setConnectionCallback(const muduo::net::ConnectionCallback& cb) { connectionCallback_ = cb; }
+    void setMessageCallback(const muduo::net::MessageCallback& cb) { messageCallback_ = cb; }
+
+    // 新连接按轮询分配到线程池中的 EventLoop，未设置时全部在 loop 中处理
+    void setThreadPool(std::shared_ptr<muduo::net::EventLoopThreadPool> pool) { threadPool_ = std::move(pool); }
+
+    const std::string& path() const { return path_; }
+
+private:
+    void handleAccept(muduo::Timestamp receiveTime);
+    void removeConnection(const muduo::net::TcpConnectionPtr& conn);
+    void removeConnectionInLoop(const muduo::net::TcpConnectionPtr& conn);
+
+    muduo::net::EventLoop* loop_;
+    std::string path_;
+    std::string name_;
+    int listenFd_ = -1;
+    int nextConnId_ = 1;
+    std::unique_ptr<muduo::net::Channel> channel_;
+    std::shared_ptr<muduo::net::EventLoopThreadPool> threadPool_;
+    std::unordered_map<std::string, muduo::net::TcpConnectionPtr> connections_; // 仅在 loop_ 中访问
+    muduo::net::ConnectionCallback connectionCallback_;
+    muduo::net::MessageCallback messageCallback_;
+};
+
+/**
+ * @brief Unix 域套接字客户端，接口与 muduo::net::TcpClient 保持一致
+ *
+ * 本机连接无需等待握手，connect() 同步完成，失败时调用方可立即回退到 TCP。
+ */
+class UnixClient {
+public:
+    UnixClient(muduo::net::EventLoop* loop, const std::string& path, const std::string& name);
+    ~UnixClient();
+
+    bool connect();
+
+    void setConnectionCallback(const muduo::net::ConnectionCallback& cb) { connectionCallback_ = cb; }
+    void setMessageCallback(const muduo::net::MessageCallback& cb) { messageCallback_ = cb; }
+
+    muduo::net::TcpConnectionPtr connection() const;
+
+private:
+    void removeConnection(const muduo::net::TcpConnectionPtr& conn);
+
+    muduo::net::EventLoop* loop_;
+    std::string path_;
+    std::string name_;
+    mutable std::mutex mutex_;
+    muduo::net::TcpConnectionPtr connection_;
+    muduo::net::ConnectionCallback connectionCallback_;
+    muduo::net::MessageCallback messageCallback_;
+};
@@ -0,0 +1,64 @@
+#pragma once
+#include <arpa/inet.h> // htons, htonl
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+// 节点间消息帧格式（TCP 与 UDP 共用）：
+// topic_name_len(2B) + topic_name + msg_name_len(2B) + msg_name + msg_data_len(4B) + msg_data
+namespace wire {
+
+inline size_t frameSize(size_t topic_len, size_t msg_name_len, size_t data_len) {
+    return 2 + topic_len + 2 + msg_name_len + 4 + data_len;
+}
+
+// 按协议格式构建完整消息帧
+inline std::string encodeFrame(const std::string& topic, const std::string& msg_name, const std::string& data) {
+    std::string buffer;
+    buffer.reserve(frameSize(topic.size(), msg_name.size(), data.size()));
+
+    uint16_t topic_len = htons(static_cast<uint16_t>(topic.size()));
+    buffer.append(reinterpret_cast<const char*>(&topic_len), sizeof(topic_len));
+    buffer.append(topic);
+
+    uint16_t msg_name_len = htons(static_cast<uint16_t>(msg_name.size()));
+    buffer.append(reinterpret_cast<const char*>(&msg_name_len), sizeof(msg_name_len));
+    buffer.append(msg_name);
+
+    uint32_t data_len = htonl(static_cast<uint32_t>(data.size()));
+    buffer.append(reinterpret_cast<const char*>(&data_len), sizeof(data_len));
+    buffer.append(data);
+    return buffer;
+}
+
+/**
+ * @brief 从缓冲区头部解析一帧
+ * @return 完整帧的字节数；数据不足一帧时返回 0
+ */
+inline size_t decodeFrame(const char* buf, size_t len,
+                          std::string* topic, std::string* msg_name, std::string* data) {
+    if (len < 2) return 0;
+    uint16_t topic_len;
+    memcpy(&topic_len, buf, 2);
+    topic_len = ntohs(topic_len);
+
+    if (len < 2u + topic_len + 2) return 0;
+    uint16_t msg_name_len;
+    memcpy(&msg_name_len, buf + 2 + topic_len, 2);
+    msg_name_len = ntohs(msg_name_len);
+
+    if (len < 2u + topic_len + 2 + msg_name_len + 4) return 0;
+    uint32_t data_len;
+    memcpy(&data_len, buf + 2 + topic_len + 2 + msg_name_len, 4);
+    data_len = ntohl(data_len);
+
+    size_t total = frameSize(topic_len, msg_name_len, data_len);
+    if (len < total) return 0;
+
+    topic->assign(buf + 2, topic_len);
+    msg_name->assign(buf + 2 + topic_len + 2, msg_name_len);
+    data->assign(buf + 2 + topic_len + 2 + msg_name_len + 4, data_len);
+    return total;
+}
+
+} // namespace wire
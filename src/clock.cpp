@@ -0,0 +1,134 @@
+// clock.cc
+// Clock 的实现
+
+#include "clock.h"
+#include <muduo/base/Logging.h>
+#include <chrono>
+#include <cmath>
+
+namespace simple_ros {
+
+Clock& Clock::instance() {
+    static Clock inst;
+    return inst;
+}
+
+double Clock::now() const {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (type_ == ClockType::SIM) return simTime_;
+    }
+    auto since_epoch = std::chrono::system_clock::now().time_since_epoch();
+    return std::chrono::duration<double>(since_epoch).count();
+}
+
+ClockType Clock::type() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return type_;
+}
+
+void Clock::enableSimTime(double start) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        type_ = ClockType::SIM;
+        simTime_ = start;
+    }
+    LOG_INFO << "Clock switched to simulated time, start=" << start;
+    cond_.notify_all();
+}
+
+void Clock::disableSimTime() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        type_ = ClockType::WALL;
+    }
+    LOG_INFO << "Clock switched to wall time";
+    cond_.notify_all();
+}
+
+void Clock::setSimTime(double t) {
+    std::vector<TimeListener> listeners;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (type_ != ClockType::SIM) {
+            LOG_WARN << "setSimTime ignored: clock is not in simulated mode";
+            return;
+        }
+        if (t < simTime_) {
+            LOG_WARN << "Simulated time moved backwards (" << simTime_ << " -> " << t << "), ignored";
+            return;
+        }
+        simTime_ = t;
+        listeners.reserve(listeners_.size());
+        for (const auto& l : listeners_) listeners.push_back(l.second);
+    }
+    cond_.notify_all();
+
+    // 监听回调在锁外执行，允许在回调中读取 now()
+    for (const auto& listener : listeners) {
+        listener(t);
+    }
+}
+
+void Clock::advance(double dt) {
+    setSimTime(now() + dt);
+}
+
+bool Clock::sleepUntil(double t) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    uint64_t gen = interruptGen_;
+    while (interruptGen_ == gen) {
+        if (type_ == ClockType::SIM) {
+            if (simTime_ >= t) return true;
+            cond_.wait(lock);
+        } else {
+            auto since_epoch = std::chrono::system_clock::now().time_since_epoch();
+            double remaining = t - std::chrono::duration<double>(since_epoch).count();
+            if (remaining <= 0) return true;
+            cond_.wait_for(lock, std::chrono::duration<double>(remaining));
+        }
+    }
+    return false;
+}
+
+void Clock::interrupt() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ++interruptGen_;
+    }
+    cond_.notify_all();
+}
+
+uint64_t Clock::addTimeListener(TimeListener listener) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    uint64_t id = nextListenerId_++;
+    listeners_.emplace_back(id, std::move(listener));
+    return id;
+}
+
+void Clock::removeTimeListener(uint64_t id) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto it = listeners_.begin(); it != listeners_.end(); ++it) {
+        if (it->first == id) {
+            listeners_.erase(it);
+            return;
+        }
+    }
+}
+
+void Clock::toMsg(double t, std_msgs::Time* msg) {
+    double sec = std::floor(t);
+    int64_t nanosec = static_cast<int64_t>(std::llround((t - sec) * 1e9));
+    if (nanosec >= 1000000000LL) {
+        sec += 1;
+        nanosec -= 1000000000LL;
+    }
+    msg->set_sec(static_cast<int64_t>(sec));
+    msg->set_nanosec(static_cast<uint32_t>(nanosec));
+}
+
+double Clock::fromMsg(const std_msgs::Time& msg) {
+    return static_cast<double>(msg.sec()) + msg.nanosec() * 1e-9;
+}
+
+} // namespace simple_ros
@@ -0,0 +1,181 @@
+// component_container.cc
+// ComponentRegistry 与 ComponentContainer 的实现
+
+#include "component_container.h"
+#include "node_handle.h"
+#include <muduo/base/Logging.h>
+#include <dlfcn.h>
+#include <algorithm>
+#include <fstream>
+
+namespace simple_ros {
+
+ComponentRegistry& ComponentRegistry::instance() {
+    static ComponentRegistry inst;
+    return inst;
+}
+
+bool ComponentRegistry::add(const std::string& type, Factory factory) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!factories_.emplace(type, std::move(factory)).second) {
+        LOG_WARN << "Component type already registered: " << type;
+        return false;
+    }
+    return true;
+}
+
+std::unique_ptr<Component> ComponentRegistry::create(const std::string& type) const {
+    Factory factory;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = factories_.find(type);
+        if (it == factories_.end()) return nullptr;
+        factory = it->second;
+    }
+    return factory();
+}
+
+bool ComponentRegistry::contains(const std::string& type) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return factories_.count(type) > 0;
+}
+
+std::vector<std::string> ComponentRegistry::types() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<std::string> result;
+    result.reserve(factories_.size());
+    for (const auto& item : factories_) result.push_back(item.first);
+    return result;
+}
+
+ComponentContainer::~ComponentContainer() {
+    unloadAll();
+}
+
+bool ComponentContainer::load(const std::string& type, const std::string& name, const nlohmann::json& params) {
+    if (name.empty()) {
+        LOG_ERROR << "Component of type " << type << " has no name";
+        return false;
+    }
+    if (get(name)) {
+        LOG_ERROR << "Component name already in use: " << name;
+        return false;
+    }
+
+    auto component = ComponentRegistry::instance().create(type);
+    if (!component) {
+        LOG_ERROR << "Unknown component type: " << type;
+        return false;
+    }
+
+    Entry entry;
+    entry.name = name;
+    entry.type = type;
+    entry.nh.reset(new NodeHandle(name));
+    try {
+        component->onInit(*entry.nh, params.is_null() ? nlohmann::json::object() : params);
+    } catch (const std::exception& e) {
+        LOG_ERROR << "Component " << name << " (" << type << ") failed to initialize: " << e.what();
+        component.reset();
+        entry.nh->unsubscribeAll();
+        return false;
+    }
+    entry.component = std::move(component);
+    entries_.push_back(std::move(entry));
+
+    LOG_INFO << "Loaded component " << name << " (" << type << ")";
+    return true;
+}
+
+bool ComponentContainer::unload(const std::string& name) {
+    auto it = std::find_if(entries_.begin(), entries_.end(),
+                           [&name](const Entry& e) { return e.name == name; });
+    if (it == entries_.end()) return false;
+    // 先销毁组件（其发布者/订阅者），再在 master 注销订阅，让其他进程的发布者断开到该节点的连接
+    it->component.reset();
+    it->nh->unsubscribeAll();
+    entries_.erase(it);
+    LOG_INFO << "Unloaded component " << name;
+    return true;
+}
+
+void ComponentContainer::unloadAll() {
+    while (!entries_.empty()) {
+        entries_.back().component.reset();
+        entries_.back().nh->unsubscribeAll();
+        LOG_INFO << "Unloaded component " << entries_.back().name;
+        entries_.pop_back();
+    }
+}
+
+size_t ComponentContainer::loadConfig(const nlohmann::json& config) {
+    if (!config.is_object()) {
+        LOG_ERROR << "Component config must be a JSON object";
+        return 0;
+    }
+
+    if (config.contains("libraries")) {
+        for (const auto& lib : config["libraries"]) {
+            if (lib.is_string()) loadLibrary(lib.get<std::string>());
+        }
+    }
+
+    size_t loaded = 0;
+    if (!config.contains("components") || !config["components"].is_array()) {
+        LOG_WARN << "Component config has no \"components\" array";
+        return 0;
+    }
+    for (const auto& item : config["components"]) {
+        if (!item.is_object() || !item.contains("type") || !item["type"].is_string()) {
+            LOG_ERROR << "Skipping component entry without \"type\": " << item.dump();
+            continue;
+        }
+        std::string type = item["type"].get<std::string>();
+        // 未指定名字时以类型名作为节点名
+        std::string name = item.value("name", type);
+        nlohmann::json params = item.contains("params") ? item["params"] : nlohmann::json::object();
+        if (load(type, name, params)) ++loaded;
+    }
+    return loaded;
+}
+
+size_t ComponentContainer::loadConfigFile(const std::string& path) {
+    std::ifstream in(path);
+    if (!in) {
+        LOG_ERROR << "Cannot open component config: " << path;
+        return 0;
+    }
+    nlohmann::json config = nlohmann::json::parse(in, nullptr, false);
+    if (config.is_discarded()) {
+        LOG_ERROR << "Invalid JSON in component config: " << path;
+        return 0;
+    }
+    return loadConfig(config);
+}
+
+bool ComponentContainer::loadLibrary(const std::string& path) {
+    // 库在进程结束前不卸载，注册的工厂函数始终有效
+    void* handle = ::dlopen(path.c_str(), RTLD_NOW | RTLD_GLOBAL);
+    if (!handle) {
+        LOG_ERROR << "Failed to load component library " << path << ": " << ::dlerror();
+        return false;
+    }
+    LOG_INFO << "Loaded component library " << path;
+    return true;
+}
+
+std::vector<std::string> ComponentContainer::names() const {
+    std::vector<std::string> result;
+    result.reserve(entries_.size());
+    for (const auto& entry : entries_) result.push_back(entry.name);
+    return result;
+}
+
+Component* ComponentContainer::get(const std::string& name) const {
+    for (const auto& entry : entries_) {
+        if (entry.name == name) return entry.component.get();
+    }
+    return nullptr;
+}
+
+} // namespace simple_ros
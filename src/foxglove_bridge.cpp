@@ -1,23 +1,46 @@
 #include "foxglove_bridge.h"
 #include <google/protobuf/descriptor.h>
-#include <google/protobuf/util/json_util.h>
+#include <google/protobuf/descriptor.pb.h>
 #include <nlohmann/json.hpp>
+#include <algorithm>
 #include <chrono>
 #include <thread>
 #include <mutex>
+#include <unordered_set>
 #include <condition_variable>
 #include <muduo/base/Logging.h>
 #include "subscription_handler_registry.h"
+#include "clock.h"
 
 
 
 using json = nlohmann::json;
 
+namespace {
+
+// JSON channel 的输出格式：保留 .proto 字段名并输出默认值，与 JSON Schema 的字段一致
+simple_ros::JsonEncoder::Options bridgeJsonOptions() {
+    simple_ros::JsonEncoder::Options options;
+    options.always_print_primitive_fields = true;
+    options.preserve_proto_field_names = true;
+    return options;
+}
+
+// 转换前的序列化大小：未反序列化的消息即线上字节，否则按 protobuf 计算
+size_t inputBytes(const google::protobuf::Message& msg) {
+    if (msg.GetDescriptor() == simple_ros::SerializedMessage::descriptor()) {
+        return static_cast<const simple_ros::SerializedMessage&>(msg).data().size();
+    }
+    return msg.ByteSizeLong();
+}
+
+} // namespace
+
 FoxgloveBridge::FoxgloveBridge(const std::string& rpc_server_address,
                                const std::string& host,
                                uint16_t port)
     : rpc_server_address_(rpc_server_address), host_(host), port_(port),
-      running_(false) {}
+      running_(false), json_encoder_(bridgeJsonOptions()) {}
 
 FoxgloveBridge::~FoxgloveBridge() {
     stop();
@@ -27,6 +50,13 @@ bool FoxgloveBridge::init() {
     foxglove::WebSocketServerOptions opts;
     opts.host = host_;
     opts.port = port_;
+    // 客户端订阅/取消订阅 channel 时调整对话题的订阅
+    opts.callbacks.onSubscribe = [this](uint64_t channel_id, const foxglove::ClientMetadata& client) {
+        onClientSubscribe(channel_id, client.id, client.sink_id);
+    };
+    opts.callbacks.onUnsubscribe = [this](uint64_t channel_id, const foxglove::ClientMetadata& client) {
+        onClientUnsubscribe(channel_id, client.id);
+    };
     auto server_result = foxglove::WebSocketServer::create(std::move(opts));
     if (!server_result.has_value()) {
         LOG_ERROR << "Failed to create foxglove server: "
@@ -66,6 +96,7 @@ FoxgloveBridge::createOrGetSceneChannel(const std::string& topic_name) {
     auto channel = std::make_shared<foxglove::schemas::SceneUpdateChannel>(
         std::move(channel_res.value()));
     scene_channels_[scene_topic] = channel;
+    registerChannel(channel->id(), topic_name);
     LOG_INFO << "Created SceneUpdateChannel for topic: " << scene_topic;
     return channel;
 }
@@ -77,85 +108,441 @@ bool FoxgloveBridge::start() {
         return false;
     }
 
+    size_t threads = conversion_threads_;
+    if (threads == 0) {
+        threads = std::max<size_t>(1, std::min<size_t>(4, std::thread::hardware_concurrency() / 2));
+    }
+    executor_ = std::make_unique<simple_ros::KeyedExecutor>(threads);
+    last_stats_time_ = std::chrono::steady_clock::now();
+    last_publish_time_ = last_stats_time_;
+
     running_ = true;
+    discovery_thread_ = std::thread(&FoxgloveBridge::discoveryLoop, this);
     poll_thread_ = std::thread(&FoxgloveBridge::pollAndSubscribeLoop, this);
-    LOG_INFO << "FoxgloveBridge started.";
+    LOG_INFO << "FoxgloveBridge started with " << threads << " conversion thread(s).";
     return true;
 }
 
 void FoxgloveBridge::stop() {
     running_ = false;
+    {
+        // 持锁通知，避免发现线程在检查条件后、进入等待前错过唤醒
+        std::lock_guard<std::mutex> lock(discovery_mutex_);
+    }
+    discovery_cv_.notify_all();
+    if (discovery_thread_.joinable())
+        discovery_thread_.join();
     if (poll_thread_.joinable())
         poll_thread_.join();
+    // 接收线程退出后不再提交新消息，再停止转换线程
+    executor_.reset();
     server_.reset();
     LOG_INFO << "FoxgloveBridge stopped.";
 }
 
+void FoxgloveBridge::discoveryLoop() {
+    // GetTopics 是阻塞 RPC，放在独立线程，master 响应慢时不影响接收与转换
+    while (running_) {
+        auto start = std::chrono::steady_clock::now();
+        simple_ros::GetTopicsResponse resp;
+        bool ok = false;
+        try {
+            ok = rpc_client_->GetTopics("", &resp);
+        } catch (const std::exception& e) {
+            LOG_ERROR << "Exception in discovery loop: " << e.what();
+        }
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        discovery_rpc_us_ = std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count();
+        ++discovery_polls_;
+
+        std::unique_lock<std::mutex> lock(discovery_mutex_);
+        if (ok) {
+            discovered_topics_.clear();
+            for (const auto& t : resp.topics()) {
+                discovered_topics_.emplace_back(t.topic_name(), t.msg_type());
+            }
+            discovered_updated_ = true;
+        } else {
+            ++discovery_failures_;
+            LOG_WARN << "Failed to GetTopics from RPC server";
+        }
+        discovery_cv_.wait_for(lock, discovery_interval_, [this]() { return !running_; });
+    }
+}
+
 void FoxgloveBridge::pollAndSubscribeLoop() {
     NodeHandle nh;
-    auto& registry = SubscriptionHandlerRegistry::getInstance();  // 单例
-    auto last_poll = std::chrono::steady_clock::now();
+    auto last_retry = std::chrono::steady_clock::now();
+    initStats(nh);
 
     while (running_) {
-        // 1️⃣ 高频 spin（处理回调）
+        // 1️⃣ 高频 spin（回调只做限速与分发），随后补发限速周期已到的最新消息
         sys_.spinOnce();
+        flushThrottled();
 
-        // 2️⃣ 每秒查询一次 RPC topic
+        // 2️⃣ 为新发现的话题创建 channel，不订阅
+        createDiscoveredChannels();
+
+        // 3️⃣ 客户端订阅情况变化后立即调整订阅，另外每秒重试之前订阅失败的话题
         auto now = std::chrono::steady_clock::now();
-        if (std::chrono::duration_cast<std::chrono::seconds>(now - last_poll).count() >= 1) {
-            last_poll = now;
-
-            try {
-                simple_ros::GetTopicsResponse resp;
-                if (!rpc_client_->GetTopics("", &resp)) {
-                    LOG_WARN << "Failed to GetTopics from RPC server";
-                } else {
-                    for (const auto& t : resp.topics()) {
-                        const std::string topic_name = t.topic_name();
-                        const std::string msg_type = t.msg_type();
-
-                        // 已经订阅过，跳过
-                        if (subscribers_.find(topic_name) != subscribers_.end()) continue;
-
-                        // 先确保 JSON channel 存在
-                        try {
-                            auto channel = createOrGetJsonChannel(topic_name, msg_type);
-                        } catch (const std::exception& e) {
-                            LOG_ERROR << "Failed to create json channel for "
-                                      << msg_type << ": " << e.what();
-                            continue;
-                        }
-
-                        // 使用 SubscriptionHandlerRegistry 创建订阅
-                        try {
-                            auto cb = [this, topic_name](const std::shared_ptr<google::protobuf::Message>& msg) {
-                                this->onGenericMessage(topic_name, msg);
-                            };
-
-                            auto sub = registry.createSubscription(nh, topic_name, msg_type, cb);
-                            if (!sub) {
-                                LOG_ERROR << "Failed to subscribe to topic: " << topic_name;
-                                continue;
-                            }
-
-                            subscribers_[topic_name] = sub;  // 保存 Subscriber 防止析构
-                        } catch (const std::exception& e) {
-                            LOG_ERROR << "Failed to subscribe topic " << topic_name
-                                      << ": " << e.what();
-                        } catch (...) {
-                            LOG_ERROR << "Unknown error subscribing topic " << topic_name;
-                        }
-                    }
-                }
-            } catch (const std::exception& e) {
-                LOG_ERROR << "Exception in poll loop: " << e.what();
-            } catch (...) {
-                LOG_ERROR << "Unknown exception in poll loop";
+        if (demand_changed_.exchange(false) || now - last_retry >= std::chrono::seconds(1)) {
+            last_retry = now;
+            updateSubscriptions(nh);
+        }
+
+        logStats();
+        publishStats();
+    }
+    stats_pub_.reset();
+
+    // 退出前在 master 注销所有订阅，发布者不再向已关闭的桥发送
+    while (!subscribers_.empty()) {
+        unsubscribeTopic(nh, subscribers_.begin()->first);
+    }
+}
+
+void FoxgloveBridge::createDiscoveredChannels() {
+    std::vector<std::pair<std::string, std::string>> discovered;
+    {
+        std::lock_guard<std::mutex> lock(discovery_mutex_);
+        if (!discovered_updated_) return;
+        discovered_updated_ = false;
+        discovered = discovered_topics_;
+    }
+    for (const auto& t : discovered) {
+        // 统计话题由桥接节点自己发布，已有对应的 channel，不再转发
+        if (topic_types_.count(t.first) || t.first == kStatsTopic) continue;
+        createChannels(t.first, t.second);
+    }
+}
+
+FoxgloveBridgeStats FoxgloveBridge::stats() const {
+    FoxgloveBridgeStats st;
+    st.discovery_polls = discovery_polls_.load();
+    st.discovery_failures = discovery_failures_.load();
+    st.discovery_rpc_ms = discovery_rpc_us_.load() / 1000.0;
+    st.topics = topic_count_.load();
+    st.received = received_.load();
+    st.throttled = throttled_.load();
+    st.dispatched = dispatched_.load();
+    st.converted = converted_.load();
+    st.replayed = replayed_.load();
+    st.cache_bytes = cache_budget_.usedBytes();
+    if (executor_) {
+        st.conversion_dropped = executor_->droppedCount();
+        st.conversion_failed = conversion_failed_.load() + executor_->failedCount();
+        st.conversion_pending = executor_->pending();
+        st.conversion_busy_s = executor_->busySeconds();
+    }
+    return st;
+}
+
+void FoxgloveBridge::logStats() {
+    constexpr auto kStatsInterval = std::chrono::seconds(10);
+    auto now = std::chrono::steady_clock::now();
+    if (now - last_stats_time_ < kStatsInterval) return;
+    double secs = std::chrono::duration<double>(now - last_stats_time_).count();
+    last_stats_time_ = now;
+
+    FoxgloveBridgeStats st = stats();
+    const FoxgloveBridgeStats& prev = last_stats_;
+    auto rate = [secs](uint64_t cur, uint64_t old) { return (cur - old) / secs; };
+    LOG_INFO << "Bridge stats: discovery " << st.topics << " topics, rpc " << st.discovery_rpc_ms << " ms"
+             << " (" << st.discovery_failures << " failed)"
+             << " | ingest " << rate(st.received, prev.received) << " msg/s, throttled "
+             << rate(st.throttled, prev.throttled) << " msg/s"
+             << " | convert " << rate(st.converted, prev.converted) << " msg/s, busy "
+             << (st.conversion_busy_s - prev.conversion_busy_s) / secs * 100.0 << "%, pending "
+             << st.conversion_pending << ", dropped " << (st.conversion_dropped - prev.conversion_dropped)
+             << ", failed " << (st.conversion_failed - prev.conversion_failed)
+             << " | cache " << st.cache_bytes / 1024 << " KiB, replayed " << (st.replayed - prev.replayed);
+    last_stats_ = st;
+}
+
+void FoxgloveBridge::initStats(NodeHandle& nh) {
+    if (stats_interval_ <= 0.0) return;
+    stats_pub_ = nh.advertise<bridge_msgs::BridgeStats>(kStatsTopic);
+
+    // 统计 channel 不参与按需订阅，直接创建，不登记到 channel_topics_
+    const auto* desc = bridge_msgs::BridgeStats::descriptor();
+    std::string schema_data = buildFileDescriptorSet(desc);
+    foxglove::Schema schema;
+    schema.name = desc->full_name();
+    schema.encoding = "protobuf";
+    schema.data = reinterpret_cast<const std::byte*>(schema_data.data());
+    schema.data_len = schema_data.size();
+    auto channel_res = foxglove::RawChannel::create(kStatsTopic, "protobuf", schema);
+    if (!channel_res.has_value()) {
+        LOG_ERROR << "Failed to create stats channel: " << foxglove::strerror(channel_res.error());
+        return;
+    }
+    stats_channel_ = std::make_shared<foxglove::RawChannel>(std::move(channel_res.value()));
+}
+
+bridge_msgs::BridgeStats FoxgloveBridge::buildStats(double period) {
+    bridge_msgs::BridgeStats out;
+    simple_ros::Clock::instance().stamp(out.mutable_header());
+    out.set_period(period);
+
+    // 每个 channel 的订阅客户端数
+    std::map<uint64_t, uint32_t> channel_subscribers;
+    std::set<uint32_t> clients;
+    {
+        std::lock_guard<std::mutex> lock(demand_mutex_);
+        for (const auto& item : topic_clients_) {
+            for (const auto& sub : item.second) {
+                ++channel_subscribers[sub.first];
+                clients.insert(sub.second);
             }
         }
+    }
+    auto subscribersOf = [&channel_subscribers](uint64_t id) {
+        auto it = channel_subscribers.find(id);
+        return it != channel_subscribers.end() ? it->second : 0u;
+    };
+    auto rate = [period](uint64_t cur, uint64_t old) {
+        return period > 0.0 && cur >= old ? (cur - old) / period : 0.0;
+    };
 
+    for (const auto& item : topics_) {
+        BridgeTopic& topic = *item.second;
+        simple_ros::StreamStats::Snapshot cur = topic.stats.takeSnapshot();
+        simple_ros::StreamStats::Snapshot& prev = last_stream_stats_[item.first];
+
+        auto addChannel = [&](bridge_msgs::TopicStats* t, uint64_t id, const std::string& name,
+                              const char* encoding, uint64_t messages, uint64_t bytes,
+                              uint64_t prev_messages, uint64_t prev_bytes) {
+            auto* c = t->add_channels();
+            c->set_id(id);
+            c->set_name(name);
+            c->set_encoding(encoding);
+            c->set_subscribers(subscribersOf(id));
+            c->set_messages(messages);
+            c->set_bytes(bytes);
+            c->set_message_rate(rate(messages, prev_messages));
+            c->set_byte_rate(rate(bytes, prev_bytes));
+        };
 
+        // 没有客户端订阅、周期内也没有消息的话题不列出
+        bool subscribed = false;
+        for (uint64_t id : {topic.protobuf_channel ? topic.protobuf_channel->id() : 0,
+                            topic.json_channel ? topic.json_channel->id() : 0,
+                            topic.scene_channel ? topic.scene_channel->id() : 0}) {
+            if (id != 0 && subscribersOf(id) > 0) subscribed = true;
+        }
+        if (subscribed || cur.received != prev.received || cur.pending() > 0) {
+            auto* t = out.add_topics();
+            t->set_topic(item.first);
+            auto type_it = topic_types_.find(item.first);
+            if (type_it != topic_types_.end()) t->set_msg_type(type_it->second);
+            t->set_received(cur.received);
+            t->set_throttled(cur.throttled);
+            t->set_dropped(cur.dropped);
+            t->set_converted(cur.converted);
+            t->set_failed(cur.failed);
+            t->set_pending(cur.pending());
+            t->set_input_bytes(cur.input_bytes);
+            t->set_receive_rate(rate(cur.received, prev.received));
+            t->set_input_byte_rate(rate(cur.input_bytes, prev.input_bytes));
+            auto* latency = t->mutable_conversion();
+            latency->set_count(cur.conversion.count());
+            latency->set_mean_us(cur.conversion.mean() * 1e6);
+            latency->set_p50_us(cur.conversion.percentile(0.5) * 1e6);
+            latency->set_p99_us(cur.conversion.percentile(0.99) * 1e6);
+            latency->set_max_us(cur.conversion.max() * 1e6);
+
+            if (topic.protobuf_channel) {
+                addChannel(t, topic.protobuf_channel->id(), item.first, "protobuf", cur.raw_messages,
+                           cur.raw_bytes, prev.raw_messages, prev.raw_bytes);
+            } else if (topic.json_channel) {
+                addChannel(t, topic.json_channel->id(), item.first, "json", cur.raw_messages,
+                           cur.raw_bytes, prev.raw_messages, prev.raw_bytes);
+            }
+            if (topic.scene_channel) {
+                addChannel(t, topic.scene_channel->id(), item.first + "/scene", "scene", cur.scene_messages,
+                           cur.scene_bytes, prev.scene_messages, prev.scene_bytes);
+            }
+        }
+        prev = std::move(cur);
     }
+
+    FoxgloveBridgeStats st = stats();
+    out.set_conversion_pending(st.conversion_pending);
+    out.set_conversion_dropped(st.conversion_dropped);
+    out.set_conversion_failed(st.conversion_failed);
+    if (period > 0.0) out.set_conversion_busy((st.conversion_busy_s - last_published_.conversion_busy_s) / period);
+    out.set_cache_bytes(st.cache_bytes);
+    out.set_clients(static_cast<uint32_t>(clients.size()));
+    last_published_ = st;
+    return out;
+}
+
+void FoxgloveBridge::publishStats() {
+    if (!stats_pub_ && !stats_channel_) return;
+    auto now = std::chrono::steady_clock::now();
+    double period = std::chrono::duration<double>(now - last_publish_time_).count();
+    if (period < stats_interval_) return;
+    last_publish_time_ = now;
+
+    bridge_msgs::BridgeStats msg = buildStats(period);
+    if (stats_pub_) stats_pub_->publish(msg);
+    if (stats_channel_) {
+        std::string data;
+        if (msg.SerializeToString(&data)) {
+            stats_channel_->log(reinterpret_cast<const std::byte*>(data.data()), data.size());
+        }
+    }
+}
+
+void FoxgloveBridge::createChannels(const std::string& topic, const std::string& msg_type) {
+    // protobuf 编码需要类型的 descriptor，找不到时退回 JSON
+    try {
+        const auto* desc = google::protobuf::DescriptorPool::generated_pool()
+                               ->FindMessageTypeByName(msg_type);
+        if (encodingFor(topic) == FoxgloveEncoding::PROTOBUF && desc) {
+            createOrGetProtobufChannel(topic, desc);
+        } else {
+            createOrGetJsonChannel(topic, msg_type);
+        }
+    } catch (const std::exception& e) {
+        LOG_ERROR << "Failed to create channel for " << msg_type << ": " << e.what();
+        return;
+    }
+    // Marker 类话题的 scene channel 也需要先广播，客户端才能订阅它
+    if (msg_type == "visualization_msgs.Marker" || msg_type == "visualization_msgs.MarkerArray") {
+        createOrGetSceneChannel(topic);
+    }
+    // 转换线程使用的输出端，创建后只读（轨迹状态除外，它只由该话题的转换线程修改）
+    auto bridge_topic = std::make_shared<BridgeTopic>(&cache_budget_);
+    bridge_topic->name = topic;
+    auto pb_it = protobuf_channels_.find(topic);
+    if (pb_it != protobuf_channels_.end()) bridge_topic->protobuf_channel = pb_it->second;
+    auto json_it = json_channels_.find(topic);
+    if (json_it != json_channels_.end()) bridge_topic->json_channel = json_it->second;
+    auto scene_it = scene_channels_.find(topic + "/scene");
+    if (scene_it != scene_channels_.end()) bridge_topic->scene_channel = scene_it->second;
+    bridge_topic->pinned = msg_type == "visualization_msgs.Marker";
+    topics_[topic] = bridge_topic;
+    {
+        std::lock_guard<std::mutex> lock(demand_mutex_);
+        replay_topics_[topic] = bridge_topic;
+    }
+    ++topic_count_;
+
+    double requested_rate = maxRateFor(topic);
+    double max_rate = effectiveMaxRate(msg_type, requested_rate);
+    if (requested_rate > 0.0 && max_rate <= 0.0) {
+        LOG_WARN << "Topic " << topic << " (" << msg_type
+                 << ") carries incremental marker updates, ignoring max rate " << requested_rate << " Hz";
+    }
+    if (max_rate > 0.0) {
+        throttles_.emplace(topic, simple_ros::LatestMessageThrottle(max_rate));
+        LOG_INFO << "Limiting topic " << topic << " to " << max_rate << " Hz";
+    }
+    topic_types_[topic] = msg_type;
+}
+
+void FoxgloveBridge::registerChannel(uint64_t channel_id, const std::string& topic) {
+    std::lock_guard<std::mutex> lock(demand_mutex_);
+    channel_topics_[channel_id] = topic;
+}
+
+void FoxgloveBridge::onClientSubscribe(uint64_t channel_id, uint32_t client_id,
+                                       std::optional<uint64_t> sink_id) {
+    std::lock_guard<std::mutex> lock(demand_mutex_);
+    auto it = channel_topics_.find(channel_id);
+    if (it == channel_topics_.end()) return;
+    if (topic_clients_[it->second].emplace(channel_id, client_id).second) {
+        // 新客户端没有之前发送的消息与实体，由转换线程补发缓存的最后状态；
+        // 记下此刻已发送的消息数，补发前若又发送过新消息，客户端已直接收到，不再补发
+        auto topic = replay_topics_.find(it->second);
+        uint64_t raw_logged = topic != replay_topics_.end() ? topic->second->raw_logged.load() : 0;
+        replay_requests_.push_back({it->second, channel_id, sink_id, raw_logged});
+        demand_changed_ = true;
+    }
+}
+
+void FoxgloveBridge::onClientUnsubscribe(uint64_t channel_id, uint32_t client_id) {
+    std::lock_guard<std::mutex> lock(demand_mutex_);
+    auto it = channel_topics_.find(channel_id);
+    if (it == channel_topics_.end()) return;
+    auto clients = topic_clients_.find(it->second);
+    if (clients != topic_clients_.end() && clients->second.erase({channel_id, client_id}) > 0) {
+        if (clients->second.empty()) topic_clients_.erase(clients);
+        demand_changed_ = true;
+    }
+}
+
+void FoxgloveBridge::updateSubscriptions(NodeHandle& nh) {
+    std::set<std::string> wanted;
+    std::vector<ReplayRequest> replays;
+    {
+        std::lock_guard<std::mutex> lock(demand_mutex_);
+        for (const auto& item : topic_clients_) wanted.insert(item.first);
+        replays.swap(replay_requests_);
+    }
+    // 补发与该话题的消息转换在同一线程中按序执行，缓存只由这个线程访问；补发任务不可丢弃
+    for (const auto& request : replays) {
+        auto it = topics_.find(request.topic);
+        if (it == topics_.end() || !executor_) continue;
+        std::shared_ptr<BridgeTopic> topic = it->second;
+        executor_->submitPinned(request.topic, [this, topic, request]() {
+            replayCached(*topic, request.channel_id, request.sink_id, request.raw_logged);
+        });
+    }
+
+    // 最后一个客户端离开的话题：取消订阅
+    for (auto it = subscribers_.begin(); it != subscribers_.end();) {
+        const std::string topic = (it++)->first;
+        if (!wanted.count(topic)) unsubscribeTopic(nh, topic);
+    }
+    // 第一个客户端到来的话题：订阅
+    for (const auto& topic : wanted) {
+        if (!subscribers_.count(topic)) subscribeTopic(nh, topic);
+    }
+}
+
+bool FoxgloveBridge::subscribeTopic(NodeHandle& nh, const std::string& topic) {
+    auto type_it = topic_types_.find(topic);
+    if (type_it == topic_types_.end()) return false;
+    const std::string& msg_type = type_it->second;
+
+    // protobuf channel 直接转发线上字节，接收端不再反序列化
+    auto mq = sys_.getMessageQueue();
+    if (mq) mq->setSerializedDelivery(topic, protobuf_channels_.count(topic) > 0);
+
+    // 使用 SubscriptionHandlerRegistry 创建订阅
+    try {
+        auto cb = [this, topic](const std::shared_ptr<google::protobuf::Message>& msg) {
+            this->onGenericMessage(topic, msg);
+        };
+        auto sub = SubscriptionHandlerRegistry::getInstance().createSubscription(nh, topic, msg_type, cb);
+        if (!sub) {
+            LOG_ERROR << "Failed to subscribe to topic: " << topic;
+            return false;
+        }
+        subscribers_[topic] = sub;  // 保存 Subscriber 防止析构
+    } catch (const std::exception& e) {
+        LOG_ERROR << "Failed to subscribe topic " << topic << ": " << e.what();
+        return false;
+    } catch (...) {
+        LOG_ERROR << "Unknown error subscribing topic " << topic;
+        return false;
+    }
+    LOG_INFO << "Subscribed to topic on client demand: " << topic;
+    return true;
+}
+
+void FoxgloveBridge::unsubscribeTopic(NodeHandle& nh, const std::string& topic) {
+    auto it = subscribers_.find(topic);
+    if (it == subscribers_.end()) return;
+    // 先释放 Subscriber（移出消息队列），再在 master 注销，发布者随后断开到本节点的连接
+    subscribers_.erase(it);
+    auto throttle = throttles_.find(topic);
+    if (throttle != throttles_.end()) throttle->second.reset();
+    if (auto mq = sys_.getMessageQueue()) mq->setSerializedDelivery(topic, false);
+    nh.unsubscribe(topic, topic_types_[topic]);
+    LOG_INFO << "Unsubscribed from topic, no client left: " << topic;
 }
 
 
@@ -165,72 +552,373 @@ void FoxgloveBridge::onGenericMessage(
     const std::shared_ptr<google::protobuf::Message>& msg) 
 {
     if (!msg) return;
+    ++received_;
+    auto it = topics_.find(topic_name);
+    if (it == topics_.end()) return;
+    const std::shared_ptr<BridgeTopic>& topic = it->second;
+    topic->stats.onReceived();
+
+    // 限速话题：周期内的新消息替换尚未发送的旧消息，被替换的消息不做任何转换
+    auto throttle = throttles_.find(topic_name);
+    if (throttle != throttles_.end()) {
+        uint64_t dropped = throttle->second.droppedCount();
+        bool send = throttle->second.offer(msg, simple_ros::LatestMessageThrottle::Clock::now());
+        uint64_t newly_dropped = throttle->second.droppedCount() - dropped;
+        throttled_ += newly_dropped;
+        if (newly_dropped > 0) topic->stats.onThrottled(newly_dropped);
+        if (!send) return;
+    }
+    dispatchMessage(topic, msg);
+}
 
-    // 1️⃣ 先发布 JSON
-    publishJsonMessage(topic_name, msg);
+void FoxgloveBridge::flushThrottled() {
+    if (throttles_.empty()) return;
+    auto now = simple_ros::LatestMessageThrottle::Clock::now();
+    for (auto& item : throttles_) {
+        if (auto msg = item.second.takeDue(now)) {
+            auto it = topics_.find(item.first);
+            if (it != topics_.end()) dispatchMessage(it->second, msg);
+        }
+    }
+}
 
-    // 2️⃣ Marker 或 MarkerArray 判断
-    const std::string msg_type = msg->GetDescriptor()->full_name();
+void FoxgloveBridge::dispatchMessage(
+    const std::shared_ptr<BridgeTopic>& topic,
+    const std::shared_ptr<google::protobuf::Message>& msg)
+{
+    if (!executor_) return;
+    ++dispatched_;
+    topic->stats.onDispatched();
+    // 按话题分配转换线程，同一话题的消息按接收顺序转换
+    auto task = [this, topic, msg]() {
+        try {
+            auto start = std::chrono::steady_clock::now();
+            forwardMessage(*topic, msg);
+            double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            topic->stats.onConverted(secs, inputBytes(*msg));
+            ++converted_;
+        } catch (const std::exception& e) {
+            // 计入失败，否则这条消息既未转换也未丢弃，一直算作排队中
+            topic->stats.onFailed();
+            ++conversion_failed_;
+            LOG_ERROR << "Failed to convert message on " << topic->name << ": " << e.what();
+        }
+    };
+    if (topic->pinned) {
+        // 丢掉一条单 Marker 消息，轨迹就永久缺少这些点，之后的消息也补不回来
+        executor_->submitPinned(topic->name, std::move(task));
+        return;
+    }
+    // 丢弃通知在接收线程中调用，此时 topics_ 仍持有该话题，捕获裸指针即可（避免为回调分配内存）
+    simple_ros::StreamStats* stats = &topic->stats;
+    executor_->submit(topic->name, std::move(task), [stats]() { stats->onDropped(); });
+}
 
-    if (msg_type == "visualization_msgs.Marker") {
-        auto marker = std::dynamic_pointer_cast<visualization_msgs::Marker>(msg);
-        if (!marker) return;
+void FoxgloveBridge::forwardMessage(
+    BridgeTopic& topic,
+    const std::shared_ptr<google::protobuf::Message>& msg)
+{
+    // 接收端未反序列化的消息，类型名随数据一起交付
+    const simple_ros::SerializedMessage* raw = nullptr;
+    if (msg->GetDescriptor() == simple_ros::SerializedMessage::descriptor()) {
+        raw = static_cast<const simple_ros::SerializedMessage*>(msg.get());
+    }
+    const std::string msg_type = raw ? raw->type() : msg->GetDescriptor()->full_name();
+
+    // 1️⃣ 先发布原始消息：protobuf channel 原样转发字节，否则转为 JSON
+    if (topic.protobuf_channel) {
+        publishProtobufMessage(topic, msg);
+    } else if (!raw && topic.json_channel) {
+        publishJsonMessage(topic, msg);
+    }
 
-        // 原来的单个 marker 发布逻辑
-        auto scene_channel = createOrGetSceneChannel(topic_name);
-        if (!scene_channel) return;
-
-        switch (marker->type()) {
-            case visualization_msgs::MarkerType::CUBE:
-                publishCube(scene_channel, marker);
-                break;
-            case visualization_msgs::MarkerType::CYLINDER:
-                publishCylinder(scene_channel, marker);
-                break;
-            case visualization_msgs::MarkerType::LINE_STRIP:
-                updateTrajectory(scene_channel, marker);
-                break;
-            default:
-                break;
+    // 2️⃣ Marker 或 MarkerArray 判断
+    if (msg_type == "visualization_msgs.Marker") {
+        std::shared_ptr<visualization_msgs::Marker> marker;
+        if (raw) {
+            // 只有 Marker 类话题需要解析出内容
+            marker = std::make_shared<visualization_msgs::Marker>();
+            if (!marker->ParseFromString(raw->data())) return;
+        } else {
+            marker = std::dynamic_pointer_cast<visualization_msgs::Marker>(msg);
         }
+        if (!marker) return;
 
+        onMarkerMessage(topic, marker);
     } else if (msg_type == "visualization_msgs.MarkerArray") {
-        auto marker_array = std::dynamic_pointer_cast<visualization_msgs::MarkerArray>(msg);
+        std::shared_ptr<visualization_msgs::MarkerArray> marker_array;
+        if (raw) {
+            marker_array = std::make_shared<visualization_msgs::MarkerArray>();
+            if (!marker_array->ParseFromString(raw->data())) return;
+        } else {
+            marker_array = std::dynamic_pointer_cast<visualization_msgs::MarkerArray>(msg);
+        }
         if (!marker_array) return;
-        onMarkerArrayMessage(topic_name, marker_array);
+        onMarkerArrayMessage(topic, marker_array);
     }
 }
 
 
+// ------------------- 最后状态缓存 -------------------
+
+namespace {
+
+// 实体的内存占用估算：结构体本身加上各图元与变长数组
+size_t sceneEntityBytes(const foxglove::schemas::SceneEntity& entity) {
+    using namespace foxglove::schemas;
+    size_t bytes = sizeof(SceneEntity) + entity.id.size() + entity.frame_id.size();
+    for (const auto& kv : entity.metadata) bytes += sizeof(KeyValuePair) + kv.key.size() + kv.value.size();
+    bytes += entity.arrows.size() * sizeof(ArrowPrimitive);
+    bytes += entity.cubes.size() * sizeof(CubePrimitive);
+    bytes += entity.spheres.size() * sizeof(SpherePrimitive);
+    bytes += entity.cylinders.size() * sizeof(CylinderPrimitive);
+    for (const auto& line : entity.lines) {
+        bytes += sizeof(LinePrimitive) + line.points.size() * sizeof(Point3) + line.colors.size() * sizeof(Color) +
+                 line.indices.size() * sizeof(uint32_t);
+    }
+    for (const auto& tri : entity.triangles) {
+        bytes += sizeof(TriangleListPrimitive) + tri.points.size() * sizeof(Point3) +
+                 tri.colors.size() * sizeof(Color) + tri.indices.size() * sizeof(uint32_t);
+    }
+    for (const auto& text : entity.texts) bytes += sizeof(TextPrimitive) + text.text.size();
+    for (const auto& model : entity.models) {
+        bytes += sizeof(ModelPrimitive) + model.url.size() + model.media_type.size() + model.data.size();
+    }
+    return bytes;
+}
+
+/**
+ * SceneUpdate 按 protobuf 编码后的字节数估算。SDK 在内部编码，不返回编码结果，
+ * 这里按字段计数：double 字段 9 字节，Vector3/Point3 29 字节，Quaternion 与 Color 38 字节，
+ * 每个嵌套消息另加 2 字节的标签与长度；字符串与字节数组按原长度计。
+ */
+size_t sceneUpdateWireBytes(const foxglove::schemas::SceneUpdate& update) {
+    constexpr size_t kVec = 29, kQuat = 38, kColor = 38, kStamp = 14;
+    constexpr size_t kPose = kVec + kQuat + 2;
+    constexpr size_t kSolid = kPose + kVec + kColor + 2;   // cube / sphere
+    size_t bytes = 0;
+    for (const auto& deletion : update.deletions) bytes += kStamp + 4 + deletion.id.size() + 2;
+    for (const auto& entity : update.entities) {
+        size_t e = 2 * kStamp + entity.id.size() + entity.frame_id.size() + 8;
+        for (const auto& kv : entity.metadata) e += kv.key.size() + kv.value.size() + 6;
+        e += entity.arrows.size() * (kPose + 4 * 9 + kColor + 2);
+        e += (entity.cubes.size() + entity.spheres.size()) * kSolid;
+        e += entity.cylinders.size() * (kSolid + 2 * 9);
+        for (const auto& line : entity.lines) {
+            e += kPose + 9 + 4 + kColor + 2 + line.points.size() * (kVec + 2) +
+                 line.colors.size() * (kColor + 2) + line.indices.size() * 3;
+        }
+        for (const auto& tri : entity.triangles) {
+            e += kPose + kColor + 2 + tri.points.size() * (kVec + 2) + tri.colors.size() * (kColor + 2) +
+                 tri.indices.size() * 3;
+        }
+        for (const auto& text : entity.texts) e += kPose + 9 + 4 + kColor + 2 + text.text.size() + 2;
+        for (const auto& model : entity.models) {
+            e += kPose + kVec + kColor + 4 + model.url.size() + model.media_type.size() + model.data.size() + 6;
+        }
+        bytes += e + 4;
+    }
+    return bytes;
+}
+
+} // namespace
+
+void FoxgloveBridge::logScene(BridgeTopic& topic, foxglove::schemas::SceneUpdate& update) {
+    if (update.deletions.empty() && update.entities.empty()) return;
+    topic.scene_channel->log(update);
+    topic.stats.scene_out.add(sceneUpdateWireBytes(update));
+    if (!topic.scene_cache_complete) return;
+
+    // 按客户端的处理顺序：先删除，再添加或替换同 id 的实体
+    size_t bytes = topic.scene_reservation.bytes();
+    for (const auto& deletion : update.deletions) {
+        if (deletion.type == foxglove::schemas::SceneEntityDeletion::DeletionType::ALL) {
+            topic.scene_cache.clear();
+            bytes = 0;
+        } else {
+            auto it = topic.scene_cache.find(deletion.id);
+            if (it == topic.scene_cache.end()) continue;
+            bytes -= it->second.bytes;
+            topic.scene_cache.erase(it);
+        }
+    }
+
+    const auto now = std::chrono::steady_clock::now();
+    for (auto& entity : update.entities) {
+        CachedSceneEntity cached;
+        cached.bytes = sceneEntityBytes(entity);
+        cached.expires = std::chrono::steady_clock::time_point::max();
+        if (entity.lifetime && (entity.lifetime->sec > 0 || entity.lifetime->nsec > 0)) {
+            cached.expires = now + std::chrono::seconds(entity.lifetime->sec) +
+                             std::chrono::nanoseconds(entity.lifetime->nsec);
+        }
+        std::string id = entity.id;
+        cached.entity = std::move(entity);
+        auto it = topic.scene_cache.find(id);
+        if (it != topic.scene_cache.end()) {
+            bytes -= it->second.bytes;
+            it->second = std::move(cached);
+            bytes += it->second.bytes;
+        } else {
+            bytes += cached.bytes;
+            topic.scene_cache.emplace(std::move(id), std::move(cached));
+        }
+    }
+    update.entities.clear();
+
+    if (!topic.scene_reservation.resize(bytes)) {
+        // 超出预算：放弃整个场景缓存，之后的新客户端改为触发一次完整重发
+        topic.scene_cache.clear();
+        topic.scene_reservation.resize(0);
+        topic.scene_cache_complete = false;
+        LOG_WARN << "Scene cache for " << topic.name << " exceeds the cache budget, falling back to resync";
+    }
+}
+
+void FoxgloveBridge::resetSceneCache(BridgeTopic& topic) {
+    topic.scene_cache.clear();
+    topic.scene_reservation.resize(0);
+    topic.scene_cache_complete = true;
+}
+
+void FoxgloveBridge::replayCached(BridgeTopic& topic, uint64_t channel_id, std::optional<uint64_t> sink_id,
+                                  uint64_t raw_logged) {
+    // 订阅之后排在补发前面的消息已发给新客户端，最后一条不必再补发
+    const bool raw_received = topic.raw_logged.load() != raw_logged;
+    auto replayRaw = [&](const std::shared_ptr<foxglove::RawChannel>& channel,
+                         const simple_ros::LastMessageSlot& last) {
+        if (!channel || channel->id() != channel_id || last.empty() || raw_received) return;
+        channel->log(reinterpret_cast<const std::byte*>(last.data().data()), last.data().size(),
+                     std::nullopt, sink_id);
+        topic.stats.raw_out.add(last.data().size());
+        ++replayed_;
+    };
+    replayRaw(topic.protobuf_channel, topic.protobuf_last);
+    replayRaw(topic.json_channel, topic.json_last);
+
+    if (!topic.scene_channel || topic.scene_channel->id() != channel_id) return;
+    if (!topic.scene_cache_complete) {
+        // 缓存不完整，下一条消息向所有客户端重发全部实体
+        topic.resync = true;
+        return;
+    }
+
+    // 缓存是当前全部实体的快照，与订阅后已收到的更新重复时客户端按 id 替换，结果不变
+    // 已到期的实体客户端也会移除，不再补发
+    foxglove::schemas::SceneUpdate update;
+    const auto now = std::chrono::steady_clock::now();
+    size_t bytes = topic.scene_reservation.bytes();
+    for (auto it = topic.scene_cache.begin(); it != topic.scene_cache.end();) {
+        if (it->second.expires <= now) {
+            bytes -= it->second.bytes;
+            it = topic.scene_cache.erase(it);
+            continue;
+        }
+        update.entities.push_back(it->second.entity);
+        ++it;
+    }
+    topic.scene_reservation.resize(bytes);
+    if (update.entities.empty()) return;
+    topic.scene_channel->log(update, std::nullopt, sink_id);
+    topic.stats.scene_out.add(sceneUpdateWireBytes(update));
+    ++replayed_;
+}
+
 // ------------------- 辅助函数 -------------------
 
 void FoxgloveBridge::publishJsonMessage(
-    const std::string& topic,
+    BridgeTopic& topic,
     const std::shared_ptr<google::protobuf::Message>& msg) 
 {
-    std::string json_str;
-    google::protobuf::util::JsonPrintOptions opts;
-    opts.add_whitespace = false;
-    opts.always_print_primitive_fields = true;
-    opts.preserve_proto_field_names = true;
-
-    auto status = google::protobuf::util::MessageToJsonString(*msg, &json_str, opts);
-    if (!status.ok()) return;
-
-    std::string msg_type = msg->GetDescriptor()->full_name();
-    auto channel_it = json_channels_.find(topic);
-    std::shared_ptr<foxglove::RawChannel> channel;
-    if (channel_it == json_channels_.end()) {
-        try {
-            channel = createOrGetJsonChannel(topic, msg_type);
-        } catch (...) { return; }
-    } else {
-        channel = channel_it->second;
+    // 每个转换线程复用一个缓冲区，稳定后不再分配
+    thread_local std::string json_str;
+    json_str.clear();
+    json_encoder_.encode(*msg, &json_str);
+
+    // 先计数再发送：与新客户端订阅并发时宁可补发重复的一条，也不漏发
+    topic.raw_logged.fetch_add(1);
+    topic.json_channel->log(reinterpret_cast<const std::byte*>(json_str.data()), json_str.size());
+    topic.json_last.store(json_str.data(), json_str.size());
+    topic.stats.raw_out.add(json_str.size());
+}
+
+FoxgloveEncoding FoxgloveBridge::encodingFor(const std::string& topic) const {
+    auto it = topic_encodings_.find(topic);
+    return it != topic_encodings_.end() ? it->second : default_encoding_;
+}
+
+double FoxgloveBridge::effectiveMaxRate(const std::string& msg_type, double max_rate_hz) {
+    if (msg_type == "visualization_msgs.Marker" || msg_type == "visualization_msgs.MarkerArray") return 0.0;
+    return max_rate_hz;
+}
+
+double FoxgloveBridge::maxRateFor(const std::string& topic) const {
+    auto it = topic_max_rates_.find(topic);
+    return it != topic_max_rates_.end() ? it->second : default_max_rate_;
+}
+
+void FoxgloveBridge::publishProtobufMessage(
+    BridgeTopic& topic,
+    const std::shared_ptr<google::protobuf::Message>& msg)
+{
+    const auto& channel = topic.protobuf_channel;
+    if (msg->GetDescriptor() == simple_ros::SerializedMessage::descriptor()) {
+        const auto& data = static_cast<const simple_ros::SerializedMessage&>(*msg).data();
+        topic.raw_logged.fetch_add(1);
+        channel->log(reinterpret_cast<const std::byte*>(data.data()), data.size());
+        topic.protobuf_last.store(data.data(), data.size());
+        topic.stats.raw_out.add(data.size());
+        return;
     }
+    // 同进程发布者投递的是消息对象，序列化后发送
+    std::string data;
+    if (!msg->SerializeToString(&data)) return;
+    topic.raw_logged.fetch_add(1);
+    channel->log(reinterpret_cast<const std::byte*>(data.data()), data.size());
+    topic.protobuf_last.store(data.data(), data.size());
+    topic.stats.raw_out.add(data.size());
+}
+
+// 类型所在文件及其全部依赖，依赖排在前面
+std::string FoxgloveBridge::buildFileDescriptorSet(const google::protobuf::Descriptor* desc) {
+    google::protobuf::FileDescriptorSet set;
+    std::unordered_set<std::string> added;
+    std::function<void(const google::protobuf::FileDescriptor*)> add =
+        [&](const google::protobuf::FileDescriptor* file) {
+            if (!added.insert(file->name()).second) return;
+            for (int i = 0; i < file->dependency_count(); ++i) {
+                add(file->dependency(i));
+            }
+            file->CopyTo(set.add_file());
+        };
+    add(desc->file());
+    return set.SerializeAsString();
+}
+
+std::shared_ptr<foxglove::RawChannel>
+FoxgloveBridge::createOrGetProtobufChannel(const std::string& topic,
+                                           const google::protobuf::Descriptor* desc)
+{
+    auto it = protobuf_channels_.find(topic);
+    if (it != protobuf_channels_.end()) return it->second;
+
+    std::string schema_data = buildFileDescriptorSet(desc);
+    foxglove::Schema schema;
+    schema.name = desc->full_name();
+    schema.encoding = "protobuf";
+    schema.data = reinterpret_cast<const std::byte*>(schema_data.data());
+    schema.data_len = schema_data.size();
 
-    if (channel) {
-        channel->log(reinterpret_cast<const std::byte*>(json_str.data()), json_str.size());
+    auto channel_res = foxglove::RawChannel::create(topic, "protobuf", schema);
+    if (!channel_res.has_value()) {
+        throw std::runtime_error(foxglove::strerror(channel_res.error()));
     }
+
+    auto channel = std::make_shared<foxglove::RawChannel>(std::move(channel_res.value()));
+    protobuf_channels_[topic] = channel;
+    registerChannel(channel->id(), topic);
+    LOG_INFO << "Created protobuf channel for topic: " << topic << " [" << desc->full_name() << "]";
+    return channel;
 }
 
 std::shared_ptr<foxglove::RawChannel>
@@ -273,228 +961,234 @@ FoxgloveBridge::createOrGetJsonChannel(const std::string& topic,
 
     auto channel = std::make_shared<foxglove::RawChannel>(std::move(channel_res.value()));
     json_channels_[topic] = channel;  // 按 topic 缓存
+    registerChannel(channel->id(), topic);
     return channel;
 }
 
 
-void FoxgloveBridge::publishCylinder(
-    const std::shared_ptr<foxglove::schemas::SceneUpdateChannel>& scene_channel,
-    const std::shared_ptr<visualization_msgs::Marker>& marker) 
-{
-    if (!scene_channel || !marker) return;
+namespace {
 
-    foxglove::schemas::CylinderPrimitive cylinder;
-    cylinder.size = foxglove::schemas::Vector3{
-        marker->scale().x(),
-        marker->scale().y(),
-        marker->scale().z()
-    };
-    cylinder.color = foxglove::schemas::Color{
-        marker->color().r(),
-        marker->color().g(),
-        marker->color().b(),
-        marker->color().a()
-    };
+uint64_t toNanos(const foxglove::schemas::Timestamp& t) {
+    return static_cast<uint64_t>(t.sec) * 1000000000ull + t.nsec;
+}
 
-    foxglove::schemas::Pose pose;
-    pose.position = foxglove::schemas::Vector3{
-        marker->pose().position().x(),
-        marker->pose().position().y(),
-        marker->pose().position().z()
-    };
-    pose.orientation = foxglove::schemas::Quaternion{
-        marker->pose().orientation().x(),
-        marker->pose().orientation().y(),
-        marker->pose().orientation().z(),
-        marker->pose().orientation().w()
-    };
-    cylinder.pose = pose;
+foxglove::schemas::Timestamp fromNanos(uint64_t ns) {
+    return {static_cast<uint32_t>(ns / 1000000000ull), static_cast<uint32_t>(ns % 1000000000ull)};
+}
 
-    cylinder.bottom_scale = 1.0;
-    cylinder.top_scale = 1.0;
+// 当前墙钟时间，用于没有自带时间戳的实体与删除
+foxglove::schemas::Timestamp wallStamp() {
+    auto now = std::chrono::system_clock::now().time_since_epoch();
+    return fromNanos(std::chrono::duration_cast<std::chrono::nanoseconds>(now).count());
+}
 
-    foxglove::schemas::SceneEntity entity;
-    entity.id = marker->ns() + "_cylinder_" + std::to_string(marker->id());
-    entity.cylinders.push_back(cylinder);
+// 实体时间戳：Marker 自带时间戳时沿用，否则取当前时间
+foxglove::schemas::Timestamp markerStamp(const visualization_msgs::Marker& marker) {
+    if (marker.has_header() && marker.header().has_stamp()) {
+        const auto& stamp = marker.header().stamp();
+        return {static_cast<uint32_t>(stamp.sec()), stamp.nanosec()};
+    }
+    return wallStamp();
+}
 
-    foxglove::schemas::SceneUpdate update;
-    update.entities.push_back(entity);
-    scene_channel->log(update);
+// 删除只作用于时间戳早于它的实体，取当前时间与已发送实体的最大时间戳中较晚者
+foxglove::schemas::Timestamp deletionStamp(const BridgeTopic& topic) {
+    auto now = std::chrono::system_clock::now().time_since_epoch();
+    uint64_t now_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(now).count();
+    return fromNanos(std::max(now_ns, topic.latest_stamp_ns + 1));
 }
 
+foxglove::schemas::SceneEntityDeletion makeDeletion(const foxglove::schemas::Timestamp& stamp,
+                                                    const std::string* id) {
+    foxglove::schemas::SceneEntityDeletion deletion;
+    deletion.timestamp = stamp;
+    if (id) {
+        deletion.type = foxglove::schemas::SceneEntityDeletion::DeletionType::MATCHING_ID;
+        deletion.id = *id;
+    } else {
+        deletion.type = foxglove::schemas::SceneEntityDeletion::DeletionType::ALL;
+    }
+    return deletion;
+}
 
-void FoxgloveBridge::publishCube(
-    const std::shared_ptr<foxglove::schemas::SceneUpdateChannel>& scene_channel,
-    const std::shared_ptr<visualization_msgs::Marker>& marker) 
-{
-    if (!scene_channel) return;
+// Marker 对应的实体：id、坐标系、时间戳与生命周期，图元由 appendMarkerPrimitives 填写
+bool makeMarkerEntity(BridgeTopic& topic, const visualization_msgs::Marker& marker,
+                      foxglove::schemas::SceneEntity* entity) {
+    if (!simple_ros::appendMarkerPrimitives(marker, entity)) return false;
+    entity->id = simple_ros::MarkerDeltaTracker::entityId(marker);
+    entity->frame_id = marker.header().frame_id();
+    entity->timestamp = markerStamp(marker);
+    topic.latest_stamp_ns = std::max(topic.latest_stamp_ns, toNanos(*entity->timestamp));
+    if (marker.lifetime() > 0) {
+        // lifetime > 0 时客户端到期自动移除实体，0 或负数表示永久保留
+        double secs = marker.lifetime();
+        entity->lifetime = foxglove::schemas::Duration{
+            static_cast<int32_t>(secs), static_cast<uint32_t>((secs - static_cast<int32_t>(secs)) * 1e9)};
+    }
+    return true;
+}
 
-    foxglove::schemas::CubePrimitive cube;
-    cube.size = foxglove::schemas::Vector3{
-        marker->scale().x(),
-        marker->scale().y(),
-        marker->scale().z()
-    };
-    cube.color = foxglove::schemas::Color{
-        marker->color().r(),
-        marker->color().g(),
-        marker->color().b(),
-        marker->color().a()
-    };
-    foxglove::schemas::Pose pose;
-    pose.position = foxglove::schemas::Vector3{
-        marker->pose().position().x(),
-        marker->pose().position().y(),
-        marker->pose().position().z()
-    };
-    pose.orientation = foxglove::schemas::Quaternion{
-        marker->pose().orientation().x(),
-        marker->pose().orientation().y(),
-        marker->pose().orientation().z(),
-        marker->pose().orientation().w()
-    };
-    cube.pose = pose;
+} // namespace
+
+void FoxgloveBridge::onMarkerMessage(
+    BridgeTopic& topic,
+    const std::shared_ptr<visualization_msgs::Marker>& marker)
+{
+    if (!topic.scene_channel || !marker) return;
 
-    foxglove::schemas::SceneEntity entity;
-    entity.id = marker->ns() + "_cube"; // 保证每个topic独立
-    entity.cubes.push_back(cube);
+    if (topic.resync.exchange(false)) {
+        // 新客户端没有收到过已封存的轨迹分段，全部重发；缓存从这里重新记录，之后的新客户端直接补发
+        for (auto& traj : topic.trajectories) traj.second.resendAll();
+        resetSceneCache(topic);
+    }
 
     foxglove::schemas::SceneUpdate update;
-    update.entities.push_back(entity);
-    scene_channel->log(update);
+    switch (marker->action()) {
+        case visualization_msgs::DELETEALL:
+            topic.trajectories.clear();
+            update.deletions.push_back(makeDeletion(deletionStamp(topic), nullptr));
+            break;
+        case visualization_msgs::DELETE: {
+            const foxglove::schemas::Timestamp stamp = deletionStamp(topic);
+            auto traj = topic.trajectories.find(marker->ns());
+            if (marker->type() == visualization_msgs::LINE_STRIP && traj != topic.trajectories.end()) {
+                // 轨迹按 ns 累积，删除时连同已封存的分段一起删除
+                const std::string traj_id = marker->ns() + "_traj";
+                for (uint64_t seq : traj->second.sentChunks()) {
+                    const std::string id = traj_id + "_" + std::to_string(seq);
+                    update.deletions.push_back(makeDeletion(stamp, &id));
+                }
+                update.deletions.push_back(makeDeletion(stamp, &traj_id));
+                topic.trajectories.erase(traj);
+            } else {
+                const std::string id = simple_ros::MarkerDeltaTracker::entityId(*marker);
+                update.deletions.push_back(makeDeletion(stamp, &id));
+            }
+            break;
+        }
+        default:
+            if (marker->type() == visualization_msgs::LINE_STRIP) {
+                // 单条 Marker 的 LINE_STRIP 视为轨迹，逐条累积点
+                updateTrajectory(topic, marker);
+                return;
+            }
+            foxglove::schemas::SceneEntity entity;
+            if (!makeMarkerEntity(topic, *marker, &entity)) return;
+            update.entities.push_back(std::move(entity));
+            break;
+    }
+    logScene(topic, update);
 }
 
 void FoxgloveBridge::updateTrajectory(
-    const std::shared_ptr<foxglove::schemas::SceneUpdateChannel>& scene_channel,
+    BridgeTopic& topic,
     const std::shared_ptr<visualization_msgs::Marker>& marker) 
 {
+    const auto& scene_channel = topic.scene_channel;
     if (!scene_channel || !marker) return;
 
-    static std::unordered_map<std::string, std::deque<foxglove::schemas::Point3>> traj_points_map;
-    auto& traj_points = traj_points_map[marker->ns()];
+    // lifetime > 0 保留最近 ceil(lifetime) 个点，== 0 只保留最新的一个点，< 0 永久保留（分段发送）
+    const size_t window = simple_ros::TrajectoryBuffer::windowForLifetime(marker->lifetime());
+    const std::string traj_id = marker->ns() + "_traj";
+    const foxglove::schemas::Timestamp now = wallStamp();
+
+    foxglove::schemas::SceneUpdate update;
+    auto deleteEntity = [&update, &now](const std::string& id) {
+        foxglove::schemas::SceneEntityDeletion deletion;
+        deletion.timestamp = now;
+        deletion.type = foxglove::schemas::SceneEntityDeletion::DeletionType::MATCHING_ID;
+        deletion.id = id;
+        update.deletions.push_back(deletion);
+    };
+
+    // 轨迹按话题保存，只由该话题所在的转换线程访问；保留方式变化时丢弃旧轨迹及其分段
+    auto it = topic.trajectories.find(marker->ns());
+    if (it != topic.trajectories.end() && it->second.window() != window) {
+        for (uint64_t seq : it->second.sentChunks()) deleteEntity(traj_id + "_" + std::to_string(seq));
+        topic.trajectories.erase(it);
+        it = topic.trajectories.end();
+    }
+    if (it == topic.trajectories.end()) {
+        it = topic.trajectories.emplace(marker->ns(), simple_ros::TrajectoryBuffer(window, trajectory_options_)).first;
+    }
+    simple_ros::TrajectoryBuffer& traj = it->second;
 
     if (marker->points_size() > 0) {
         // 如果 marker 自带点集，直接取出来
         for (const auto& pt : marker->points()) {
-            traj_points.push_back({
-                pt.x(),
-                pt.y(),
-                pt.z()
-            });
+            traj.append({pt.x(), pt.y(), pt.z()});
         }
     } else {
         // 否则退化为使用 pose().position()
-        traj_points.push_back({
-            marker->pose().position().x(),
-            marker->pose().position().y(),
-            marker->pose().position().z()
-        });
+        traj.append({marker->pose().position().x(), marker->pose().position().y(), marker->pose().position().z()});
     }
 
-    if(marker->lifetime() < 0){
-        // 永久保留
-        while (traj_points.size() > 10000) { // 限制最大点数，防止内存无限增长
-            traj_points.pop_front();
-        }
-    } else if(marker->lifetime() == 0){
-        // 只保留最新的一个点
-        while (traj_points.size() > 1) {
-            traj_points.pop_front();
-        }
-    } else if(marker->lifetime() > 0){
-        // 保留最近 N 个点
-        while (traj_points.size() > (int)marker->lifetime()) { 
-            traj_points.pop_front();
+    foxglove::schemas::LinePrimitive line;
+    line.type = foxglove::schemas::LinePrimitive::LineType::LINE_STRIP;
+    line.thickness = std::max({marker->scale().x(), marker->scale().y(), marker->scale().z()}) * 0.2;
+    line.scale_invariant = false;
+    line.color = foxglove::schemas::Color{
+        marker->color().r(),
+        marker->color().g(),
+        marker->color().b(),
+        marker->color().a()
+    };
+    auto makeEntity = [&line](const std::string& id, const std::vector<simple_ros::TrajectoryPoint>& points) {
+        foxglove::schemas::SceneEntity entity;
+        entity.id = id;
+        if (!points.empty()) {
+            foxglove::schemas::LinePrimitive segment = line;
+            segment.points.reserve(points.size());
+            for (const auto& p : points) segment.points.push_back({p.x, p.y, p.z});
+            entity.lines.push_back(std::move(segment));
         }
-    }
-
-
-    foxglove::schemas::SceneEntity traj_entity;
-    traj_entity.id = marker->ns() + "_traj";
+        return entity;
+    };
 
-    if (!traj_points.empty()) {
-        foxglove::schemas::LinePrimitive line;
-        line.type = foxglove::schemas::LinePrimitive::LineType::LINE_STRIP;
-        line.thickness = std::max({marker->scale().x(), marker->scale().y(), marker->scale().z()}) * 0.2;
-        line.scale_invariant = false;
-        line.color = foxglove::schemas::Color{
-            marker->color().r(),
-            marker->color().g(),
-            marker->color().b(),
-            marker->color().a()
-        };
-        line.points.assign(traj_points.begin(), traj_points.end());
-        traj_entity.lines.push_back(line);
+    // 已封存的分段只发送一次，被淘汰的分段通知客户端删除；每次只重发尾段
+    std::vector<const simple_ros::TrajectoryBuffer::Chunk*> sealed;
+    std::vector<uint64_t> evicted;
+    traj.takeChanges(&sealed, &evicted);
+    for (uint64_t seq : evicted) deleteEntity(traj_id + "_" + std::to_string(seq));
+    for (const auto* chunk : sealed) {
+        update.entities.push_back(makeEntity(traj_id + "_" + std::to_string(chunk->seq), chunk->points));
     }
-
-    foxglove::schemas::SceneUpdate update;
-    update.entities.push_back(traj_entity);
-    scene_channel->log(update);
+    update.entities.push_back(makeEntity(traj_id, traj.tail()));
+    logScene(topic, update);
 }
 
 
 void FoxgloveBridge::onMarkerArrayMessage(
-    const std::string& topic_name,
+    BridgeTopic& topic,
     const std::shared_ptr<visualization_msgs::MarkerArray>& marker_array) 
 {
-    if (!marker_array) return;
+    const auto& scene_channel = topic.scene_channel;
+    if (!scene_channel || !marker_array) return;
+
+    if (topic.resync.exchange(false)) {
+        // 清空后这条消息会发送全部实体，缓存随之重新完整
+        topic.markers.clear();
+        resetSceneCache(topic);
+    }
 
-    auto scene_channel = createOrGetSceneChannel(topic_name);
-    if (!scene_channel) return;
+    // 只发送相对上次变化的实体，以及 DELETE/DELETEALL 对应的删除
+    simple_ros::MarkerDelta delta = topic.markers.apply(*marker_array, simple_ros::MarkerDeltaTracker::Clock::now());
+    if (delta.empty()) return;
 
     foxglove::schemas::SceneUpdate update;
+    if (delta.delete_all || !delta.deleted.empty()) {
+        const foxglove::schemas::Timestamp stamp = deletionStamp(topic);
+        if (delta.delete_all) update.deletions.push_back(makeDeletion(stamp, nullptr));
+        for (const auto& id : delta.deleted) update.deletions.push_back(makeDeletion(stamp, &id));
+    }
 
-    for (const auto& marker : marker_array->markers()) {
+    for (const auto* changed : delta.changed) {
         foxglove::schemas::SceneEntity entity;
-        entity.id = marker.ns() + "_" + std::to_string(marker.id());
-
-        switch (marker.type()) {
-            case visualization_msgs::MarkerType::CUBE: {
-                foxglove::schemas::CubePrimitive cube;
-                cube.size = {marker.scale().x(), marker.scale().y(), marker.scale().z()};
-                cube.color = {marker.color().r(), marker.color().g(), marker.color().b(), marker.color().a()};
-                foxglove::schemas::Pose pose;
-                pose.position = {marker.pose().position().x(), marker.pose().position().y(), marker.pose().position().z()};
-                pose.orientation = {marker.pose().orientation().x(), marker.pose().orientation().y(),
-                                         marker.pose().orientation().z(), marker.pose().orientation().w()};
-                cube.pose = pose;
-                entity.cubes.push_back(cube);
-                break;
-            }
-            case visualization_msgs::MarkerType::CYLINDER: {
-                foxglove::schemas::CylinderPrimitive cylinder;
-                cylinder.size = {marker.scale().x(), marker.scale().y(), marker.scale().z()};
-                cylinder.color = {marker.color().r(), marker.color().g(), marker.color().b(), marker.color().a()};
-                foxglove::schemas::Pose pose;
-                pose.position = {marker.pose().position().x(), marker.pose().position().y(), marker.pose().position().z()};
-                pose.orientation = {marker.pose().orientation().x(), marker.pose().orientation().y(),
-                                             marker.pose().orientation().z(), marker.pose().orientation().w()};
-                cylinder.pose = pose;
-                cylinder.bottom_scale = 1.0;
-                cylinder.top_scale = 1.0;
-                entity.cylinders.push_back(cylinder);
-                break;
-            }
-            case visualization_msgs::MarkerType::LINE_STRIP: {
-                foxglove::schemas::LinePrimitive line;
-                line.type = foxglove::schemas::LinePrimitive::LineType::LINE_STRIP;
-                line.points.reserve(marker.points_size());
-                for (const auto& pt : marker.points()) {
-                    line.points.push_back({pt.x(), pt.y(), pt.z()});
-                }
-                line.color = {marker.color().r(), marker.color().g(), marker.color().b(), marker.color().a()};
-                line.thickness = std::max({marker.scale().x(), marker.scale().y(), marker.scale().z()}) * 0.2;
-                entity.lines.push_back(line);
-                break;
-            }
-            default:
-                break; // 可根据需要扩展其他类型
-        }
-
-        update.entities.push_back(entity);
+        if (!makeMarkerEntity(topic, *changed, &entity)) continue;
+        update.entities.push_back(std::move(entity));
     }
 
-    scene_channel->log(update);
+    logScene(topic, update);
 }
 
 
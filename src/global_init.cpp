@@ -1,11 +1,29 @@
 #include "global_init.h"
 #include <muduo/base/Logging.h>
+#include <algorithm>
 #include <chrono>
 #include <thread>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include <future>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
 #include "ros_rpc_client.h"  // 添加ROS RPC客户端头文件
+#include "unix_transport.h"
+#include "clock.h"
+#include "msg_factory.h"
+#include "rosgraph_msgs.pb.h"
 
 using namespace simple_ros;
 
+namespace {
+// deadline 检查的最短周期（秒）
+const double kMinDeadlineCheckInterval = 0.01;
+}
+
 SystemManager& SystemManager::instance() {
     static SystemManager inst;
     return inst;
@@ -30,40 +48,177 @@ void SystemManager::init(int port, std::string node_name) {
 }
 
 void SystemManager::init(const std::string& node_name) {
-    int port = findAvailablePort();
-    if (port < 0) {
-        LOG_ERROR << "No available port found in range 60000-61000";
-        throw std::runtime_error("No available port for node initialization");
-    }
-
-    // 调用原来的手动端口版本
-    init(port, node_name);
+    // 端口 0：由内核分配
+    init(0, node_name);
 }
 
 void SystemManager::init(int port) {
+    using StartupClock = std::chrono::steady_clock;
+    auto elapsedMs = [](StartupClock::time_point since) {
+        return std::chrono::duration<double, std::milli>(StartupClock::now() - since).count();
+    };
+    const auto init_start = StartupClock::now();
+    startupTimings_ = StartupTimings();
+
+    // 实时调优：先锁定内存，之后创建的线程栈与分配都不再缺页
+    auto phase_start = StartupClock::now();
+    const char* rt_env = std::getenv("SIMPLE_ROS_RT_PROFILE");
+    if (rt_env && *rt_env) {
+        std::string error;
+        if (!RealtimeProfile::loadFile(rt_env, &rtProfile_, &error)) {
+            LOG_ERROR << "Ignoring realtime profile: " << error;
+        }
+    }
+    rtProfile_.lockMemory();
+    startupTimings_.realtime_ms = elapsedMs(phase_start);
+
+    // 端口 0 时绑定临时套接字获取内核分配的端口，监听就绪前一直占用，避免被其他进程抢走
+    phase_start = StartupClock::now();
+    int reserved_fd = -1;
+    if (port == 0) {
+        port = reservePort(&reserved_fd);
+        if (port < 0) {
+            LOG_ERROR << "Failed to obtain a port from the kernel";
+            throw std::runtime_error("No available port for node initialization");
+        }
+    }
+    nodeInfo_.set_port(port);
+    if (nodeInfo_.ip().empty()) nodeInfo_.set_ip("127.0.0.1");
+    startupTimings_.port_ms = elapsedMs(phase_start);
+
     if (!messageQueue_) {
         messageQueue_ = std::make_shared<MessageQueue>();
     }
 
     // 创建全局RPC客户端，连接到主服务器
+    phase_start = StartupClock::now();
     rpcClient_ = std::make_shared<RosRpcClient>("localhost:50051");
+    startupTimings_.rpc_client_ms = elapsedMs(phase_start);
     LOG_INFO << "Global RosRpcClient initialized";
 
-    // 启动后台线程
-    eventThread_ = std::thread([this, port]() {  // <-- 显式捕获 port
+    // 可选 io_uring 数据面
+    const char* backend_env = std::getenv("SIMPLE_ROS_IO_BACKEND");
+    if (backend_env && std::strcmp(backend_env, "io_uring") == 0) {
+        ioBackend_ = IoBackend::IO_URING;
+    }
+    if (ioBackend_ == IoBackend::IO_URING && !ioUring_) {
+        if (IoUringBackend::available()) {
+            ioUring_ = std::make_shared<IoUringBackend>();
+            if (rtProfile_.enabled()) {
+                ioUring_->setThreadInitCallback([this]() { rtProfile_.applyToCurrentThread(ThreadRole::IO_URING); });
+            }
+            if (ioUring_->start()) {
+                LOG_INFO << "Using io_uring data plane";
+            } else {
+                LOG_ERROR << "io_uring backend failed to start, falling back to muduo";
+                ioUring_.reset();
+            }
+        } else {
+            LOG_WARN << "io_uring backend unavailable, falling back to muduo";
+        }
+    }
+
+    // 接收消息的 Arena 分配方式与对象池容量
+    const char* arena_env = std::getenv("SIMPLE_ROS_MSG_ARENA");
+    if (arena_env && std::strcmp(arena_env, "message") == 0) {
+        MsgFactory::instance().setArenaMode(ArenaMode::PER_MESSAGE);
+    } else if (arena_env && std::strcmp(arena_env, "batch") == 0) {
+        MsgFactory::instance().setArenaMode(ArenaMode::PER_BATCH);
+    }
+    const char* pool_env = std::getenv("SIMPLE_ROS_MSG_POOL");
+    if (pool_env && *pool_env) {
+        MsgFactory::instance().setPoolCapacity(std::strtoul(pool_env, nullptr, 10));
+    }
+
+    // 仿真时间：/clock 消息在接收线程中直接推进 Clock，不依赖 spin
+    const char* sim_env = std::getenv("SIMPLE_ROS_USE_SIM_TIME");
+    if (sim_env && std::strcmp(sim_env, "1") == 0) {
+        useSimTime_ = true;
+    }
+    if (useSimTime_) {
+        if (!Clock::instance().isSimTime()) {
+            Clock::instance().enableSimTime(0.0);
+        }
+        messageQueue_->setInlineHandler(Clock::kClockTopic,
+            [](const std::shared_ptr<google::protobuf::Message>& msg) {
+                // 接收路径上的消息由 DynamicMessageFactory 创建，按描述符拷贝到具体类型
+                if (msg->GetDescriptor() != rosgraph_msgs::Clock::descriptor()) return;
+                rosgraph_msgs::Clock clock_msg;
+                clock_msg.CopyFrom(*msg);
+                Clock::instance().setSimTime(Clock::fromMsg(clock_msg.clock()));
+            });
+    }
+
+    // 同机节点通过 Unix 域套接字通信，路径随 NodeInfo 注册到 Master
+    std::string unix_path = unix_transport::defaultSocketPath(port);
+    nodeInfo_.set_unix_path(unix_path);
+    nodeInfo_.set_host_id(unix_transport::localHostId());
+
+    // 定时器与发布者连接单独一个线程，不与接收解析争抢；startLoop 返回时循环已就绪
+    phase_start = StartupClock::now();
+    if (ioThreadConfig_.dedicated_timer_loop && !timerThread_) {
+        muduo::net::EventLoopThread::ThreadInitCallback timer_init;
+        if (rtProfile_.enabled()) {
+            timer_init = [this](muduo::net::EventLoop*) { rtProfile_.applyToCurrentThread(ThreadRole::TIMER); };
+        }
+        timerThread_.reset(new muduo::net::EventLoopThread(timer_init, "TimerLoop"));
+        timerLoop_ = timerThread_->startLoop();
+    }
+    startupTimings_.timer_loop_ms = elapsedMs(phase_start);
+
+    // 启动后台线程，监听就绪后通过 ready 通知，init 返回时 eventLoop_/pollManager_ 均可用
+    phase_start = StartupClock::now();
+    std::promise<void> ready;
+    std::future<void> ready_future = ready.get_future();
+    eventThread_ = std::thread([this, port, unix_path, &ready]() {  // <-- 显式捕获 port
+        if (rtProfile_.enabled()) rtProfile_.applyToCurrentThread(ThreadRole::EVENT);
         eventLoop_ = std::make_shared<muduo::net::EventLoop>();
 
         muduo::net::InetAddress listenAddr("127.0.0.1", port);
-        pollManager_ = std::make_shared<PollManager>(eventLoop_.get(), listenAddr);
+        pollManager_ = std::make_shared<PollManager>(eventLoop_.get(), listenAddr, unix_path);
+        if (ioUring_) {
+            pollManager_->useIoUring(ioUring_);
+        }
+        // 接收连接按轮询固定到各 IO 线程
+        pollManager_->setThreadNum(ioThreadConfig_.receive_threads);
+        if (rtProfile_.enabled()) {
+            pollManager_->setThreadInitCallback([this]() { rtProfile_.applyToCurrentThread(ThreadRole::RECEIVE); });
+        }
 
         pollManager_->start();
         LOG_INFO << "PollManager started in background thread";
+        ready.set_value();
 
         eventLoop_->loop();  // 阻塞直到 quit()
 
         pollManager_.reset();
         eventLoop_.reset();
     });
+    ready_future.wait();
+    if (reserved_fd >= 0) ::close(reserved_fd);
+    startupTimings_.listener_ms = elapsedMs(phase_start);
+    // UDP 接收端是否可用随 NodeInfo 注册到 Master，发布者据此决定 BEST_EFFORT 话题是否对本节点使用 UDP
+    nodeInfo_.set_udp(pollManager_->udpEnabled());
+
+    // 监听就绪后再订阅 /clock，发布者收到目标更新时可以立即连接
+    if (useSimTime_) {
+        phase_start = StartupClock::now();
+        SubscribeResponse response;
+        if (!rpcClient_->Subscribe(Clock::kClockTopic, rosgraph_msgs::Clock::descriptor()->full_name(),
+                                   nodeInfo_, &response)) {
+            LOG_ERROR << "Subscribe RPC failed for " << Clock::kClockTopic;
+        }
+        startupTimings_.clock_subscribe_ms = elapsedMs(phase_start);
+    }
+
+    startupTimings_.total_ms = elapsedMs(init_start);
+    LOG_INFO << "Node " << nodeInfo_.node_name() << " ready on port " << port
+             << " in " << startupTimings_.total_ms << " ms (realtime " << startupTimings_.realtime_ms
+             << ", port " << startupTimings_.port_ms
+             << ", rpc client " << startupTimings_.rpc_client_ms
+             << ", timer loop " << startupTimings_.timer_loop_ms
+             << ", listener " << startupTimings_.listener_ms
+             << ", clock " << startupTimings_.clock_subscribe_ms << ")";
 }
 
 
@@ -72,11 +227,27 @@ void SystemManager::init() {
 }
 
 void SystemManager::spin() {
+    if (rtProfile_.enabled()) rtProfile_.applyToCurrentThread(ThreadRole::SPIN);
     while (running_) {
-        if (messageQueue_) {
-            messageQueue_->processCallbacks();
+        if (!messageQueue_) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            continue;
+        }
+        // 队列空闲时等待新消息，最多 1ms 后重新检查 running_
+        if (!messageQueue_->processCallbacks()) {
+            messageQueue_->waitForWork(std::chrono::milliseconds(1));
         }
-        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+
+void SystemManager::spin(int num_threads) {
+    std::vector<std::thread> spinners;
+    for (int i = 1; i < num_threads; ++i) {
+        spinners.emplace_back([this]() { spin(); });
+    }
+    spin();
+    for (auto& t : spinners) {
+        t.join();
     }
 }
 
@@ -87,37 +258,102 @@ void SystemManager::spinOnce() {
     std::this_thread::sleep_for(std::chrono::milliseconds(1));
 }
 
+std::shared_ptr<TimingWheel> SystemManager::getTimingWheel() {
+    std::lock_guard<std::mutex> lock(timingWheelMutex_);
+    if (!timingWheel_) {
+        muduo::net::EventLoop* loop = getTimerLoop();
+        if (!loop) {
+            LOG_ERROR << "getTimingWheel called before EventLoop is ready";
+            return nullptr;
+        }
+        timingWheel_ = std::make_shared<TimingWheel>(loop, timingWheelOptions_);
+    }
+    return timingWheel_;
+}
+
+void SystemManager::updateDeadlineCheck() {
+    muduo::net::EventLoop* loop = getTimerLoop();
+    if (!running_ || !messageQueue_ || !loop) return;
+    // 周期检查订阅话题的 deadline：发布者停止发布、没有新消息到达时也能记录错过；
+    // 没有 deadline 时不启用，避免定时器线程无谓地周期唤醒
+    double deadline = messageQueue_->minDeadline();
+    double period = deadline > 0 ? std::max(deadline / 2, kMinDeadlineCheckInterval) : 0.0;
+
+    std::lock_guard<std::mutex> lock(deadlineCheckMutex_);
+    if (period == deadlineCheckPeriod_) return;
+    if (deadlineCheckPeriod_ > 0) loop->cancel(deadlineCheckTimer_);
+    deadlineCheckPeriod_ = period;
+    if (period > 0) {
+        std::weak_ptr<MessageQueue> weak_queue = messageQueue_;
+        deadlineCheckTimer_ = loop->runEvery(period, [weak_queue]() {
+            if (auto queue = weak_queue.lock()) queue->checkDeadlines();
+        });
+    }
+}
+
 void SystemManager::shutdown() {
     running_ = false;
-    // 1. 安全退出 EventLoop
+    // 唤醒阻塞在 Rate::sleep / Clock::sleepUntil 中的线程
+    Clock::instance().interrupt();
+    // 1. 时间轮须在其 EventLoop 退出前注销 Channel；用户仍持有的引用之后析构时不再访问 EventLoop
+    {
+        std::lock_guard<std::mutex> lock(timingWheelMutex_);
+        if (timingWheel_) timingWheel_->detach();
+        timingWheel_.reset();
+    }
+    // 2. 安全退出 EventLoop
     if (eventLoop_) {
         eventLoop_->runInLoop([this]() { eventLoop_->quit(); });
     }
-    // 2. 等待后台线程退出
+    // 3. 等待后台线程退出
     if (eventThread_.joinable()) {
         eventThread_.join();
     }
+    // 4. 退出定时器线程（EventLoopThread 析构时 quit 并 join），其上的定时器随之失效
+    {
+        std::lock_guard<std::mutex> lock(deadlineCheckMutex_);
+        deadlineCheckPeriod_ = 0.0;
+    }
+    timerLoop_ = nullptr;
+    timerThread_.reset();
+    if (ioUring_) {
+        ioUring_->stop();
+        ioUring_.reset();
+    }
     messageQueue_.reset();
     LOG_INFO << "SystemManager shutdown complete";
 }
 
 
-int SystemManager::findAvailablePort(int start_port, int end_port) {
-    for (int port = start_port; port <= end_port; ++port) {
-        int sock = socket(AF_INET, SOCK_STREAM, 0);
-        if (sock < 0) continue;
+int SystemManager::reservePort(int* reserved_fd) {
+    // 内核分配的端口偶尔与已占用的 UDP 端口同号，换一个重试
+    for (int attempt = 0; attempt < 16; ++attempt) {
+        int sock = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (sock < 0) return -1;
+        // 与 muduo Acceptor 一样设置 SO_REUSEADDR，未 listen 的占位套接字不妨碍其绑定同一端口
+        int on = 1;
+        setsockopt(sock, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
 
         sockaddr_in addr{};
         addr.sin_family = AF_INET;
-        addr.sin_addr.s_addr = INADDR_ANY;
-        addr.sin_port = htons(port);
-
-        int bind_result = bind(sock, (struct sockaddr*)&addr, sizeof(addr));
-        close(sock);
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        addr.sin_port = 0;
+        socklen_t len = sizeof(addr);
+        if (bind(sock, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 ||
+            getsockname(sock, reinterpret_cast<sockaddr*>(&addr), &len) != 0) {
+            close(sock);
+            return -1;
+        }
 
-        if (bind_result == 0) {
-            return port;  // 找到可用端口
+        // BEST_EFFORT 话题使用同一端口的 UDP
+        int udp_sock = socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+        int udp_result = udp_sock < 0 ? -1 : bind(udp_sock, reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
+        if (udp_sock >= 0) close(udp_sock);
+        if (udp_result == 0) {
+            *reserved_fd = sock;
+            return ntohs(addr.sin_port);
         }
+        close(sock);
     }
-    return -1; // 没有可用端口
+    return -1;
 }
@@ -0,0 +1,657 @@
+#include "io_uring_backend.h"
+#include <muduo/base/Logging.h>
+
+#ifdef SIMPLE_ROS_HAVE_IO_URING
+
+#include "wire_format.h"
+#include <liburing.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+// user_data 高 8 位为操作类型，低 56 位为连接 ID
+enum OpType : uint64_t {
+    OP_WAKEUP = 1,
+    OP_ACCEPT = 2,
+    OP_RECV = 3,
+    OP_SEND = 4,
+    OP_CONNECT = 5,
+};
+
+constexpr uint16_t kBufferGroup = 1;
+
+inline uint64_t packUserData(OpType op, uint64_t id) { return (static_cast<uint64_t>(op) << 56) | id; }
+inline OpType opOf(uint64_t data) { return static_cast<OpType>(data >> 56); }
+inline uint64_t idOf(uint64_t data) { return data & ((1ULL << 56) - 1); }
+
+// 在 ring 上实际注册一个 provided buffer ring 并提交一次 multishot recv：
+// buf ring 需要内核 5.19+，multishot recv 需要 6.0+（旧内核对其返回 -EINVAL），只探测 opcode 无法区分
+bool probeBufRingRecv(io_uring* ring) {
+    constexpr unsigned kEntries = 2;
+    constexpr unsigned kSize = 64;
+    int ret = 0;
+    io_uring_buf_ring* br = io_uring_setup_buf_ring(ring, kEntries, kBufferGroup, 0, &ret);
+    if (!br) return false;
+    char bufs[kEntries][kSize];
+    for (unsigned i = 0; i < kEntries; ++i) {
+        io_uring_buf_ring_add(br, bufs[i], kSize, i, io_uring_buf_ring_mask(kEntries), i);
+    }
+    io_uring_buf_ring_advance(br, kEntries);
+
+    bool ok = false;
+    int sv[2];
+    if (::socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, sv) == 0) {
+        io_uring_sqe* sqe = io_uring_get_sqe(ring);
+        io_uring_prep_recv_multishot(sqe, sv[0], nullptr, 0, 0);
+        sqe->flags |= IOSQE_BUFFER_SELECT;
+        sqe->buf_group = kBufferGroup;
+        if (::write(sv[1], "x", 1) == 1 && io_uring_submit(ring) == 1) {
+            __kernel_timespec timeout{1, 0};
+            io_uring_cqe* cqe = nullptr;
+            if (io_uring_wait_cqe_timeout(ring, &cqe, &timeout) == 0) {
+                ok = cqe->res == 1 && (cqe->flags & IORING_CQE_F_BUFFER);
+                bool more = cqe->flags & IORING_CQE_F_MORE;
+                io_uring_cqe_seen(ring, cqe);
+                // 关闭对端让 multishot 以 EOF 结束，之后才能释放 buf ring
+                ::shutdown(sv[1], SHUT_RDWR);
+                while (more && io_uring_wait_cqe_timeout(ring, &cqe, &timeout) == 0) {
+                    more = cqe->flags & IORING_CQE_F_MORE;
+                    io_uring_cqe_seen(ring, cqe);
+                }
+            }
+        }
+        ::close(sv[0]);
+        ::close(sv[1]);
+    }
+    io_uring_free_buf_ring(ring, br, kEntries, kBufferGroup);
+    return ok;
+}
+
+} // namespace
+
+class IoUringBackend::Impl {
+public:
+    explicit Impl(const IoUringOptions& options) : options_(options) {}
+
+    ~Impl() { stop(); cleanup(); }
+
+    bool init() {
+        io_uring_params params{};
+#if defined(IORING_SETUP_SUBMIT_ALL) && defined(IORING_SETUP_COOP_TASKRUN)
+        params.flags = IORING_SETUP_SUBMIT_ALL | IORING_SETUP_COOP_TASKRUN;
+#endif
+        int ret = io_uring_queue_init_params(options_.queue_depth, &ring_, &params);
+        if (ret < 0) {
+            // 旧内核不支持上述标志时退回默认参数
+            params = io_uring_params{};
+            ret = io_uring_queue_init_params(options_.queue_depth, &ring_, &params);
+        }
+        if (ret < 0) {
+            LOG_WARN << "io_uring_queue_init failed: " << strerror(-ret);
+            return false;
+        }
+        ringInited_ = true;
+
+        // 接收：provided buffer ring，由内核为每次 recv 挑选缓冲区
+        recvPool_.resize(static_cast<size_t>(options_.recv_buffer_count) * options_.recv_buffer_size);
+        bufRing_ = io_uring_setup_buf_ring(&ring_, options_.recv_buffer_count, kBufferGroup, 0, &ret);
+        if (!bufRing_) {
+            LOG_WARN << "io_uring_setup_buf_ring failed: " << strerror(-ret);
+            return false;
+        }
+        for (unsigned i = 0; i < options_.recv_buffer_count; ++i) {
+            io_uring_buf_ring_add(bufRing_, recvBuffer(i), options_.recv_buffer_size, i,
+                                  io_uring_buf_ring_mask(options_.recv_buffer_count), i);
+        }
+        io_uring_buf_ring_advance(bufRing_, options_.recv_buffer_count);
+
+        // 发送：注册固定缓冲区，避免每次提交时内核 pin 用户页
+        sendPool_.resize(static_cast<size_t>(options_.send_slab_count) * options_.send_slab_size);
+        std::vector<iovec> iovecs(options_.send_slab_count);
+        for (unsigned i = 0; i < options_.send_slab_count; ++i) {
+            iovecs[i].iov_base = sendSlab(i);
+            iovecs[i].iov_len = options_.send_slab_size;
+            freeSlabs_.push_back(static_cast<int>(i));
+        }
+        ret = io_uring_register_buffers(&ring_, iovecs.data(), iovecs.size());
+        if (ret < 0) {
+            LOG_WARN << "io_uring_register_buffers failed: " << strerror(-ret) << ", using plain send";
+            freeSlabs_.clear();
+        }
+
+        wakeFd_ = ::eventfd(0, EFD_CLOEXEC);
+        if (wakeFd_ < 0) return false;
+        armWakeup();
+        ready_ = true;
+        return true;
+    }
+
+    bool listen(const std::string& ip, uint16_t port) {
+        int fd = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (fd < 0) return false;
+        int on = 1;
+        ::setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(port);
+        ::inet_pton(AF_INET, ip.c_str(), &addr.sin_addr);
+        if (::bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0 || ::listen(fd, SOMAXCONN) < 0) {
+            LOG_WARN << "IoUringBackend: bind/listen " << ip << ":" << port << " failed, errno=" << errno;
+            ::close(fd);
+            return false;
+        }
+        listenFd_ = fd;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            pendingAccept_ = true;
+        }
+        wakeup();
+        LOG_INFO << "IoUringBackend listening on " << ip << ":" << port;
+        return true;
+    }
+
+    // 连接由 io_uring 线程异步建立，调用线程不阻塞
+    int64_t connect(const std::string& ip, uint16_t port) {
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(port);
+        if (::inet_pton(AF_INET, ip.c_str(), &addr.sin_addr) != 1) {
+            LOG_WARN << "IoUringBackend: invalid address " << ip;
+            return -1;
+        }
+        int fd = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (fd < 0) return -1;
+
+        int64_t id;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            id = nextConnId_++;
+            Conn& c = conns_[id];
+            c.fd = fd;
+            c.connecting = true;
+            c.peer = addr;
+            pendingConnects_.push_back(id);
+        }
+        wakeup();
+        return id;
+    }
+
+    bool send(int64_t id, std::string frame) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto it = conns_.find(id);
+            if (it == conns_.end() || it->second.closed) return false;
+            it->second.outq.push_back(std::move(frame));
+            if (it->second.sending || it->second.dirty) return true;
+            it->second.dirty = true;
+            dirtyConns_.push_back(id);
+        }
+        wakeup();
+        return true;
+    }
+
+    bool isConnected(int64_t id) const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = conns_.find(id);
+        return it != conns_.end() && !it->second.closed;
+    }
+
+    void close(int64_t id) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto it = conns_.find(id);
+            if (it == conns_.end()) return;
+            it->second.closed = true;
+            closingConns_.push_back(id);
+        }
+        wakeup();
+    }
+
+    bool start() {
+        // init 失败时没有唤醒用的 eventfd，线程会永远阻塞在 submit_and_wait 中，stop 也无法唤醒
+        if (!ready_) return false;
+        if (running_.exchange(true)) return true;
+        thread_ = std::thread([this]() {
+            if (threadInitCallback_) threadInitCallback_();
+            run();
+        });
+        return true;
+    }
+
+    void stop() {
+        if (!running_.exchange(false)) return;
+        wakeup();
+        if (thread_.joinable()) thread_.join();
+    }
+
+    void setFrameCallback(FrameCallback cb) { frameCallback_ = std::move(cb); }
+    void setThreadInitCallback(std::function<void()> cb) { threadInitCallback_ = std::move(cb); }
+
+    Stats stats() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return stats_;
+    }
+
+private:
+    struct Conn {
+        int fd = -1;
+        bool closed = false;
+        bool connecting = false;  // 主动连接尚未完成，期间 send 的帧在 outq 中排队
+        sockaddr_in peer{};       // 主动连接的目标地址，connect 在途时须保持有效
+        bool sending = false;     // 已有发送在途，保证同一连接按序发送
+        bool dirty = false;       // 已加入 dirtyConns_
+        bool recvArmed = false;
+        std::deque<std::string> outq;
+        std::string inflight;     // 非固定缓冲区发送时持有数据
+        size_t inflightOff = 0;
+        size_t inflightLen = 0;
+        int slab = -1;            // 使用的固定缓冲区下标
+        std::string inbuf;        // 接收拼帧缓冲
+    };
+
+    char* recvBuffer(unsigned bid) { return recvPool_.data() + static_cast<size_t>(bid) * options_.recv_buffer_size; }
+    char* sendSlab(int idx) { return sendPool_.data() + static_cast<size_t>(idx) * options_.send_slab_size; }
+
+    void wakeup() {
+        if (wakeFd_ < 0) return;
+        uint64_t one = 1;
+        ssize_t n = ::write(wakeFd_, &one, sizeof(one));
+        (void)n;
+    }
+
+    io_uring_sqe* getSqe() {
+        io_uring_sqe* sqe = io_uring_get_sqe(&ring_);
+        if (!sqe) {
+            // SQ 已满：先提交已有请求再取
+            io_uring_submit(&ring_);
+            ++stats_.submit_calls;
+            sqe = io_uring_get_sqe(&ring_);
+        }
+        if (sqe) ++stats_.sqes;
+        return sqe;
+    }
+
+    void armWakeup() {
+        io_uring_sqe* sqe = getSqe();
+        io_uring_prep_read(sqe, wakeFd_, &wakeValue_, sizeof(wakeValue_), 0);
+        io_uring_sqe_set_data64(sqe, packUserData(OP_WAKEUP, 0));
+    }
+
+    void armAccept() {
+        io_uring_sqe* sqe = getSqe();
+        io_uring_prep_multishot_accept(sqe, listenFd_, nullptr, nullptr, SOCK_CLOEXEC);
+        io_uring_sqe_set_data64(sqe, packUserData(OP_ACCEPT, 0));
+    }
+
+    void armConnect(int64_t id, Conn& c) {
+        io_uring_sqe* sqe = getSqe();
+        io_uring_prep_connect(sqe, c.fd, reinterpret_cast<sockaddr*>(&c.peer), sizeof(c.peer));
+        io_uring_sqe_set_data64(sqe, packUserData(OP_CONNECT, static_cast<uint64_t>(id)));
+    }
+
+    void armRecv(int64_t id, Conn& c) {
+        io_uring_sqe* sqe = getSqe();
+        io_uring_prep_recv_multishot(sqe, c.fd, nullptr, 0, 0);
+        sqe->flags |= IOSQE_BUFFER_SELECT;
+        sqe->buf_group = kBufferGroup;
+        io_uring_sqe_set_data64(sqe, packUserData(OP_RECV, static_cast<uint64_t>(id)));
+        c.recvArmed = true;
+    }
+
+    // 合并该连接排队的所有帧，提交一次发送
+    void submitSend(int64_t id, Conn& c) {
+        if (c.connecting || c.sending || c.outq.empty() || c.closed) return;
+
+        size_t total = 0;
+        for (const auto& f : c.outq) total += f.size();
+
+        io_uring_sqe* sqe = getSqe();
+        if (!freeSlabs_.empty() && total <= options_.send_slab_size) {
+            c.slab = freeSlabs_.back();
+            freeSlabs_.pop_back();
+            char* p = sendSlab(c.slab);
+            for (const auto& f : c.outq) {
+                memcpy(p, f.data(), f.size());
+                p += f.size();
+            }
+            io_uring_prep_write_fixed(sqe, c.fd, sendSlab(c.slab), total, 0, c.slab);
+        } else {
+            c.inflight.clear();
+            c.inflight.reserve(total);
+            for (const auto& f : c.outq) c.inflight.append(f);
+            io_uring_prep_send(sqe, c.fd, c.inflight.data(), total, MSG_NOSIGNAL);
+        }
+        c.outq.clear();
+        c.inflightOff = 0;
+        c.inflightLen = total;
+        c.sending = true;
+        io_uring_sqe_set_data64(sqe, packUserData(OP_SEND, static_cast<uint64_t>(id)));
+    }
+
+    // 部分写入时提交剩余部分
+    void resubmitRemainder(int64_t id, Conn& c) {
+        io_uring_sqe* sqe = getSqe();
+        size_t remain = c.inflightLen - c.inflightOff;
+        if (c.slab >= 0) {
+            io_uring_prep_write_fixed(sqe, c.fd, sendSlab(c.slab) + c.inflightOff, remain, 0, c.slab);
+        } else {
+            io_uring_prep_send(sqe, c.fd, c.inflight.data() + c.inflightOff, remain, MSG_NOSIGNAL);
+        }
+        io_uring_sqe_set_data64(sqe, packUserData(OP_SEND, static_cast<uint64_t>(id)));
+    }
+
+    void releaseSendBuffer(Conn& c) {
+        if (c.slab >= 0) {
+            freeSlabs_.push_back(c.slab);
+            c.slab = -1;
+        }
+        c.inflight.clear();
+        c.sending = false;
+    }
+
+    void destroyConn(int64_t id) {
+        auto it = conns_.find(id);
+        if (it == conns_.end()) return;
+        Conn& c = it->second;
+        if (c.connecting || c.sending || c.recvArmed) {
+            // 还有在途请求：先关闭 fd 让其以错误完成，CQE 到达后再回收
+            c.closed = true;
+            if (c.fd >= 0) { ::shutdown(c.fd, SHUT_RDWR); }
+            return;
+        }
+        if (c.fd >= 0) ::close(c.fd);
+        conns_.erase(it);
+    }
+
+    // 处理其他线程投递的命令（监听、发送、关闭）
+    void drainCommands() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (pendingAccept_) {
+            pendingAccept_ = false;
+            armAccept();
+        }
+        for (int64_t id : pendingConnects_) {
+            auto it = conns_.find(id);
+            if (it != conns_.end()) armConnect(id, it->second);
+        }
+        pendingConnects_.clear();
+        for (int64_t id : dirtyConns_) {
+            auto it = conns_.find(id);
+            if (it == conns_.end()) continue;
+            it->second.dirty = false;
+            submitSend(id, it->second);
+        }
+        dirtyConns_.clear();
+        for (int64_t id : closingConns_) destroyConn(id);
+        closingConns_.clear();
+    }
+
+    void handleCqe(io_uring_cqe* cqe) {
+        uint64_t data = io_uring_cqe_get_data64(cqe);
+        int res = cqe->res;
+        int64_t id = static_cast<int64_t>(idOf(data));
+
+        switch (opOf(data)) {
+        case OP_WAKEUP: {
+            std::lock_guard<std::mutex> lock(mutex_);
+            armWakeup();
+            break;
+        }
+        case OP_ACCEPT: {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (res >= 0) {
+                int64_t cid = nextConnId_++;
+                Conn& c = conns_[cid];
+                c.fd = res;
+                armRecv(cid, c);
+            }
+            if (!(cqe->flags & IORING_CQE_F_MORE) && running_) armAccept();
+            break;
+        }
+        case OP_CONNECT: {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto it = conns_.find(id);
+            if (it == conns_.end()) break;
+            Conn& c = it->second;
+            c.connecting = false;
+            if (res < 0 || c.closed) {
+                if (res < 0) {
+                    LOG_WARN << "IoUringBackend: connect " << ::inet_ntoa(c.peer.sin_addr) << ":"
+                             << ntohs(c.peer.sin_port) << " failed: " << strerror(-res);
+                }
+                // 之后 send 返回 false，由调用方丢弃该连接 ID 并重新连接
+                c.closed = true;
+                c.outq.clear();
+                destroyConn(id);
+                break;
+            }
+            int on = 1;
+            ::setsockopt(c.fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+            submitSend(id, c);
+            break;
+        }
+        case OP_RECV:
+            handleRecv(id, cqe);
+            break;
+        case OP_SEND: {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto it = conns_.find(id);
+            if (it == conns_.end()) break;
+            Conn& c = it->second;
+            if (res <= 0) {
+                releaseSendBuffer(c);
+                c.closed = true;
+                destroyConn(id);
+                break;
+            }
+            stats_.bytes_out += static_cast<uint64_t>(res);
+            c.inflightOff += static_cast<size_t>(res);
+            if (c.inflightOff < c.inflightLen) {
+                resubmitRemainder(id, c);
+                break;
+            }
+            releaseSendBuffer(c);
+            if (c.closed) {
+                destroyConn(id);
+            } else {
+                submitSend(id, c);
+            }
+            break;
+        }
+        }
+    }
+
+    void handleRecv(int64_t id, io_uring_cqe* cqe) {
+        int res = cqe->res;
+        std::vector<std::tuple<std::string, std::string, std::string>> frames;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto it = conns_.find(id);
+            if (it == conns_.end()) return;
+            Conn& c = it->second;
+            const bool more = cqe->flags & IORING_CQE_F_MORE;
+
+            if (res > 0 && (cqe->flags & IORING_CQE_F_BUFFER)) {
+                unsigned bid = cqe->flags >> IORING_CQE_BUFFER_SHIFT;
+                c.inbuf.append(recvBuffer(bid), static_cast<size_t>(res));
+                stats_.bytes_in += static_cast<uint64_t>(res);
+                // 立即归还缓冲区
+                io_uring_buf_ring_add(bufRing_, recvBuffer(bid), options_.recv_buffer_size, bid,
+                                      io_uring_buf_ring_mask(options_.recv_buffer_count), 0);
+                io_uring_buf_ring_advance(bufRing_, 1);
+
+                size_t off = 0;
+                std::string topic, msg_name, payload;
+                while (size_t n = wire::decodeFrame(c.inbuf.data() + off, c.inbuf.size() - off,
+                                                    &topic, &msg_name, &payload)) {
+                    frames.emplace_back(std::move(topic), std::move(msg_name), std::move(payload));
+                    off += n;
+                }
+                if (off > 0) c.inbuf.erase(0, off);
+                stats_.frames_in += frames.size();
+            }
+
+            if (!more) {
+                c.recvArmed = false;
+                if (res == -ENOBUFS || (res > 0 && !c.closed)) {
+                    // 缓冲区暂时耗尽或内核结束了 multishot，重新挂上
+                    armRecv(id, c);
+                } else {
+                    c.closed = true;
+                    destroyConn(id);
+                }
+            }
+        }
+
+        if (frameCallback_) {
+            for (const auto& f : frames) {
+                frameCallback_(std::get<0>(f), std::get<1>(f), std::get<2>(f));
+            }
+        }
+    }
+
+    void run() {
+        while (running_) {
+            drainCommands();
+            int ret = io_uring_submit_and_wait(&ring_, 1);
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                ++stats_.submit_calls;
+            }
+            if (ret < 0 && ret != -EINTR) {
+                LOG_ERROR << "io_uring_submit_and_wait failed: " << strerror(-ret);
+                break;
+            }
+
+            // 批量收割完成事件
+            io_uring_cqe* cqe;
+            unsigned head;
+            unsigned count = 0;
+            io_uring_for_each_cqe(&ring_, head, cqe) {
+                handleCqe(cqe);
+                ++count;
+            }
+            io_uring_cq_advance(&ring_, count);
+            std::lock_guard<std::mutex> lock(mutex_);
+            stats_.cqes += count;
+        }
+    }
+
+    void cleanup() {
+        for (auto& item : conns_) {
+            if (item.second.fd >= 0) ::close(item.second.fd);
+        }
+        conns_.clear();
+        if (listenFd_ >= 0) ::close(listenFd_);
+        if (wakeFd_ >= 0) ::close(wakeFd_);
+        if (ringInited_) {
+            if (bufRing_) io_uring_free_buf_ring(&ring_, bufRing_, options_.recv_buffer_count, kBufferGroup);
+            io_uring_queue_exit(&ring_);
+        }
+        listenFd_ = wakeFd_ = -1;
+        bufRing_ = nullptr;
+        ringInited_ = false;
+        ready_ = false;
+    }
+
+    IoUringOptions options_;
+    io_uring ring_{};
+    bool ringInited_ = false;
+    bool ready_ = false;                 // init 全部成功，可以启动
+    io_uring_buf_ring* bufRing_ = nullptr;
+    std::vector<char> recvPool_;
+    std::vector<char> sendPool_;
+    std::vector<int> freeSlabs_;
+
+    int listenFd_ = -1;
+    int wakeFd_ = -1;
+    uint64_t wakeValue_ = 0;
+
+    std::atomic<bool> running_{false};
+    std::thread thread_;
+    FrameCallback frameCallback_;
+    std::function<void()> threadInitCallback_;
+
+    // 以下成员由 mutex_ 保护（io_uring 线程与调用线程共享）
+    mutable std::mutex mutex_;
+    std::unordered_map<int64_t, Conn> conns_;
+    int64_t nextConnId_ = 1;
+    bool pendingAccept_ = false;
+    std::vector<int64_t> pendingConnects_;
+    std::vector<int64_t> dirtyConns_;
+    std::vector<int64_t> closingConns_;
+    Stats stats_;
+};
+
+bool IoUringBackend::available() {
+    io_uring ring;
+    if (io_uring_queue_init(4, &ring, 0) < 0) return false;
+    // Impl::init 与接收路径依赖的全部能力：opcode、provided buffer ring（5.19+）与 multishot recv（6.0+）
+    io_uring_probe* probe = io_uring_get_probe_ring(&ring);
+    bool ok = probe && io_uring_opcode_supported(probe, IORING_OP_RECV) &&
+              io_uring_opcode_supported(probe, IORING_OP_WRITE_FIXED) &&
+              io_uring_opcode_supported(probe, IORING_OP_CONNECT);
+    if (probe) io_uring_free_probe(probe);
+    ok = ok && probeBufRingRecv(&ring);
+    io_uring_queue_exit(&ring);
+    return ok;
+}
+
+IoUringBackend::IoUringBackend(const IoUringOptions& options) : impl_(new Impl(options)) {
+    if (!impl_->init()) {
+        LOG_ERROR << "IoUringBackend initialization failed, start() will refuse to run";
+    }
+}
+
+IoUringBackend::~IoUringBackend() = default;
+
+bool IoUringBackend::listen(const std::string& ip, uint16_t port) { return impl_->listen(ip, port); }
+void IoUringBackend::setFrameCallback(FrameCallback cb) { impl_->setFrameCallback(std::move(cb)); }
+void IoUringBackend::setThreadInitCallback(std::function<void()> cb) { impl_->setThreadInitCallback(std::move(cb)); }
+int64_t IoUringBackend::connect(const std::string& ip, uint16_t port) { return impl_->connect(ip, port); }
+bool IoUringBackend::send(int64_t conn_id, std::string frame) { return impl_->send(conn_id, std::move(frame)); }
+bool IoUringBackend::isConnected(int64_t conn_id) const { return impl_->isConnected(conn_id); }
+void IoUringBackend::close(int64_t conn_id) { impl_->close(conn_id); }
+bool IoUringBackend::start() { return impl_->start(); }
+void IoUringBackend::stop() { impl_->stop(); }
+IoUringBackend::Stats IoUringBackend::stats() const { return impl_->stats(); }
+
+#else // !SIMPLE_ROS_HAVE_IO_URING
+
+// 未启用 ENABLE_IO_URING：所有调用失败，系统使用 muduo
+class IoUringBackend::Impl {};
+
+bool IoUringBackend::available() { return false; }
+
+IoUringBackend::IoUringBackend(const IoUringOptions&) {
+    LOG_WARN << "simple_ros was built without ENABLE_IO_URING";
+}
+
+IoUringBackend::~IoUringBackend() = default;
+
+bool IoUringBackend::listen(const std::string&, uint16_t) { return false; }
+void IoUringBackend::setFrameCallback(FrameCallback) {}
+void IoUringBackend::setThreadInitCallback(std::function<void()>) {}
+int64_t IoUringBackend::connect(const std::string&, uint16_t) { return -1; }
+bool IoUringBackend::send(int64_t, std::string) { return false; }
+bool IoUringBackend::isConnected(int64_t) const { return false; }
+void IoUringBackend::close(int64_t) {}
+bool IoUringBackend::start() { return false; }
+void IoUringBackend::stop() {}
+IoUringBackend::Stats IoUringBackend::stats() const { return Stats(); }
+
+#endif // SIMPLE_ROS_HAVE_IO_URING
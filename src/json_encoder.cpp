@@ -0,0 +1,313 @@
+#include "json_encoder.h"
+#include <google/protobuf/util/json_util.h>
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <mutex>
+
+using google::protobuf::Descriptor;
+using google::protobuf::FieldDescriptor;
+using google::protobuf::Message;
+using google::protobuf::Reflection;
+
+namespace simple_ros {
+
+struct JsonEncoder::FieldPlan {
+    const FieldDescriptor* field = nullptr;
+    std::string key;                        // 已转义的 "name":
+    FieldDescriptor::CppType type = FieldDescriptor::CPPTYPE_INT32;
+    bool repeated = false;
+    bool is_map = false;
+    bool is_bytes = false;
+    bool always_print = false;              // 未设置时仍输出默认值
+    const MessagePlan* message = nullptr;   // 消息字段的类型计划；map 字段为 entry 类型的计划
+};
+
+struct JsonEncoder::MessagePlan {
+    const Descriptor* descriptor = nullptr;
+    bool well_known = false;                // google.protobuf 下的类型，交给 MessageToJsonString
+    std::vector<FieldPlan> fields;          // 按字段号排序
+};
+
+namespace {
+
+const char kHex[] = "0123456789abcdef";
+
+void appendEscaped(const std::string& s, std::string* out) {
+    out->push_back('"');
+    size_t run = 0;  // 无需转义的连续字节整体追加
+    for (size_t i = 0; i < s.size(); ++i) {
+        unsigned char c = static_cast<unsigned char>(s[i]);
+        if (c >= 0x20 && c != '"' && c != '\\') continue;
+        out->append(s, run, i - run);
+        run = i + 1;
+        switch (c) {
+            case '"': out->append("\\\""); break;
+            case '\\': out->append("\\\\"); break;
+            case '\b': out->append("\\b"); break;
+            case '\f': out->append("\\f"); break;
+            case '\n': out->append("\\n"); break;
+            case '\r': out->append("\\r"); break;
+            case '\t': out->append("\\t"); break;
+            default:
+                out->append("\\u00");
+                out->push_back(kHex[c >> 4]);
+                out->push_back(kHex[c & 0xf]);
+                break;
+        }
+    }
+    out->append(s, run, s.size() - run);
+    out->push_back('"');
+}
+
+void appendBase64(const std::string& s, std::string* out) {
+    static const char kTable[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    out->push_back('"');
+    const auto* p = reinterpret_cast<const unsigned char*>(s.data());
+    size_t i = 0;
+    for (; i + 3 <= s.size(); i += 3) {
+        uint32_t v = (p[i] << 16) | (p[i + 1] << 8) | p[i + 2];
+        out->push_back(kTable[v >> 18]);
+        out->push_back(kTable[(v >> 12) & 0x3f]);
+        out->push_back(kTable[(v >> 6) & 0x3f]);
+        out->push_back(kTable[v & 0x3f]);
+    }
+    if (i < s.size()) {
+        uint32_t v = p[i] << 16;
+        if (i + 1 < s.size()) v |= p[i + 1] << 8;
+        out->push_back(kTable[v >> 18]);
+        out->push_back(kTable[(v >> 12) & 0x3f]);
+        out->push_back(i + 1 < s.size() ? kTable[(v >> 6) & 0x3f] : '=');
+        out->push_back('=');
+    }
+    out->push_back('"');
+}
+
+template <typename T>
+void appendNumber(T value, std::string* out) {
+    char buf[32];
+    auto result = std::to_chars(buf, buf + sizeof(buf), value);
+    out->append(buf, result.ptr);
+}
+
+// 64 位整数按 proto3 JSON 规范输出为字符串
+template <typename T>
+void appendQuoted(T value, std::string* out) {
+    out->push_back('"');
+    appendNumber(value, out);
+    out->push_back('"');
+}
+
+// 浮点数：最短往返表示，NaN 与无穷输出为字符串
+template <typename T>
+void appendFloat(T value, std::string* out) {
+    if (std::isnan(value)) {
+        out->append("\"NaN\"");
+    } else if (std::isinf(value)) {
+        out->append(value > 0 ? "\"Infinity\"" : "\"-Infinity\"");
+    } else {
+        appendNumber(value, out);
+    }
+}
+
+} // namespace
+
+JsonEncoder::JsonEncoder() : JsonEncoder(Options()) {}
+
+JsonEncoder::JsonEncoder(Options options) : options_(std::move(options)) {}
+
+JsonEncoder::~JsonEncoder() = default;
+
+size_t JsonEncoder::planCount() const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    return plans_.size();
+}
+
+const JsonEncoder::MessagePlan* JsonEncoder::plan(const Descriptor* descriptor) const {
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        auto it = plans_.find(descriptor);
+        if (it != plans_.end()) return it->second.get();
+    }
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    return buildLocked(descriptor);
+}
+
+const JsonEncoder::MessagePlan* JsonEncoder::buildLocked(const Descriptor* descriptor) const {
+    auto it = plans_.find(descriptor);
+    if (it != plans_.end()) return it->second.get();
+
+    // 先登记再填充字段，递归类型的嵌套字段可以引用自身的计划
+    auto owned = std::make_unique<MessagePlan>();
+    MessagePlan* plan = owned.get();
+    plans_.emplace(descriptor, std::move(owned));
+    plan->descriptor = descriptor;
+    plan->well_known = descriptor->file()->package() == "google.protobuf";
+    if (plan->well_known) return plan;
+
+    for (int i = 0; i < descriptor->field_count(); ++i) {
+        const FieldDescriptor* field = descriptor->field(i);
+        if (options_.skip_fields.count(field->full_name())) continue;
+
+        FieldPlan fp;
+        fp.field = field;
+        appendEscaped(options_.preserve_proto_field_names ? field->name() : field->json_name(), &fp.key);
+        fp.key.push_back(':');
+        fp.type = field->cpp_type();
+        fp.repeated = field->is_repeated();
+        fp.is_map = field->is_map();
+        fp.is_bytes = field->type() == FieldDescriptor::TYPE_BYTES;
+        // 与 MessageToJsonString 一致：只补全没有显式存在性的标量及 repeated/map 字段
+        fp.always_print = options_.always_print_primitive_fields &&
+                          (fp.repeated || (fp.type != FieldDescriptor::CPPTYPE_MESSAGE &&
+                                           !field->has_presence()));
+        if (fp.type == FieldDescriptor::CPPTYPE_MESSAGE) {
+            fp.message = buildLocked(field->message_type());
+        }
+        plan->fields.push_back(std::move(fp));
+    }
+    std::sort(plan->fields.begin(), plan->fields.end(), [](const FieldPlan& a, const FieldPlan& b) {
+        return a.field->number() < b.field->number();
+    });
+    return plan;
+}
+
+void JsonEncoder::encode(const Message& msg, std::string* out) const {
+    encodeMessage(*plan(msg.GetDescriptor()), msg, out);
+}
+
+std::string JsonEncoder::encode(const Message& msg) const {
+    std::string out;
+    encode(msg, &out);
+    return out;
+}
+
+void JsonEncoder::encodeMessage(const MessagePlan& plan, const Message& msg, std::string* out) const {
+    if (plan.well_known) {
+        google::protobuf::util::JsonPrintOptions opts;
+        opts.always_print_primitive_fields = options_.always_print_primitive_fields;
+        opts.preserve_proto_field_names = options_.preserve_proto_field_names;
+        std::string json;
+        if (google::protobuf::util::MessageToJsonString(msg, &json, opts).ok()) {
+            out->append(json);
+        } else {
+            out->append("null");
+        }
+        return;
+    }
+
+    const Reflection* reflection = msg.GetReflection();
+    out->push_back('{');
+    bool first = true;
+    for (const FieldPlan& field : plan.fields) {
+        int count = 0;
+        if (field.repeated) {
+            count = reflection->FieldSize(msg, field.field);
+            if (count == 0 && !field.always_print) continue;
+        } else if (!reflection->HasField(msg, field.field) && !field.always_print) {
+            continue;
+        }
+
+        if (!first) out->push_back(',');
+        first = false;
+        out->append(field.key);
+
+        if (field.is_map) {
+            encodeMap(field, msg, out);
+        } else if (field.repeated) {
+            out->push_back('[');
+            for (int i = 0; i < count; ++i) {
+                if (i > 0) out->push_back(',');
+                encodeValue(field, msg, i, out);
+            }
+            out->push_back(']');
+        } else {
+            encodeValue(field, msg, -1, out);
+        }
+    }
+    out->push_back('}');
+}
+
+// index 为 -1 时读取单值字段，否则读取 repeated 字段的第 index 个元素
+void JsonEncoder::encodeValue(const FieldPlan& field, const Message& msg, int index, std::string* out) const {
+    const Reflection* r = msg.GetReflection();
+    const FieldDescriptor* f = field.field;
+    const bool rep = index >= 0;
+    switch (field.type) {
+        case FieldDescriptor::CPPTYPE_INT32:
+            appendNumber(rep ? r->GetRepeatedInt32(msg, f, index) : r->GetInt32(msg, f), out);
+            break;
+        case FieldDescriptor::CPPTYPE_UINT32:
+            appendNumber(rep ? r->GetRepeatedUInt32(msg, f, index) : r->GetUInt32(msg, f), out);
+            break;
+        case FieldDescriptor::CPPTYPE_INT64:
+            appendQuoted(rep ? r->GetRepeatedInt64(msg, f, index) : r->GetInt64(msg, f), out);
+            break;
+        case FieldDescriptor::CPPTYPE_UINT64:
+            appendQuoted(rep ? r->GetRepeatedUInt64(msg, f, index) : r->GetUInt64(msg, f), out);
+            break;
+        case FieldDescriptor::CPPTYPE_DOUBLE:
+            appendFloat(rep ? r->GetRepeatedDouble(msg, f, index) : r->GetDouble(msg, f), out);
+            break;
+        case FieldDescriptor::CPPTYPE_FLOAT:
+            appendFloat(rep ? r->GetRepeatedFloat(msg, f, index) : r->GetFloat(msg, f), out);
+            break;
+        case FieldDescriptor::CPPTYPE_BOOL:
+            out->append((rep ? r->GetRepeatedBool(msg, f, index) : r->GetBool(msg, f)) ? "true" : "false");
+            break;
+        case FieldDescriptor::CPPTYPE_ENUM: {
+            int value = rep ? r->GetRepeatedEnumValue(msg, f, index) : r->GetEnumValue(msg, f);
+            const auto* enum_value = f->enum_type()->FindValueByNumber(value);
+            if (enum_value) {
+                appendEscaped(enum_value->name(), out);
+            } else {
+                appendNumber(value, out);
+            }
+            break;
+        }
+        case FieldDescriptor::CPPTYPE_STRING: {
+            std::string scratch;
+            const std::string& value = rep ? r->GetRepeatedStringReference(msg, f, index, &scratch)
+                                           : r->GetStringReference(msg, f, &scratch);
+            if (field.is_bytes) {
+                appendBase64(value, out);
+            } else {
+                appendEscaped(value, out);
+            }
+            break;
+        }
+        case FieldDescriptor::CPPTYPE_MESSAGE:
+            encodeMessage(*field.message, rep ? r->GetRepeatedMessage(msg, f, index) : r->GetMessage(msg, f), out);
+            break;
+    }
+}
+
+void JsonEncoder::encodeMap(const FieldPlan& field, const Message& msg, std::string* out) const {
+    const MessagePlan& entry_plan = *field.message;
+    const FieldPlan& key_field = entry_plan.fields[0];
+    const FieldPlan& value_field = entry_plan.fields[1];
+    const Reflection* reflection = msg.GetReflection();
+    const int count = reflection->FieldSize(msg, field.field);
+
+    out->push_back('{');
+    for (int i = 0; i < count; ++i) {
+        if (i > 0) out->push_back(',');
+        const Message& entry = reflection->GetRepeatedMessage(msg, field.field, i);
+        // JSON 对象的键必须是字符串：字符串键直接转义，其他类型加引号
+        if (key_field.type == FieldDescriptor::CPPTYPE_STRING) {
+            encodeValue(key_field, entry, -1, out);
+        } else {
+            size_t start = out->size();
+            encodeValue(key_field, entry, -1, out);
+            if ((*out)[start] != '"') {
+                out->insert(out->begin() + start, '"');
+                out->push_back('"');
+            }
+        }
+        out->push_back(':');
+        encodeValue(value_field, entry, -1, out);
+    }
+    out->push_back('}');
+}
+
+} // namespace simple_ros
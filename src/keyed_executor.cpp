@@ -0,0 +1,130 @@
+#include "keyed_executor.h"
+#include <muduo/base/Logging.h>
+#include <algorithm>
+#include <chrono>
+#include <exception>
+
+namespace simple_ros {
+
+KeyedExecutor::KeyedExecutor(size_t threads, size_t queue_limit)
+    : queue_limit_(queue_limit) {
+    if (threads == 0) threads = 1;
+    workers_.reserve(threads);
+    for (size_t i = 0; i < threads; ++i) {
+        workers_.push_back(std::make_unique<Worker>());
+    }
+    for (auto& worker : workers_) {
+        Worker* w = worker.get();
+        w->thread = std::thread([this, w]() { run(*w); });
+    }
+}
+
+KeyedExecutor::~KeyedExecutor() {
+    stop();
+}
+
+bool KeyedExecutor::submit(const std::string& key, Task task, Task on_drop) {
+    return enqueue(key, {key, std::move(task), std::move(on_drop), false});
+}
+
+bool KeyedExecutor::submitPinned(const std::string& key, Task task) {
+    return enqueue(key, {key, std::move(task), nullptr, true});
+}
+
+bool KeyedExecutor::enqueue(const std::string& key, Entry entry) {
+    Worker& worker = *workers_[std::hash<std::string>()(key) % workers_.size()];
+    bool dropped = false;
+    Task dropped_hook;
+    {
+        std::lock_guard<std::mutex> lock(worker.mutex);
+        if (!running_.load(std::memory_order_relaxed)) return false;
+        worker.tasks.push_back(std::move(entry));
+        KeyState& state = worker.keys[key];
+        ++state.queued;
+        if (queue_limit_ > 0 && state.queued > queue_limit_) {
+            // 丢弃该 key 最早的可丢弃任务（可能就是刚提交的这个），不可丢弃的任务与其他 key 的任务保留
+            auto victim = std::find_if(worker.tasks.begin(), worker.tasks.end(),
+                                       [&key](const Entry& e) { return !e.pinned && e.key == key; });
+            if (victim != worker.tasks.end()) {
+                dropped_hook = std::move(victim->on_drop);
+                worker.tasks.erase(victim);
+                --state.queued;
+                dropped = true;
+            } else if (state.queued >= std::max(state.warn_at, 2 * queue_limit_)) {
+                LOG_WARN << "KeyedExecutor: " << state.queued << " unbounded tasks queued for " << key
+                         << " (limit " << queue_limit_ << ")";
+                state.warn_at = state.queued * 2;
+            }
+        }
+    }
+    worker.cv.notify_one();
+    if (dropped) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        // 在锁外调用，回调中可以再次提交
+        if (dropped_hook) dropped_hook();
+    }
+    return !dropped;
+}
+
+void KeyedExecutor::stop() {
+    if (!running_.exchange(false)) return;
+    for (auto& worker : workers_) {
+        {
+            // 持锁修改后通知，避免工作线程错过唤醒
+            std::lock_guard<std::mutex> lock(worker->mutex);
+            worker->tasks.clear();
+            worker->keys.clear();
+        }
+        worker->cv.notify_all();
+    }
+    for (auto& worker : workers_) {
+        if (worker->thread.joinable()) worker->thread.join();
+    }
+}
+
+size_t KeyedExecutor::pending() const {
+    size_t total = 0;
+    for (const auto& worker : workers_) {
+        std::lock_guard<std::mutex> lock(worker->mutex);
+        total += worker->tasks.size();
+    }
+    return total;
+}
+
+double KeyedExecutor::busySeconds() const {
+    return busy_ns_.load(std::memory_order_relaxed) * 1e-9;
+}
+
+void KeyedExecutor::run(Worker& worker) {
+    while (true) {
+        Task task;
+        {
+            std::unique_lock<std::mutex> lock(worker.mutex);
+            worker.cv.wait(lock, [&]() {
+                return !worker.tasks.empty() || !running_.load(std::memory_order_relaxed);
+            });
+            if (!running_.load(std::memory_order_relaxed)) return;
+            Entry& front = worker.tasks.front();
+            auto key_it = worker.keys.find(front.key);
+            if (key_it != worker.keys.end() && --key_it->second.queued == 0) worker.keys.erase(key_it);
+            task = std::move(front.task);
+            worker.tasks.pop_front();
+        }
+        auto start = std::chrono::steady_clock::now();
+        try {
+            task();
+        } catch (const std::exception& e) {
+            failed_.fetch_add(1, std::memory_order_relaxed);
+            LOG_ERROR << "KeyedExecutor: task failed: " << e.what();
+        } catch (...) {
+            failed_.fetch_add(1, std::memory_order_relaxed);
+            LOG_ERROR << "KeyedExecutor: task failed with unknown exception";
+        }
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        busy_ns_.fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count(),
+                           std::memory_order_relaxed);
+        executed_.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+} // namespace simple_ros
@@ -0,0 +1,64 @@
+// latency_histogram.cc
+// LatencyHistogram 的实现
+
+#include "latency_histogram.h"
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+
+namespace simple_ros {
+
+void LatencyHistogram::record(double seconds) {
+    if (seconds < 0) seconds = 0;
+    double us = seconds * 1e6;
+
+    size_t bucket = 0;
+    if (us >= 1.0) {
+        bucket = static_cast<size_t>(std::ilogb(us)) + 1;
+        if (bucket >= kBucketCount) bucket = kBucketCount - 1;
+    }
+    ++buckets_[bucket];
+
+    if (count_ == 0 || seconds < min_) min_ = seconds;
+    if (seconds > max_) max_ = seconds;
+    sum_ += seconds;
+    ++count_;
+}
+
+void LatencyHistogram::reset() {
+    buckets_.fill(0);
+    count_ = 0;
+    sum_ = min_ = max_ = 0.0;
+}
+
+double LatencyHistogram::bucketUpperBound(size_t i) {
+    return std::ldexp(1.0, static_cast<int>(i)) * 1e-6;
+}
+
+double LatencyHistogram::percentile(double p) const {
+    if (count_ == 0) return 0.0;
+    uint64_t target = static_cast<uint64_t>(std::ceil(p * count_));
+    if (target == 0) target = 1;
+    uint64_t seen = 0;
+    for (size_t i = 0; i < kBucketCount; ++i) {
+        seen += buckets_[i];
+        if (seen >= target) {
+            // 上界不超过实际最大值
+            return std::min(bucketUpperBound(i), max_);
+        }
+    }
+    return max_;
+}
+
+std::string LatencyHistogram::summary() const {
+    std::ostringstream oss;
+    oss.precision(3);
+    oss << "n=" << count_
+        << " mean=" << mean() * 1e6 << "us"
+        << " p50=" << percentile(0.5) * 1e6 << "us"
+        << " p99=" << percentile(0.99) * 1e6 << "us"
+        << " max=" << max_ * 1e6 << "us";
+    return oss.str();
+}
+
+} // namespace simple_ros
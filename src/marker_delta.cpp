@@ -0,0 +1,81 @@
+#include "marker_delta.h"
+
+namespace simple_ros {
+
+std::string MarkerDeltaTracker::entityId(const visualization_msgs::Marker& marker) {
+    return marker.ns() + "_" + std::to_string(marker.id());
+}
+
+void MarkerDeltaTracker::fingerprint(const visualization_msgs::Marker& marker, std::string* out) {
+    // 时间戳每条消息都在变化，不影响显示内容，比较时去掉
+    if (marker.has_header() && marker.header().has_stamp()) {
+        scratch_.CopyFrom(marker);
+        scratch_.mutable_header()->clear_stamp();
+        scratch_.SerializeToString(out);
+    } else {
+        marker.SerializeToString(out);
+    }
+}
+
+MarkerDelta MarkerDeltaTracker::apply(const visualization_msgs::MarkerArray& array, Clock::time_point now) {
+    MarkerDelta delta;
+    std::unordered_map<std::string, size_t> changed_index;  // 实体 ID → delta.changed 下标
+    std::string fp;
+
+    for (const auto& marker : array.markers()) {
+        if (marker.action() == visualization_msgs::MarkerAction::DELETEALL) {
+            // 之前的新增与删除都被覆盖
+            entries_.clear();
+            delta = MarkerDelta();
+            delta.delete_all = true;
+            changed_index.clear();
+            continue;
+        }
+
+        std::string id = entityId(marker);
+        if (marker.action() == visualization_msgs::MarkerAction::DELETE) {
+            entries_.erase(id);
+            auto it = changed_index.find(id);
+            if (it != changed_index.end()) {
+                delta.changed[it->second] = nullptr;
+                changed_index.erase(it);
+            }
+            delta.deleted.push_back(std::move(id));
+            continue;
+        }
+
+        fingerprint(marker, &fp);
+        auto entry = entries_.find(id);
+        if (entry != entries_.end() && entry->second.fingerprint == fp) {
+            double lifetime = entry->second.lifetime;
+            bool refresh = lifetime > 0.0 &&
+                           now - entry->second.sent >= std::chrono::duration<double>(lifetime * 0.5);
+            if (!refresh) continue;
+        }
+
+        Entry& e = entries_[id];
+        e.fingerprint.swap(fp);
+        e.sent = now;
+        e.lifetime = marker.lifetime();
+
+        auto it = changed_index.find(id);
+        if (it != changed_index.end()) {
+            // 同一条消息中重复出现的 ID 以最后一个为准
+            delta.changed[it->second] = &marker;
+        } else {
+            changed_index.emplace(std::move(id), delta.changed.size());
+            delta.changed.push_back(&marker);
+        }
+    }
+
+    // 去掉被同一条消息中后续 DELETE 取消的新增
+    std::vector<const visualization_msgs::Marker*> changed;
+    changed.reserve(delta.changed.size());
+    for (const auto* marker : delta.changed) {
+        if (marker) changed.push_back(marker);
+    }
+    delta.changed.swap(changed);
+    return delta;
+}
+
+} // namespace simple_ros
@@ -0,0 +1,277 @@
+#include "marker_scene.h"
+#include <algorithm>
+#include <cmath>
+
+namespace simple_ros {
+
+namespace {
+
+using foxglove::schemas::Color;
+using foxglove::schemas::Point3;
+using foxglove::schemas::Pose;
+using foxglove::schemas::Quaternion;
+using foxglove::schemas::Vector3;
+
+Color toColor(const visualization_msgs::ColorRGBA& c) {
+    return Color{c.r(), c.g(), c.b(), c.a()};
+}
+
+Vector3 toVector(const geometry_msgs::Vector3& v) {
+    return Vector3{v.x(), v.y(), v.z()};
+}
+
+Quaternion normalized(double x, double y, double z, double w) {
+    double norm = std::sqrt(x * x + y * y + z * z + w * w);
+    if (norm < 1e-12) return Quaternion{0.0, 0.0, 0.0, 1.0};
+    return Quaternion{x / norm, y / norm, z / norm, w / norm};
+}
+
+Quaternion multiply(const Quaternion& a, const Quaternion& b) {
+    return Quaternion{a.w * b.x + a.x * b.w + a.y * b.z - a.z * b.y,
+                      a.w * b.y - a.x * b.z + a.y * b.w + a.z * b.x,
+                      a.w * b.z + a.x * b.y - a.y * b.x + a.z * b.w,
+                      a.w * b.w - a.x * b.x - a.y * b.y - a.z * b.z};
+}
+
+// 行主序旋转矩阵加平移，批量变换点时只从四元数计算一次
+struct Transform {
+    double r[9];
+    double t[3];
+
+    explicit Transform(const Pose& pose) {
+        const Quaternion& q = *pose.orientation;
+        double xx = q.x * q.x, yy = q.y * q.y, zz = q.z * q.z;
+        double xy = q.x * q.y, xz = q.x * q.z, yz = q.y * q.z;
+        double wx = q.w * q.x, wy = q.w * q.y, wz = q.w * q.z;
+        r[0] = 1 - 2 * (yy + zz); r[1] = 2 * (xy - wz);     r[2] = 2 * (xz + wy);
+        r[3] = 2 * (xy + wz);     r[4] = 1 - 2 * (xx + zz); r[5] = 2 * (yz - wx);
+        r[6] = 2 * (xz - wy);     r[7] = 2 * (yz + wx);     r[8] = 1 - 2 * (xx + yy);
+        t[0] = pose.position->x;
+        t[1] = pose.position->y;
+        t[2] = pose.position->z;
+    }
+
+    Vector3 apply(double x, double y, double z) const {
+        return Vector3{r[0] * x + r[1] * y + r[2] * z + t[0],
+                       r[3] * x + r[4] * y + r[5] * z + t[1],
+                       r[6] * x + r[7] * y + r[8] * z + t[2]};
+    }
+};
+
+/**
+ * POINTS 的点按结构数组（SoA）批量变换：先从 protobuf 对象中取出坐标到连续的 x/y/z 数组，
+ * 再用一个无分支的循环做旋转加平移（编译器可向量化），最后写入图元。
+ * 缓冲区按线程复用，稳定后不再分配。
+ */
+struct PointBatch {
+    std::vector<double> x, y, z;
+
+    void gather(const google::protobuf::RepeatedPtrField<geometry_msgs::Point>& points) {
+        const size_t n = points.size();
+        x.resize(n);
+        y.resize(n);
+        z.resize(n);
+        double* __restrict px = x.data();
+        double* __restrict py = y.data();
+        double* __restrict pz = z.data();
+        for (size_t i = 0; i < n; ++i) {
+            const auto& p = points.Get(static_cast<int>(i));
+            px[i] = p.x();
+            py[i] = p.y();
+            pz[i] = p.z();
+        }
+    }
+
+    void transform(const Transform& tf) {
+        const size_t n = x.size();
+        double* __restrict px = x.data();
+        double* __restrict py = y.data();
+        double* __restrict pz = z.data();
+        const double r0 = tf.r[0], r1 = tf.r[1], r2 = tf.r[2];
+        const double r3 = tf.r[3], r4 = tf.r[4], r5 = tf.r[5];
+        const double r6 = tf.r[6], r7 = tf.r[7], r8 = tf.r[8];
+        const double t0 = tf.t[0], t1 = tf.t[1], t2 = tf.t[2];
+        for (size_t i = 0; i < n; ++i) {
+            const double ix = px[i], iy = py[i], iz = pz[i];
+            px[i] = r0 * ix + r1 * iy + r2 * iz + t0;
+            py[i] = r3 * ix + r4 * iy + r5 * iz + t1;
+            pz[i] = r6 * ix + r7 * iy + r8 * iz + t2;
+        }
+    }
+};
+
+void appendArrow(const visualization_msgs::Marker& marker, const Pose& pose, foxglove::schemas::SceneEntity* entity) {
+    foxglove::schemas::ArrowPrimitive arrow;
+    arrow.color = toColor(marker.color());
+    const auto& scale = marker.scale();
+    if (marker.points_size() >= 2) {
+        // 起止点模式：scale.x 为杆径，scale.y 为箭头直径，scale.z 为箭头长度（0 时取总长的 23%）
+        const auto& a = marker.points(0);
+        const auto& b = marker.points(1);
+        double dx = b.x() - a.x(), dy = b.y() - a.y(), dz = b.z() - a.z();
+        double length = std::sqrt(dx * dx + dy * dy + dz * dz);
+        // 把 +X 轴转到起点指向终点的方向
+        Quaternion dir{0.0, 0.0, 0.0, 1.0};
+        if (length > 1e-12) {
+            double ux = dx / length, uy = dy / length, uz = dz / length;
+            dir = ux < -1.0 + 1e-9 ? Quaternion{0.0, 0.0, 1.0, 0.0} : normalized(0.0, -uz, uy, 1.0 + ux);
+        }
+        Transform tf(pose);
+        Pose arrow_pose;
+        arrow_pose.position = tf.apply(a.x(), a.y(), a.z());
+        arrow_pose.orientation = multiply(*pose.orientation, dir);
+        arrow.pose = arrow_pose;
+        arrow.head_length = scale.z() > 0.0 ? std::min(scale.z(), length) : 0.23 * length;
+        arrow.shaft_length = std::max(0.0, length - arrow.head_length);
+        arrow.shaft_diameter = scale.x();
+        arrow.head_diameter = scale.y();
+    } else {
+        // 姿态模式：沿 pose 的 +X 轴，scale.x 为总长，scale.y/scale.z 为宽高
+        arrow.pose = pose;
+        arrow.shaft_length = 0.77 * scale.x();
+        arrow.head_length = 0.23 * scale.x();
+        arrow.shaft_diameter = std::max(scale.y(), scale.z());
+        arrow.head_diameter = 2.0 * arrow.shaft_diameter;
+    }
+    entity->arrows.push_back(std::move(arrow));
+}
+
+void appendPoints(const visualization_msgs::Marker& marker, const Pose& pose, foxglove::schemas::SceneEntity* entity) {
+    thread_local PointBatch batch;
+    batch.gather(marker.points());
+    batch.transform(Transform(pose));
+
+    const size_t n = batch.x.size();
+    const bool per_point_color = marker.colors_size() == marker.points_size();
+    const double sx = marker.scale().x();
+    const double sy = marker.scale().y() > 0.0 ? marker.scale().y() : sx;
+    const Vector3 size{sx, sy, sx};
+    const Color color = toColor(marker.color());
+    const Quaternion identity{0.0, 0.0, 0.0, 1.0};
+
+    const size_t base = entity->spheres.size();
+    entity->spheres.resize(base + n);
+    foxglove::schemas::SpherePrimitive* out = entity->spheres.data() + base;
+    for (size_t i = 0; i < n; ++i) {
+        Pose p;
+        p.position = Vector3{batch.x[i], batch.y[i], batch.z[i]};
+        p.orientation = identity;
+        out[i].pose = p;
+        out[i].size = size;
+        out[i].color = per_point_color ? toColor(marker.colors(static_cast<int>(i))) : color;
+    }
+}
+
+} // namespace
+
+Pose toScenePose(const geometry_msgs::Pose& pose) {
+    Pose out;
+    out.position = Vector3{pose.position().x(), pose.position().y(), pose.position().z()};
+    const auto& q = pose.orientation();
+    out.orientation = normalized(q.x(), q.y(), q.z(), q.w());
+    return out;
+}
+
+void convertPoints(const google::protobuf::RepeatedPtrField<geometry_msgs::Point>& points,
+                   std::vector<Point3>* out) {
+    const size_t n = points.size();
+    out->resize(n);
+    Point3* dst = out->data();
+    for (const auto& p : points) {
+        dst->x = p.x();
+        dst->y = p.y();
+        dst->z = p.z();
+        ++dst;
+    }
+}
+
+void convertColors(const google::protobuf::RepeatedPtrField<visualization_msgs::ColorRGBA>& colors,
+                   std::vector<Color>* out) {
+    const size_t n = colors.size();
+    out->resize(n);
+    Color* dst = out->data();
+    for (const auto& c : colors) {
+        dst->r = c.r();
+        dst->g = c.g();
+        dst->b = c.b();
+        dst->a = c.a();
+        ++dst;
+    }
+}
+
+bool appendMarkerPrimitives(const visualization_msgs::Marker& marker, foxglove::schemas::SceneEntity* entity) {
+    const Pose pose = toScenePose(marker.pose());
+    switch (marker.type()) {
+        case visualization_msgs::CUBE: {
+            foxglove::schemas::CubePrimitive cube;
+            cube.pose = pose;
+            cube.size = toVector(marker.scale());
+            cube.color = toColor(marker.color());
+            entity->cubes.push_back(cube);
+            return true;
+        }
+        case visualization_msgs::SPHERE: {
+            foxglove::schemas::SpherePrimitive sphere;
+            sphere.pose = pose;
+            sphere.size = toVector(marker.scale());
+            sphere.color = toColor(marker.color());
+            entity->spheres.push_back(sphere);
+            return true;
+        }
+        case visualization_msgs::CYLINDER: {
+            foxglove::schemas::CylinderPrimitive cylinder;
+            cylinder.pose = pose;
+            cylinder.size = toVector(marker.scale());
+            cylinder.color = toColor(marker.color());
+            cylinder.bottom_scale = 1.0;
+            cylinder.top_scale = 1.0;
+            entity->cylinders.push_back(cylinder);
+            return true;
+        }
+        case visualization_msgs::ARROW:
+            appendArrow(marker, pose, entity);
+            return true;
+        case visualization_msgs::LINE_STRIP: {
+            foxglove::schemas::LinePrimitive line;
+            line.type = foxglove::schemas::LinePrimitive::LineType::LINE_STRIP;
+            line.pose = pose;
+            line.thickness = std::max({marker.scale().x(), marker.scale().y(), marker.scale().z()}) * 0.2;
+            line.scale_invariant = false;
+            line.color = toColor(marker.color());
+            convertPoints(marker.points(), &line.points);
+            if (marker.colors_size() == marker.points_size() && marker.colors_size() > 0) {
+                convertColors(marker.colors(), &line.colors);
+            }
+            entity->lines.push_back(std::move(line));
+            return true;
+        }
+        case visualization_msgs::POINTS:
+            appendPoints(marker, pose, entity);
+            return true;
+        case visualization_msgs::TEXT_VIEW_FACING: {
+            foxglove::schemas::TextPrimitive text;
+            text.pose = pose;
+            text.billboard = true;
+            text.font_size = marker.scale().z();
+            text.scale_invariant = false;
+            text.color = toColor(marker.color());
+            text.text = marker.text();
+            entity->texts.push_back(std::move(text));
+            return true;
+        }
+        case visualization_msgs::MESH_RESOURCE: {
+            foxglove::schemas::ModelPrimitive model;
+            model.pose = pose;
+            model.scale = toVector(marker.scale());
+            model.color = toColor(marker.color());
+            model.override_color = !marker.mesh_use_embedded_materials();
+            model.url = marker.mesh_resource();
+            entity->models.push_back(std::move(model));
+            return true;
+        }
+        default:
+            return false;
+    }
+}
+
+} // namespace simple_ros
@@ -0,0 +1,43 @@
+#include "message_cache.h"
+
+namespace simple_ros {
+
+bool CacheBudget::tryReserve(size_t bytes) {
+    size_t used = used_bytes_.load(std::memory_order_relaxed);
+    do {
+        if (used + bytes > max_bytes_.load(std::memory_order_relaxed)) return false;
+    } while (!used_bytes_.compare_exchange_weak(used, used + bytes, std::memory_order_relaxed));
+    return true;
+}
+
+void CacheBudget::release(size_t bytes) {
+    used_bytes_.fetch_sub(bytes, std::memory_order_relaxed);
+}
+
+bool CacheReservation::resize(size_t bytes) {
+    if (bytes > bytes_) {
+        if (!budget_ || !budget_->tryReserve(bytes - bytes_)) return false;
+    } else if (bytes < bytes_) {
+        budget_->release(bytes_ - bytes);
+    }
+    bytes_ = bytes;
+    return true;
+}
+
+bool LastMessageSlot::store(const void* data, size_t size) {
+    if (!reservation_.resize(size)) {
+        clear();
+        return false;
+    }
+    data_.assign(static_cast<const char*>(data), size);
+    valid_ = true;
+    return true;
+}
+
+void LastMessageSlot::clear() {
+    valid_ = false;
+    data_.clear();
+    reservation_.resize(0);
+}
+
+} // namespace simple_ros
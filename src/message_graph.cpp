@@ -5,6 +5,7 @@
 #include <nlohmann/json.hpp> // 若不想引入第三方，可手写 JSON 字符串
 #include "message_graph.h"
 #include <grpcpp/server_builder.h>
+#include <muduo/base/Logging.h>
 namespace simple_ros {
 // ========== MessageGraph 实现 ==========
 void MessageGraph::UpsertNode(const NodeInfo& info) {
@@ -15,7 +16,17 @@ void MessageGraph::UpsertNode(const NodeInfo& info) {
 void MessageGraph::ConnectPublisherToSubscribers(const std::string& pub_node, const TopicKey& k) {
     auto it = subscribers_by_topic_.find(k);
     if (it == subscribers_by_topic_.end()) return;
+    QoSProfile pub_qos;
+    GetPublisherQoS(pub_node, k, &pub_qos);
     for (const auto& sub : it->second) {
+        QoSProfile sub_qos;
+        GetSubscriberQoS(sub, k, &sub_qos);
+        std::string reason;
+        if (!QoSProfile::isCompatible(pub_qos, sub_qos, &reason)) {
+            LOG_WARN << "Incompatible QoS on topic " << k.topic << ": " << pub_node
+                     << " -> " << sub << " (" << reason << ")";
+            continue;
+        }
         edges_.insert(Edge{pub_node, sub, k});
     }
 }
@@ -23,25 +34,80 @@ void MessageGraph::ConnectPublisherToSubscribers(const std::string& pub_node, co
 void MessageGraph::ConnectPublishersToSubscriber(const std::string& sub_node, const TopicKey& k) {
     auto it = publishers_by_topic_.find(k);
     if (it == publishers_by_topic_.end()) return;
+    QoSProfile sub_qos;
+    GetSubscriberQoS(sub_node, k, &sub_qos);
     for (const auto& pub : it->second) {
+        QoSProfile pub_qos;
+        GetPublisherQoS(pub, k, &pub_qos);
+        std::string reason;
+        if (!QoSProfile::isCompatible(pub_qos, sub_qos, &reason)) {
+            LOG_WARN << "Incompatible QoS on topic " << k.topic << ": " << pub
+                     << " -> " << sub_node << " (" << reason << ")";
+            continue;
+        }
         edges_.insert(Edge{pub, sub_node, k});
     }
 }
 
-void MessageGraph::AddPublisher(const NodeInfo& node, const TopicKey& k) {
+void MessageGraph::AddPublisher(const NodeInfo& node, const TopicKey& k, const QoSProfile& qos) {
     UpsertNode(node);
-    nodes_[node.node_name()].publishes.insert(k);
+    auto& v = nodes_[node.node_name()];
+    v.publishes.insert(k);
+    v.publish_qos[k] = qos;
     publishers_by_topic_[k].insert(node.node_name());
+    // 重复注册时 QoS 可能变化，先删除旧边再按新 QoS 重新匹配
+    RemoveEdgesBy(node.node_name(), k, /*node_is_publisher=*/true);
     ConnectPublisherToSubscribers(node.node_name(), k);
 }
 
-void MessageGraph::AddSubscriber(const NodeInfo& node, const TopicKey& k) {
+void MessageGraph::AddSubscriber(const NodeInfo& node, const TopicKey& k, const QoSProfile& qos) {
     UpsertNode(node);
-    nodes_[node.node_name()].subscribes.insert(k);
+    auto& v = nodes_[node.node_name()];
+    v.subscribes.insert(k);
+    v.subscribe_qos[k] = qos;
     subscribers_by_topic_[k].insert(node.node_name());
+    RemoveEdgesBy(node.node_name(), k, /*node_is_publisher=*/false);
     ConnectPublishersToSubscriber(node.node_name(), k);
 }
 
+bool MessageGraph::GetPublisherQoS(const std::string& node_name, const TopicKey& k, QoSProfile* qos) const {
+    auto it = nodes_.find(node_name);
+    if (it == nodes_.end()) return false;
+    auto qit = it->second.publish_qos.find(k);
+    if (qit == it->second.publish_qos.end()) return false;
+    *qos = qit->second;
+    return true;
+}
+
+bool MessageGraph::GetSubscriberQoS(const std::string& node_name, const TopicKey& k, QoSProfile* qos) const {
+    auto it = nodes_.find(node_name);
+    if (it == nodes_.end()) return false;
+    auto qit = it->second.subscribe_qos.find(k);
+    if (qit == it->second.subscribe_qos.end()) return false;
+    *qos = qit->second;
+    return true;
+}
+
+std::vector<NodeInfo> MessageGraph::GetCompatibleSubscribers(const std::string& pub_node, const TopicKey& k) const {
+    std::vector<NodeInfo> result;
+    for (const auto& e : edges_) {
+        if (e.src_node != pub_node || !(e.key == k)) continue;
+        if (auto nit = nodes_.find(e.dst_node); nit != nodes_.end())
+            result.push_back(nit->second.info);
+    }
+    return result;
+}
+
+std::vector<NodeInfo> MessageGraph::GetCompatiblePublishers(const std::string& sub_node, const TopicKey& k) const {
+    std::vector<NodeInfo> result;
+    for (const auto& e : edges_) {
+        if (e.dst_node != sub_node || !(e.key == k)) continue;
+        if (auto nit = nodes_.find(e.src_node); nit != nodes_.end())
+            result.push_back(nit->second.info);
+    }
+    return result;
+}
+
 void MessageGraph::RemoveEdgesBy(const std::string& node, const TopicKey& k, bool node_is_publisher) {
     // 由于 edges_ 是 unordered_set，只能线性扫描；但边规模通常 << 节点规模，且仅在注销/退订时发生。
     std::vector<Edge> to_erase;
@@ -59,6 +125,7 @@ void MessageGraph::RemovePublisher(const NodeInfo& node, const TopicKey& k) {
     auto itn = nodes_.find(node.node_name());
     if (itn != nodes_.end()) {
         itn->second.publishes.erase(k);
+        itn->second.publish_qos.erase(k);
     }
     auto itp = publishers_by_topic_.find(k);
     if (itp != publishers_by_topic_.end()) {
@@ -73,6 +140,7 @@ void MessageGraph::RemoveSubscriber(const NodeInfo& node, const TopicKey& k) {
     auto itn = nodes_.find(node.node_name());
     if (itn != nodes_.end()) {
         itn->second.subscribes.erase(k);
+        itn->second.subscribe_qos.erase(k);
     }
     auto its = subscribers_by_topic_.find(k);
     if (its != subscribers_by_topic_.end()) {
@@ -107,11 +175,19 @@ std::string MessageGraph::ToReadableString() const {
         oss << " - " << name << " (ip=" << v.info.ip() << ", port=" << v.info.port() << ")\n";
         if (!v.publishes.empty()) {
             oss << "    publishes:\n";
-            for (const auto& k : v.publishes) oss << "      - " << k.topic << " : " << k.msg_type << "\n";
+            for (const auto& k : v.publishes) {
+                oss << "      - " << k.topic << " : " << k.msg_type;
+                if (auto q = v.publish_qos.find(k); q != v.publish_qos.end()) oss << " [" << q->second.toString() << "]";
+                oss << "\n";
+            }
         }
         if (!v.subscribes.empty()) {
             oss << "    subscribes:\n";
-            for (const auto& k : v.subscribes) oss << "      - " << k.topic << " : " << k.msg_type << "\n";
+            for (const auto& k : v.subscribes) {
+                oss << "      - " << k.topic << " : " << k.msg_type;
+                if (auto q = v.subscribe_qos.find(k); q != v.subscribe_qos.end()) oss << " [" << q->second.toString() << "]";
+                oss << "\n";
+            }
         }
     }
     oss << "\n[Edges]\n";
@@ -0,0 +1,43 @@
+#include "message_throttle.h"
+
+namespace simple_ros {
+
+LatestMessageThrottle::LatestMessageThrottle(double max_rate_hz) {
+    setMaxRate(max_rate_hz);
+}
+
+void LatestMessageThrottle::setMaxRate(double max_rate_hz) {
+    max_rate_hz_ = max_rate_hz > 0.0 ? max_rate_hz : 0.0;
+    period_ = max_rate_hz_ > 0.0
+        ? std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / max_rate_hz_))
+        : Clock::duration::zero();
+}
+
+bool LatestMessageThrottle::offer(MessagePtr msg, Clock::time_point now) {
+    if (!limited()) return true;
+    if (now >= next_due_) {
+        // 新消息比待发送的更新，直接发送新消息
+        if (pending_) {
+            pending_.reset();
+            ++dropped_;
+        }
+        next_due_ = now + period_;
+        return true;
+    }
+    if (pending_) ++dropped_;
+    pending_ = std::move(msg);
+    return false;
+}
+
+LatestMessageThrottle::MessagePtr LatestMessageThrottle::takeDue(Clock::time_point now) {
+    if (!pending_ || now < next_due_) return nullptr;
+    next_due_ = now + period_;
+    return std::move(pending_);
+}
+
+void LatestMessageThrottle::reset() {
+    pending_.reset();
+    next_due_ = Clock::time_point{};
+}
+
+} // namespace simple_ros
@@ -1,4 +1,101 @@
 #include "msg_factory.h"
+#include <algorithm>
+
+namespace {
+
+constexpr size_t kMinArenaBlock = 1024;
+constexpr size_t kMaxArenaBlock = 4u << 20;   // 更大的消息由 Arena 继续追加新块
+constexpr size_t kArenaGrowBlock = 64u << 10;
+
+} // namespace
+
+MessageArena::MessageArena(size_t initial_block_size)
+    : block_(new char[std::max(initial_block_size, kMinArenaBlock)]),
+      arena_(makeOptions(block_.get(), std::max(initial_block_size, kMinArenaBlock)))
+{
+}
+
+google::protobuf::ArenaOptions MessageArena::makeOptions(char* block, size_t size) {
+    google::protobuf::ArenaOptions options;
+    options.initial_block = block;
+    options.initial_block_size = size;
+    options.max_block_size = kArenaGrowBlock;
+    return options;
+}
+
+size_t MessageArena::blockSizeFor(size_t payload_size) {
+    // 嵌套消息展开为对象后约为线上大小的 2 倍，再留出对象头与 repeated 指针数组
+    size_t size = payload_size * 2 + 512;
+    return std::min(std::max(size, kMinArenaBlock), kMaxArenaBlock);
+}
+
+MessagePool::MessagePool(const google::protobuf::Message* prototype, size_t capacity)
+    : prototype_(prototype), capacity_(capacity)
+{
+}
+
+MessagePool::~MessagePool() {
+    for (auto* msg : idle_) delete msg;
+}
+
+std::shared_ptr<google::protobuf::Message> MessagePool::acquire() {
+    google::protobuf::Message* msg = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!idle_.empty()) {
+            msg = idle_.back();
+            idle_.pop_back();
+        }
+    }
+    if (msg) {
+        reused_.fetch_add(1, std::memory_order_relaxed);
+    } else {
+        msg = prototype_->New();
+        created_.fetch_add(1, std::memory_order_relaxed);
+    }
+    // 删除器持有池，池在所有借出的消息归还之前不会析构
+    auto self = shared_from_this();
+    return std::shared_ptr<google::protobuf::Message>(msg, [self](google::protobuf::Message* m) {
+        self->release(m);
+    });
+}
+
+void MessagePool::release(google::protobuf::Message* msg) {
+    // Clear 在锁外进行，保留字段容量供下一条消息复用
+    msg->Clear();
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (idle_.size() < capacity_.load(std::memory_order_relaxed)) {
+            idle_.push_back(msg);
+            return;
+        }
+    }
+    delete msg;
+}
+
+void MessagePool::setCapacity(size_t capacity) {
+    std::vector<google::protobuf::Message*> dropped;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        capacity_.store(capacity, std::memory_order_relaxed);
+        while (idle_.size() > capacity) {
+            dropped.push_back(idle_.back());
+            idle_.pop_back();
+        }
+    }
+    for (auto* msg : dropped) delete msg;
+}
+
+size_t MessagePool::idleCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return idle_.size();
+}
+
+MsgFactory::MsgFactory()
+    : entries_(new std::atomic<const TypeEntry*>[kMaxTypes])
+{
+    for (size_t i = 0; i < kMaxTypes; ++i) entries_[i].store(nullptr, std::memory_order_relaxed);
+}
 
 // 获取单例
 MsgFactory& MsgFactory::instance() {
@@ -6,27 +103,110 @@ MsgFactory& MsgFactory::instance() {
     return inst;
 }
 
-// 创建 unique_ptr<Message>
-std::unique_ptr<google::protobuf::Message> MsgFactory::createMessage(const std::string& name) {
+MsgTypeId MsgFactory::registerPrototype(const std::string& name, const google::protobuf::Message* prototype) {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    return registerLocked(name, prototype);
+}
+
+MsgTypeId MsgFactory::registerLocked(const std::string& name, const google::protobuf::Message* prototype) {
+    MsgTypeId id;
+    auto it = ids_.find(name);
+    if (it != ids_.end()) {
+        id = it->second;
+        const TypeEntry* current = entries_[id].load(std::memory_order_acquire);
+        if (current && current->prototype == prototype) return id;
+    } else {
+        if (nextId_ >= kMaxTypes) {
+            return kInvalidMsgTypeId;
+        }
+        id = nextId_++;
+        ids_[name] = id;
+    }
+
+    // 新条目（或以生成类型替换动态类型）：旧条目保留，已借出的消息仍归还到旧池
+    auto entry = std::make_unique<TypeEntry>();
+    entry->name = name;
+    entry->prototype = prototype;
+    entry->pool = std::make_shared<MessagePool>(prototype, poolCapacity_.load(std::memory_order_relaxed));
+    entries_[id].store(entry.get(), std::memory_order_release);
+    allEntries_.push_back(std::move(entry));
+    return id;
+}
+
+MsgTypeId MsgFactory::typeId(const std::string& name) {
     // 1. 尝试从缓存获取
-    auto it = factory_.find(name);
-    if (it != factory_.end()) {
-        return std::unique_ptr<google::protobuf::Message>(it->second->New());
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        auto it = ids_.find(name);
+        if (it != ids_.end()) {
+            return it->second;
+        }
     }
 
     // 2. 未注册类型，通过 DescriptorPool 查找
     const google::protobuf::Descriptor* desc =
         google::protobuf::DescriptorPool::generated_pool()->FindMessageTypeByName(name);
-    if (!desc) return nullptr;
+    if (!desc) return kInvalidMsgTypeId;
 
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    // 并发解析或注册同一类型时以先登记的为准，不用动态类型覆盖已注册的生成类型
+    auto it = ids_.find(name);
+    if (it != ids_.end()) return it->second;
     const google::protobuf::Message* prototype = dynamic_factory_.GetPrototype(desc);
-    if (!prototype) return nullptr;
+    if (!prototype) return kInvalidMsgTypeId;
 
     // 3. 缓存起来，下次直接使用
-    factory_[name] = prototype;
+    return registerLocked(name, prototype);
+}
+
+const MsgFactory::TypeEntry* MsgFactory::entry(MsgTypeId id) const {
+    if (id == kInvalidMsgTypeId || id >= kMaxTypes) return nullptr;
+    return entries_[id].load(std::memory_order_acquire);
+}
+
+const std::string& MsgFactory::typeName(MsgTypeId id) const {
+    static const std::string kEmpty;
+    const TypeEntry* e = entry(id);
+    return e ? e->name : kEmpty;
+}
+
+std::shared_ptr<MessagePool> MsgFactory::pool(MsgTypeId id) const {
+    const TypeEntry* e = entry(id);
+    return e ? e->pool : nullptr;
+}
 
-    // 4. 返回 unique_ptr
-    return std::unique_ptr<google::protobuf::Message>(prototype->New());
+void MsgFactory::setPoolCapacity(size_t capacity) {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    poolCapacity_.store(capacity, std::memory_order_relaxed);
+    for (const auto& e : allEntries_) {
+        e->pool->setCapacity(capacity);
+    }
+}
+
+// 创建 unique_ptr<Message>
+std::unique_ptr<google::protobuf::Message> MsgFactory::createMessage(const std::string& name) {
+    const TypeEntry* e = entry(typeId(name));
+    if (!e) return nullptr;
+    return std::unique_ptr<google::protobuf::Message>(e->prototype->New());
+}
+
+std::shared_ptr<google::protobuf::Message> MsgFactory::createSharedMessage(MsgTypeId id,
+                                                                           const MessageArenaPtr& arena) {
+    const TypeEntry* e = entry(id);
+    if (!e) return nullptr;
+    if (arena) {
+        // Arena 上的消息由 Arena 析构时统一销毁，不能单独 delete；别名构造让 shared_ptr 管理 Arena 的生命周期
+        return std::shared_ptr<google::protobuf::Message>(arena, e->prototype->New(arena->get()));
+    }
+    if (e->pool->capacity() > 0) {
+        return e->pool->acquire();
+    }
+    return std::shared_ptr<google::protobuf::Message>(e->prototype->New());
+}
+
+std::shared_ptr<google::protobuf::Message> MsgFactory::createSharedMessage(const std::string& name,
+                                                                           const MessageArenaPtr& arena) {
+    return createSharedMessage(typeId(name), arena);
 }
 
 // 将 unique_ptr 转换为 shared_ptr
@@ -35,3 +215,16 @@ std::shared_ptr<google::protobuf::Message> MsgFactory::makeSharedMessage(
 {
     return std::shared_ptr<google::protobuf::Message>(std::move(msg));
 }
+
+MsgTypeId MsgTypeIdCache::lookup(const std::string& name) {
+    for (size_t i = 0; i < kSlots; ++i) {
+        if (ids_[i] != kInvalidMsgTypeId && names_[i] == name) return ids_[i];
+    }
+    MsgTypeId id = MsgFactory::instance().typeId(name);
+    if (id != kInvalidMsgTypeId) {
+        names_[next_] = name;
+        ids_[next_] = id;
+        next_ = (next_ + 1) % kSlots;
+    }
+    return id;
+}
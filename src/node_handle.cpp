@@ -1,15 +1,24 @@
 #include "node_handle.h"
 #include "global_init.h"
 #include <muduo/base/Logging.h>
+#include <algorithm>
 #include "timer.h"  // 添加timer头文件
 
-NodeHandle::NodeHandle() {
+NodeHandle::NodeHandle()
+    : defaultGroup_(std::make_shared<CallbackGroup>(CallbackGroupType::MUTUALLY_EXCLUSIVE)) {
     // 从SystemManager获取节点信息
     nodeInfo_ = SystemManager::instance().getNodeInfo();
     LOG_INFO << "NodeHandle initialized with node_name: " << nodeInfo_.node_name()
              << ", IP: " << nodeInfo_.ip() << ", Port: " << nodeInfo_.port();
 }
 
+NodeHandle::NodeHandle(const std::string& node_name)
+    : NodeHandle() {
+    // 监听端点沿用进程的 NodeInfo，只替换节点名
+    nodeInfo_.set_node_name(node_name);
+    LOG_INFO << "NodeHandle renamed to " << node_name;
+}
+
 NodeHandle::~NodeHandle() {
     LOG_INFO << "NodeHandle destroyed";
 }
@@ -18,35 +27,96 @@ NodeHandle::NodeHandle(NodeHandle&&) noexcept = default;
 
 NodeHandle& NodeHandle::operator=(NodeHandle&&) noexcept = default;
 
+bool NodeHandle::unsubscribe(const std::string& topic, const std::string& msg_type_name) {
+    auto rpc_client = SystemManager::instance().getRpcClient();
+    if (!rpc_client) {
+        LOG_ERROR << "Global RPC client not initialized";
+        return false;
+    }
+    simple_ros::UnsubscribeResponse response;
+    if (!rpc_client->Unsubscribe(topic, msg_type_name, nodeInfo_, &response) || !response.success()) {
+        LOG_ERROR << "Unsubscribe RPC failed for topic: " << topic;
+        return false;
+    }
+    LOG_INFO << "Unsubscribed " << nodeInfo_.node_name() << " from topic: " << topic;
+    subscriptions_.erase(std::remove(subscriptions_.begin(), subscriptions_.end(),
+                                     std::make_pair(topic, msg_type_name)),
+                         subscriptions_.end());
+    return true;
+}
+
+void NodeHandle::unsubscribeAll() {
+    auto subscriptions = std::move(subscriptions_);
+    subscriptions_.clear();
+    for (const auto& sub : subscriptions) {
+        unsubscribe(sub.first, sub.second);
+    }
+}
+
+void NodeHandle::recordSubscription(const std::string& topic, const std::string& msg_type_name) {
+    auto entry = std::make_pair(topic, msg_type_name);
+    if (std::find(subscriptions_.begin(), subscriptions_.end(), entry) == subscriptions_.end()) {
+        subscriptions_.push_back(std::move(entry));
+    }
+}
+
 // 添加createTimer方法的实现
-std::shared_ptr<Timer> NodeHandle::createTimer(double period, const TimerCallback& callback, bool oneshot) {
-    // 获取SystemManager的事件循环
-    muduo::net::EventLoop* loop = SystemManager::instance().getEventLoop().get();
+std::shared_ptr<Timer> NodeHandle::createTimer(double period, const TimerCallback& callback, bool oneshot,
+                                               const CallbackGroupPtr& group) {
+    auto& sys = SystemManager::instance();
+    // 定时器运行在独立的定时器线程中，不受接收线程负载影响
+    muduo::net::EventLoop* loop = sys.getTimerLoop();
     
     // 创建定时器
     auto timer = std::make_shared<Timer>(loop, period, callback);
     timer->setOneShot(oneshot);
+
+    // 回调投递到消息队列，耗时的定时器回调不会阻塞网络 IO
+    auto msg_queue = sys.getMessageQueue();
+    if (sys.getIoThreadConfig().timer_callbacks_in_spin && msg_queue) {
+        std::weak_ptr<MessageQueue> weak_queue = msg_queue;
+        CallbackGroupPtr timer_group = group ? group : defaultGroup_;
+        timer->setDispatcher([weak_queue, timer_group](std::function<void()> fn) {
+            if (auto queue = weak_queue.lock()) {
+                queue->pushTask(std::move(fn), timer_group);
+            }
+        });
+    }
     timer->start();
     
     return timer;
 }
 
+CallbackGroupPtr NodeHandle::createCallbackGroup(CallbackGroupType type) {
+    return std::make_shared<CallbackGroup>(type);
+}
+
 std::shared_ptr<Subscriber> NodeHandle::subscribe(const std::string& topic, 
                                                  uint32_t queue_size, 
                                                  const std::string& msg_type_name, 
                                                  MessageQueue::Callback callback) {
-    LOG_INFO << "Subscribe to topic=" << topic << " with dynamic type=" << msg_type_name;
+    return subscribe(topic, simple_ros::QoSProfile(queue_size), msg_type_name, std::move(callback));
+}
+
+std::shared_ptr<Subscriber> NodeHandle::subscribe(const std::string& topic,
+                                                 const simple_ros::QoSProfile& qos,
+                                                 const std::string& msg_type_name,
+                                                 MessageQueue::Callback callback,
+                                                 const CallbackGroupPtr& group) {
+    LOG_INFO << "Subscribe to topic=" << topic << " with dynamic type=" << msg_type_name
+             << ", qos=" << qos.toString();
     
     // 创建订阅者实例
-    auto subscriber = std::make_shared<Subscriber>(topic, queue_size, callback);
+    auto subscriber = std::make_shared<Subscriber>(topic, qos, callback, group ? group : defaultGroup_);
     
     // 调用RPC订阅
     auto rpc_client = SystemManager::instance().getRpcClient();
     if (rpc_client) {
         SubscribeResponse response;
-        bool success = rpc_client->Subscribe(topic, msg_type_name, nodeInfo_, &response);
+        bool success = rpc_client->Subscribe(topic, msg_type_name, nodeInfo_, &response, qos.toMsg());
         if (success) {
             LOG_INFO << "Subscribe RPC successful for topic: " << topic << " with type: " << msg_type_name;
+            recordSubscription(topic, msg_type_name);
         } else {
             LOG_ERROR << "Subscribe RPC failed for topic: " << topic << " with type: " << msg_type_name;
         }
@@ -1,17 +1,26 @@
 #include "poll_manager.h"
 #include "msg_factory.h"
 #include "global_init.h" // 访问 g_messageQueue
+#include "wire_format.h"
 #include <google/protobuf/message.h>
 #include <google/protobuf/descriptor.h>
 #include <google/protobuf/reflection.h>
 #include <arpa/inet.h>
+#include <algorithm>
 #include <muduo/base/Logging.h>
 
 using namespace muduo;
 using namespace muduo::net;
 
-PollManager::PollManager(EventLoop* loop, const InetAddress& listenAddr)
-    : server_(loop, listenAddr, "PollManager")
+namespace {
+// 当前线程正在执行的目标监听回调，用于识别在回调内部移除自身的情况
+thread_local const void* invoking_listener = nullptr;
+}
+
+PollManager::PollManager(EventLoop* loop, const InetAddress& listenAddr, const std::string& unixPath)
+    : server_(loop, listenAddr, "PollManager"),
+      listenAddr_(listenAddr),
+      udpReceiver_(loop, listenAddr)
 {
     server_.setConnectionCallback(
         std::bind(&PollManager::onConnection, this, std::placeholders::_1)
@@ -19,10 +28,62 @@ PollManager::PollManager(EventLoop* loop, const InetAddress& listenAddr)
     server_.setMessageCallback(
         std::bind(&PollManager::onMessage, this, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3)
     );
+    if (!unixPath.empty()) {
+        unixServer_.reset(new UnixServer(loop, unixPath, "PollManager"));
+        unixServer_->setConnectionCallback(
+            std::bind(&PollManager::onConnection, this, std::placeholders::_1)
+        );
+        unixServer_->setMessageCallback(
+            std::bind(&PollManager::onMessage, this, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3)
+        );
+    }
+    // UDP 数据报重组后与 TCP 帧格式相同
+    udpReceiver_.setFrameCallback([this](const std::string& frame) {
+        std::string topic, msg_name, msg_data;
+        if (wire::decodeFrame(frame.data(), frame.size(), &topic, &msg_name, &msg_data) != frame.size()) {
+            LOG_WARN << "Malformed UDP frame of " << frame.size() << " bytes";
+            return;
+        }
+        handleMessage(topic, msg_name, msg_data);
+    });
+}
+
+void PollManager::setThreadNum(int num_threads) {
+    if (num_threads > 0) {
+        numThreads_ = num_threads;
+        server_.setThreadNum(num_threads);
+        LOG_INFO << "PollManager using " << num_threads << " receive thread(s)";
+    }
+}
+
+void PollManager::setThreadInitCallback(std::function<void()> cb) {
+    server_.setThreadInitCallback([cb](EventLoop*) { cb(); });
 }
 
 void PollManager::start() {
-    server_.start();
+    bool io_uring_listening = false;
+    if (ioUring_ && numThreads_ > 0) {
+        // io_uring 只在自己的单个线程中接收，无法满足多个接收线程与 Unix 域套接字共用线程池的配置
+        LOG_ERROR << "io_uring receive path ignores receive_threads=" << numThreads_
+                  << ", receiving TCP with muduo instead (io_uring still used for sending)";
+    } else if (ioUring_) {
+        // 回调在 io_uring 线程中执行，handleMessage 内部的共享状态均已加锁
+        ioUring_->setFrameCallback(
+            [this](const std::string& topic, const std::string& msg_name, const std::string& data) {
+                handleMessage(topic, msg_name, data);
+            });
+        io_uring_listening = ioUring_->listen(listenAddr_.toIp(), listenAddr_.port());
+    }
+    if (!io_uring_listening) {
+        server_.start();
+        // Unix 域套接字连接与 TCP 共用接收线程池
+        if (unixServer_) unixServer_->setThreadPool(server_.threadPool());
+    }
+    udpEnabled_ = udpReceiver_.start();
+    if (unixServer_ && !unixServer_->start()) {
+        // 发布者连接失败时会回退到 TCP
+        unixServer_.reset();
+    }
 }
 
 void PollManager::onConnection(const TcpConnectionPtr& conn) {
@@ -35,57 +96,26 @@ void PollManager::onConnection(const TcpConnectionPtr& conn) {
 
 // 协议:topic_name_len(2B) + topic_name +  msg_name_len(2B) + msg_name  + msg_data_len(4B) + msg_data
 void PollManager::onMessage(const TcpConnectionPtr& conn, Buffer* buf, Timestamp) {
-    while (buf->readableBytes() >= 2) { // 至少需要有topic_len(2B)
-        // 读取topic长度
-        uint16_t topic_len;
-        memcpy(&topic_len, buf->peek(), 2);
-        topic_len = ntohs(topic_len);
-
-        // 检查是否有足够的数据读取topic
-        if (buf->readableBytes() < 2 + topic_len) break;
-
-        // 读取topic
-        std::string topic(buf->peek() + 2, topic_len);
-
-        // 检查是否有足够的数据读取msg_name_len
-        if (buf->readableBytes() < 2 + topic_len + 2) break;
-
-        // 读取消息名称长度
-        uint16_t msg_name_len;
-        memcpy(&msg_name_len, buf->peek() + 2 + topic_len, 2);
-        msg_name_len = ntohs(msg_name_len);
-
-        // 检查是否有足够的数据读取msg_name
-        if (buf->readableBytes() < 2 + topic_len + 2 + msg_name_len) break;
-
-        // 读取消息名称
-        std::string msg_name(buf->peek() + 2 + topic_len + 2, msg_name_len);
-
-        // 检查是否有足够的数据读取msg_len
-        if (buf->readableBytes() < 2 + topic_len + 2 + msg_name_len + 4) break;
-
-        // 读取消息数据长度
-        uint32_t msg_len;
-        memcpy(&msg_len, buf->peek() + 2 + topic_len + 2 + msg_name_len, 4);
-        msg_len = ntohl(msg_len);
-
-        // 检查是否有足够的数据读取msg_data
-        if (buf->readableBytes() < 2 + topic_len + 2 + msg_name_len + 4 + msg_len) break;
-
-        // 读取消息数据
-        std::string msg_data(buf->peek() + 2 + topic_len + 2 + msg_name_len + 4, msg_len);
-
+    std::string topic, msg_name, msg_data;
+    // PER_BATCH：本次读取解出的所有帧共用一个 Arena，首块按缓冲区中的数据量分配
+    MessageArenaPtr batch_arena;
+    bool per_batch = MsgFactory::instance().arenaMode() == ArenaMode::PER_BATCH;
+    while (size_t frame_len = wire::decodeFrame(buf->peek(), buf->readableBytes(), &topic, &msg_name, &msg_data)) {
+        if (per_batch && !batch_arena) {
+            batch_arena = std::make_shared<MessageArena>(MessageArena::blockSizeFor(buf->readableBytes()));
+        }
         // 处理消息
-        handleMessage(topic, msg_name, msg_data);
+        handleMessage(topic, msg_name, msg_data, batch_arena);
 
         // 移动缓冲区指针
-        buf->retrieve(2 + topic_len + 2 + msg_name_len + 4 + msg_len);
+        buf->retrieve(frame_len);
     }
 }
 
 void PollManager::handleMessage(const std::string& topic,
                                 const std::string& msg_name,
-                                const std::string& data) {
+                                const std::string& data,
+                                const MessageArenaPtr& batch_arena) {
 
     // LOG_INFO << "Received message on topic [" << topic << "], type: " << msg_name;
     if (msg_name == "TopicTargetsUpdate") {
@@ -95,41 +125,116 @@ void PollManager::handleMessage(const std::string& topic,
             return;
         }
 
-        auto& targets = topic_targets_[update.topic()];
-
-        // 增加目标
-        for (const auto& n : update.add_targets()) {
-            targets.insert(n);
-        }
-
-        // 移除目标
-        for (const auto& n : update.remove_targets()) {
-            targets.erase(n);
+        std::vector<TargetsListenerPtr> listeners;
+        {
+            std::lock_guard<std::mutex> lock(targets_mutex_);
+            auto& targets = topic_targets_[update.topic()];
+
+            // 增加目标
+            for (const auto& n : update.add_targets()) {
+                targets.insert(n);
+            }
+
+            // 移除目标
+            for (const auto& n : update.remove_targets()) {
+                targets.erase(n);
+            }
+
+            auto it = targets_listeners_.find(update.topic());
+            if (it != targets_listeners_.end()) {
+                listeners = it->second;
+            }
         }
 
         LOG_INFO << "Updated targets for topic: " << update.topic()
                  << " (+" << update.add_targets_size()
                  << ", -" << update.remove_targets_size() << ")";
+
+        // 通知发布者立即建立到新目标的连接，而不是等到下一次 publish。
+        // 回调在锁外执行，inflight 计数让 removeTargetsListener 等它返回，发布者析构后不会再被调用
+        for (const auto& l : listeners) {
+            {
+                std::lock_guard<std::mutex> lock(targets_mutex_);
+                if (l->removed) continue;
+                ++l->inflight;
+            }
+            invoking_listener = l.get();
+            l->cb();
+            invoking_listener = nullptr;
+            {
+                std::lock_guard<std::mutex> lock(targets_mutex_);
+                --l->inflight;
+            }
+            listeners_idle_.notify_all();
+        }
         return;
     }
     
-    // 创建消息并解析
-    auto msg = MsgFactory::instance().createMessage(msg_name);
+    auto mq = SystemManager::instance().getMessageQueue();
+    if (!mq) return;
+
+    MsgFactory& factory = MsgFactory::instance();
+    if (mq->serializedDelivery(topic)) {
+        // 订阅者只转发字节：不反序列化，原样交出
+        static const MsgTypeId serialized_type = factory.registerMessage<SerializedMessage>();
+        auto raw = std::static_pointer_cast<SerializedMessage>(factory.createSharedMessage(serialized_type, nullptr));
+        raw->set_type(msg_name);
+        raw->set_data(data);
+        mq->push(topic, std::move(raw));
+        return;
+    }
+
+    // 创建消息并解析；启用 Arena 时消息及其嵌套字段都分配在 Arena 上，随 shared_ptr 一起释放，
+    // 否则从该类型的对象池取出，最后一个 shared_ptr 释放时 Clear 后放回
+    MessageArenaPtr arena = batch_arena;
+    if (!arena && factory.arenaMode() != ArenaMode::NONE) {
+        arena = std::make_shared<MessageArena>(MessageArena::blockSizeFor(data.size()));
+    }
+    // 每个接收线程缓存类型名到类型 ID 的映射，稳定运行时不再对类型名求哈希
+    thread_local MsgTypeIdCache type_ids;
+    auto msg = factory.createSharedMessage(type_ids.lookup(msg_name), arena);
     if (!msg || !msg->ParseFromString(data)) {
         LOG_WARN << "Failed to create/parse message: " << msg_name;
         return;
     }
     
     // 推送到消息队列
-    if (auto mq = SystemManager::instance().getMessageQueue()) {
-        mq->push(topic, MsgFactory::instance().makeSharedMessage(std::move(msg)));
-    }
+    mq->push(topic, std::move(msg));
 }
 
 
 std::unordered_set<NodeInfo, NodeInfoHash, NodeInfoEqual> PollManager::getTargets(const std::string& topic) const {
+    std::lock_guard<std::mutex> lock(targets_mutex_);
     auto it = topic_targets_.find(topic);
     if (it == topic_targets_.end()) return {};
-    return it->second;
+    return std::unordered_set<NodeInfo, NodeInfoHash, NodeInfoEqual>(it->second.begin(), it->second.end());
+}
+
+uint64_t PollManager::addTargetsListener(const std::string& topic, std::function<void()> cb) {
+    std::lock_guard<std::mutex> lock(targets_mutex_);
+    uint64_t id = next_listener_id_++;
+    auto listener = std::make_shared<TargetsListener>();
+    listener->id = id;
+    listener->cb = std::move(cb);
+    targets_listeners_[topic].push_back(std::move(listener));
+    return id;
+}
+
+void PollManager::removeTargetsListener(const std::string& topic, uint64_t id) {
+    std::unique_lock<std::mutex> lock(targets_mutex_);
+    auto it = targets_listeners_.find(topic);
+    if (it == targets_listeners_.end()) return;
+    auto& listeners = it->second;
+    auto pos = std::find_if(listeners.begin(), listeners.end(),
+                            [id](const TargetsListenerPtr& l) { return l->id == id; });
+    if (pos == listeners.end()) return;
+    TargetsListenerPtr listener = *pos;
+    listeners.erase(pos);
+    if (listeners.empty()) targets_listeners_.erase(it);
+
+    listener->removed = true;
+    // 在回调自身中移除时不能等待自己
+    int self = (invoking_listener == listener.get()) ? 1 : 0;
+    listeners_idle_.wait(lock, [&]() { return listener->inflight <= self; });
 }
 
@@ -0,0 +1,76 @@
+// qos.cc
+// QoSProfile 的实现
+
+#include "qos.h"
+#include <sstream>
+
+namespace simple_ros {
+
+QoSProfile QoSProfile::sensorData() {
+    return QoSProfile(5).bestEffort();
+}
+
+QoSProfile QoSProfile::command() {
+    return QoSProfile(10).reliable();
+}
+
+QoSProfile QoSProfile::latched(uint32_t d) {
+    return QoSProfile(d).reliable().transientLocal();
+}
+
+QoSPolicy QoSProfile::toMsg() const {
+    QoSPolicy msg;
+    msg.set_reliability(reliability == Reliability::BEST_EFFORT
+                            ? QoSPolicy::BEST_EFFORT : QoSPolicy::RELIABLE);
+    msg.set_durability(durability == Durability::TRANSIENT_LOCAL
+                           ? QoSPolicy::TRANSIENT_LOCAL : QoSPolicy::VOLATILE);
+    msg.set_depth(depth);
+    msg.set_deadline(deadline);
+    msg.set_lifespan(lifespan);
+    return msg;
+}
+
+QoSProfile QoSProfile::fromMsg(const QoSPolicy& msg) {
+    QoSProfile qos;
+    qos.reliability = msg.reliability() == QoSPolicy::BEST_EFFORT
+                          ? Reliability::BEST_EFFORT : Reliability::RELIABLE;
+    qos.durability = msg.durability() == QoSPolicy::TRANSIENT_LOCAL
+                         ? Durability::TRANSIENT_LOCAL : Durability::VOLATILE;
+    // 旧客户端不携带 QoS，depth 为 0 时沿用默认值
+    qos.depth = msg.depth() > 0 ? msg.depth() : QoSProfile().depth;
+    qos.deadline = msg.deadline();
+    qos.lifespan = msg.lifespan();
+    return qos;
+}
+
+// 兼容规则（订阅者的要求不能高于发布者的承诺）：
+// 1. 订阅者要求可靠，发布者只提供尽力而为 -> 不兼容
+// 2. 订阅者要求补发历史，发布者不保留历史 -> 不兼容
+// 3. 订阅者要求的 deadline 比发布者承诺的更短 -> 不兼容
+bool QoSProfile::isCompatible(const QoSProfile& pub, const QoSProfile& sub, std::string* reason) {
+    if (sub.reliability == Reliability::RELIABLE && pub.reliability == Reliability::BEST_EFFORT) {
+        if (reason) *reason = "subscriber requires RELIABLE but publisher is BEST_EFFORT";
+        return false;
+    }
+    if (sub.durability == Durability::TRANSIENT_LOCAL && pub.durability == Durability::VOLATILE) {
+        if (reason) *reason = "subscriber requires TRANSIENT_LOCAL but publisher is VOLATILE";
+        return false;
+    }
+    if (sub.deadline > 0 && (pub.deadline <= 0 || pub.deadline > sub.deadline)) {
+        if (reason) *reason = "publisher deadline does not satisfy subscriber deadline";
+        return false;
+    }
+    return true;
+}
+
+std::string QoSProfile::toString() const {
+    std::ostringstream oss;
+    oss << (reliability == Reliability::RELIABLE ? "RELIABLE" : "BEST_EFFORT")
+        << "/" << (durability == Durability::VOLATILE ? "VOLATILE" : "TRANSIENT_LOCAL")
+        << " depth=" << depth;
+    if (deadline > 0) oss << " deadline=" << deadline;
+    if (lifespan > 0) oss << " lifespan=" << lifespan;
+    return oss.str();
+}
+
+} // namespace simple_ros
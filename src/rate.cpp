@@ -0,0 +1,38 @@
+// rate.cc
+// Rate 的实现
+
+#include "rate.h"
+#include "clock.h"
+
+namespace simple_ros {
+
+Rate::Rate(double frequency)
+    : period_(frequency > 0 ? 1.0 / frequency : 0.0),
+      start_(Clock::instance().now()) {
+}
+
+bool Rate::sleep() {
+    Clock& clock = Clock::instance();
+    double expected_end = start_ + period_;
+    double now = clock.now();
+    actualCycleTime_ = now - start_;
+
+    // 已落后超过一个周期：不补偿，从当前时刻重新对齐
+    if (now > expected_end + period_) {
+        start_ = now;
+        return false;
+    }
+
+    bool met = now <= expected_end;
+    if (met) {
+        clock.sleepUntil(expected_end);
+    }
+    start_ = expected_end;
+    return met;
+}
+
+void Rate::reset() {
+    start_ = Clock::instance().now();
+}
+
+} // namespace simple_ros
@@ -0,0 +1,189 @@
+// realtime_profile.cc
+// RealtimeProfile 的实现
+
+#include "realtime_profile.h"
+#include <muduo/base/Logging.h>
+#include <alloca.h>
+#include <malloc.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+
+namespace simple_ros {
+
+namespace {
+
+const char* kRoleKeys[kThreadRoleCount] = {"event", "receive", "timer", "spin", "io_uring"};
+
+long pageSize() {
+    long size = ::sysconf(_SC_PAGESIZE);
+    return size > 0 ? size : 4096;
+}
+
+// 逐页写入当前线程的栈，使其在 mlockall 之后驻留内存
+void prefaultStack(size_t bytes) {
+    if (bytes == 0) return;
+    volatile char* stack = static_cast<volatile char*>(alloca(bytes));
+    long page = pageSize();
+    for (size_t i = 0; i < bytes; i += page) {
+        stack[i] = 0;
+    }
+}
+
+bool parsePolicy(const std::string& name, SchedPolicy* policy) {
+    if (name == "other" || name.empty()) {
+        *policy = SchedPolicy::OTHER;
+    } else if (name == "fifo") {
+        *policy = SchedPolicy::FIFO;
+    } else if (name == "rr") {
+        *policy = SchedPolicy::RR;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+const char* threadRoleName(ThreadRole role) {
+    return kRoleKeys[static_cast<size_t>(role)];
+}
+
+bool RealtimeProfile::enabled() const {
+    if (lock_memory || prefault_stack > 0) return true;
+    for (const auto& t : threads) {
+        if (t.configured()) return true;
+    }
+    return false;
+}
+
+bool applyThreadRtSettings(const ThreadRtSettings& settings, const char* role_name) {
+    bool ok = true;
+    pthread_t self = ::pthread_self();
+
+    if (!settings.cpus.empty()) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        for (int cpu : settings.cpus) {
+            if (cpu >= 0 && cpu < CPU_SETSIZE) CPU_SET(cpu, &set);
+        }
+        int err = ::pthread_setaffinity_np(self, sizeof(set), &set);
+        if (err != 0) {
+            LOG_WARN << "Failed to set CPU affinity for " << role_name << " thread: " << std::strerror(err);
+            ok = false;
+        }
+    }
+
+    if (settings.policy != SchedPolicy::OTHER) {
+        int policy = settings.policy == SchedPolicy::FIFO ? SCHED_FIFO : SCHED_RR;
+        sched_param param{};
+        param.sched_priority = settings.priority;
+        int min_prio = ::sched_get_priority_min(policy);
+        int max_prio = ::sched_get_priority_max(policy);
+        if (param.sched_priority < min_prio) param.sched_priority = min_prio;
+        if (param.sched_priority > max_prio) param.sched_priority = max_prio;
+        int err = ::pthread_setschedparam(self, policy, &param);
+        if (err != 0) {
+            LOG_WARN << "Failed to set " << (policy == SCHED_FIFO ? "SCHED_FIFO" : "SCHED_RR")
+                     << " priority " << param.sched_priority << " for " << role_name << " thread: "
+                     << std::strerror(err) << " (needs CAP_SYS_NICE or RLIMIT_RTPRIO)";
+            ok = false;
+        }
+    }
+
+    if (ok && settings.configured()) {
+        LOG_INFO << "Realtime settings applied to " << role_name << " thread";
+    }
+    return ok;
+}
+
+bool RealtimeProfile::applyToCurrentThread(ThreadRole role) const {
+    // 栈先于调度策略预触碰，实时线程运行后不再因栈增长缺页
+    prefaultStack(prefault_stack);
+    const ThreadRtSettings& s = settings(role);
+    if (!s.configured()) return true;
+    return applyThreadRtSettings(s, threadRoleName(role));
+}
+
+bool RealtimeProfile::lockMemory() const {
+    if (!lock_memory) return true;
+
+    if (::mlockall(MCL_CURRENT | MCL_FUTURE) != 0) {
+        LOG_WARN << "mlockall failed: " << std::strerror(errno) << " (check RLIMIT_MEMLOCK)";
+        return false;
+    }
+    // 释放的内存留在 malloc 中复用，不归还给内核，也不为大块分配单独 mmap
+    ::mallopt(M_TRIM_THRESHOLD, -1);
+    ::mallopt(M_MMAP_MAX, 0);
+
+    if (prefault_heap > 0) {
+        char* heap = static_cast<char*>(std::malloc(prefault_heap));
+        if (heap) {
+            long page = pageSize();
+            for (size_t i = 0; i < prefault_heap; i += page) {
+                heap[i] = 0;
+            }
+            std::free(heap);
+        }
+    }
+    LOG_INFO << "Process memory locked, prefaulted " << (prefault_heap >> 20) << " MiB heap";
+    return true;
+}
+
+bool RealtimeProfile::fromJson(const nlohmann::json& json, RealtimeProfile* out, std::string* error) {
+    auto fail = [error](const std::string& msg) {
+        if (error) *error = msg;
+        return false;
+    };
+    if (!json.is_object()) return fail("realtime profile must be a JSON object");
+
+    RealtimeProfile profile;
+    try {
+        profile.lock_memory = json.value("lock_memory", false);
+        profile.prefault_heap = json.value("prefault_heap_mb", static_cast<size_t>(0)) << 20;
+        profile.prefault_stack = json.value("prefault_stack_kb", static_cast<size_t>(0)) << 10;
+
+        if (json.contains("threads")) {
+            const auto& threads = json["threads"];
+            if (!threads.is_object()) return fail("\"threads\" must be an object");
+            for (auto it = threads.begin(); it != threads.end(); ++it) {
+                size_t idx = 0;
+                while (idx < kThreadRoleCount && it.key() != kRoleKeys[idx]) ++idx;
+                if (idx == kThreadRoleCount) return fail("unknown thread role \"" + it.key() + "\"");
+
+                ThreadRtSettings& s = profile.threads[idx];
+                s.cpus = it.value().value("cpus", std::vector<int>());
+                if (!parsePolicy(it.value().value("policy", std::string("other")), &s.policy)) {
+                    return fail("unknown policy for thread role \"" + it.key() + "\"");
+                }
+                s.priority = it.value().value("priority", 0);
+            }
+        }
+    } catch (const nlohmann::json::exception& e) {
+        return fail(e.what());
+    }
+
+    *out = std::move(profile);
+    return true;
+}
+
+bool RealtimeProfile::loadFile(const std::string& path, RealtimeProfile* out, std::string* error) {
+    std::ifstream in(path);
+    if (!in) {
+        if (error) *error = "cannot open " + path;
+        return false;
+    }
+    nlohmann::json json = nlohmann::json::parse(in, nullptr, false);
+    if (json.is_discarded()) {
+        if (error) *error = "invalid JSON in " + path;
+        return false;
+    }
+    return fromJson(json, out, error);
+}
+
+} // namespace simple_ros
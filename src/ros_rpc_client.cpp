@@ -11,11 +11,13 @@ RosRpcClient::RosRpcClient(const std::string& server_address) {
 bool RosRpcClient::Subscribe(const std::string& topic_name,
                             const std::string& msg_type,
                             const NodeInfo& node_info,
-                            SubscribeResponse* response) {
+                            SubscribeResponse* response,
+                            const QoSPolicy& qos) {
     SubscribeRequest request;
     request.set_topic_name(topic_name);
     request.set_msg_type(msg_type);
     *request.mutable_node_info() = node_info;
+    *request.mutable_qos() = qos;
 
     grpc::ClientContext context;
     grpc::Status status = stub_->Subscribe(&context, request, response);
@@ -30,11 +32,13 @@ bool RosRpcClient::Subscribe(const std::string& topic_name,
 bool RosRpcClient::RegisterPublisher(const std::string& topic_name,
                                     const std::string& msg_type,
                                     const NodeInfo& node_info,
-                                    RegisterPublisherResponse* response) {
+                                    RegisterPublisherResponse* response,
+                                    const QoSPolicy& qos) {
     RegisterPublisherRequest request;
     request.set_topic_name(topic_name);
     request.set_msg_type(msg_type);
     *request.mutable_node_info() = node_info;
+    *request.mutable_qos() = qos;
                                         
     grpc::ClientContext context;
     grpc::Status status = stub_->RegisterPublisher(&context, request, response);
@@ -5,6 +5,19 @@
 
 namespace simple_ros {
 
+namespace {
+// nodes 中不在 keep 里的节点（按节点名比较）
+std::vector<NodeInfo> nodesNotIn(const std::vector<NodeInfo>& nodes, const std::vector<NodeInfo>& keep) {
+    std::unordered_set<std::string> names;
+    for (const auto& n : keep) names.insert(n.node_name());
+    std::vector<NodeInfo> result;
+    for (const auto& n : nodes) {
+        if (!names.count(n.node_name())) result.push_back(n);
+    }
+    return result;
+}
+} // namespace
+
 // ========== 服务实现 ==========
 
 grpc::Status RosRpcServiceImpl::Subscribe(grpc::ServerContext*,
@@ -19,20 +32,41 @@ grpc::Status RosRpcServiceImpl::Subscribe(grpc::ServerContext*,
 
     {
         // 更新图
-        graph_->AddSubscriber(node, {request->topic_name(), request->msg_type()});
-        LOG_DEBUG << "Added subscriber " << node.node_name() << " to topic " << request->topic_name();
-
-        // 通知该 topic 的发布者新增订阅者
+        const TopicKey k{request->topic_name(), request->msg_type()};
+        const QoSProfile qos = QoSProfile::fromMsg(request->qos());
+        // 重复订阅时 QoS 可能变化，记录原先连通的发布者
+        const auto previous_pubs = graph_->GetCompatiblePublishers(node.node_name(), k);
+        graph_->AddSubscriber(node, k, qos);
+        LOG_DEBUG << "Added subscriber " << node.node_name() << " to topic " << request->topic_name()
+                  << " with QoS " << qos.toString();
+
+        // 通知该 topic 上 QoS 兼容的发布者新增订阅者
         simple_ros::TopicTargetsUpdate update;
         update.set_topic(request->topic_name());
         auto* add_node = update.add_add_targets();
         *add_node = node;
 
         int count = 0;
-        for (auto& pub : graph_->GetPublishersByTopic(request->topic_name())) {
+        const auto compatible_pubs = graph_->GetCompatiblePublishers(node.node_name(), k);
+        for (auto& pub : compatible_pubs) {
             tcp_server_->SendUpdate(pub.node_name(), update);
             count++;
         }
+
+        // 新 QoS 下不再兼容的发布者断开该订阅者
+        simple_ros::TopicTargetsUpdate removal;
+        removal.set_topic(request->topic_name());
+        *removal.add_remove_targets() = node;
+        for (auto& pub : nodesNotIn(previous_pubs, compatible_pubs)) {
+            tcp_server_->SendUpdate(pub.node_name(), removal);
+            LOG_INFO << "Publisher " << pub.node_name() << " no longer compatible with subscriber "
+                     << node.node_name() << " on topic " << request->topic_name();
+        }
+        int incompatible = static_cast<int>(graph_->GetPublishersByTopic(request->topic_name()).size()) - count;
+        if (incompatible > 0) {
+            LOG_WARN << incompatible << " publisher(s) on topic " << request->topic_name()
+                     << " have incompatible QoS with subscriber " << node.node_name();
+        }
         LOG_INFO << "Notified " << count << " publishers about new subscriber " << node.node_name();
     }
 
@@ -77,19 +111,28 @@ grpc::Status RosRpcServiceImpl::RegisterPublisher(grpc::ServerContext*,
     const NodeInfo& node = request->node_info();
 
     {
-        graph_->AddPublisher(node, k);
+        const QoSProfile qos = QoSProfile::fromMsg(request->qos());
+        // 重复注册时 QoS 可能变化，记录原先连通的订阅者
+        const auto previous_subs = graph_->GetCompatibleSubscribers(node.node_name(), k);
+        graph_->AddPublisher(node, k, qos);
 
         LOG_INFO << "RegisterPublisher request: topic=" << request->topic_name() 
             << ", msg_type=" << request->msg_type() 
-            << ", node_name=" << node.node_name();
+            << ", node_name=" << node.node_name()
+            << ", qos=" << qos.toString();
 
-        // 通知当前注册的发布者所有订阅该话题的节点
+        // 通知当前注册的发布者所有 QoS 兼容的订阅节点
         simple_ros::TopicTargetsUpdate update;
         update.set_topic(request->topic_name());
-        for (const auto& sub : graph_->GetSubscribersByTopic(request->topic_name())) {
+        const auto compatible_subs = graph_->GetCompatibleSubscribers(node.node_name(), k);
+        for (const auto& sub : compatible_subs) {
             auto* add_node = update.add_add_targets();
             *add_node = sub;
         }
+        // 新 QoS 下不再兼容的订阅者从发布者的目标中移除
+        for (const auto& sub : nodesNotIn(previous_subs, compatible_subs)) {
+            *update.add_remove_targets() = sub;
+        }
         
         // 只通知新注册的发布者
         tcp_server_->SendUpdate(node.node_name(), update);
@@ -0,0 +1,47 @@
+#include "stream_stats.h"
+
+namespace simple_ros {
+
+void StreamStats::onConverted(double seconds, size_t input_bytes) {
+    input_bytes_.fetch_add(input_bytes, std::memory_order_relaxed);
+    {
+        std::lock_guard<std::mutex> lock(hist_mutex_);
+        conversion_.record(seconds);
+    }
+    // 最后递增，快照中的 converted 不会超前于耗时与字节数
+    converted_.fetch_add(1, std::memory_order_release);
+}
+
+void StreamStats::fillCounters(Snapshot* out) const {
+    // 先读完成计数再读分发计数，pending 不会因并发更新而出现负数
+    out->converted = converted_.load(std::memory_order_acquire);
+    out->failed = failed_.load(std::memory_order_acquire);
+    out->dropped = dropped_.load(std::memory_order_relaxed);
+    out->dispatched = dispatched_.load(std::memory_order_relaxed);
+    out->received = received_.load(std::memory_order_relaxed);
+    out->throttled = throttled_.load(std::memory_order_relaxed);
+    out->input_bytes = input_bytes_.load(std::memory_order_relaxed);
+    out->raw_messages = raw_out.messages.load(std::memory_order_relaxed);
+    out->raw_bytes = raw_out.bytes.load(std::memory_order_relaxed);
+    out->scene_messages = scene_out.messages.load(std::memory_order_relaxed);
+    out->scene_bytes = scene_out.bytes.load(std::memory_order_relaxed);
+}
+
+StreamStats::Snapshot StreamStats::snapshot() const {
+    Snapshot out;
+    fillCounters(&out);
+    std::lock_guard<std::mutex> lock(hist_mutex_);
+    out.conversion = conversion_;
+    return out;
+}
+
+StreamStats::Snapshot StreamStats::takeSnapshot() {
+    Snapshot out;
+    fillCounters(&out);
+    std::lock_guard<std::mutex> lock(hist_mutex_);
+    out.conversion = conversion_;
+    conversion_.reset();
+    return out;
+}
+
+} // namespace simple_ros
@@ -5,16 +5,30 @@
 Subscriber::Subscriber(const std::string& topic, 
                        uint32_t queue_size, 
                        MessageQueue::Callback callback)
-    : topic_(topic), queue_size_(queue_size), callback_(std::move(callback)) {
+    : Subscriber(topic, simple_ros::QoSProfile(queue_size), std::move(callback)) {
+}
+
+Subscriber::Subscriber(const std::string& topic,
+                       const simple_ros::QoSProfile& qos,
+                       MessageQueue::Callback callback,
+                       simple_ros::CallbackGroupPtr group)
+    : topic_(topic), queue_size_(qos.depth), callback_(std::move(callback)), qos_(qos),
+      group_(std::move(group)) {
+    attach();
+}
+
+void Subscriber::attach() {
     // 通过SystemManager获取消息队列并订阅
     auto msg_queue = SystemManager::instance().getMessageQueue();
     if (msg_queue) {
         msg_queue_ = msg_queue;
-        msg_queue->registerTopic(topic);
-        msg_queue->setTopicMaxQueueSize(topic, queue_size);
-        msg_queue->addSubscriber(topic, callback_);
+        msg_queue->registerTopic(topic_);
+        msg_queue->setTopicMaxQueueSize(topic_, queue_size_);
+        msg_queue->setTopicTiming(topic_, qos_.lifespan, qos_.deadline);
+        subscriberId_ = msg_queue->addSubscriber(topic_, callback_, group_);
+        SystemManager::instance().updateDeadlineCheck();
     } else {
-        LOG_ERROR << "MessageQueue not initialized when creating Subscriber for topic: " << topic;
+        LOG_ERROR << "MessageQueue not initialized when creating Subscriber for topic: " << topic_;
     }
 }
 
@@ -22,7 +36,9 @@ Subscriber::~Subscriber() {
     // 取消订阅
     auto msg_queue = msg_queue_.lock();
     if (msg_queue) {
-        msg_queue->removeSubscriber(topic_);
+        // 只移除自己，同进程其他节点对该主题的订阅不受影响
+        msg_queue->removeSubscriber(topic_, subscriberId_);
+        SystemManager::instance().updateDeadlineCheck();
         LOG_INFO << "Unsubscribed from topic: " << topic_;
     }
 }
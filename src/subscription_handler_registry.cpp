@@ -1,4 +1,23 @@
 #include "subscription_handler_registry.h"
+#include "json_encoder.h"
+
+namespace {
+
+// 默认回调：每条消息输出一行 JSON（保留 .proto 字段名并输出默认值）
+void printMessage(const std::shared_ptr<google::protobuf::Message>& msg) {
+    static const simple_ros::JsonEncoder encoder([] {
+        simple_ros::JsonEncoder::Options options;
+        options.always_print_primitive_fields = true;
+        options.preserve_proto_field_names = true;
+        return options;
+    }());
+    thread_local std::string line;
+    line.clear();
+    encoder.encode(*msg, &line);
+    std::cout << "[" << msg->GetTypeName() << "] " << line << std::endl;
+}
+
+} // namespace
 
 SubscriptionHandlerRegistry& SubscriptionHandlerRegistry::getInstance() {
     static SubscriptionHandlerRegistry instance;
@@ -27,10 +46,7 @@ std::shared_ptr<Subscriber> SubscriptionHandlerRegistry::createSubscription(
     const std::string& msg_type_name)
 {
     try {
-        auto callback = [](const std::shared_ptr<google::protobuf::Message>& msg) {
-            std::cout << "[" << msg->GetTypeName() << "]\n" << msg->DebugString() << std::endl;
-        };
-        return nh.subscribe(topic_name, 10, msg_type_name, callback);
+        return nh.subscribe(topic_name, genericQoS(), msg_type_name, printMessage);
     } catch (const std::exception& e) {
         std::cerr << "Error creating subscription: " << e.what() << std::endl;
         return nullptr;
@@ -45,11 +61,9 @@ std::shared_ptr<Subscriber> SubscriptionHandlerRegistry::createSubscription(
 {
     try {
         if (!callback) {
-            callback = [](const std::shared_ptr<google::protobuf::Message>& msg) {
-                std::cout << "[" << msg->GetTypeName() << "]\n" << msg->DebugString() << std::endl;
-            };
+            callback = printMessage;
         }
-        return nh.subscribe(topic_name, 10, msg_type_name, callback);
+        return nh.subscribe(topic_name, genericQoS(), msg_type_name, callback);
     } catch (const std::exception& e) {
         std::cerr << "Error creating subscription: " << e.what() << std::endl;
         return nullptr;
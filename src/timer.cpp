@@ -2,144 +2,382 @@
 // Timer类的实现
 
 #include "timer.h"
-#include "muduo/base/Timestamp.h"
-#include <thread>
+#include "clock.h"
+#include "muduo/net/Channel.h"
+#include "muduo/base/Logging.h"
+#include <sys/timerfd.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <mutex>
 
 namespace simple_ros {
 
+namespace {
+
+constexpr int64_t kNanosPerSecond = 1000000000LL;
+
+int64_t monotonicNanos() {
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<int64_t>(ts.tv_sec) * kNanosPerSecond + ts.tv_nsec;
+}
+
+// Clock 时间（墙上时间或仿真时间），用于 TimerEvent
+double clockSeconds() {
+    return Clock::instance().now();
+}
+
+int64_t toNanos(double seconds) {
+    return static_cast<int64_t>(std::llround(seconds * kNanosPerSecond));
+}
+
+} // namespace
+
+struct Timer::State : public std::enable_shared_from_this<Timer::State> {
+    muduo::net::EventLoop* loop = nullptr;
+    int fd = -1;
+    std::unique_ptr<muduo::net::Channel> channel;
+    bool sim = false;                  // 创建时 Clock 处于仿真模式，由时间监听驱动而非 timerfd
+    uint64_t listener_id = 0;
+
+    mutable std::mutex mutex;          // 保护以下字段（用户线程与 EventLoop 线程共享）
+    double period = 0.0;
+    int64_t period_ns = 0;
+    TimerCallback callback;
+    TimerDispatcher dispatcher;
+    uint64_t generation = 0;           // 每次 stop 递增，用于丢弃过期的已派发回调
+    bool isRunning = false;
+    bool isOneShot = false;
+    bool isPaused = false;
+    OverrunPolicy policy = OverrunPolicy::SKIP;
+    int64_t next_deadline = 0;         // 下一次截止时间（纳秒，CLOCK_MONOTONIC 或仿真时间）
+    int64_t remaining_ns = 0;          // 暂停时剩余的时间
+    double wall_offset = 0.0;          // Clock 时间 - 截止时间基准（秒），用于换算 TimerEvent
+    double last_real = 0.0;
+    int32_t last_duration = 0;
+    uint64_t total_overruns = 0;
+    int64_t overruns_counted_until = 0; // CATCH_UP：不晚于该截止时间的错过周期已计入 total_overruns
+    LatencyHistogram histogram;
+
+    // 当前时间（纳秒），与 next_deadline 同一基准
+    int64_t nowNanos() const {
+        return sim ? toNanos(Clock::instance().now()) : monotonicNanos();
+    }
+
+    // 按 next_deadline 设置 timerfd（绝对时间），调用方持有 mutex
+    void armLocked() {
+        if (sim || fd < 0) return;  // 仿真模式下由 onSimTime 检查截止时间；timerfd 创建失败时已报错
+        itimerspec spec{};
+        int64_t deadline = next_deadline > 0 ? next_deadline : 1;
+        spec.it_value.tv_sec = deadline / kNanosPerSecond;
+        spec.it_value.tv_nsec = deadline % kNanosPerSecond;
+        if (::timerfd_settime(fd, TFD_TIMER_ABSTIME, &spec, nullptr) < 0) {
+            // 设置失败时定时器不会再触发
+            LOG_ERROR << "Timer: timerfd_settime failed to arm: " << strerror(errno);
+        }
+    }
+
+    void disarmLocked() {
+        if (sim || fd < 0) return;
+        itimerspec spec{};
+        if (::timerfd_settime(fd, 0, &spec, nullptr) < 0) {
+            // 取消失败时已停止的定时器仍可能触发一次
+            LOG_ERROR << "Timer: timerfd_settime failed to disarm: " << strerror(errno);
+        }
+    }
+
+    void handleRead();
+    void onSimTime(double t);
+    void fire(int64_t now);
+    void invoke(const TimerCallback& cb, const TimerEvent& event);
+};
+
+void Timer::State::handleRead() {
+    uint64_t expirations = 0;
+    ssize_t n = ::read(fd, &expirations, sizeof(expirations));
+    (void)n;
+    fire(monotonicNanos());
+}
+
+void Timer::State::onSimTime(double t) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!isRunning || toNanos(t) < next_deadline) return;
+    }
+    // 仿真时间可能一步跨过多个周期，CATCH_UP 时逐个补齐，与 timerfd 立即再次触发的行为一致
+    std::shared_ptr<State> self = shared_from_this();
+    loop->queueInLoop([self]() {
+        int64_t now = self->nowNanos();
+        while (true) {
+            {
+                std::lock_guard<std::mutex> lock(self->mutex);
+                if (!self->isRunning || now < self->next_deadline) break;
+            }
+            self->fire(now);
+        }
+    });
+}
+
+void Timer::State::fire(int64_t now) {
+    TimerEvent event;
+    TimerCallback cb;
+    TimerDispatcher dispatcher_copy;
+    uint64_t generation_copy = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!isRunning) return;
+
+        int64_t deadline = next_deadline;
+        if (now < deadline) {
+            // 截止时间已被 setPeriod/resume 推后，等待下一次触发
+            return;
+        }
+
+        // 已错过的完整周期数
+        uint32_t missed = period_ns > 0 ? static_cast<uint32_t>((now - deadline) / period_ns) : 0;
+        if (policy == OverrunPolicy::CATCH_UP && missed > 0) {
+            // 补齐触发时这些周期仍在"错过"之列，只计入首次发现时尚未计数的部分
+            int64_t last_missed = deadline + static_cast<int64_t>(missed) * period_ns;
+            int64_t counted_from = std::max(deadline, overruns_counted_until);
+            missed = last_missed > counted_from ? static_cast<uint32_t>((last_missed - counted_from) / period_ns) : 0;
+            overruns_counted_until = std::max(overruns_counted_until, last_missed);
+        }
+        total_overruns += missed;
+
+        double current_real = clockSeconds();
+        event.current_real = current_real;
+        event.last_real = last_real;
+        event.expected_real = deadline / static_cast<double>(kNanosPerSecond) + wall_offset;
+        event.last_duration = last_duration;
+        event.jitter = (now - deadline) / static_cast<double>(kNanosPerSecond);
+        event.overruns = missed;
+        event.total_overruns = total_overruns;
+        histogram.record(event.jitter);
+        last_real = current_real;
+
+        if (isOneShot) {
+            isRunning = false;
+        } else {
+            // 截止时间只按周期推进，与回调耗时无关
+            if (policy == OverrunPolicy::SKIP) {
+                next_deadline = deadline + static_cast<int64_t>(missed + 1) * period_ns;
+            } else {
+                // CATCH_UP：下一个截止时间若已过去，timerfd 会立即再次触发
+                next_deadline = deadline + period_ns;
+            }
+            armLocked();
+        }
+        cb = callback;
+        dispatcher_copy = dispatcher;
+        generation_copy = generation;
+    }
+
+    if (!dispatcher_copy) {
+        invoke(cb, event);
+        return;
+    }
+
+    // 交给派发器在其他线程执行，stop 之后的过期回调直接丢弃
+    std::shared_ptr<State> self = shared_from_this();
+    dispatcher_copy([self, cb, event, generation_copy]() {
+        {
+            std::lock_guard<std::mutex> lock(self->mutex);
+            if (self->generation != generation_copy) return;
+        }
+        self->invoke(cb, event);
+    });
+}
+
+void Timer::State::invoke(const TimerCallback& cb, const TimerEvent& event) {
+    // 回调耗时始终按真实时间计算
+    int64_t startTime = monotonicNanos();
+    // 调用用户回调
+    try {
+        if (cb) {
+            cb(event);
+        }
+    } catch (const std::exception& e) {
+        // 实际应用中应该有更好的异常处理
+        fprintf(stderr, "Timer callback exception: %s\n", e.what());
+    }
+
+    // 计算回调执行时间
+    int64_t endTime = monotonicNanos();
+    std::lock_guard<std::mutex> lock(mutex);
+    last_duration = static_cast<int32_t>((endTime - startTime) / 1000000);
+}
+
 Timer::Timer(muduo::net::EventLoop* loop, double period, const TimerCallback& callback)
-    : loop_(loop),
-      period_(period),
-      callback_(callback),
-      isRunning_(false),
-      isOneShot_(false),
-      isPaused_(false) {
-    lastEvent_.current_real = 0.0;
-    lastEvent_.last_real = 0.0;
-    lastEvent_.expected_real = 0.0;
-    lastEvent_.last_duration = 0;
+    : state_(std::make_shared<State>()) {
+    state_->loop = loop;
+    state_->period = period;
+    state_->period_ns = toNanos(period);
+    state_->callback = callback;
+    state_->sim = Clock::instance().isSimTime();
+    if (state_->sim) {
+        std::weak_ptr<State> weak = state_;
+        state_->listener_id = Clock::instance().addTimeListener([weak](double t) {
+            if (auto state = weak.lock()) state->onSimTime(t);
+        });
+    }
+    state_->fd = ::timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (state_->fd < 0) {
+        LOG_ERROR << "Timer: timerfd_create failed: " << strerror(errno);
+        return;
+    }
+
+    // Channel 只能在 EventLoop 线程中注册；timerfd 在 start 之前不会触发
+    std::shared_ptr<State> state = state_;
+    loop->runInLoop([state]() {
+        state->channel.reset(new muduo::net::Channel(state->loop, state->fd));
+        State* raw = state.get();
+        state->channel->setReadCallback([raw](muduo::Timestamp) { raw->handleRead(); });
+        state->channel->enableReading();
+    });
 }
 
 Timer::~Timer() {
     stop();
+    if (state_->sim) {
+        Clock::instance().removeTimeListener(state_->listener_id);
+    }
+    if (state_->fd < 0) return;
+
+    // 在 EventLoop 线程中注销 Channel，lambda 持有 state 直到注销完成
+    std::shared_ptr<State> state = state_;
+    state_->loop->runInLoop([state]() {
+        if (state->channel) {
+            state->channel->disableAll();
+            state->channel->remove();
+            state->channel.reset();
+        }
+        ::close(state->fd);
+        state->fd = -1;
+    });
+}
+
+void Timer::arm() {
+    // 调用方持有 mutex；仿真模式下两者同一基准，偏移为 0
+    int64_t now = state_->nowNanos();
+    state_->wall_offset = state_->sim ? 0.0 : clockSeconds() - now / static_cast<double>(kNanosPerSecond);
+    state_->armLocked();
 }
 
 void Timer::start() {
-    if (isRunning_ || isPaused_) return;
-    
-    isRunning_ = true;
-    isPaused_ = false;
-    
-    // 获取当前时间作为期望触发时间的基准
-    lastEvent_.expected_real = muduo::Timestamp::now().secondsSinceEpoch();
-    
-    if (isOneShot_) {
-        timerId_ = loop_->runAfter(period_, std::bind(&Timer::internalCallback, this));
-    } else {
-        timerId_ = loop_->runEvery(period_, std::bind(&Timer::internalCallback, this));
-    }
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    if (state_->isRunning || state_->isPaused || state_->fd < 0) return;
+
+    state_->isRunning = true;
+    state_->isPaused = false;
+
+    // 第 k 次的期望触发时间为 start + k * period
+    state_->next_deadline = state_->nowNanos() + state_->period_ns;
+    state_->overruns_counted_until = 0;
+    arm();
 }
 
 void Timer::stop() {
-    if (!isRunning_ && !isPaused_) return;
-    
-    if (isRunning_) {
-        loop_->cancel(timerId_);
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    if (!state_->isRunning && !state_->isPaused) return;
+
+    if (state_->fd >= 0) {
+        state_->disarmLocked();
     }
-    
-    isRunning_ = false;
-    isPaused_ = false;
+
+    state_->isRunning = false;
+    state_->isPaused = false;
+    ++state_->generation;
 }
 
 void Timer::pause() {
-    if (!isRunning_ || isPaused_) return;
-    
-    loop_->cancel(timerId_);
-    isRunning_ = false;
-    isPaused_ = true;
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    if (!state_->isRunning || state_->isPaused) return;
+
+    int64_t remaining = state_->next_deadline - state_->nowNanos();
+    state_->remaining_ns = remaining > 0 ? remaining : 0;
+    state_->disarmLocked();
+    state_->isRunning = false;
+    state_->isPaused = true;
 }
 
 void Timer::resume() {
-    if (isRunning_ || !isPaused_) return;
-    
-    isRunning_ = true;
-    isPaused_ = false;
-    
-    // 计算剩余时间
-    double currentTime = muduo::Timestamp::now().secondsSinceEpoch();
-    double elapsed = currentTime - lastEvent_.current_real;
-    double remaining = period_ - std::fmod(elapsed, period_);
-    
-    if (remaining < 0) remaining = 0;
-    
-    if (isOneShot_) {
-        timerId_ = loop_->runAfter(remaining, std::bind(&Timer::internalCallback, this));
-    } else {
-        timerId_ = loop_->runEvery(period_, std::bind(&Timer::internalCallback, this));
-    }
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    if (state_->isRunning || !state_->isPaused) return;
+
+    state_->isRunning = true;
+    state_->isPaused = false;
+
+    // 保留暂停前剩余的时间，之后的截止时间以此为新的基准
+    state_->next_deadline = state_->nowNanos() + state_->remaining_ns;
+    state_->overruns_counted_until = 0;
+    arm();
 }
 
 void Timer::setOneShot(bool oneshot) {
-    bool wasRunning = isRunning_;
+    bool wasRunning;
+    {
+        std::lock_guard<std::mutex> lock(state_->mutex);
+        wasRunning = state_->isRunning;
+    }
     if (wasRunning) {
         stop();
     }
-    
-    isOneShot_ = oneshot;
-    
+
+    {
+        std::lock_guard<std::mutex> lock(state_->mutex);
+        state_->isOneShot = oneshot;
+    }
+
     if (wasRunning) {
         start();
     }
 }
 
 void Timer::setPeriod(double period) {
-    bool wasRunning = isRunning_;
-    if (wasRunning) {
-        stop();
-    }
-    
-    period_ = period;
-    
-    if (wasRunning) {
-        start();
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    int64_t old_period_ns = state_->period_ns;
+    state_->period = period;
+    state_->period_ns = toNanos(period);
+
+    if (state_->isRunning) {
+        // 以上一次截止时间为基准切换到新周期
+        state_->next_deadline += state_->period_ns - old_period_ns;
+        arm();
     }
 }
 
 double Timer::getPeriod() const {
-    return period_;
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    return state_->period;
 }
 
-void Timer::internalCallback() {
-    // 记录当前时间
-    double startTime = muduo::Timestamp::now().secondsSinceEpoch();
-    
-    // 更新事件信息
-    TimerEvent event;
-    event.current_real = startTime;
-    event.last_real = lastEvent_.current_real;
-    event.expected_real = lastEvent_.expected_real + period_;
-    event.last_duration = lastEvent_.last_duration;
-    
-    // 调用用户回调
-    try {
-        if (callback_) {
-            callback_(event);
-        }
-    } catch (const std::exception& e) {
-        // 实际应用中应该有更好的异常处理
-        fprintf(stderr, "Timer callback exception: %s\n", e.what());
-    }
-    
-    // 计算回调执行时间
-    double endTime = muduo::Timestamp::now().secondsSinceEpoch();
-    lastEvent_.last_duration = static_cast<int32_t>((endTime - startTime) * 1000);
-    lastEvent_.current_real = startTime;
-    lastEvent_.expected_real = event.expected_real;
-    
-    // 对于一次性定时器，执行后停止
-    if (isOneShot_) {
-        isRunning_ = false;
-    }
+void Timer::setDispatcher(const TimerDispatcher& dispatcher) {
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    state_->dispatcher = dispatcher;
+}
+
+void Timer::setOverrunPolicy(OverrunPolicy policy) {
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    state_->policy = policy;
+}
+
+OverrunPolicy Timer::getOverrunPolicy() const {
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    return state_->policy;
+}
+
+LatencyHistogram Timer::getLatencyHistogram() const {
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    return state_->histogram;
+}
+
+uint64_t Timer::getOverrunCount() const {
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    return state_->total_overruns;
 }
 
-} // namespace simple_ros
\ No newline at end of file
+} // namespace simple_ros
@@ -0,0 +1,303 @@
+// timing_wheel.cc
+// TimingWheel 的实现
+
+#include "timing_wheel.h"
+#include <muduo/base/Logging.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cmath>
+#include <ctime>
+#include <future>
+
+namespace simple_ros {
+
+namespace {
+
+int64_t monotonicNanos() {
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<int64_t>(ts.tv_sec) * 1000000000LL + ts.tv_nsec;
+}
+
+} // namespace
+
+TimingWheel::TimingWheel(muduo::net::EventLoop* loop, const Options& options)
+    : loop_(loop),
+      resolution_(options.resolution),
+      slotBits_(options.slot_bits),
+      levels_(options.levels) {
+    if (resolution_ <= 0 || slotBits_ < 1 || slotBits_ > 16 || levels_ < 1 || slotBits_ * levels_ > 48) {
+        LOG_WARN << "TimingWheel: invalid options, using defaults";
+        Options defaults;
+        resolution_ = defaults.resolution;
+        slotBits_ = defaults.slot_bits;
+        levels_ = defaults.levels;
+    }
+    slotMask_ = (1ULL << slotBits_) - 1;
+    heads_.assign(static_cast<size_t>(levels_) << slotBits_, kNil);
+    baseNanos_ = monotonicNanos();
+
+    if (!loop_) return;
+
+    timerfd_ = ::timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (timerfd_ < 0) {
+        LOG_ERROR << "TimingWheel: timerfd_create failed";
+        return;
+    }
+    loop_->runInLoop([this]() {
+        channel_.reset(new muduo::net::Channel(loop_, timerfd_));
+        channel_->setReadCallback([this](muduo::Timestamp) { handleRead(); });
+        channel_->enableReading();
+    });
+}
+
+TimingWheel::~TimingWheel() {
+    detach();
+}
+
+void TimingWheel::detach() {
+    if (!loop_ || timerfd_ < 0) {
+        loop_ = nullptr;
+        return;
+    }
+
+    // Channel 须在 EventLoop 线程中注销，等待完成后再释放
+    auto removeChannel = [this]() {
+        if (channel_) {
+            channel_->disableAll();
+            channel_->remove();
+            channel_.reset();
+        }
+    };
+    if (loop_->isInLoopThread()) {
+        removeChannel();
+    } else {
+        std::promise<void> done;
+        loop_->runInLoop([&]() {
+            removeChannel();
+            done.set_value();
+        });
+        done.get_future().wait();
+    }
+
+    // 之后 schedule 不再使用 timerfd，只能通过 advance 推进
+    std::lock_guard<std::mutex> lock(mutex_);
+    ::close(timerfd_);
+    timerfd_ = -1;
+    armed_ = false;
+    loop_ = nullptr;
+}
+
+uint64_t TimingWheel::ticksFor(double seconds) const {
+    if (seconds <= 0) return 1;
+    double ticks = std::ceil(seconds / resolution_ - 1e-9);
+    return ticks < 1 ? 1 : static_cast<uint64_t>(ticks);
+}
+
+uint64_t TimingWheel::realTick() const {
+    int64_t elapsed = monotonicNanos() - baseNanos_;
+    return static_cast<uint64_t>(elapsed / (resolution_ * 1e9));
+}
+
+uint32_t TimingWheel::allocNode() {
+    if (!freeList_.empty()) {
+        uint32_t idx = freeList_.back();
+        freeList_.pop_back();
+        return idx;
+    }
+    nodes_.emplace_back();
+    return static_cast<uint32_t>(nodes_.size() - 1);
+}
+
+void TimingWheel::freeNode(uint32_t idx) {
+    Node& node = nodes_[idx];
+    node.cb = nullptr;
+    node.slot = kNil;
+    ++node.generation;
+    freeList_.push_back(idx);
+}
+
+void TimingWheel::link(uint32_t idx, uint64_t earliest) {
+    Node& node = nodes_[idx];
+    uint64_t expire = std::max(node.expire, earliest);
+    uint64_t delta = expire - current_;
+
+    // 选择能容纳 delta 的最低层
+    int level = 0;
+    while (level < levels_ - 1 && delta >= (1ULL << (slotBits_ * (level + 1)))) {
+        ++level;
+    }
+    uint64_t range = 1ULL << (slotBits_ * levels_);
+    if (delta >= range) {
+        // 超出时间轮范围，先放在最远的槽，下沉时重新计算
+        expire = current_ + range - 1;
+    }
+
+    uint64_t index = (expire >> (slotBits_ * level)) & slotMask_;
+    uint32_t slot = static_cast<uint32_t>((static_cast<uint64_t>(level) << slotBits_) + index);
+
+    node.slot = slot;
+    node.prev = kNil;
+    node.next = heads_[slot];
+    if (node.next != kNil) nodes_[node.next].prev = idx;
+    heads_[slot] = idx;
+}
+
+void TimingWheel::unlink(uint32_t idx) {
+    Node& node = nodes_[idx];
+    if (node.prev != kNil) {
+        nodes_[node.prev].next = node.next;
+    } else {
+        heads_[node.slot] = node.next;
+    }
+    if (node.next != kNil) nodes_[node.next].prev = node.prev;
+    node.prev = node.next = kNil;
+}
+
+void TimingWheel::cascade(int level, uint64_t index) {
+    uint32_t slot = static_cast<uint32_t>((static_cast<uint64_t>(level) << slotBits_) + index);
+    uint32_t idx = heads_[slot];
+    heads_[slot] = kNil;
+    while (idx != kNil) {
+        uint32_t next = nodes_[idx].next;
+        // 下沉发生在处理第 0 层当前槽之前，恰好在本 tick 到期的定时器仍能按时触发
+        link(idx, current_);
+        idx = next;
+    }
+}
+
+void TimingWheel::tickLocked(std::vector<Callback>* fired) {
+    ++current_;
+
+    // 低层转完一圈时，把上一层对应槽的定时器下沉
+    for (int level = 1; level < levels_; ++level) {
+        uint64_t lowMask = (1ULL << (slotBits_ * level)) - 1;
+        if ((current_ & lowMask) != 0) break;
+        cascade(level, (current_ >> (slotBits_ * level)) & slotMask_);
+    }
+
+    uint32_t slot = static_cast<uint32_t>(current_ & slotMask_);
+    uint32_t idx = heads_[slot];
+    heads_[slot] = kNil;
+    while (idx != kNil) {
+        Node& node = nodes_[idx];
+        uint32_t next = node.next;
+        node.prev = node.next = kNil;
+
+        if (node.expire > current_) {
+            link(idx, current_ + 1);
+        } else if (node.period > 0) {
+            fired->push_back(node.cb);
+            node.expire += node.period;
+            link(idx, current_ + 1);
+        } else {
+            fired->push_back(std::move(node.cb));
+            freeNode(idx);
+            --active_;
+        }
+        idx = next;
+    }
+}
+
+void TimingWheel::armLocked(bool on) {
+    if (timerfd_ < 0 || on == armed_) return;
+    armed_ = on;
+
+    itimerspec spec{};
+    if (on) {
+        int64_t ns = static_cast<int64_t>(resolution_ * 1e9);
+        spec.it_interval.tv_sec = ns / 1000000000LL;
+        spec.it_interval.tv_nsec = ns % 1000000000LL;
+        spec.it_value = spec.it_interval;
+    }
+    ::timerfd_settime(timerfd_, 0, &spec, nullptr);
+}
+
+TimingWheel::TimerId TimingWheel::schedule(double delay, Callback cb, double period) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    uint64_t now = current_;
+    if (timerfd_ >= 0) {
+        // 以真实时间为起点，current_ 落后时（tick 尚未处理）也不会提前触发
+        now = std::max(current_, realTick());
+        // 空闲期间没有 tick，重新开始计时前先对齐到真实时间
+        if (active_ == 0) current_ = now;
+    }
+
+    uint32_t idx = allocNode();
+    Node& node = nodes_[idx];
+    node.expire = now + ticksFor(delay);
+    node.period = period > 0 ? ticksFor(period) : 0;
+    node.cb = std::move(cb);
+    link(idx, current_ + 1);
+    ++active_;
+    armLocked(true);
+
+    return (static_cast<uint64_t>(node.generation) << 32) | (static_cast<uint64_t>(idx) + 1);
+}
+
+bool TimingWheel::cancel(TimerId id) {
+    if (id == kInvalidTimer) return false;
+    uint32_t idx = static_cast<uint32_t>((id & 0xffffffffULL) - 1);
+    uint32_t generation = static_cast<uint32_t>(id >> 32);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (idx >= nodes_.size()) return false;
+    Node& node = nodes_[idx];
+    if (node.slot == kNil || node.generation != generation) return false;
+
+    unlink(idx);
+    freeNode(idx);
+    if (--active_ == 0) armLocked(false);
+    return true;
+}
+
+size_t TimingWheel::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return active_;
+}
+
+uint64_t TimingWheel::currentTick() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return current_;
+}
+
+size_t TimingWheel::advance(uint64_t ticks) {
+    std::vector<Callback> fired;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (uint64_t i = 0; i < ticks; ++i) {
+            tickLocked(&fired);
+        }
+        if (active_ == 0) armLocked(false);
+    }
+    for (auto& cb : fired) {
+        if (cb) cb();
+    }
+    return fired.size();
+}
+
+void TimingWheel::handleRead() {
+    uint64_t expirations = 0;
+    ssize_t n = ::read(timerfd_, &expirations, sizeof(expirations));
+    (void)n;
+
+    std::vector<Callback> fired;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        // 按真实时间补齐 tick，EventLoop 偶尔卡顿时不会累积延迟
+        uint64_t target = realTick();
+        while (current_ < target && active_ > 0) {
+            tickLocked(&fired);
+        }
+        if (active_ == 0) {
+            current_ = std::max(current_, target);
+            armLocked(false);
+        }
+    }
+    for (auto& cb : fired) {
+        if (cb) cb();
+    }
+}
+
+} // namespace simple_ros
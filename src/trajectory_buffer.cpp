@@ -0,0 +1,138 @@
+#include "trajectory_buffer.h"
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+namespace simple_ros {
+
+namespace {
+
+// 点 p 到线段 ab 的距离
+double segmentDistance(const TrajectoryPoint& p, const TrajectoryPoint& a, const TrajectoryPoint& b) {
+    double abx = b.x - a.x, aby = b.y - a.y, abz = b.z - a.z;
+    double apx = p.x - a.x, apy = p.y - a.y, apz = p.z - a.z;
+    double len2 = abx * abx + aby * aby + abz * abz;
+    double t = len2 > 0.0 ? (apx * abx + apy * aby + apz * abz) / len2 : 0.0;
+    t = std::min(1.0, std::max(0.0, t));
+    double dx = apx - t * abx, dy = apy - t * aby, dz = apz - t * abz;
+    return std::sqrt(dx * dx + dy * dy + dz * dz);
+}
+
+} // namespace
+
+size_t TrajectoryBuffer::windowForLifetime(double lifetime) {
+    if (lifetime < 0) return 0;
+    // 直接截断会把 (0, 1) 变成 0，即永久模式
+    return std::max<size_t>(1, static_cast<size_t>(std::ceil(lifetime)));
+}
+
+TrajectoryBuffer::TrajectoryBuffer(size_t window, const Options& options)
+    : window_(window), options_(options), ring_(window) {
+    options_.chunk_size = std::max<size_t>(options_.chunk_size, 2);
+    if (window_ == 0) tail_.reserve(options_.chunk_size);
+}
+
+void TrajectoryBuffer::append(const TrajectoryPoint& point) {
+    if (windowed()) {
+        ring_.push_back(point);
+        return;
+    }
+    tail_.push_back(point);
+    if (tail_.size() >= options_.chunk_size) seal();
+}
+
+void TrajectoryBuffer::seal() {
+    Chunk chunk;
+    chunk.seq = next_seq_++;
+    if (options_.simplify_tolerance > 0.0) {
+        chunk.points = simplify(tail_, options_.simplify_tolerance);
+    } else {
+        chunk.points = tail_;
+    }
+    chunk_points_ += chunk.points.size();
+    chunks_.push_back(std::move(chunk));
+
+    // 新尾段以上一段的末点开头
+    TrajectoryPoint last = tail_.back();
+    tail_.clear();
+    tail_.push_back(last);
+
+    while (!chunks_.empty() && chunk_points_ + tail_.size() > options_.max_points) {
+        const Chunk& oldest = chunks_.front();
+        if (oldest.sent) evicted_.push_back(oldest.seq);
+        chunk_points_ -= oldest.points.size();
+        chunks_.pop_front();
+    }
+}
+
+const std::vector<TrajectoryPoint>& TrajectoryBuffer::tail() {
+    if (windowed()) {
+        tail_.clear();
+        ring_.copyTo(tail_);
+    }
+    return tail_;
+}
+
+void TrajectoryBuffer::takeChanges(std::vector<const Chunk*>* sealed, std::vector<uint64_t>* evicted) {
+    for (auto& chunk : chunks_) {
+        if (chunk.sent) continue;
+        chunk.sent = true;
+        sealed->push_back(&chunk);
+    }
+    evicted->insert(evicted->end(), evicted_.begin(), evicted_.end());
+    evicted_.clear();
+}
+
+void TrajectoryBuffer::resendAll() {
+    for (auto& chunk : chunks_) chunk.sent = false;
+}
+
+std::vector<uint64_t> TrajectoryBuffer::sentChunks() const {
+    std::vector<uint64_t> seqs;
+    for (const auto& chunk : chunks_) {
+        if (chunk.sent) seqs.push_back(chunk.seq);
+    }
+    return seqs;
+}
+
+size_t TrajectoryBuffer::pointCount() const {
+    return windowed() ? ring_.size() : chunk_points_ + tail_.size();
+}
+
+std::vector<TrajectoryPoint> TrajectoryBuffer::simplify(const std::vector<TrajectoryPoint>& points,
+                                                        double tolerance) {
+    if (points.size() <= 2) return points;
+
+    // 用显式栈代替递归，长折线不会栈溢出
+    std::vector<bool> keep(points.size(), false);
+    keep.front() = true;
+    keep.back() = true;
+    std::vector<std::pair<size_t, size_t>> stack;
+    stack.emplace_back(0, points.size() - 1);
+    while (!stack.empty()) {
+        auto range = stack.back();
+        stack.pop_back();
+        double max_dist = 0.0;
+        size_t index = range.first;
+        for (size_t i = range.first + 1; i < range.second; ++i) {
+            double d = segmentDistance(points[i], points[range.first], points[range.second]);
+            if (d > max_dist) {
+                max_dist = d;
+                index = i;
+            }
+        }
+        if (max_dist > tolerance) {
+            keep[index] = true;
+            stack.emplace_back(range.first, index);
+            stack.emplace_back(index, range.second);
+        }
+    }
+
+    std::vector<TrajectoryPoint> result;
+    for (size_t i = 0; i < points.size(); ++i) {
+        if (keep[i]) result.push_back(points[i]);
+    }
+    return result;
+}
+
+} // namespace simple_ros
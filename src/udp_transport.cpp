@@ -0,0 +1,292 @@
+#include "udp_transport.h"
+#include <muduo/base/Logging.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#include <random>
+
+using namespace muduo;
+using namespace muduo::net;
+
+namespace {
+// 长时间没有数据的发送流会被清理（发布者退出或重启）
+constexpr auto kStreamIdleTimeout = std::chrono::seconds(10);
+// 高频话题突发时避免内核丢包
+constexpr int kSocketBufferSize = 4 * 1024 * 1024;
+
+void writeU32(char* p, uint32_t v) { v = htonl(v); memcpy(p, &v, 4); }
+void writeU16(char* p, uint16_t v) { v = htons(v); memcpy(p, &v, 2); }
+uint32_t readU32(const char* p) { uint32_t v; memcpy(&v, p, 4); return ntohl(v); }
+uint16_t readU16(const char* p) { uint16_t v; memcpy(&v, p, 2); return ntohs(v); }
+} // namespace
+
+// ================= 分片 =================
+
+std::vector<std::string> udp::fragment(uint32_t stream_id, uint32_t seq, const std::string& frame,
+                                       size_t max_payload) {
+    std::vector<std::string> datagrams;
+    if (frame.empty() || frame.size() > kMaxMessageSize || max_payload == 0) return datagrams;
+
+    size_t count = (frame.size() + max_payload - 1) / max_payload;
+    if (count > 0xFFFF) return datagrams;
+
+    datagrams.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        size_t offset = i * max_payload;
+        size_t len = std::min(max_payload, frame.size() - offset);
+
+        std::string dgram(kHeaderSize + len, '\0');
+        char* p = &dgram[0];
+        writeU32(p, kMagic);
+        writeU32(p + 4, stream_id);
+        writeU32(p + 8, seq);
+        writeU16(p + 12, static_cast<uint16_t>(i));
+        writeU16(p + 14, static_cast<uint16_t>(count));
+        writeU32(p + 16, static_cast<uint32_t>(frame.size()));
+        memcpy(p + kHeaderSize, frame.data() + offset, len);
+        datagrams.push_back(std::move(dgram));
+    }
+    return datagrams;
+}
+
+bool udp::parseHeader(const char* data, size_t len, UdpFragmentHeader* header) {
+    if (len < kHeaderSize || readU32(data) != kMagic) return false;
+    header->stream_id = readU32(data + 4);
+    header->seq = readU32(data + 8);
+    header->frag_index = readU16(data + 12);
+    header->frag_count = readU16(data + 14);
+    header->total_len = readU32(data + 16);
+    return header->frag_count > 0 && header->frag_index < header->frag_count &&
+           header->total_len > 0 && header->total_len <= kMaxMessageSize;
+}
+
+// ================= 重组 =================
+
+bool UdpReassembler::onDatagram(const std::string& source, const char* data, size_t len, std::string* frame) {
+    UdpFragmentHeader header;
+    if (!udp::parseHeader(data, len, &header)) {
+        ++stats_.dropped_invalid;
+        return false;
+    }
+    // frag_count 来自网络：须与 total_len 按分片大小算出的数目一致，
+    // 否则一个伪造的数据报就能让接收端为一条消息预留上万个分片槽位
+    size_t payload_len = len - udp::kHeaderSize;
+    if (header.total_len > max_message_size_ || payload_len > max_payload_ ||
+        header.frag_count != (header.total_len + max_payload_ - 1) / max_payload_) {
+        ++stats_.dropped_invalid;
+        return false;
+    }
+
+    auto now = std::chrono::steady_clock::now();
+    std::string key = source + "#" + std::to_string(header.stream_id);
+    auto it = streams_.find(key);
+    if (it == streams_.end()) {
+        purgeIdleStreams(now);
+        it = streams_.emplace(key, StreamState()).first;
+    }
+    StreamState& s = it->second;
+    s.last_active = now;
+
+    // 已交付过更新（或相同）的消息：过期分片
+    if (s.has_delivered && !seqNewer(header.seq, s.last_delivered)) {
+        ++stats_.dropped_stale;
+        return false;
+    }
+
+    if (s.assembling) {
+        if (seqNewer(s.seq, header.seq)) {
+            // 比正在重组的消息更旧：乱序分片
+            ++stats_.dropped_stale;
+            return false;
+        }
+        if (header.seq != s.seq) {
+            // 更新的消息到达，旧消息已无意义
+            ++stats_.dropped_incomplete;
+            s.assembling = false;
+        } else if (header.frag_count != s.frag_count || header.total_len != s.total_len) {
+            ++stats_.dropped_invalid;
+            return false;
+        }
+    }
+
+    const char* payload = data + udp::kHeaderSize;
+
+    // 单分片消息直接交付
+    if (header.frag_count == 1) {
+        if (payload_len != header.total_len) {
+            ++stats_.dropped_invalid;
+            return false;
+        }
+        frame->assign(payload, payload_len);
+        s.has_delivered = true;
+        s.last_delivered = header.seq;
+        ++stats_.delivered;
+        return true;
+    }
+
+    if (!s.assembling) {
+        s.assembling = true;
+        s.seq = header.seq;
+        s.frag_count = header.frag_count;
+        s.total_len = header.total_len;
+        s.received = 0;
+        s.fragments.assign(header.frag_count, std::string());
+    }
+
+    std::string& slot = s.fragments[header.frag_index];
+    if (!slot.empty()) return false;  // 重复分片
+    slot.assign(payload, payload_len);
+    if (++s.received < s.frag_count) return false;
+
+    frame->clear();
+    frame->reserve(s.total_len);
+    for (auto& part : s.fragments) {
+        frame->append(part);
+    }
+    s.fragments.clear();
+    s.assembling = false;
+
+    if (frame->size() != s.total_len) {
+        ++stats_.dropped_invalid;
+        return false;
+    }
+    s.has_delivered = true;
+    s.last_delivered = header.seq;
+    ++stats_.delivered;
+    return true;
+}
+
+void UdpReassembler::purgeIdleStreams(std::chrono::steady_clock::time_point now) {
+    for (auto it = streams_.begin(); it != streams_.end();) {
+        if (now - it->second.last_active > kStreamIdleTimeout) {
+            it = streams_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+// ================= 接收端 =================
+
+UdpReceiver::UdpReceiver(EventLoop* loop, const InetAddress& listenAddr)
+    : loop_(loop), listenAddr_(listenAddr), recvBuf_(65536) {
+}
+
+UdpReceiver::~UdpReceiver() {
+    if (channel_) {
+        channel_->disableAll();
+        channel_->remove();
+    }
+    if (fd_ >= 0) ::close(fd_);
+}
+
+bool UdpReceiver::start() {
+    fd_ = ::socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd_ < 0) {
+        LOG_WARN << "UdpReceiver: socket() failed, errno=" << errno;
+        return false;
+    }
+    int bufsize = kSocketBufferSize;
+    ::setsockopt(fd_, SOL_SOCKET, SO_RCVBUF, &bufsize, sizeof(bufsize));
+
+    if (::bind(fd_, listenAddr_.getSockAddr(), sizeof(sockaddr_in)) < 0) {
+        LOG_WARN << "UdpReceiver: bind " << listenAddr_.toIpPort() << " failed, errno=" << errno
+                 << ", best-effort topics will not be received";
+        ::close(fd_);
+        fd_ = -1;
+        return false;
+    }
+
+    channel_.reset(new Channel(loop_, fd_));
+    channel_->setReadCallback(std::bind(&UdpReceiver::handleRead, this, std::placeholders::_1));
+    channel_->enableReading();
+    LOG_INFO << "UdpReceiver listening on " << listenAddr_.toIpPort();
+    return true;
+}
+
+void UdpReceiver::handleRead(Timestamp) {
+    std::string frame;
+    // 一次把内核缓冲区读空，减少 epoll 唤醒次数
+    while (true) {
+        sockaddr_in peer{};
+        socklen_t peer_len = sizeof(peer);
+        ssize_t n = ::recvfrom(fd_, recvBuf_.data(), recvBuf_.size(), 0,
+                               reinterpret_cast<sockaddr*>(&peer), &peer_len);
+        if (n < 0) {
+            if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+                LOG_WARN << "UdpReceiver: recvfrom failed, errno=" << errno;
+            }
+            break;
+        }
+
+        char ip[INET_ADDRSTRLEN] = {0};
+        ::inet_ntop(AF_INET, &peer.sin_addr, ip, sizeof(ip));
+        std::string source = std::string(ip) + ":" + std::to_string(ntohs(peer.sin_port));
+
+        if (reassembler_.onDatagram(source, recvBuf_.data(), static_cast<size_t>(n), &frame) &&
+            frameCallback_) {
+            frameCallback_(frame);
+        }
+    }
+}
+
+// ================= 发送端 =================
+
+UdpSender::UdpSender() {
+    std::random_device rd;
+    streamId_ = rd();
+
+    fd_ = ::socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd_ < 0) {
+        LOG_ERROR << "UdpSender: socket() failed, errno=" << errno;
+        return;
+    }
+    int bufsize = kSocketBufferSize;
+    ::setsockopt(fd_, SOL_SOCKET, SO_SNDBUF, &bufsize, sizeof(bufsize));
+}
+
+UdpSender::~UdpSender() {
+    if (fd_ >= 0) ::close(fd_);
+}
+
+sockaddr_in UdpSender::makeAddr(const std::string& ip, uint16_t port) {
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    ::inet_pton(AF_INET, ip.c_str(), &addr.sin_addr);
+    return addr;
+}
+
+size_t UdpSender::send(const std::string& frame, const std::vector<sockaddr_in>& targets) {
+    if (fd_ < 0 || targets.empty()) return 0;
+
+    auto datagrams = udp::fragment(streamId_, nextSeq_++, frame);
+    if (datagrams.empty()) {
+        LOG_WARN << "UdpSender: frame of " << frame.size() << " bytes cannot be fragmented";
+        return 0;
+    }
+
+    size_t sent = 0;
+    for (const auto& target : targets) {
+        if (sendDatagrams(datagrams, target)) ++sent;
+    }
+    return sent;
+}
+
+bool UdpSender::sendTo(const std::string& frame, const sockaddr_in& target) {
+    return send(frame, std::vector<sockaddr_in>{target}) == 1;
+}
+
+bool UdpSender::sendDatagrams(const std::vector<std::string>& datagrams, const sockaddr_in& target) {
+    for (const auto& dgram : datagrams) {
+        ssize_t n = ::sendto(fd_, dgram.data(), dgram.size(), 0,
+                             reinterpret_cast<const sockaddr*>(&target), sizeof(target));
+        if (n < 0) {
+            // 发送缓冲区满或对端不可达：尽力而为，放弃这条消息的剩余分片
+            return false;
+        }
+    }
+    return true;
+}
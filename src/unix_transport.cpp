@@ -0,0 +1,198 @@
+#include "unix_transport.h"
+#include <muduo/base/Logging.h>
+#include <muduo/net/InetAddress.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+
+using namespace muduo;
+using namespace muduo::net;
+
+namespace {
+
+bool makeUnixAddr(const std::string& path, sockaddr_un* addr, socklen_t* len) {
+    memset(addr, 0, sizeof(*addr));
+    addr->sun_family = AF_UNIX;
+    if (path.empty() || path.size() >= sizeof(addr->sun_path)) return false;
+
+    if (path[0] == '@') {
+        // 抽象命名空间：sun_path[0] 为 '\0'，长度按实际名字计算
+        memcpy(addr->sun_path + 1, path.data() + 1, path.size() - 1);
+    } else {
+        memcpy(addr->sun_path, path.data(), path.size());
+    }
+    *len = static_cast<socklen_t>(offsetof(sockaddr_un, sun_path) + path.size());
+    return true;
+}
+
+// Unix 套接字没有 IP 地址，TcpConnection 只用它打印日志
+const InetAddress kUnixPlaceholderAddr("127.0.0.1", 0);
+
+} // namespace
+
+std::string unix_transport::localHostId() {
+    // 同一内核启动周期内唯一；容器间即使 boot_id 相同，抽象套接字不可达时也会回退到 TCP
+    std::ifstream in("/proc/sys/kernel/random/boot_id");
+    std::string id;
+    if (in && std::getline(in, id) && !id.empty()) return id;
+
+    char host[256] = {0};
+    if (::gethostname(host, sizeof(host) - 1) == 0) return host;
+    return std::string();
+}
+
+std::string unix_transport::defaultSocketPath(int port) {
+    return "@simple_ros/" + std::to_string(::getpid()) + "-" + std::to_string(port);
+}
+
+// ================= 服务端 =================
+
+UnixServer::UnixServer(EventLoop* loop, const std::string& path, const std::string& name)
+    : loop_(loop), path_(path), name_(name) {
+}
+
+UnixServer::~UnixServer() {
+    if (channel_) {
+        channel_->disableAll();
+        channel_->remove();
+    }
+    if (listenFd_ >= 0) {
+        ::close(listenFd_);
+        if (!path_.empty() && path_[0] != '@') ::unlink(path_.c_str());
+    }
+    for (auto& item : connections_) {
+        TcpConnectionPtr conn = item.second;
+        conn->getLoop()->runInLoop([conn]() { conn->connectDestroyed(); });
+    }
+}
+
+bool UnixServer::start() {
+    sockaddr_un addr;
+    socklen_t addr_len = 0;
+    if (!makeUnixAddr(path_, &addr, &addr_len)) {
+        LOG_WARN << "UnixServer: invalid socket path " << path_;
+        return false;
+    }
+
+    listenFd_ = ::socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (listenFd_ < 0) {
+        LOG_WARN << "UnixServer: socket() failed, errno=" << errno;
+        return false;
+    }
+    if (path_[0] != '@') ::unlink(path_.c_str());  // 清理上次异常退出遗留的文件
+
+    if (::bind(listenFd_, reinterpret_cast<sockaddr*>(&addr), addr_len) < 0 ||
+        ::listen(listenFd_, SOMAXCONN) < 0) {
+        LOG_WARN << "UnixServer: bind/listen " << path_ << " failed, errno=" << errno;
+        ::close(listenFd_);
+        listenFd_ = -1;
+        return false;
+    }
+
+    channel_.reset(new Channel(loop_, listenFd_));
+    channel_->setReadCallback(std::bind(&UnixServer::handleAccept, this, std::placeholders::_1));
+    channel_->enableReading();
+    LOG_INFO << "UnixServer [" << name_ << "] listening on " << path_;
+    return true;
+}
+
+void UnixServer::handleAccept(Timestamp) {
+    while (true) {
+        int connfd = ::accept4(listenFd_, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (connfd < 0) {
+            if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+                LOG_WARN << "UnixServer: accept failed, errno=" << errno;
+            }
+            break;
+        }
+
+        std::string conn_name = name_ + "-unix#" + std::to_string(nextConnId_++);
+        EventLoop* ioLoop = threadPool_ ? threadPool_->getNextLoop() : loop_;
+        auto conn = std::make_shared<TcpConnection>(ioLoop, conn_name, connfd,
+                                                    kUnixPlaceholderAddr, kUnixPlaceholderAddr);
+        connections_[conn_name] = conn;
+        conn->setConnectionCallback(connectionCallback_);
+        conn->setMessageCallback(messageCallback_);
+        conn->setCloseCallback(std::bind(&UnixServer::removeConnection, this, std::placeholders::_1));
+        ioLoop->runInLoop([conn]() { conn->connectEstablished(); });
+    }
+}
+
+void UnixServer::removeConnection(const TcpConnectionPtr& conn) {
+    // 关闭回调在连接所属的 IO 线程中执行，connections_ 只在 loop_ 中修改
+    loop_->runInLoop(std::bind(&UnixServer::removeConnectionInLoop, this, conn));
+}
+
+void UnixServer::removeConnectionInLoop(const TcpConnectionPtr& conn) {
+    connections_.erase(conn->name());
+    // 与 TcpServer 相同：在当前事件处理结束后再销毁连接
+    conn->getLoop()->queueInLoop([conn]() { conn->connectDestroyed(); });
+}
+
+// ================= 客户端 =================
+
+UnixClient::UnixClient(EventLoop* loop, const std::string& path, const std::string& name)
+    : loop_(loop), path_(path), name_(name) {
+}
+
+UnixClient::~UnixClient() {
+    TcpConnectionPtr conn;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        conn = connection_;
+        connection_.reset();
+    }
+    if (conn) {
+        EventLoop* loop = loop_;
+        loop_->runInLoop([conn, loop]() {
+            conn->setCloseCallback([loop](const TcpConnectionPtr& c) {
+                loop->queueInLoop([c]() { c->connectDestroyed(); });
+            });
+            conn->forceClose();
+        });
+    }
+}
+
+bool UnixClient::connect() {
+    sockaddr_un addr;
+    socklen_t addr_len = 0;
+    if (!makeUnixAddr(path_, &addr, &addr_len)) return false;
+
+    int fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) return false;
+
+    // 本机连接要么立即成功，要么立即失败（对端不存在、不可达或 backlog 已满）
+    if (::connect(fd, reinterpret_cast<sockaddr*>(&addr), addr_len) < 0) {
+        LOG_INFO << "UnixClient: connect " << path_ << " failed, errno=" << errno;
+        ::close(fd);
+        return false;
+    }
+
+    auto conn = std::make_shared<TcpConnection>(loop_, name_ + "-unix", fd,
+                                                kUnixPlaceholderAddr, kUnixPlaceholderAddr);
+    conn->setConnectionCallback(connectionCallback_);
+    conn->setMessageCallback(messageCallback_);
+    conn->setCloseCallback(std::bind(&UnixClient::removeConnection, this, std::placeholders::_1));
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        connection_ = conn;
+    }
+    loop_->runInLoop([conn]() { conn->connectEstablished(); });
+    return true;
+}
+
+TcpConnectionPtr UnixClient::connection() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return connection_;
+}
+
+void UnixClient::removeConnection(const TcpConnectionPtr& conn) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (connection_ == conn) connection_.reset();
+    }
+    loop_->queueInLoop([conn]() { conn->connectDestroyed(); });
+}
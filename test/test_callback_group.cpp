@@ -0,0 +1,136 @@
+#include "message_queue.h"
+#include "callback_group.h"
+#include <gtest/gtest.h>
+#include <google/protobuf/empty.pb.h>
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace simple_ros;
+
+namespace {
+
+// 用 n 个线程处理消息队列，直到 done 返回 true
+template<typename Done>
+void runSpinners(MessageQueue& queue, int n, Done done) {
+    std::vector<std::thread> threads;
+    for (int i = 0; i < n; ++i) {
+        threads.emplace_back([&]() {
+            auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+            while (!done() && std::chrono::steady_clock::now() < deadline) {
+                if (!queue.processCallbacks()) {
+                    queue.waitForWork(std::chrono::milliseconds(1));
+                }
+            }
+        });
+    }
+    for (auto& t : threads) t.join();
+}
+
+// 记录回调的最大并发数
+struct ConcurrencyProbe {
+    std::atomic<int> active{0};
+    std::atomic<int> max_active{0};
+    std::atomic<int> calls{0};
+
+    void run() {
+        int now = ++active;
+        int prev = max_active.load();
+        while (now > prev && !max_active.compare_exchange_weak(prev, now)) {}
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        --active;
+        ++calls;
+    }
+};
+
+} // namespace
+
+TEST(CallbackGroupTest, MutuallyExclusiveTryEnter) {
+    CallbackGroup group;
+    EXPECT_TRUE(group.tryEnter());
+    EXPECT_FALSE(group.tryEnter());
+    group.leave();
+    EXPECT_TRUE(group.tryEnter());
+}
+
+TEST(CallbackGroupTest, ReentrantAlwaysEnters) {
+    CallbackGroup group(CallbackGroupType::REENTRANT);
+    EXPECT_TRUE(group.tryEnter());
+    EXPECT_TRUE(group.tryEnter());
+}
+
+TEST(CallbackGroupTest, TaskAndSubscriptionInSameGroupDoNotOverlap) {
+    MessageQueue queue;
+    ConcurrencyProbe probe;
+    auto group = std::make_shared<CallbackGroup>();
+
+    queue.registerTopic("topic");
+    queue.addSubscriber("topic", [&](const std::shared_ptr<google::protobuf::Message>&) { probe.run(); }, group);
+    for (int i = 0; i < 20; ++i) {
+        queue.push("topic", std::make_shared<google::protobuf::Empty>());
+        queue.pushTask([&]() { probe.run(); }, group);
+    }
+
+    runSpinners(queue, 4, [&]() { return probe.calls.load() >= 40; });
+    EXPECT_EQ(probe.calls.load(), 40);
+    EXPECT_EQ(probe.max_active.load(), 1);
+}
+
+TEST(CallbackGroupTest, ReentrantGroupRunsInParallel) {
+    MessageQueue queue;
+    ConcurrencyProbe probe;
+    auto group = std::make_shared<CallbackGroup>(CallbackGroupType::REENTRANT);
+
+    for (int i = 0; i < 40; ++i) {
+        queue.pushTask([&]() { probe.run(); }, group);
+    }
+
+    runSpinners(queue, 4, [&]() { return probe.calls.load() >= 40; });
+    EXPECT_EQ(probe.calls.load(), 40);
+    EXPECT_GT(probe.max_active.load(), 1);
+}
+
+TEST(CallbackGroupTest, DifferentGroupsRunInParallel) {
+    MessageQueue queue;
+    ConcurrencyProbe probe;
+    auto group_a = std::make_shared<CallbackGroup>();
+    auto group_b = std::make_shared<CallbackGroup>();
+
+    for (int i = 0; i < 20; ++i) {
+        queue.pushTask([&]() { probe.run(); }, group_a);
+        queue.pushTask([&]() { probe.run(); }, group_b);
+    }
+
+    runSpinners(queue, 2, [&]() { return probe.calls.load() >= 40; });
+    EXPECT_EQ(probe.calls.load(), 40);
+    EXPECT_EQ(probe.max_active.load(), 2);
+}
+
+TEST(CallbackGroupTest, DefaultGroupSerializesTasks) {
+    MessageQueue queue;
+    std::vector<int> order;
+    for (int i = 0; i < 10; ++i) {
+        queue.pushTask([&order, i]() { order.push_back(i); });
+    }
+    while (queue.processCallbacks()) {}
+
+    ASSERT_EQ(order.size(), 10u);
+    for (int i = 0; i < 10; ++i) EXPECT_EQ(order[i], i);
+}
+
+TEST(CallbackGroupTest, ThrowingCallbackReleasesGroup) {
+    MessageQueue queue;
+    auto group = std::make_shared<CallbackGroup>();
+    queue.pushTask([]() { throw std::runtime_error("callback failed"); }, group);
+    EXPECT_THROW(queue.processCallbacks(), std::runtime_error);
+
+    // 异常之后组已释放，同组的后续任务照常执行
+    EXPECT_TRUE(group->tryEnter());
+    group->leave();
+    bool ran = false;
+    queue.pushTask([&]() { ran = true; }, group);
+    EXPECT_TRUE(queue.processCallbacks());
+    EXPECT_TRUE(ran);
+}
@@ -0,0 +1,181 @@
+#include "clock.h"
+#include "rate.h"
+#include "timer.h"
+#include <muduo/net/EventLoopThread.h>
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+using namespace simple_ros;
+
+class ClockTest : public ::testing::Test {
+protected:
+    void TearDown() override { Clock::instance().disableSimTime(); }
+};
+
+TEST_F(ClockTest, WallTimeByDefault) {
+    Clock& clock = Clock::instance();
+    EXPECT_FALSE(clock.isSimTime());
+    double before = std::chrono::duration<double>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    EXPECT_NEAR(clock.now(), before, 0.1);
+}
+
+TEST_F(ClockTest, SimTimeOnlyMovesForward) {
+    Clock& clock = Clock::instance();
+    clock.enableSimTime(10.0);
+    EXPECT_DOUBLE_EQ(clock.now(), 10.0);
+
+    clock.setSimTime(12.5);
+    EXPECT_DOUBLE_EQ(clock.now(), 12.5);
+    clock.setSimTime(11.0);  // 回退被忽略
+    EXPECT_DOUBLE_EQ(clock.now(), 12.5);
+    clock.advance(0.5);
+    EXPECT_DOUBLE_EQ(clock.now(), 13.0);
+}
+
+TEST_F(ClockTest, MsgRoundTrip) {
+    std_msgs::Time msg;
+    Clock::toMsg(1234.000000250, &msg);
+    EXPECT_EQ(msg.sec(), 1234);
+    EXPECT_NEAR(msg.nanosec(), 250u, 1u);
+    EXPECT_NEAR(Clock::fromMsg(msg), 1234.00000025, 1e-9);
+}
+
+TEST_F(ClockTest, SleepUntilFollowsSimTime) {
+    Clock& clock = Clock::instance();
+    clock.enableSimTime(0.0);
+
+    std::atomic<bool> woke{false};
+    std::thread sleeper([&]() {
+        EXPECT_TRUE(clock.sleepUntil(1.0));
+        woke = true;
+    });
+
+    clock.setSimTime(0.5);
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT_FALSE(woke.load());
+
+    clock.setSimTime(1.0);
+    sleeper.join();
+    EXPECT_TRUE(woke.load());
+}
+
+TEST_F(ClockTest, InterruptWakesSleepers) {
+    Clock& clock = Clock::instance();
+    clock.enableSimTime(0.0);
+    std::thread sleeper([&]() { EXPECT_FALSE(clock.sleepUntil(100.0)); });
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    clock.interrupt();
+    sleeper.join();
+}
+
+TEST_F(ClockTest, ListenersSeeEveryUpdate) {
+    Clock& clock = Clock::instance();
+    clock.enableSimTime(0.0);
+    std::vector<double> seen;
+    uint64_t id = clock.addTimeListener([&](double t) { seen.push_back(t); });
+    clock.setSimTime(1.0);
+    clock.setSimTime(2.0);
+    clock.removeTimeListener(id);
+    clock.setSimTime(3.0);
+    EXPECT_EQ(seen, (std::vector<double>{1.0, 2.0}));
+}
+
+TEST_F(ClockTest, RateRunsFasterThanRealTime) {
+    Clock& clock = Clock::instance();
+    clock.enableSimTime(0.0);
+
+    // 驱动线程以远快于真实时间的速度推进仿真时间
+    std::atomic<bool> running{true};
+    std::thread driver([&]() {
+        while (running) {
+            clock.advance(0.001);
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+        }
+    });
+
+    auto wall_start = std::chrono::steady_clock::now();
+    Rate rate(10.0);  // 10Hz，10 次循环对应 1s 仿真时间
+    for (int i = 0; i < 10; ++i) {
+        rate.sleep();
+    }
+    double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - wall_start).count();
+    running = false;
+    driver.join();
+
+    EXPECT_GE(clock.now(), 1.0);
+    EXPECT_LT(wall, 0.5);
+}
+
+TEST_F(ClockTest, TimerFollowsSimTime) {
+    muduo::net::EventLoopThread loopThread;
+    muduo::net::EventLoop* loop = loopThread.startLoop();
+
+    Clock& clock = Clock::instance();
+    clock.enableSimTime(0.0);
+
+    std::atomic<int> calls{0};
+    std::vector<double> expected;
+    std::mutex mutex;
+    {
+        Timer timer(loop, 0.1, [&](const TimerEvent& e) {
+            std::lock_guard<std::mutex> lock(mutex);
+            expected.push_back(e.expected_real);
+            ++calls;
+        });
+        timer.setOverrunPolicy(OverrunPolicy::CATCH_UP);
+        timer.start();
+
+        // 仿真时间不动时定时器不触发
+        std::this_thread::sleep_for(std::chrono::milliseconds(150));
+        EXPECT_EQ(calls.load(), 0);
+
+        // 一步推进 0.5s，CATCH_UP 补齐全部 5 个周期
+        clock.setSimTime(0.5);
+        for (int i = 0; i < 100 && calls.load() < 5; ++i) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+        timer.stop();
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    ASSERT_EQ(expected.size(), 5u);
+    for (size_t i = 0; i < expected.size(); ++i) {
+        EXPECT_NEAR(expected[i], 0.1 * (i + 1), 1e-6);
+    }
+}
+
+TEST_F(ClockTest, CatchUpCountsEachMissedPeriodOnce) {
+    muduo::net::EventLoopThread loopThread;
+    muduo::net::EventLoop* loop = loopThread.startLoop();
+
+    Clock& clock = Clock::instance();
+    clock.enableSimTime(0.0);
+
+    std::atomic<int> calls{0};
+    std::atomic<uint32_t> overruns{0};
+    uint64_t total = 0;
+    {
+        Timer timer(loop, 0.1, [&](const TimerEvent& e) {
+            overruns += e.overruns;
+            ++calls;
+        });
+        timer.setOverrunPolicy(OverrunPolicy::CATCH_UP);
+        timer.start();
+
+        // 一步推进 0.5s：首次触发时发现错过 0.2~0.5 共 4 个周期，之后的补齐触发不再重复计数
+        clock.setSimTime(0.5);
+        for (int i = 0; i < 100 && calls.load() < 5; ++i) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+        timer.stop();
+        total = timer.getOverrunCount();
+    }
+
+    EXPECT_EQ(calls.load(), 5);
+    EXPECT_EQ(overruns.load(), 4u);
+    EXPECT_EQ(total, 4u);
+}
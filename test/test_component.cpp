@@ -0,0 +1,154 @@
+#include "component_container.h"
+#include "node_handle.h"
+#include "message_queue.h"
+#include <gtest/gtest.h>
+#include <google/protobuf/empty.pb.h>
+#include <cstdio>
+#include <fstream>
+
+using namespace simple_ros;
+
+namespace {
+
+int g_alive = 0;
+
+class CountingComponent : public Component {
+public:
+    CountingComponent() { ++g_alive; }
+    ~CountingComponent() override { --g_alive; }
+
+    void onInit(NodeHandle& nh, const nlohmann::json& params) override {
+        node_name = nh.getNodeName();
+        rate = params.value("rate", 0);
+    }
+
+    std::string node_name;
+    int rate = 0;
+};
+
+class FailingComponent : public Component {
+public:
+    void onInit(NodeHandle&, const nlohmann::json&) override {
+        throw std::runtime_error("missing parameter");
+    }
+};
+
+} // namespace
+
+SIMPLE_ROS_REGISTER_COMPONENT(CountingComponent)
+SIMPLE_ROS_REGISTER_COMPONENT_AS(FailingComponent, "test/Failing")
+
+TEST(ComponentTest, RegistryKnowsRegisteredTypes) {
+    auto& registry = ComponentRegistry::instance();
+    EXPECT_TRUE(registry.contains("CountingComponent"));
+    EXPECT_TRUE(registry.contains("test/Failing"));
+    EXPECT_FALSE(registry.contains("NoSuchComponent"));
+    EXPECT_EQ(registry.create("NoSuchComponent"), nullptr);
+    // 同名类型不能重复注册
+    EXPECT_FALSE(registry.add("CountingComponent", []() { return std::unique_ptr<Component>(); }));
+}
+
+TEST(ComponentTest, LoadPassesNodeNameAndParams) {
+    ComponentContainer container;
+    ASSERT_TRUE(container.load("CountingComponent", "counter_a", {{"rate", 50}}));
+    ASSERT_TRUE(container.load("CountingComponent", "counter_b"));
+    EXPECT_EQ(g_alive, 2);
+
+    auto* a = dynamic_cast<CountingComponent*>(container.get("counter_a"));
+    auto* b = dynamic_cast<CountingComponent*>(container.get("counter_b"));
+    ASSERT_NE(a, nullptr);
+    ASSERT_NE(b, nullptr);
+    EXPECT_EQ(a->node_name, "counter_a");
+    EXPECT_EQ(a->rate, 50);
+    EXPECT_EQ(b->node_name, "counter_b");
+    EXPECT_EQ(b->rate, 0);
+
+    // 名字重复、类型未注册、onInit 抛出异常都不会加载
+    EXPECT_FALSE(container.load("CountingComponent", "counter_a"));
+    EXPECT_FALSE(container.load("NoSuchComponent", "x"));
+    EXPECT_FALSE(container.load("test/Failing", "failing"));
+    EXPECT_EQ(container.size(), 2u);
+
+    EXPECT_TRUE(container.unload("counter_a"));
+    EXPECT_FALSE(container.unload("counter_a"));
+    EXPECT_EQ(g_alive, 1);
+    EXPECT_EQ(container.names(), std::vector<std::string>{"counter_b"});
+}
+
+TEST(ComponentTest, DestructorUnloadsAll) {
+    {
+        ComponentContainer container;
+        container.load("CountingComponent", "c1");
+        container.load("CountingComponent", "c2");
+        EXPECT_EQ(g_alive, 2);
+    }
+    EXPECT_EQ(g_alive, 0);
+}
+
+TEST(ComponentTest, LoadConfigFile) {
+    const char* path = "/tmp/simple_ros_test_components.json";
+    {
+        std::ofstream out(path);
+        out << R"({
+            "components": [
+                {"type": "CountingComponent", "name": "sim", "params": {"rate": 200}},
+                {"type": "CountingComponent"},
+                {"type": "NoSuchComponent", "name": "bad"},
+                {"name": "no_type"}
+            ]
+        })";
+    }
+    ComponentContainer container;
+    EXPECT_EQ(container.loadConfigFile(path), 2u);
+    EXPECT_EQ(container.names(), (std::vector<std::string>{"sim", "CountingComponent"}));
+    EXPECT_EQ(dynamic_cast<CountingComponent*>(container.get("sim"))->rate, 200);
+    std::remove(path);
+
+    EXPECT_EQ(container.loadConfigFile("/nonexistent/components.json"), 0u);
+}
+
+TEST(ComponentTest, SubscribersOfSameTopicAreRemovedIndividually) {
+    MessageQueue queue;
+    int a_calls = 0;
+    int b_calls = 0;
+    queue.registerTopic("shared");
+    uint64_t a = queue.addSubscriber("shared", [&](const std::shared_ptr<google::protobuf::Message>&) { ++a_calls; },
+                                     std::make_shared<CallbackGroup>());
+    queue.addSubscriber("shared", [&](const std::shared_ptr<google::protobuf::Message>&) { ++b_calls; },
+                        std::make_shared<CallbackGroup>());
+
+    queue.push("shared", std::make_shared<google::protobuf::Empty>());
+    EXPECT_TRUE(queue.processCallbacks());
+    EXPECT_EQ(a_calls, 1);
+    EXPECT_EQ(b_calls, 1);
+
+    // 一个组件卸载不影响同进程另一个组件的订阅
+    queue.removeSubscriber("shared", a);
+    EXPECT_TRUE(queue.hasSubscribers("shared"));
+    queue.push("shared", std::make_shared<google::protobuf::Empty>());
+    EXPECT_TRUE(queue.processCallbacks());
+    EXPECT_EQ(a_calls, 1);
+    EXPECT_EQ(b_calls, 2);
+}
+
+TEST(ComponentTest, MessageWaitsForAllSubscriberGroups) {
+    MessageQueue queue;
+    auto group_a = std::make_shared<CallbackGroup>();
+    auto group_b = std::make_shared<CallbackGroup>();
+    int calls = 0;
+    queue.registerTopic("shared");
+    queue.addSubscriber("shared", [&](const std::shared_ptr<google::protobuf::Message>&) { ++calls; }, group_a);
+    queue.addSubscriber("shared", [&](const std::shared_ptr<google::protobuf::Message>&) { ++calls; }, group_b);
+    queue.push("shared", std::make_shared<google::protobuf::Empty>());
+
+    // group_b 正在执行其他回调时，消息不能分发（否则会与 group_b 的回调并发）
+    ASSERT_TRUE(group_b->tryEnter());
+    EXPECT_FALSE(queue.processCallbacks());
+    // 回退后 group_a 没有被占住
+    EXPECT_TRUE(group_a->tryEnter());
+    group_a->leave();
+
+    group_b->leave();
+    EXPECT_TRUE(queue.processCallbacks());
+    EXPECT_EQ(calls, 2);
+}
@@ -19,8 +19,11 @@ TEST(SystemManagerTest, InitAndSendMessage) {
     sys.init();
     LOG_INFO << "System initialized successfully";
 
-    // 等待系统完全启动
-    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    // init 返回时监听已就绪，无需等待
+    ASSERT_NE(sys.getPollManager(), nullptr);
+    ASSERT_NE(sys.getEventLoop(), nullptr);
+    EXPECT_EQ(sys.getNodeInfo().port(), 12345);
+    EXPECT_GT(sys.getStartupTimings().total_ms, 0.0);
 
     // 注册消息类型
     MsgFactory::instance().registerMessage<example::SensorData>();
@@ -0,0 +1,185 @@
+#include "json_encoder.h"
+#include "marker.pb.h"
+#include <google/protobuf/descriptor.pb.h>
+#include <google/protobuf/dynamic_message.h>
+#include <google/protobuf/util/json_util.h>
+#include <gtest/gtest.h>
+#include <nlohmann/json.hpp>
+#include <cmath>
+#include <limits>
+
+using google::protobuf::FieldDescriptorProto;
+using json = nlohmann::json;
+using namespace simple_ros;
+
+namespace {
+
+// 与 MessageToJsonString 的输出按 JSON 语义比较（字段顺序与转义写法可以不同）
+void expectSameAsUtil(const google::protobuf::Message& msg, bool always_print, bool proto_names) {
+    JsonEncoder::Options options;
+    options.always_print_primitive_fields = always_print;
+    options.preserve_proto_field_names = proto_names;
+    JsonEncoder encoder(options);
+
+    google::protobuf::util::JsonPrintOptions util_options;
+    util_options.always_print_primitive_fields = always_print;
+    util_options.preserve_proto_field_names = proto_names;
+    std::string expected;
+    ASSERT_TRUE(google::protobuf::util::MessageToJsonString(msg, &expected, util_options).ok());
+
+    std::string actual = encoder.encode(msg);
+    EXPECT_EQ(json::parse(actual), json::parse(expected)) << actual << "\nvs\n" << expected;
+}
+
+visualization_msgs::MarkerArray makeMarkerArray() {
+    visualization_msgs::MarkerArray array;
+    for (int i = 0; i < 3; ++i) {
+        auto* marker = array.add_markers();
+        marker->mutable_header()->set_frame_id("map \"quoted\"\n");
+        marker->mutable_header()->mutable_stamp()->set_sec(1700000000 + i);
+        marker->set_ns("ns");
+        marker->set_id(i);
+        marker->set_type(visualization_msgs::LINE_STRIP);
+        marker->mutable_pose()->mutable_orientation()->set_w(1.0);
+        marker->mutable_scale()->set_x(0.1);
+        marker->mutable_color()->set_r(0.25f);
+        marker->mutable_color()->set_a(1.0f);
+        for (int p = 0; p < 4; ++p) {
+            auto* pt = marker->add_points();
+            pt->set_x(p * 0.1);
+            pt->set_y(-1e-7 * p);
+            pt->set_z(1e20);
+        }
+    }
+    return array;
+}
+
+// 覆盖 map、bytes、oneof、proto3 optional、repeated 标量与递归类型的动态消息
+const google::protobuf::Descriptor* buildTestDescriptor(google::protobuf::DescriptorPool* pool) {
+    google::protobuf::FileDescriptorProto file;
+    file.set_name("json_encoder_test.proto");
+    file.set_package("json_test");
+    file.set_syntax("proto3");
+
+    auto* color = file.add_enum_type();
+    color->set_name("Color");
+    color->add_value()->set_name("RED");
+    color->mutable_value(0)->set_number(0);
+    color->add_value()->set_name("GREEN");
+    color->mutable_value(1)->set_number(1);
+
+    auto* entry = file.add_message_type();
+    entry->set_name("Node");
+    auto addField = [](google::protobuf::DescriptorProto* msg, const std::string& name, int number,
+                       FieldDescriptorProto::Type type, FieldDescriptorProto::Label label) {
+        auto* f = msg->add_field();
+        f->set_name(name);
+        f->set_number(number);
+        f->set_type(type);
+        f->set_label(label);
+        return f;
+    };
+    const auto OPT = FieldDescriptorProto::LABEL_OPTIONAL;
+    const auto REP = FieldDescriptorProto::LABEL_REPEATED;
+    addField(entry, "big_id", 1, FieldDescriptorProto::TYPE_INT64, OPT);
+    addField(entry, "payload", 2, FieldDescriptorProto::TYPE_BYTES, OPT);
+    addField(entry, "color", 3, FieldDescriptorProto::TYPE_ENUM, OPT)->set_type_name(".json_test.Color");
+    addField(entry, "samples", 4, FieldDescriptorProto::TYPE_DOUBLE, REP);
+    addField(entry, "child", 5, FieldDescriptorProto::TYPE_MESSAGE, OPT)->set_type_name(".json_test.Node");
+    addField(entry, "ratio", 6, FieldDescriptorProto::TYPE_FLOAT, OPT);
+    addField(entry, "flag", 7, FieldDescriptorProto::TYPE_BOOL, OPT);
+
+    // map<string, int32> counts = 8;
+    auto* map_entry = entry->add_nested_type();
+    map_entry->set_name("CountsEntry");
+    map_entry->mutable_options()->set_map_entry(true);
+    addField(map_entry, "key", 1, FieldDescriptorProto::TYPE_STRING, OPT);
+    addField(map_entry, "value", 2, FieldDescriptorProto::TYPE_INT32, OPT);
+    addField(entry, "counts", 8, FieldDescriptorProto::TYPE_MESSAGE, REP)->set_type_name(".json_test.Node.CountsEntry");
+
+    // oneof value { string text = 9; uint64 code = 10; }
+    entry->add_oneof_decl()->set_name("value");
+    addField(entry, "text", 9, FieldDescriptorProto::TYPE_STRING, OPT)->set_oneof_index(0);
+    addField(entry, "code", 10, FieldDescriptorProto::TYPE_UINT64, OPT)->set_oneof_index(0);
+
+    // optional int32 level = 11;（proto3 optional 以合成 oneof 表示）
+    entry->add_oneof_decl()->set_name("_level");
+    auto* level = addField(entry, "level_value", 11, FieldDescriptorProto::TYPE_INT32, OPT);
+    level->set_oneof_index(1);
+    level->set_proto3_optional(true);
+
+    const auto* fd = pool->BuildFile(file);
+    return fd ? fd->FindMessageTypeByName("Node") : nullptr;
+}
+
+} // namespace
+
+TEST(JsonEncoderTest, MatchesUtilOnGeneratedMessages) {
+    geometry_msgs::Odometry odom;
+    odom.mutable_pose()->mutable_position()->set_x(1.5);
+    odom.mutable_pose()->mutable_orientation()->set_w(1.0);
+    odom.mutable_linear_velocity()->set_x(0.3);
+    odom.mutable_header()->mutable_stamp()->set_sec(-5);
+    odom.mutable_header()->mutable_stamp()->set_nanosec(42);
+
+    for (bool always_print : {false, true}) {
+        for (bool proto_names : {false, true}) {
+            expectSameAsUtil(odom, always_print, proto_names);
+            expectSameAsUtil(makeMarkerArray(), always_print, proto_names);
+            expectSameAsUtil(visualization_msgs::Marker(), always_print, proto_names);
+        }
+    }
+}
+
+TEST(JsonEncoderTest, MatchesUtilOnDynamicMessages) {
+    google::protobuf::DescriptorPool pool;
+    const auto* descriptor = buildTestDescriptor(&pool);
+    ASSERT_NE(descriptor, nullptr);
+    google::protobuf::DynamicMessageFactory factory(&pool);
+    std::unique_ptr<google::protobuf::Message> msg(factory.GetPrototype(descriptor)->New());
+    const auto* r = msg->GetReflection();
+
+    r->SetInt64(msg.get(), descriptor->FindFieldByName("big_id"), std::numeric_limits<int64_t>::min());
+    r->SetString(msg.get(), descriptor->FindFieldByName("payload"), std::string("\x00\xff\x10 ab", 6));
+    r->SetEnumValue(msg.get(), descriptor->FindFieldByName("color"), 1);
+    const auto* samples = descriptor->FindFieldByName("samples");
+    r->AddDouble(msg.get(), samples, 0.1);
+    r->AddDouble(msg.get(), samples, std::nan(""));
+    r->AddDouble(msg.get(), samples, -std::numeric_limits<double>::infinity());
+    r->SetFloat(msg.get(), descriptor->FindFieldByName("ratio"), 0.1f);
+    r->SetUInt64(msg.get(), descriptor->FindFieldByName("code"), 18446744073709551615ull);
+    r->SetInt32(msg.get(), descriptor->FindFieldByName("level_value"), 0);
+
+    auto* child = r->MutableMessage(msg.get(), descriptor->FindFieldByName("child"));
+    child->GetReflection()->SetString(child, descriptor->FindFieldByName("text"), "\x01tab\t");
+
+    const auto* counts = descriptor->FindFieldByName("counts");
+    auto* e = r->AddMessage(msg.get(), counts);
+    e->GetReflection()->SetString(e, counts->message_type()->FindFieldByName("key"), "a");
+    e->GetReflection()->SetInt32(e, counts->message_type()->FindFieldByName("value"), 3);
+
+    for (bool always_print : {false, true}) {
+        expectSameAsUtil(*msg, always_print, false);
+        expectSameAsUtil(*child, always_print, true);
+    }
+}
+
+TEST(JsonEncoderTest, SkipsFieldsAndReusesPlans) {
+    JsonEncoder::Options options;
+    options.skip_fields.insert("visualization_msgs.Marker.points");
+    JsonEncoder encoder(options);
+
+    auto array = makeMarkerArray();
+    std::string out;
+    encoder.encode(array, &out);
+    json parsed = json::parse(out);
+    ASSERT_EQ(parsed["markers"].size(), 3u);
+    EXPECT_FALSE(parsed["markers"][0].contains("points"));
+    EXPECT_EQ(parsed["markers"][0]["ns"], "ns");
+
+    // 计划按类型只生成一次，再次编码追加到同一缓冲区
+    size_t plans = encoder.planCount();
+    encoder.encode(array, &out);
+    EXPECT_EQ(encoder.planCount(), plans);
+    EXPECT_EQ(out.size(), 2 * out.find("]}") + 4);
+}
@@ -0,0 +1,198 @@
+#include "keyed_executor.h"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace simple_ros;
+
+namespace {
+
+void waitFor(const std::function<bool()>& done) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (!done() && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+
+} // namespace
+
+TEST(KeyedExecutorTest, PreservesOrderPerKey) {
+    KeyedExecutor executor(4, 0);
+    std::mutex mutex;
+    std::map<std::string, std::vector<int>> seen;
+    const std::vector<std::string> keys = {"/a", "/b", "/c", "/d", "/e"};
+    const int per_key = 500;
+
+    for (int i = 0; i < per_key; ++i) {
+        for (const auto& key : keys) {
+            executor.submit(key, [&, key, i]() {
+                std::lock_guard<std::mutex> lock(mutex);
+                seen[key].push_back(i);
+            });
+        }
+    }
+    waitFor([&]() { return executor.executedCount() == keys.size() * per_key; });
+    ASSERT_EQ(executor.executedCount(), keys.size() * per_key);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    for (const auto& key : keys) {
+        const auto& order = seen[key];
+        ASSERT_EQ(order.size(), static_cast<size_t>(per_key));
+        for (int i = 0; i < per_key; ++i) EXPECT_EQ(order[i], i);
+    }
+}
+
+TEST(KeyedExecutorTest, RunsKeysInParallel) {
+    KeyedExecutor executor(4, 0);
+    std::mutex mutex;
+    std::set<std::thread::id> threads;
+    for (int i = 0; i < 64; ++i) {
+        executor.submit("/topic" + std::to_string(i), [&]() {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            std::lock_guard<std::mutex> lock(mutex);
+            threads.insert(std::this_thread::get_id());
+        });
+    }
+    waitFor([&]() { return executor.executedCount() == 64; });
+    std::lock_guard<std::mutex> lock(mutex);
+    EXPECT_GT(threads.size(), 1u);
+    EXPECT_GT(executor.busySeconds(), 0.0);
+}
+
+TEST(KeyedExecutorTest, DropsOldestWhenQueueFull) {
+    KeyedExecutor executor(1, 2);
+    std::atomic<bool> release(false);
+    std::atomic<int> started(0);
+    std::vector<int> ran;
+    std::mutex mutex;
+
+    executor.submit("/k", [&]() {
+        started = 1;
+        while (!release) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    });
+    waitFor([&]() { return started == 1; });
+
+    for (int i = 0; i < 4; ++i) {
+        executor.submit("/k", [&, i]() {
+            std::lock_guard<std::mutex> lock(mutex);
+            ran.push_back(i);
+        });
+    }
+    EXPECT_EQ(executor.droppedCount(), 2u);
+    release = true;
+    waitFor([&]() { return executor.executedCount() == 3; });
+
+    std::lock_guard<std::mutex> lock(mutex);
+    EXPECT_EQ(ran, (std::vector<int>{2, 3}));
+}
+
+TEST(KeyedExecutorTest, NotifiesDroppedTask) {
+    KeyedExecutor executor(1, 1);
+    std::atomic<bool> release(false);
+    std::atomic<int> started(0);
+
+    executor.submit("/k", [&]() {
+        started = 1;
+        while (!release) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    });
+    waitFor([&]() { return started == 1; });
+
+    // 每个 key 只容纳一个任务：每次提交都丢弃该 key 的前一个，丢弃通知带着被丢弃任务自己的名字
+    std::vector<std::string> dropped;
+    for (const char* name : {"a1", "a2", "a3"}) {
+        std::string n = name;
+        executor.submit("/a", []() {}, [&dropped, n]() { dropped.push_back(n); });
+    }
+    EXPECT_EQ(dropped, (std::vector<std::string>{"a1", "a2"}));
+    release = true;
+    waitFor([&]() { return executor.executedCount() == 2; });
+    EXPECT_EQ(dropped.size(), 2u);
+}
+
+TEST(KeyedExecutorTest, BoundsQueuePerKey) {
+    KeyedExecutor executor(1, 2);
+    std::atomic<bool> release(false);
+    std::atomic<int> started(0);
+    std::vector<std::string> ran;
+    std::mutex mutex;
+    auto record = [&](const std::string& name) {
+        return [&, name]() {
+            std::lock_guard<std::mutex> lock(mutex);
+            ran.push_back(name);
+        };
+    };
+
+    executor.submit("/k", [&]() {
+        started = 1;
+        while (!release) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    });
+    waitFor([&]() { return started == 1; });
+
+    // 同一线程上的高频 key 只挤掉自己最早的任务，低频 key 的任务保留
+    EXPECT_TRUE(executor.submit("/slow", record("slow")));
+    for (int i = 0; i < 5; ++i) {
+        executor.submit("/fast", record("fast" + std::to_string(i)));
+    }
+    EXPECT_EQ(executor.droppedCount(), 3u);
+    EXPECT_EQ(executor.pending(), 3u);
+
+    release = true;
+    waitFor([&]() { return executor.executedCount() == 4; });
+    std::lock_guard<std::mutex> lock(mutex);
+    EXPECT_EQ(ran, (std::vector<std::string>{"slow", "fast3", "fast4"}));
+}
+
+TEST(KeyedExecutorTest, CountsFailedTasks) {
+    KeyedExecutor executor(1, 0);
+    std::atomic<int> after(0);
+    executor.submit("/k", []() { throw std::runtime_error("bad message"); });
+    executor.submit("/k", [&]() { after = 1; });
+
+    // 抛出异常的任务计入 failedCount，工作线程继续执行后面的任务
+    waitFor([&]() { return executor.executedCount() == 2; });
+    EXPECT_EQ(executor.failedCount(), 1u);
+    EXPECT_EQ(after.load(), 1);
+    EXPECT_EQ(executor.pending(), 0u);
+}
+
+TEST(KeyedExecutorTest, KeepsPinnedTasksWhenQueueFull) {
+    KeyedExecutor executor(1, 2);
+    std::atomic<bool> release(false);
+    std::atomic<int> started(0);
+    std::vector<std::string> ran;
+    std::mutex mutex;
+    auto record = [&](const std::string& name) {
+        return [&, name]() {
+            std::lock_guard<std::mutex> lock(mutex);
+            ran.push_back(name);
+        };
+    };
+
+    executor.submit("/k", [&]() {
+        started = 1;
+        while (!release) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    });
+    waitFor([&]() { return started == 1; });
+
+    // 队列已满时跳过不可丢弃的任务，丢弃其后最早的普通任务
+    EXPECT_TRUE(executor.submitPinned("/k", record("pinned1")));
+    EXPECT_TRUE(executor.submit("/k", record("a")));
+    EXPECT_FALSE(executor.submit("/k", record("b")));
+    EXPECT_FALSE(executor.submitPinned("/k", record("pinned2")));
+    // 队列中全是不可丢弃的任务时超出上限排队
+    EXPECT_TRUE(executor.submitPinned("/k", record("pinned3")));
+    EXPECT_EQ(executor.pending(), 3u);
+    EXPECT_EQ(executor.droppedCount(), 2u);
+
+    release = true;
+    waitFor([&]() { return executor.executedCount() == 4; });
+    std::lock_guard<std::mutex> lock(mutex);
+    EXPECT_EQ(ran, (std::vector<std::string>{"pinned1", "pinned2", "pinned3"}));
+}
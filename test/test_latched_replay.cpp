@@ -0,0 +1,190 @@
+#include "global_init.h"
+#include "node_handle.h"
+#include "wire_format.h"
+#include "example.pb.h"
+#include <gtest/gtest.h>
+#include <muduo/net/EventLoop.h>
+#include <muduo/net/EventLoopThread.h>
+#include <muduo/net/TcpServer.h>
+#include <muduo/net/TcpClient.h>
+#include <muduo/net/InetAddress.h>
+#include <muduo/base/Logging.h>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+
+const uint16_t kSubscriberPort = 12361;
+
+// 假订阅者：只监听端口并记录收到的消息帧
+class FrameRecorder {
+public:
+    explicit FrameRecorder(muduo::net::EventLoop* loop)
+        : server_(loop, muduo::net::InetAddress("127.0.0.1", kSubscriberPort), "FrameRecorder") {
+        server_.setMessageCallback([this](const muduo::net::TcpConnectionPtr&, muduo::net::Buffer* buf,
+                                          muduo::Timestamp) {
+            std::string topic, msg_name, data;
+            while (size_t n = wire::decodeFrame(buf->peek(), buf->readableBytes(), &topic, &msg_name, &data)) {
+                buf->retrieve(n);
+                std::lock_guard<std::mutex> lock(mutex_);
+                frames_.push_back({topic, data});
+            }
+        });
+        server_.start();
+    }
+
+    std::vector<std::pair<std::string, std::string>> frames() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return frames_;
+    }
+
+private:
+    muduo::net::TcpServer server_;
+    std::mutex mutex_;
+    std::vector<std::pair<std::string, std::string>> frames_;
+};
+
+// 模拟 Master 推送：向节点的监听端口发送一条 TopicTargetsUpdate
+void pushTargetsUpdate(uint16_t node_port, const TopicTargetsUpdate& update) {
+    std::string data;
+    ASSERT_TRUE(update.SerializeToString(&data));
+    std::string frame = wire::encodeFrame(update.topic(), "TopicTargetsUpdate", data);
+
+    muduo::net::EventLoop loop;
+    muduo::net::TcpClient client(&loop, muduo::net::InetAddress("127.0.0.1", node_port), "TargetsPusher");
+    client.setConnectionCallback([&frame](const muduo::net::TcpConnectionPtr& conn) {
+        if (conn->connected()) conn->send(frame);
+    });
+    client.setWriteCompleteCallback([&loop](const muduo::net::TcpConnectionPtr&) { loop.quit(); });
+    client.connect();
+    loop.loop();
+}
+
+// 同一进程中的两个用例共用一次初始化
+uint16_t initNode() {
+    static const uint16_t port = [] {
+        auto& sys = SystemManager::instance();
+        sys.init("latched_replay_node");
+        return static_cast<uint16_t>(sys.getNodeInfo().port());
+    }();
+    return port;
+}
+
+// spin 直到 done 成立，最多等待 2 秒
+void spinUntil(const std::function<bool()>& done) {
+    for (int i = 0; i < 2000 && !done(); ++i) {
+        SystemManager::instance().spinOnce();
+    }
+}
+
+} // namespace
+
+// 锁存话题：订阅者在发布之后才加入，也能收到最近一条消息
+TEST(LatchedReplayTest, LateSubscriberReceivesLatchedMessage) {
+    uint16_t node_port = initNode();
+
+    muduo::net::EventLoopThread recorder_thread;
+    muduo::net::EventLoop* recorder_loop = recorder_thread.startLoop();
+    auto recorder = std::make_unique<FrameRecorder>(recorder_loop);
+
+    NodeHandle nh;
+    auto pub = nh.advertise<example::SensorData>("latched_topic", true);
+    example::SensorData sensor;
+    sensor.set_sensor_id(7);
+    sensor.set_value(1.5f);
+    pub->publish(sensor);
+
+    // 发布之后订阅者才出现
+    TopicTargetsUpdate update;
+    update.set_topic("latched_topic");
+    NodeInfo target;
+    target.set_node_name("late_subscriber");
+    target.set_ip("127.0.0.1");
+    target.set_port(kSubscriberPort);
+    *update.add_add_targets() = target;
+    pushTargetsUpdate(node_port, update);
+
+    std::vector<std::pair<std::string, std::string>> frames;
+    for (int i = 0; i < 200 && frames.empty(); ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        frames = recorder->frames();
+    }
+
+    // 发布者析构后监听已移除，之后的目标更新不会再回调到已释放的发布者
+    pub.reset();
+    update.clear_add_targets();
+    *update.add_remove_targets() = target;
+    pushTargetsUpdate(node_port, update);
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+    // TcpServer 须在自己的 EventLoop 线程中析构
+    std::promise<void> destroyed;
+    recorder_loop->runInLoop([&]() {
+        recorder.reset();
+        destroyed.set_value();
+    });
+    destroyed.get_future().wait();
+
+    ASSERT_EQ(frames.size(), 1u);
+    EXPECT_EQ(frames[0].first, "latched_topic");
+    example::SensorData received;
+    ASSERT_TRUE(received.ParseFromString(frames[0].second));
+    EXPECT_EQ(received.sensor_id(), 7);
+    EXPECT_FLOAT_EQ(received.value(), 1.5f);
+}
+
+// 本进程的订阅者先后加入：每个新订阅者各自收到一次锁存消息，先加入的不会重复收到
+TEST(LatchedReplayTest, EachLateLocalSubscriberReceivesLatchedMessageOnce) {
+    uint16_t node_port = initNode();
+
+    NodeHandle nh;
+    auto pub = nh.advertise<example::SensorData>("latched_local_topic", true);
+    example::SensorData sensor;
+    sensor.set_sensor_id(9);
+    pub->publish(sensor);
+
+    std::atomic<int> first_count{0};
+    std::atomic<int> second_count{0};
+    auto counter = [](std::atomic<int>* count) {
+        return std::function<void(const std::shared_ptr<example::SensorData>&)>(
+            [count](const std::shared_ptr<example::SensorData>& msg) {
+                if (msg->sensor_id() == 9) ++*count;
+            });
+    };
+
+    // 第一个本进程订阅者加入：目标是本节点自己的监听端点
+    auto first = nh.subscribe<example::SensorData>("latched_local_topic", 10, counter(&first_count));
+    TopicTargetsUpdate update;
+    update.set_topic("latched_local_topic");
+    NodeInfo local_a;
+    local_a.set_node_name("local_a");
+    local_a.set_ip("127.0.0.1");
+    local_a.set_port(node_port);
+    *update.add_add_targets() = local_a;
+    pushTargetsUpdate(node_port, update);
+    spinUntil([&]() { return first_count.load() == 1; });
+    EXPECT_EQ(first_count.load(), 1);
+
+    // 同一进程中的第二个节点（如容器中后加载的组件）随后订阅
+    auto second = nh.subscribe<example::SensorData>("latched_local_topic", 10, counter(&second_count));
+    NodeInfo local_b = local_a;
+    local_b.set_node_name("local_b");
+    update.clear_add_targets();
+    *update.add_add_targets() = local_b;
+    pushTargetsUpdate(node_port, update);
+    spinUntil([&]() { return second_count.load() == 1; });
+    // 再处理一段时间，确认没有补发给第一个订阅者
+    for (int i = 0; i < 100; ++i) SystemManager::instance().spinOnce();
+
+    EXPECT_EQ(second_count.load(), 1);
+    EXPECT_EQ(first_count.load(), 1);
+
+    pub.reset();
+    first.reset();
+    second.reset();
+}
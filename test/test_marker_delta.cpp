@@ -0,0 +1,95 @@
+#include "marker_delta.h"
+#include <gtest/gtest.h>
+
+using namespace simple_ros;
+
+namespace {
+
+visualization_msgs::Marker* addMarker(visualization_msgs::MarkerArray& array, const std::string& ns, int id,
+                                      double x, int64_t stamp_sec = 0) {
+    auto* marker = array.add_markers();
+    marker->set_ns(ns);
+    marker->set_id(id);
+    marker->set_type(visualization_msgs::CUBE);
+    marker->set_action(visualization_msgs::ADD);
+    marker->mutable_pose()->mutable_position()->set_x(x);
+    marker->mutable_header()->mutable_stamp()->set_sec(stamp_sec);
+    marker->mutable_header()->set_frame_id("world");
+    return marker;
+}
+
+} // namespace
+
+TEST(MarkerDeltaTest, SendsOnlyChangedMarkers) {
+    MarkerDeltaTracker tracker;
+    auto now = MarkerDeltaTracker::Clock::now();
+
+    visualization_msgs::MarkerArray first;
+    addMarker(first, "quad", 0, 1.0, 1);
+    addMarker(first, "quad", 1, 2.0, 1);
+    MarkerDelta delta = tracker.apply(first, now);
+    EXPECT_EQ(delta.changed.size(), 2u);
+    EXPECT_EQ(tracker.size(), 2u);
+
+    // 只有时间戳不同视为未变化；id 1 的位置变化
+    visualization_msgs::MarkerArray second;
+    addMarker(second, "quad", 0, 1.0, 2);
+    addMarker(second, "quad", 1, 2.5, 2);
+    delta = tracker.apply(second, now);
+    ASSERT_EQ(delta.changed.size(), 1u);
+    EXPECT_EQ(MarkerDeltaTracker::entityId(*delta.changed[0]), "quad_1");
+    EXPECT_FALSE(delta.delete_all);
+    EXPECT_TRUE(delta.deleted.empty());
+
+    delta = tracker.apply(second, now);
+    EXPECT_TRUE(delta.empty());
+}
+
+TEST(MarkerDeltaTest, DeleteActions) {
+    MarkerDeltaTracker tracker;
+    auto now = MarkerDeltaTracker::Clock::now();
+
+    visualization_msgs::MarkerArray array;
+    addMarker(array, "a", 0, 1.0);
+    addMarker(array, "a", 1, 1.0);
+    tracker.apply(array, now);
+
+    // DELETE 之后同一个 Marker 再次出现需要重新发送
+    visualization_msgs::MarkerArray del;
+    addMarker(del, "a", 0, 1.0)->set_action(visualization_msgs::DELETE);
+    MarkerDelta delta = tracker.apply(del, now);
+    ASSERT_EQ(delta.deleted.size(), 1u);
+    EXPECT_EQ(delta.deleted[0], "a_0");
+    EXPECT_EQ(tracker.size(), 1u);
+    EXPECT_EQ(tracker.apply(array, now).changed.size(), 1u);
+
+    // 同一条消息中先新增后删除：不发送该实体
+    visualization_msgs::MarkerArray add_then_delete;
+    addMarker(add_then_delete, "b", 0, 1.0);
+    addMarker(add_then_delete, "b", 0, 1.0)->set_action(visualization_msgs::DELETE);
+    delta = tracker.apply(add_then_delete, now);
+    EXPECT_TRUE(delta.changed.empty());
+    EXPECT_EQ(delta.deleted.size(), 1u);
+
+    // DELETEALL 覆盖之前的操作，之后的新增保留
+    visualization_msgs::MarkerArray reset;
+    addMarker(reset, "a", 5, 1.0);
+    reset.add_markers()->set_action(visualization_msgs::DELETEALL);
+    addMarker(reset, "a", 6, 1.0);
+    delta = tracker.apply(reset, now);
+    EXPECT_TRUE(delta.delete_all);
+    ASSERT_EQ(delta.changed.size(), 1u);
+    EXPECT_EQ(MarkerDeltaTracker::entityId(*delta.changed[0]), "a_6");
+    EXPECT_EQ(tracker.size(), 1u);
+}
+
+TEST(MarkerDeltaTest, RefreshesBeforeLifetimeExpires) {
+    MarkerDeltaTracker tracker;
+    auto t0 = MarkerDeltaTracker::Clock::now();
+
+    visualization_msgs::MarkerArray array;
+    addMarker(array, "tmp", 0, 1.0)->set_lifetime(2.0);
+    EXPECT_EQ(tracker.apply(array, t0).changed.size(), 1u);
+    EXPECT_TRUE(tracker.apply(array, t0 + std::chrono::milliseconds(500)).empty());
+    EXPECT_EQ(tracker.apply(array, t0 + std::chrono::milliseconds(1000)).changed.size(), 1u);
+}
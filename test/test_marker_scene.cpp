@@ -0,0 +1,166 @@
+#include "marker_scene.h"
+#include "foxglove_bridge.h"
+#include "message_throttle.h"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <vector>
+
+using namespace simple_ros;
+
+namespace {
+
+visualization_msgs::Marker makeMarker(visualization_msgs::MarkerType type) {
+    visualization_msgs::Marker marker;
+    marker.set_ns("test");
+    marker.set_type(type);
+    marker.mutable_scale()->set_x(1.0);
+    marker.mutable_scale()->set_y(2.0);
+    marker.mutable_scale()->set_z(3.0);
+    marker.mutable_color()->set_g(1.0f);
+    marker.mutable_color()->set_a(1.0f);
+    return marker;
+}
+
+// 绕 z 轴旋转 90 度
+void setYaw90(visualization_msgs::Marker* marker, double tx) {
+    auto* pose = marker->mutable_pose();
+    pose->mutable_position()->set_x(tx);
+    pose->mutable_orientation()->set_z(std::sqrt(0.5));
+    pose->mutable_orientation()->set_w(std::sqrt(0.5));
+}
+
+} // namespace
+
+TEST(MarkerSceneTest, ConvertsEveryMarkerType) {
+    const visualization_msgs::MarkerType types[] = {
+        visualization_msgs::CUBE, visualization_msgs::SPHERE, visualization_msgs::CYLINDER,
+        visualization_msgs::ARROW, visualization_msgs::LINE_STRIP, visualization_msgs::POINTS,
+        visualization_msgs::TEXT_VIEW_FACING, visualization_msgs::MESH_RESOURCE};
+    foxglove::schemas::SceneEntity entity;
+    for (auto type : types) {
+        auto marker = makeMarker(type);
+        marker.add_points()->set_x(1.0);
+        marker.add_points()->set_y(1.0);
+        marker.set_text("hello");
+        marker.set_mesh_resource("package://robot/base.stl");
+        EXPECT_TRUE(appendMarkerPrimitives(marker, &entity)) << type;
+    }
+    EXPECT_EQ(entity.cubes.size(), 1u);
+    EXPECT_EQ(entity.spheres.size(), 3u);   // SPHERE 与 POINTS 的两个点
+    EXPECT_EQ(entity.cylinders.size(), 1u);
+    EXPECT_EQ(entity.arrows.size(), 1u);
+    EXPECT_EQ(entity.lines.size(), 1u);
+    ASSERT_EQ(entity.texts.size(), 1u);
+    EXPECT_EQ(entity.texts[0].text, "hello");
+    EXPECT_TRUE(entity.texts[0].billboard);
+    EXPECT_DOUBLE_EQ(entity.texts[0].font_size, 3.0);
+    ASSERT_EQ(entity.models.size(), 1u);
+    EXPECT_EQ(entity.models[0].url, "package://robot/base.stl");
+    EXPECT_TRUE(entity.models[0].override_color);
+
+    // 未设置姿态时使用单位四元数
+    ASSERT_TRUE(entity.cubes[0].pose && entity.cubes[0].pose->orientation);
+    EXPECT_DOUBLE_EQ(entity.cubes[0].pose->orientation->w, 1.0);
+
+    auto unknown = makeMarker(static_cast<visualization_msgs::MarkerType>(42));
+    EXPECT_FALSE(appendMarkerPrimitives(unknown, &entity));
+}
+
+TEST(MarkerSceneTest, TransformsPointsWithPoseAndColors) {
+    auto marker = makeMarker(visualization_msgs::POINTS);
+    setYaw90(&marker, 10.0);
+    for (int i = 0; i < 1000; ++i) {
+        auto* p = marker.add_points();
+        p->set_x(i);
+        p->set_z(0.5);
+        marker.add_colors()->set_r(i % 2);
+    }
+
+    foxglove::schemas::SceneEntity entity;
+    ASSERT_TRUE(appendMarkerPrimitives(marker, &entity));
+    ASSERT_EQ(entity.spheres.size(), 1000u);
+    // 点 (i, 0, 0.5) 旋转 90 度后为 (0, i, 0.5)，再平移 x += 10
+    const auto& last = *entity.spheres[999].pose->position;
+    EXPECT_NEAR(last.x, 10.0, 1e-9);
+    EXPECT_NEAR(last.y, 999.0, 1e-9);
+    EXPECT_NEAR(last.z, 0.5, 1e-9);
+    EXPECT_DOUBLE_EQ(entity.spheres[1].color->r, 1.0);
+    EXPECT_DOUBLE_EQ(entity.spheres[2].color->r, 0.0);
+    EXPECT_DOUBLE_EQ(entity.spheres[0].size->y, 2.0);
+}
+
+TEST(MarkerSceneTest, LineStripKeepsPoseAndPerPointColors) {
+    auto marker = makeMarker(visualization_msgs::LINE_STRIP);
+    setYaw90(&marker, 1.0);
+    for (int i = 0; i < 3; ++i) {
+        marker.add_points()->set_x(i);
+        marker.add_colors()->set_b(0.5f);
+    }
+
+    foxglove::schemas::SceneEntity entity;
+    ASSERT_TRUE(appendMarkerPrimitives(marker, &entity));
+    ASSERT_EQ(entity.lines.size(), 1u);
+    const auto& line = entity.lines[0];
+    ASSERT_EQ(line.points.size(), 3u);
+    EXPECT_DOUBLE_EQ(line.points[2].x, 2.0);   // 点保持在 Marker 的 pose 坐标系中
+    ASSERT_EQ(line.colors.size(), 3u);
+    EXPECT_DOUBLE_EQ(line.colors[0].b, 0.5);
+    EXPECT_DOUBLE_EQ(line.pose->position->x, 1.0);
+}
+
+TEST(MarkerSceneTest, ArrowFromStartAndEndPoints) {
+    auto marker = makeMarker(visualization_msgs::ARROW);
+    marker.mutable_scale()->set_z(0.0);
+    auto* a = marker.add_points();
+    a->set_x(1.0);
+    auto* b = marker.add_points();
+    b->set_x(1.0);
+    b->set_y(4.0);
+
+    foxglove::schemas::SceneEntity entity;
+    ASSERT_TRUE(appendMarkerPrimitives(marker, &entity));
+    ASSERT_EQ(entity.arrows.size(), 1u);
+    const auto& arrow = entity.arrows[0];
+    EXPECT_NEAR(arrow.shaft_length + arrow.head_length, 4.0, 1e-9);
+    EXPECT_DOUBLE_EQ(arrow.shaft_diameter, 1.0);
+    EXPECT_DOUBLE_EQ(arrow.head_diameter, 2.0);
+    // 起点在 (1, 0, 0)，+X 轴转向 +Y：绕 z 轴 90 度
+    EXPECT_NEAR(arrow.pose->position->x, 1.0, 1e-9);
+    EXPECT_NEAR(arrow.pose->orientation->z, std::sqrt(0.5), 1e-9);
+    EXPECT_NEAR(arrow.pose->orientation->w, std::sqrt(0.5), 1e-9);
+}
+
+// Marker 话题即使设置了限速，同一周期内的 ADD → DELETE → ADD 也全部送达，DELETE 不会被替换
+TEST(MarkerSceneTest, ThrottledMarkerTopicStillDeliversDelete) {
+    auto add_a = std::make_shared<visualization_msgs::Marker>(makeMarker(visualization_msgs::CUBE));
+    add_a->set_id(1);
+    auto del_a = std::make_shared<visualization_msgs::Marker>(*add_a);
+    del_a->set_action(visualization_msgs::DELETE);
+    auto add_b = std::make_shared<visualization_msgs::Marker>(*add_a);
+    add_b->set_id(2);
+    const std::vector<LatestMessageThrottle::MessagePtr> burst = {add_a, del_a, add_b};
+
+    auto deliver = [&](double max_rate) {
+        LatestMessageThrottle throttle(max_rate);
+        auto now = LatestMessageThrottle::Clock::now();
+        std::vector<LatestMessageThrottle::MessagePtr> sent;
+        for (const auto& msg : burst) {
+            if (throttle.offer(msg, now)) sent.push_back(msg);
+        }
+        if (auto msg = throttle.takeDue(now + std::chrono::seconds(1))) sent.push_back(msg);
+        return sent;
+    };
+
+    // 直接按 10 Hz 限速时 DELETE 被后面的 ADD 替换
+    auto raw = deliver(10.0);
+    EXPECT_EQ(std::count(raw.begin(), raw.end(), del_a), 0);
+
+    EXPECT_DOUBLE_EQ(FoxgloveBridge::effectiveMaxRate("visualization_msgs.Marker", 10.0), 0.0);
+    EXPECT_DOUBLE_EQ(FoxgloveBridge::effectiveMaxRate("visualization_msgs.MarkerArray", 10.0), 0.0);
+    EXPECT_DOUBLE_EQ(FoxgloveBridge::effectiveMaxRate("sensor_msgs.LaserScan", 10.0), 10.0);
+
+    auto sent = deliver(FoxgloveBridge::effectiveMaxRate("visualization_msgs.Marker", 10.0));
+    EXPECT_EQ(sent, burst);
+}
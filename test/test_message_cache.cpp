@@ -0,0 +1,58 @@
+#include "message_cache.h"
+#include <gtest/gtest.h>
+
+using namespace simple_ros;
+
+TEST(MessageCacheTest, SlotKeepsLatestMessage) {
+    CacheBudget budget(100);
+    LastMessageSlot slot(&budget);
+    EXPECT_TRUE(slot.empty());
+
+    ASSERT_TRUE(slot.store("hello", 5));
+    ASSERT_TRUE(slot.store("hi", 2));
+    EXPECT_EQ(slot.data(), "hi");
+    EXPECT_EQ(budget.usedBytes(), 2u);
+
+    slot.clear();
+    EXPECT_TRUE(slot.empty());
+    EXPECT_EQ(budget.usedBytes(), 0u);
+}
+
+TEST(MessageCacheTest, BudgetIsSharedAndCapped) {
+    CacheBudget budget(10);
+    LastMessageSlot a(&budget);
+    LastMessageSlot b(&budget);
+
+    ASSERT_TRUE(a.store("123456", 6));
+    // 超出剩余预算：b 不缓存，a 不受影响
+    EXPECT_FALSE(b.store("abcdef", 6));
+    EXPECT_TRUE(b.empty());
+    EXPECT_EQ(a.data(), "123456");
+
+    // a 变小后释放出的预算可以被 b 使用
+    ASSERT_TRUE(a.store("12", 2));
+    EXPECT_TRUE(b.store("abcdef", 6));
+    EXPECT_EQ(budget.usedBytes(), 8u);
+
+    // 已缓存的消息增大到超出预算时清空，归还原来占用的字节
+    EXPECT_FALSE(a.store("123456", 6));
+    EXPECT_TRUE(a.empty());
+    EXPECT_EQ(budget.usedBytes(), 6u);
+}
+
+TEST(MessageCacheTest, ReservationReleasesOnDestruction) {
+    CacheBudget budget(64);
+    {
+        CacheReservation reservation(&budget);
+        ASSERT_TRUE(reservation.resize(40));
+        EXPECT_FALSE(reservation.resize(65));
+        EXPECT_EQ(reservation.bytes(), 40u);
+        EXPECT_EQ(budget.usedBytes(), 40u);
+    }
+    EXPECT_EQ(budget.usedBytes(), 0u);
+
+    // 预算为 0 表示不缓存
+    CacheBudget disabled(0);
+    LastMessageSlot slot(&disabled);
+    EXPECT_FALSE(slot.store("x", 1));
+}
@@ -0,0 +1,66 @@
+#include "message_throttle.h"
+#include "example.pb.h"
+#include <gtest/gtest.h>
+#include <memory>
+
+using namespace simple_ros;
+
+namespace {
+
+using Clock = LatestMessageThrottle::Clock;
+
+std::shared_ptr<google::protobuf::Message> heartbeat(int64_t stamp) {
+    auto msg = std::make_shared<example::Heartbeat>();
+    msg->set_timestamp(stamp);
+    return msg;
+}
+
+int64_t stampOf(const LatestMessageThrottle::MessagePtr& msg) {
+    return static_cast<const example::Heartbeat&>(*msg).timestamp();
+}
+
+} // namespace
+
+TEST(MessageThrottleTest, UnlimitedPassesEverything) {
+    LatestMessageThrottle throttle;
+    auto now = Clock::now();
+    for (int i = 0; i < 10; ++i) {
+        EXPECT_TRUE(throttle.offer(heartbeat(i), now));
+    }
+    EXPECT_FALSE(throttle.hasPending());
+    EXPECT_EQ(throttle.droppedCount(), 0u);
+}
+
+TEST(MessageThrottleTest, KeepsLatestWithinPeriod) {
+    LatestMessageThrottle throttle(10.0);  // 100ms
+    auto t0 = Clock::now();
+    EXPECT_TRUE(throttle.offer(heartbeat(1), t0));
+
+    // 周期内的消息只保留最新一条
+    EXPECT_FALSE(throttle.offer(heartbeat(2), t0 + std::chrono::milliseconds(10)));
+    EXPECT_FALSE(throttle.offer(heartbeat(3), t0 + std::chrono::milliseconds(20)));
+    EXPECT_FALSE(throttle.offer(heartbeat(4), t0 + std::chrono::milliseconds(30)));
+    EXPECT_EQ(throttle.droppedCount(), 2u);
+
+    EXPECT_EQ(throttle.takeDue(t0 + std::chrono::milliseconds(50)), nullptr);
+    auto due = throttle.takeDue(t0 + std::chrono::milliseconds(100));
+    ASSERT_NE(due, nullptr);
+    EXPECT_EQ(stampOf(due), 4);
+    EXPECT_FALSE(throttle.hasPending());
+
+    // 补发后重新计时
+    EXPECT_FALSE(throttle.offer(heartbeat(5), t0 + std::chrono::milliseconds(150)));
+    EXPECT_TRUE(throttle.offer(heartbeat(6), t0 + std::chrono::milliseconds(200)));
+    EXPECT_FALSE(throttle.hasPending());
+    EXPECT_EQ(throttle.droppedCount(), 3u);
+}
+
+TEST(MessageThrottleTest, ResetDropsPending) {
+    LatestMessageThrottle throttle(1.0);
+    auto t0 = Clock::now();
+    EXPECT_TRUE(throttle.offer(heartbeat(1), t0));
+    EXPECT_FALSE(throttle.offer(heartbeat(2), t0 + std::chrono::milliseconds(1)));
+    throttle.reset();
+    EXPECT_FALSE(throttle.hasPending());
+    EXPECT_TRUE(throttle.offer(heartbeat(3), t0 + std::chrono::milliseconds(2)));
+}
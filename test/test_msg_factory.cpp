@@ -66,3 +66,128 @@ TEST(MsgFactoryTest, CreateAndParse) {
     EXPECT_EQ(getField<int32_t>(*sensor_msg, "sensor_id"), 100);
     EXPECT_FLOAT_EQ(getField<float>(*sensor_msg, "value"), 12.34f);
 }
+
+TEST(MsgFactoryTest, ArenaMessageOutlivesLocalArenaHandle) {
+    REGISTER_MSG(SensorData);
+
+    example::SensorData sensor;
+    sensor.set_sensor_id(7);
+    sensor.set_value(1.5f);
+    std::string data;
+    sensor.SerializeToString(&data);
+
+    std::shared_ptr<google::protobuf::Message> msg;
+    std::weak_ptr<MessageArena> weak_arena;
+    {
+        auto arena = std::make_shared<MessageArena>(MessageArena::blockSizeFor(data.size()));
+        weak_arena = arena;
+        msg = MsgFactory::instance().createSharedMessage("example.SensorData", arena);
+    }
+    ASSERT_NE(msg, nullptr);
+    ASSERT_TRUE(msg->ParseFromString(data));
+    EXPECT_NE(msg->GetArena(), nullptr);
+    EXPECT_FALSE(weak_arena.expired());   // 消息持有 Arena
+
+    auto typed = std::dynamic_pointer_cast<example::SensorData>(msg);
+    ASSERT_NE(typed, nullptr);
+    EXPECT_EQ(typed->sensor_id(), 7);
+
+    msg.reset();
+    EXPECT_FALSE(weak_arena.expired());   // 别名 shared_ptr 共享同一控制块
+    typed.reset();
+    EXPECT_TRUE(weak_arena.expired());
+}
+
+TEST(MsgFactoryTest, BatchArenaSharedByMessages) {
+    auto arena = std::make_shared<MessageArena>(4096);
+    // 未注册的类型经 DynamicMessageFactory 在 Arena 上创建
+    auto a = MsgFactory::instance().createSharedMessage("example.Heartbeat", arena);
+    auto b = MsgFactory::instance().createSharedMessage("example.Heartbeat", arena);
+    ASSERT_NE(a, nullptr);
+    ASSERT_NE(b, nullptr);
+    EXPECT_EQ(std::dynamic_pointer_cast<example::Heartbeat>(a), nullptr);
+
+    example::Heartbeat beat;
+    beat.set_timestamp(42);
+    ASSERT_TRUE(a->ParseFromString(beat.SerializeAsString()));
+    EXPECT_EQ(a->DebugString(), beat.DebugString());
+    EXPECT_EQ(a->GetArena(), arena->get());
+    EXPECT_EQ(b->GetArena(), arena->get());
+    EXPECT_GT(arena->spaceUsed(), 0u);
+
+    // 不传 Arena 时在堆上创建
+    auto heap = MsgFactory::instance().createSharedMessage("example.Heartbeat", nullptr);
+    ASSERT_NE(heap, nullptr);
+    EXPECT_EQ(heap->GetArena(), nullptr);
+    EXPECT_EQ(MsgFactory::instance().createSharedMessage("example.NoSuchType", arena), nullptr);
+}
+
+TEST(MsgFactoryTest, CreateOnArena) {
+    auto msg = MsgFactory::createOnArena<example::SensorData>();
+    ASSERT_NE(msg, nullptr);
+    EXPECT_NE(msg->GetArena(), nullptr);
+    msg->set_sensor_id(3);
+    example::SensorData copy(*msg);   // 拷贝到堆上
+    EXPECT_EQ(copy.GetArena(), nullptr);
+    EXPECT_EQ(copy.sensor_id(), 3);
+}
+
+TEST(MsgFactoryTest, TypeIdLookup) {
+    auto& factory = MsgFactory::instance();
+    MsgTypeId id = REGISTER_MSG(SensorData);
+    ASSERT_NE(id, kInvalidMsgTypeId);
+    EXPECT_EQ(REGISTER_MSG(SensorData), id);   // 重复注册不改变 ID
+    EXPECT_EQ(factory.typeId("example.SensorData"), id);
+    EXPECT_EQ(factory.typeName(id), "example.SensorData");
+    EXPECT_EQ(factory.typeId("example.NoSuchType"), kInvalidMsgTypeId);
+    EXPECT_EQ(factory.createSharedMessage(kInvalidMsgTypeId, nullptr), nullptr);
+
+    MsgTypeIdCache cache;
+    EXPECT_EQ(cache.lookup("example.SensorData"), id);
+    EXPECT_EQ(cache.lookup("example.SensorData"), id);
+    EXPECT_NE(cache.lookup("example.Heartbeat"), kInvalidMsgTypeId);
+    EXPECT_EQ(cache.lookup("example.NoSuchType"), kInvalidMsgTypeId);
+}
+
+TEST(MsgFactoryTest, PoolRecyclesClearedMessages) {
+    auto& factory = MsgFactory::instance();
+    factory.setPoolCapacity(2);
+    MsgTypeId id = REGISTER_MSG(SensorData);
+    auto pool = factory.pool(id);
+    ASSERT_NE(pool, nullptr);
+    EXPECT_EQ(pool->capacity(), 2u);
+
+    auto msg = factory.createSharedMessage(id, nullptr);
+    ASSERT_NE(msg, nullptr);
+    auto typed = std::dynamic_pointer_cast<example::SensorData>(msg);
+    ASSERT_NE(typed, nullptr);
+    typed->set_sensor_id(9);
+    const google::protobuf::Message* raw = msg.get();
+    size_t idle_before = pool->idleCount();
+
+    msg.reset();
+    EXPECT_EQ(pool->idleCount(), idle_before);   // 别名仍持有
+    typed.reset();
+    EXPECT_EQ(pool->idleCount(), idle_before + 1);
+
+    uint64_t reused_before = pool->reusedCount();
+    auto again = std::dynamic_pointer_cast<example::SensorData>(factory.createSharedMessage(id, nullptr));
+    ASSERT_NE(again, nullptr);
+    EXPECT_EQ(again.get(), raw);
+    EXPECT_EQ(again->sensor_id(), 0);            // 归还时已 Clear
+    EXPECT_EQ(pool->reusedCount(), reused_before + 1);
+
+    // 超出容量的消息直接释放
+    std::vector<std::shared_ptr<google::protobuf::Message>> held;
+    for (int i = 0; i < 4; ++i) held.push_back(factory.createSharedMessage(id, nullptr));
+    held.clear();
+    again.reset();
+    EXPECT_EQ(pool->idleCount(), 2u);
+
+    factory.setPoolCapacity(0);
+    EXPECT_EQ(pool->idleCount(), 0u);
+    auto heap = factory.createSharedMessage(id, nullptr);
+    heap.reset();
+    EXPECT_EQ(pool->idleCount(), 0u);
+    factory.setPoolCapacity(16);
+}
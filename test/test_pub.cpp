@@ -17,7 +17,6 @@ public:
         // 初始化系统
         auto& sys = SystemManager::instance();
         sys.init(port_, nodeName_);
-        std::this_thread::sleep_for(std::chrono::milliseconds(200));
         
         // 创建NodeHandle
         nh_ = std::make_shared<NodeHandle>();
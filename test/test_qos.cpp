@@ -0,0 +1,151 @@
+#include "qos.h"
+#include "message_graph.h"
+#include "message_queue.h"
+#include "subscription_handler_registry.h"
+#include <gtest/gtest.h>
+#include <string>
+#include <thread>
+#include <chrono>
+
+using namespace simple_ros;
+
+namespace {
+
+NodeInfo makeNode(const std::string& name, int port) {
+    NodeInfo info;
+    info.set_node_name(name);
+    info.set_ip("127.0.0.1");
+    info.set_port(port);
+    return info;
+}
+
+} // namespace
+
+// ---------------- QoSProfile ----------------
+TEST(QoSProfileTest, MsgRoundTrip) {
+    QoSProfile qos = QoSProfile(3).bestEffort().transientLocal().setDeadline(0.1).setLifespan(2.0);
+    QoSProfile back = QoSProfile::fromMsg(qos.toMsg());
+
+    EXPECT_EQ(back.reliability, Reliability::BEST_EFFORT);
+    EXPECT_EQ(back.durability, Durability::TRANSIENT_LOCAL);
+    EXPECT_EQ(back.depth, 3u);
+    EXPECT_DOUBLE_EQ(back.deadline, 0.1);
+    EXPECT_DOUBLE_EQ(back.lifespan, 2.0);
+
+    // 旧客户端未携带 QoS 时使用默认值
+    QoSProfile legacy = QoSProfile::fromMsg(QoSPolicy());
+    EXPECT_EQ(legacy.reliability, Reliability::RELIABLE);
+    EXPECT_EQ(legacy.depth, QoSProfile().depth);
+}
+
+TEST(QoSProfileTest, Compatibility) {
+    std::string reason;
+    EXPECT_TRUE(QoSProfile::isCompatible(QoSProfile(), QoSProfile()));
+    EXPECT_TRUE(QoSProfile::isCompatible(QoSProfile(), QoSProfile::sensorData()));
+    EXPECT_TRUE(QoSProfile::isCompatible(QoSProfile::latched(), QoSProfile()));
+
+    EXPECT_FALSE(QoSProfile::isCompatible(QoSProfile::sensorData(), QoSProfile(), &reason));
+    EXPECT_FALSE(reason.empty());
+    EXPECT_FALSE(QoSProfile::isCompatible(QoSProfile(), QoSProfile().transientLocal()));
+
+    EXPECT_FALSE(QoSProfile::isCompatible(QoSProfile(), QoSProfile().setDeadline(0.1)));
+    EXPECT_FALSE(QoSProfile::isCompatible(QoSProfile().setDeadline(0.5), QoSProfile().setDeadline(0.1)));
+    EXPECT_TRUE(QoSProfile::isCompatible(QoSProfile().setDeadline(0.05), QoSProfile().setDeadline(0.1)));
+}
+
+// ---------------- MessageGraph ----------------
+TEST(QoSGraphTest, OnlyCompatiblePairsAreConnected) {
+    MessageGraph graph;
+    TopicKey key{"scan", "example.SensorData"};
+
+    NodeInfo pub = makeNode("lidar", 60001);
+    NodeInfo reliable_sub = makeNode("planner", 60002);
+    NodeInfo best_effort_sub = makeNode("viewer", 60003);
+
+    graph.AddPublisher(pub, key, QoSProfile::sensorData());
+    graph.AddSubscriber(reliable_sub, key, QoSProfile::command());
+    graph.AddSubscriber(best_effort_sub, key, QoSProfile::sensorData());
+
+    auto subs = graph.GetCompatibleSubscribers("lidar", key);
+    ASSERT_EQ(subs.size(), 1u);
+    EXPECT_EQ(subs[0].node_name(), "viewer");
+
+    auto pubs = graph.GetCompatiblePublishers("planner", key);
+    EXPECT_TRUE(pubs.empty());
+
+    // 发布者升级为可靠后重新注册，两个订阅者都应连通
+    graph.AddPublisher(pub, key, QoSProfile::command());
+    EXPECT_EQ(graph.GetCompatibleSubscribers("lidar", key).size(), 2u);
+
+    QoSProfile stored;
+    ASSERT_TRUE(graph.GetPublisherQoS("lidar", key, &stored));
+    EXPECT_EQ(stored.reliability, Reliability::RELIABLE);
+}
+
+// 桥接与 rostopic echo 的通用订阅能连上任何发布者，包括 BEST_EFFORT 与锁存话题
+TEST(QoSGraphTest, GenericToolsConnectToBestEffortPublishers) {
+    MessageGraph graph;
+    TopicKey scan{"scan", "example.SensorData"};
+    TopicKey map{"map", "example.SensorData"};
+
+    graph.AddPublisher(makeNode("lidar", 60001), scan, QoSProfile::sensorData());
+    graph.AddPublisher(makeNode("map_server", 60002), map, QoSProfile::latched());
+    NodeInfo bridge = makeNode("foxglove_bridge", 60003);
+    graph.AddSubscriber(bridge, scan, SubscriptionHandlerRegistry::genericQoS());
+    graph.AddSubscriber(bridge, map, SubscriptionHandlerRegistry::genericQoS());
+
+    auto scan_pubs = graph.GetCompatiblePublishers("foxglove_bridge", scan);
+    ASSERT_EQ(scan_pubs.size(), 1u);
+    EXPECT_EQ(scan_pubs[0].node_name(), "lidar");
+    auto map_pubs = graph.GetCompatiblePublishers("foxglove_bridge", map);
+    ASSERT_EQ(map_pubs.size(), 1u);
+    EXPECT_EQ(map_pubs[0].node_name(), "map_server");
+
+    // 默认 QoS（RELIABLE）的订阅连不上 BEST_EFFORT 发布者
+    EXPECT_FALSE(QoSProfile::isCompatible(QoSProfile::sensorData(), QoSProfile(10)));
+}
+
+// ---------------- deadline ----------------
+TEST(QoSDeadlineTest, MissesCountedWithoutNewMessages) {
+    MessageQueue queue;
+    queue.registerTopic("scan");
+    queue.setTopicTiming("scan", 0.0, 0.05);
+
+    // 收到首条消息之前不计数
+    std::this_thread::sleep_for(std::chrono::milliseconds(80));
+    queue.checkDeadlines();
+    EXPECT_EQ(queue.getDeadlineMissedCount("scan"), 0u);
+
+    // 之后发布者停止发布：定时检查每满一个周期记一次
+    queue.push("scan", std::make_shared<NodeInfo>());
+    std::this_thread::sleep_for(std::chrono::milliseconds(120));
+    queue.checkDeadlines();
+    EXPECT_EQ(queue.getDeadlineMissedCount("scan"), 2u);
+
+    // 已记录的周期不会在下一条消息到达时重复计数
+    queue.push("scan", std::make_shared<NodeInfo>());
+    EXPECT_EQ(queue.getDeadlineMissedCount("scan"), 2u);
+    queue.checkDeadlines();
+    EXPECT_EQ(queue.getDeadlineMissedCount("scan"), 2u);
+}
+
+// deadline 检查只在有话题设置 deadline 时启用，周期取最小的 deadline
+TEST(QoSDeadlineTest, MinDeadlineTracksTopics) {
+    MessageQueue queue;
+    EXPECT_EQ(queue.minDeadline(), 0.0);
+
+    queue.registerTopic("scan");
+    queue.setTopicTiming("scan", 0.0, 0.2);
+    uint64_t scan_id = queue.addSubscriber("scan", [](const std::shared_ptr<google::protobuf::Message>&) {});
+    queue.registerTopic("imu");
+    queue.setTopicTiming("imu", 0.0, 0.05);
+    uint64_t imu_id = queue.addSubscriber("imu", [](const std::shared_ptr<google::protobuf::Message>&) {});
+    queue.registerTopic("map");
+    queue.setTopicTiming("map", 1.0, 0.0);
+    EXPECT_DOUBLE_EQ(queue.minDeadline(), 0.05);
+
+    queue.removeSubscriber("imu", imu_id);
+    EXPECT_DOUBLE_EQ(queue.minDeadline(), 0.2);
+    queue.removeSubscriber("scan", scan_id);
+    EXPECT_EQ(queue.minDeadline(), 0.0);
+}
@@ -0,0 +1,87 @@
+#include "realtime_profile.h"
+#include <gtest/gtest.h>
+#include <pthread.h>
+#include <sched.h>
+#include <thread>
+
+using namespace simple_ros;
+
+TEST(RealtimeProfileTest, DefaultProfileIsDisabled) {
+    RealtimeProfile profile;
+    EXPECT_FALSE(profile.enabled());
+    EXPECT_TRUE(profile.lockMemory());
+    EXPECT_TRUE(profile.applyToCurrentThread(ThreadRole::SPIN));
+}
+
+TEST(RealtimeProfileTest, ParsesJson) {
+    auto json = nlohmann::json::parse(R"({
+        "lock_memory": true,
+        "prefault_heap_mb": 8,
+        "prefault_stack_kb": 64,
+        "threads": {
+            "timer": {"cpus": [1], "policy": "fifo", "priority": 85},
+            "spin":  {"cpus": [2, 3], "policy": "rr", "priority": 70},
+            "event": {"cpus": [0]}
+        }
+    })");
+    RealtimeProfile profile;
+    std::string error;
+    ASSERT_TRUE(RealtimeProfile::fromJson(json, &profile, &error)) << error;
+
+    EXPECT_TRUE(profile.enabled());
+    EXPECT_TRUE(profile.lock_memory);
+    EXPECT_EQ(profile.prefault_heap, 8u << 20);
+    EXPECT_EQ(profile.prefault_stack, 64u << 10);
+
+    const auto& timer = profile.settings(ThreadRole::TIMER);
+    EXPECT_EQ(timer.cpus, std::vector<int>{1});
+    EXPECT_EQ(timer.policy, SchedPolicy::FIFO);
+    EXPECT_EQ(timer.priority, 85);
+
+    const auto& spin = profile.settings(ThreadRole::SPIN);
+    EXPECT_EQ(spin.cpus, (std::vector<int>{2, 3}));
+    EXPECT_EQ(spin.policy, SchedPolicy::RR);
+
+    const auto& event = profile.settings(ThreadRole::EVENT);
+    EXPECT_EQ(event.policy, SchedPolicy::OTHER);
+    EXPECT_TRUE(event.configured());
+
+    EXPECT_FALSE(profile.settings(ThreadRole::RECEIVE).configured());
+}
+
+TEST(RealtimeProfileTest, RejectsUnknownRoleAndPolicy) {
+    RealtimeProfile profile;
+    std::string error;
+    EXPECT_FALSE(RealtimeProfile::fromJson(
+        nlohmann::json::parse(R"({"threads": {"gpu": {"cpus": [0]}}})"), &profile, &error));
+    EXPECT_NE(error.find("gpu"), std::string::npos);
+
+    EXPECT_FALSE(RealtimeProfile::fromJson(
+        nlohmann::json::parse(R"({"threads": {"timer": {"policy": "deadline"}}})"), &profile, &error));
+    EXPECT_FALSE(RealtimeProfile::fromJson(nlohmann::json::array(), &profile, &error));
+    EXPECT_FALSE(RealtimeProfile::loadFile("/nonexistent/rt.json", &profile, &error));
+}
+
+TEST(RealtimeProfileTest, AppliesAffinityToCurrentThread) {
+    // 亲和性不需要特权；只设置到当前允许的第一个 CPU
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    ASSERT_EQ(sched_getaffinity(0, sizeof(allowed), &allowed), 0);
+    int first = 0;
+    while (first < CPU_SETSIZE && !CPU_ISSET(first, &allowed)) ++first;
+    ASSERT_LT(first, CPU_SETSIZE);
+
+    RealtimeProfile profile;
+    profile.settings(ThreadRole::SPIN).cpus = {first};
+    profile.prefault_stack = 32 * 1024;
+
+    std::thread worker([&]() {
+        EXPECT_TRUE(profile.applyToCurrentThread(ThreadRole::SPIN));
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        ASSERT_EQ(pthread_getaffinity_np(pthread_self(), sizeof(set), &set), 0);
+        EXPECT_EQ(CPU_COUNT(&set), 1);
+        EXPECT_TRUE(CPU_ISSET(first, &set));
+    });
+    worker.join();
+}
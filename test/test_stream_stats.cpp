@@ -0,0 +1,83 @@
+#include "stream_stats.h"
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+
+using namespace simple_ros;
+
+TEST(StreamStatsTest, CountsPipelineStages) {
+    StreamStats stats;
+    for (int i = 0; i < 5; ++i) stats.onReceived();
+    stats.onThrottled(2);
+    for (int i = 0; i < 3; ++i) stats.onDispatched();
+    stats.onDropped();
+    stats.onConverted(100e-6, 1000);
+    stats.raw_out.add(1000);
+    stats.scene_out.add(4096);
+
+    StreamStats::Snapshot snap = stats.snapshot();
+    EXPECT_EQ(snap.received, 5u);
+    EXPECT_EQ(snap.throttled, 2u);
+    EXPECT_EQ(snap.dispatched, 3u);
+    EXPECT_EQ(snap.dropped, 1u);
+    EXPECT_EQ(snap.converted, 1u);
+    EXPECT_EQ(snap.pending(), 1u);
+    EXPECT_EQ(snap.input_bytes, 1000u);
+    EXPECT_EQ(snap.raw_messages, 1u);
+    EXPECT_EQ(snap.raw_bytes, 1000u);
+    EXPECT_EQ(snap.scene_bytes, 4096u);
+    EXPECT_EQ(snap.conversion.count(), 1u);
+}
+
+TEST(StreamStatsTest, FailedMessagesAreNotPending) {
+    StreamStats stats;
+    for (int i = 0; i < 3; ++i) stats.onDispatched();
+    stats.onConverted(10e-6, 100);
+    stats.onFailed();
+
+    StreamStats::Snapshot snap = stats.snapshot();
+    EXPECT_EQ(snap.failed, 1u);
+    EXPECT_EQ(snap.pending(), 1u);
+    stats.onFailed();
+    EXPECT_EQ(stats.snapshot().pending(), 0u);
+}
+
+TEST(StreamStatsTest, TakeSnapshotResetsHistogramOnly) {
+    StreamStats stats;
+    stats.onDispatched();
+    stats.onConverted(50e-6, 10);
+    EXPECT_EQ(stats.takeSnapshot().conversion.count(), 1u);
+
+    StreamStats::Snapshot next = stats.takeSnapshot();
+    EXPECT_EQ(next.conversion.count(), 0u);
+    EXPECT_EQ(next.converted, 1u);
+    EXPECT_EQ(next.input_bytes, 10u);
+}
+
+TEST(StreamStatsTest, ConcurrentWritersAndReader) {
+    StreamStats stats;
+    constexpr int kPerThread = 20000;
+    std::thread receiver([&]() {
+        for (int i = 0; i < kPerThread; ++i) {
+            stats.onReceived();
+            stats.onDispatched();
+        }
+    });
+    std::thread converter([&]() {
+        for (int i = 0; i < kPerThread; ++i) {
+            stats.onConverted(1e-6, 8);
+            stats.raw_out.add(8);
+        }
+    });
+    uint64_t histogram_total = 0;
+    for (int i = 0; i < 100; ++i) histogram_total += stats.takeSnapshot().conversion.count();
+    receiver.join();
+    converter.join();
+
+    StreamStats::Snapshot snap = stats.takeSnapshot();
+    histogram_total += snap.conversion.count();
+    EXPECT_EQ(snap.received, static_cast<uint64_t>(kPerThread));
+    EXPECT_EQ(snap.converted, static_cast<uint64_t>(kPerThread));
+    EXPECT_EQ(snap.raw_bytes, 8u * kPerThread);
+    EXPECT_EQ(histogram_total, static_cast<uint64_t>(kPerThread));
+}
@@ -10,7 +10,6 @@ int main() {
     // 初始化系统
     auto& sys = SystemManager::instance();
     sys.init(12345, "subcriber_node");
-    std::this_thread::sleep_for(std::chrono::milliseconds(200));
 
     NodeHandle nh;
 
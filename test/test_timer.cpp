@@ -0,0 +1,144 @@
+#include "timer.h"
+#include "latency_histogram.h"
+#include <muduo/net/EventLoop.h>
+#include <muduo/net/EventLoopThread.h>
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace simple_ros;
+
+// ---------------- LatencyHistogram ----------------
+TEST(LatencyHistogramTest, EmptyHistogram) {
+    LatencyHistogram h;
+    EXPECT_EQ(h.count(), 0u);
+    EXPECT_DOUBLE_EQ(h.min(), 0.0);
+    EXPECT_DOUBLE_EQ(h.mean(), 0.0);
+    EXPECT_DOUBLE_EQ(h.percentile(0.99), 0.0);
+}
+
+TEST(LatencyHistogramTest, PercentileFallsInBucket) {
+    LatencyHistogram h;
+    for (int i = 0; i < 99; ++i) h.record(10e-6);  // 10us
+    h.record(1e-3);                                // 1ms
+
+    EXPECT_EQ(h.count(), 100u);
+    EXPECT_NEAR(h.min(), 10e-6, 1e-9);
+    EXPECT_NEAR(h.max(), 1e-3, 1e-9);
+
+    // 10us 落在 [8, 16) 桶，1ms 落在 [512, 1024) 或 [1024, 2048) 桶
+    EXPECT_DOUBLE_EQ(h.percentile(0.5), 16e-6);
+    EXPECT_GE(h.percentile(1.0), 1e-3);
+}
+
+TEST(LatencyHistogramTest, NegativeSamplesCountAsZero) {
+    LatencyHistogram h;
+    h.record(-5e-6);
+    EXPECT_EQ(h.count(), 1u);
+    EXPECT_EQ(h.buckets()[0], 1u);
+    h.reset();
+    EXPECT_EQ(h.count(), 0u);
+}
+
+// ---------------- Timer ----------------
+class TimerTest : public ::testing::Test {
+protected:
+    void SetUp() override { loop_ = loopThread_.startLoop(); }
+
+    muduo::net::EventLoopThread loopThread_;
+    muduo::net::EventLoop* loop_ = nullptr;
+};
+
+TEST_F(TimerTest, NoDriftWithSlowCallback) {
+    const double period = 0.02;
+    std::mutex mutex;
+    std::vector<TimerEvent> events;
+
+    Timer timer(loop_, period, [&](const TimerEvent& e) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            events.push_back(e);
+        }
+        // 回调耗时不应推迟后续截止时间
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    });
+    timer.start();
+    std::this_thread::sleep_for(std::chrono::milliseconds(230));
+    timer.stop();
+
+    std::lock_guard<std::mutex> lock(mutex);
+    ASSERT_GE(events.size(), 8u);
+    // 期望时间严格按周期递增
+    for (size_t i = 1; i < events.size(); ++i) {
+        EXPECT_NEAR(events[i].expected_real - events[i - 1].expected_real, period, 1e-6);
+        EXPECT_GE(events[i].jitter, 0.0);
+    }
+    EXPECT_EQ(timer.getLatencyHistogram().count(), events.size());
+}
+
+TEST_F(TimerTest, SkipPolicyReportsOverruns) {
+    std::atomic<int> calls{0};
+    std::atomic<uint32_t> overruns{0};
+
+    Timer timer(loop_, 0.01, [&](const TimerEvent& e) {
+        if (calls++ == 0) {
+            // 第一次回调阻塞约 5 个周期
+            std::this_thread::sleep_for(std::chrono::milliseconds(55));
+        }
+        overruns += e.overruns;
+    });
+    timer.setOverrunPolicy(OverrunPolicy::SKIP);
+    timer.start();
+    std::this_thread::sleep_for(std::chrono::milliseconds(120));
+    timer.stop();
+
+    EXPECT_GE(overruns.load(), 3u);
+    EXPECT_EQ(timer.getOverrunCount(), overruns.load());
+    // 跳过的周期不会补调：约 12 个周期中只回调约 7 次
+    EXPECT_LE(calls.load(), 9);
+}
+
+TEST_F(TimerTest, CatchUpPolicyRunsMissedPeriods) {
+    std::atomic<int> calls{0};
+
+    Timer timer(loop_, 0.01, [&](const TimerEvent&) {
+        if (calls++ == 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(55));
+        }
+    });
+    timer.setOverrunPolicy(OverrunPolicy::CATCH_UP);
+    timer.start();
+    std::this_thread::sleep_for(std::chrono::milliseconds(125));
+    timer.stop();
+
+    // 错过的周期会被依次补上，总次数接近经过的周期数
+    EXPECT_GE(calls.load(), 10);
+}
+
+TEST_F(TimerTest, OneShotFiresOnce) {
+    std::atomic<int> calls{0};
+    Timer timer(loop_, 0.01, [&](const TimerEvent&) { ++calls; });
+    timer.setOneShot(true);
+    timer.start();
+    std::this_thread::sleep_for(std::chrono::milliseconds(60));
+    EXPECT_EQ(calls.load(), 1);
+}
+
+TEST_F(TimerTest, PauseKeepsRemainingTime) {
+    std::atomic<int> calls{0};
+    Timer timer(loop_, 0.05, [&](const TimerEvent&) { ++calls; });
+    timer.start();
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    timer.pause();
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    EXPECT_EQ(calls.load(), 0);
+
+    timer.resume();
+    // 剩余约 30ms 后触发
+    std::this_thread::sleep_for(std::chrono::milliseconds(45));
+    EXPECT_EQ(calls.load(), 1);
+    timer.stop();
+}
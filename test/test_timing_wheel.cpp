@@ -0,0 +1,141 @@
+#include "timing_wheel.h"
+#include <muduo/net/EventLoopThread.h>
+#include <gtest/gtest.h>
+#include <random>
+#include <vector>
+
+using namespace simple_ros;
+
+namespace {
+
+// 不依赖 EventLoop，通过 advance 手动推进
+TimingWheel::Options smallWheel() {
+    TimingWheel::Options options;
+    options.slot_bits = 2;  // 每层 4 个槽
+    options.levels = 3;     // 范围 64 个 tick
+    return options;
+}
+
+} // namespace
+
+TEST(TimingWheelTest, OneShotFiresOnExpireTick) {
+    TimingWheel wheel(nullptr);
+    int calls = 0;
+    wheel.schedule(0.005, [&]() { ++calls; });  // 5 个 tick
+    EXPECT_EQ(wheel.size(), 1u);
+
+    wheel.advance(4);
+    EXPECT_EQ(calls, 0);
+    wheel.advance(1);
+    EXPECT_EQ(calls, 1);
+    EXPECT_EQ(wheel.size(), 0u);
+
+    wheel.advance(100);
+    EXPECT_EQ(calls, 1);
+}
+
+TEST(TimingWheelTest, PeriodicDoesNotDrift) {
+    TimingWheel wheel(nullptr);
+    std::vector<uint64_t> ticks;
+    wheel.schedule(0.003, [&]() { ticks.push_back(wheel.currentTick()); }, 0.003);
+
+    for (int i = 0; i < 30; ++i) wheel.advance(1);
+    ASSERT_EQ(ticks.size(), 10u);
+    for (size_t i = 0; i < ticks.size(); ++i) {
+        EXPECT_EQ(ticks[i], 3 * (i + 1));
+    }
+}
+
+TEST(TimingWheelTest, CancelAndStaleId) {
+    TimingWheel wheel(nullptr);
+    int calls = 0;
+    auto id = wheel.schedule(0.002, [&]() { ++calls; });
+    EXPECT_TRUE(wheel.cancel(id));
+    EXPECT_FALSE(wheel.cancel(id));
+
+    // 复用同一节点后，旧 id 不能取消新定时器
+    auto id2 = wheel.schedule(0.002, [&]() { ++calls; });
+    EXPECT_FALSE(wheel.cancel(id));
+    wheel.advance(2);
+    EXPECT_EQ(calls, 1);
+    EXPECT_FALSE(wheel.cancel(id2));
+    EXPECT_FALSE(wheel.cancel(TimingWheel::kInvalidTimer));
+}
+
+TEST(TimingWheelTest, CascadesAcrossLevels) {
+    TimingWheel wheel(nullptr, smallWheel());
+    std::vector<uint64_t> fired;
+    const std::vector<int> delays = {1, 3, 4, 5, 15, 16, 17, 31, 47, 63};
+    for (int d : delays) {
+        wheel.schedule(d * 0.001, [&fired, &wheel]() { fired.push_back(wheel.currentTick()); });
+    }
+    for (int i = 0; i < 70; ++i) wheel.advance(1);
+
+    ASSERT_EQ(fired.size(), delays.size());
+    for (size_t i = 0; i < delays.size(); ++i) {
+        EXPECT_EQ(fired[i], static_cast<uint64_t>(delays[i]));
+    }
+}
+
+TEST(TimingWheelTest, BeyondRangeStillExact) {
+    TimingWheel wheel(nullptr, smallWheel());
+    uint64_t fired_at = 0;
+    wheel.schedule(0.200, [&]() { fired_at = wheel.currentTick(); });  // 超出 64 tick 范围
+    wheel.advance(199);
+    EXPECT_EQ(fired_at, 0u);
+    wheel.advance(1);
+    EXPECT_EQ(fired_at, 200u);
+}
+
+TEST(TimingWheelTest, RandomTimersFireExactly) {
+    TimingWheel wheel(nullptr);
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<int> dist(1, 200000);
+
+    const int n = 20000;
+    std::vector<uint64_t> expected(n), actual(n, 0);
+    std::vector<TimingWheel::TimerId> ids(n);
+    for (int i = 0; i < n; ++i) {
+        expected[i] = dist(rng);
+        ids[i] = wheel.schedule(expected[i] * 0.001, [&actual, &wheel, i]() { actual[i] = wheel.currentTick(); });
+    }
+    // 取消一半
+    for (int i = 0; i < n; i += 2) {
+        EXPECT_TRUE(wheel.cancel(ids[i]));
+    }
+    EXPECT_EQ(wheel.size(), static_cast<size_t>(n / 2));
+
+    for (int t = 0; t < 200000; ++t) wheel.advance(1);
+    for (int i = 0; i < n; ++i) {
+        EXPECT_EQ(actual[i], i % 2 == 0 ? 0 : expected[i]) << "timer " << i;
+    }
+    EXPECT_EQ(wheel.size(), 0u);
+}
+
+TEST(TimingWheelTest, CallbackMayReschedule) {
+    TimingWheel wheel(nullptr);
+    int calls = 0;
+    std::function<void()> rearm = [&]() {
+        if (++calls < 3) wheel.schedule(0.001, rearm);
+    };
+    wheel.schedule(0.001, rearm);
+    for (int i = 0; i < 10; ++i) wheel.advance(1);
+    EXPECT_EQ(calls, 3);
+}
+
+TEST(TimingWheelTest, DetachedWheelOutlivesLoop) {
+    std::shared_ptr<TimingWheel> wheel;
+    {
+        muduo::net::EventLoopThread loopThread;
+        wheel = std::make_shared<TimingWheel>(loopThread.startLoop());
+        wheel->schedule(10.0, []() {});
+        wheel->detach();
+    }
+
+    // EventLoop 已退出：仍可手动推进，析构时不再访问 EventLoop
+    int calls = 0;
+    wheel->schedule(0.002, [&]() { ++calls; });
+    wheel->advance(2);
+    EXPECT_EQ(calls, 1);
+    wheel.reset();
+}
@@ -0,0 +1,130 @@
+#include "trajectory_buffer.h"
+#include <gtest/gtest.h>
+
+using namespace simple_ros;
+
+namespace {
+
+TrajectoryPoint point(double x, double y = 0.0) {
+    TrajectoryPoint p;
+    p.x = x;
+    p.y = y;
+    return p;
+}
+
+} // namespace
+
+TEST(RingBufferTest, OverwritesOldest) {
+    RingBuffer<int> ring(3);
+    for (int i = 0; i < 5; ++i) ring.push_back(i);
+    ASSERT_EQ(ring.size(), 3u);
+    EXPECT_TRUE(ring.full());
+    EXPECT_EQ(ring.front(), 2);
+    EXPECT_EQ(ring.back(), 4);
+    std::vector<int> out;
+    ring.copyTo(out);
+    EXPECT_EQ(out, (std::vector<int>{2, 3, 4}));
+}
+
+TEST(TrajectoryBufferTest, WindowKeepsLatestPoints) {
+    TrajectoryBuffer traj(3, TrajectoryBuffer::Options());
+    for (int i = 0; i < 10; ++i) traj.append(point(i));
+
+    const auto& tail = traj.tail();
+    ASSERT_EQ(tail.size(), 3u);
+    EXPECT_DOUBLE_EQ(tail.front().x, 7.0);
+    EXPECT_DOUBLE_EQ(tail.back().x, 9.0);
+
+    std::vector<const TrajectoryBuffer::Chunk*> sealed;
+    std::vector<uint64_t> evicted;
+    traj.takeChanges(&sealed, &evicted);
+    EXPECT_TRUE(sealed.empty());
+    EXPECT_TRUE(evicted.empty());
+}
+
+TEST(TrajectoryBufferTest, WindowForLifetime) {
+    EXPECT_EQ(TrajectoryBuffer::windowForLifetime(50.0), 50u);
+    EXPECT_EQ(TrajectoryBuffer::windowForLifetime(2.5), 3u);
+    // 小于 1 的正数只保留最新的点，不能截断为 0 而变成永久轨迹
+    EXPECT_EQ(TrajectoryBuffer::windowForLifetime(0.1), 1u);
+    EXPECT_EQ(TrajectoryBuffer::windowForLifetime(0.0), 1u);
+    EXPECT_EQ(TrajectoryBuffer::windowForLifetime(-1.0), 0u);
+
+    TrajectoryBuffer traj(TrajectoryBuffer::windowForLifetime(0.1), TrajectoryBuffer::Options());
+    EXPECT_TRUE(traj.windowed());
+    for (int i = 0; i < 5; ++i) traj.append(point(i));
+    ASSERT_EQ(traj.tail().size(), 1u);
+    EXPECT_DOUBLE_EQ(traj.tail().front().x, 4.0);
+}
+
+TEST(TrajectoryBufferTest, SealsContinuousChunksOnce) {
+    TrajectoryBuffer::Options options;
+    options.chunk_size = 4;
+    TrajectoryBuffer traj(0, options);
+
+    std::vector<const TrajectoryBuffer::Chunk*> sealed;
+    std::vector<uint64_t> evicted;
+    for (int i = 0; i < 4; ++i) traj.append(point(i));
+    traj.takeChanges(&sealed, &evicted);
+    ASSERT_EQ(sealed.size(), 1u);
+    EXPECT_EQ(sealed[0]->seq, 0u);
+    EXPECT_EQ(sealed[0]->points.size(), 4u);
+
+    // 新尾段以上一段的末点开头
+    ASSERT_EQ(traj.tail().size(), 1u);
+    EXPECT_DOUBLE_EQ(traj.tail().front().x, 3.0);
+
+    // 已发送的分段不再重复报告
+    sealed.clear();
+    traj.append(point(4));
+    traj.takeChanges(&sealed, &evicted);
+    EXPECT_TRUE(sealed.empty());
+    EXPECT_EQ(traj.tail().size(), 2u);
+
+    // 新客户端加入后重新报告
+    traj.resendAll();
+    traj.takeChanges(&sealed, &evicted);
+    EXPECT_EQ(sealed.size(), 1u);
+}
+
+TEST(TrajectoryBufferTest, EvictsOldestChunks) {
+    TrajectoryBuffer::Options options;
+    options.chunk_size = 4;
+    options.max_points = 10;
+    TrajectoryBuffer traj(0, options);
+
+    std::vector<const TrajectoryBuffer::Chunk*> sealed;
+    std::vector<uint64_t> evicted;
+    for (int i = 0; i < 4; ++i) traj.append(point(i));
+    traj.takeChanges(&sealed, &evicted);
+
+    // 之后每 3 个新点封存一段，点数超过 10 时淘汰已发送的第 0 段
+    for (int i = 4; i < 13; ++i) traj.append(point(i));
+    sealed.clear();
+    traj.takeChanges(&sealed, &evicted);
+    ASSERT_EQ(evicted.size(), 1u);
+    EXPECT_EQ(evicted[0], 0u);
+    EXPECT_LE(traj.pointCount(), 10u);
+    EXPECT_EQ(traj.sentChunks().size(), 2u);
+}
+
+TEST(TrajectoryBufferTest, SimplifiesSealedChunks) {
+    std::vector<TrajectoryPoint> line;
+    for (int i = 0; i <= 10; ++i) line.push_back(point(i, i <= 5 ? i : 10 - i));
+
+    auto kept = TrajectoryBuffer::simplify(line, 0.1);
+    ASSERT_EQ(kept.size(), 3u);
+    EXPECT_DOUBLE_EQ(kept[1].x, 5.0);
+    EXPECT_EQ(TrajectoryBuffer::simplify(line, 6.0).size(), 2u);
+
+    TrajectoryBuffer::Options options;
+    options.chunk_size = 11;
+    options.simplify_tolerance = 0.1;
+    TrajectoryBuffer traj(0, options);
+    for (const auto& p : line) traj.append(p);
+    std::vector<const TrajectoryBuffer::Chunk*> sealed;
+    std::vector<uint64_t> evicted;
+    traj.takeChanges(&sealed, &evicted);
+    ASSERT_EQ(sealed.size(), 1u);
+    EXPECT_EQ(sealed[0]->points.size(), 3u);
+}
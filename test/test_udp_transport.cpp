@@ -0,0 +1,140 @@
+#include "udp_transport.h"
+#include "wire_format.h"
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+namespace {
+
+std::string makeFrame(size_t payload_size, char fill) {
+    return wire::encodeFrame("imu", "example.SensorData", std::string(payload_size, fill));
+}
+
+bool feed(UdpReassembler& r, const std::string& dgram, std::string* out) {
+    return r.onDatagram("127.0.0.1:5000", dgram.data(), dgram.size(), out);
+}
+
+} // namespace
+
+// ---------------- 帧格式 ----------------
+TEST(WireFormatTest, EncodeDecodeRoundTrip) {
+    std::string frame = wire::encodeFrame("topic", "pkg.Msg", "payload");
+    std::string topic, msg_name, data;
+    EXPECT_EQ(wire::decodeFrame(frame.data(), frame.size(), &topic, &msg_name, &data), frame.size());
+    EXPECT_EQ(topic, "topic");
+    EXPECT_EQ(msg_name, "pkg.Msg");
+    EXPECT_EQ(data, "payload");
+
+    // 数据不足一帧时不消费
+    EXPECT_EQ(wire::decodeFrame(frame.data(), frame.size() - 1, &topic, &msg_name, &data), 0u);
+}
+
+// ---------------- 分片与重组 ----------------
+TEST(UdpTransportTest, SmallFrameSingleDatagram) {
+    std::string frame = makeFrame(100, 'a');
+    auto dgrams = udp::fragment(1, 1, frame);
+    ASSERT_EQ(dgrams.size(), 1u);
+
+    UdpReassembler r;
+    std::string out;
+    ASSERT_TRUE(feed(r, dgrams[0], &out));
+    EXPECT_EQ(out, frame);
+}
+
+TEST(UdpTransportTest, LargeFrameFragmentedAndReassembledOutOfOrder) {
+    std::string frame = makeFrame(10000, 'b');
+    auto dgrams = udp::fragment(7, 1, frame);
+    ASSERT_GT(dgrams.size(), 1u);
+    for (const auto& d : dgrams) {
+        EXPECT_LE(d.size(), udp::kHeaderSize + udp::kMaxFragmentPayload);
+    }
+
+    // 同一消息内分片乱序到达仍可重组
+    UdpReassembler r;
+    std::string out;
+    for (size_t i = dgrams.size(); i-- > 1;) {
+        EXPECT_FALSE(feed(r, dgrams[i], &out));
+    }
+    ASSERT_TRUE(feed(r, dgrams[0], &out));
+    EXPECT_EQ(out, frame);
+    EXPECT_EQ(r.stats().delivered, 1u);
+}
+
+TEST(UdpTransportTest, StaleMessagesDropped) {
+    UdpReassembler r;
+    std::string out;
+    auto newer = udp::fragment(1, 5, makeFrame(10, 'n'));
+    auto older = udp::fragment(1, 4, makeFrame(10, 'o'));
+
+    ASSERT_TRUE(feed(r, newer[0], &out));
+    EXPECT_FALSE(feed(r, older[0], &out));
+    EXPECT_FALSE(feed(r, newer[0], &out));  // 重复
+    EXPECT_EQ(r.stats().dropped_stale, 2u);
+}
+
+TEST(UdpTransportTest, IncompleteMessageReplacedByNewer) {
+    UdpReassembler r;
+    std::string out;
+    auto first = udp::fragment(1, 1, makeFrame(5000, 'x'));
+    auto second = udp::fragment(1, 2, makeFrame(5000, 'y'));
+
+    // 第一条只收到部分分片
+    EXPECT_FALSE(feed(r, first[0], &out));
+    for (size_t i = 0; i + 1 < second.size(); ++i) {
+        EXPECT_FALSE(feed(r, second[i], &out));
+    }
+    EXPECT_EQ(r.stats().dropped_incomplete, 1u);
+
+    // 旧消息迟到的分片被丢弃
+    EXPECT_FALSE(feed(r, first[1], &out));
+
+    ASSERT_TRUE(feed(r, second.back(), &out));
+    EXPECT_EQ(out, makeFrame(5000, 'y'));
+}
+
+TEST(UdpTransportTest, StreamsAreIndependent) {
+    UdpReassembler r;
+    std::string out;
+    auto a = udp::fragment(1, 10, makeFrame(10, 'a'));
+    auto b = udp::fragment(2, 1, makeFrame(10, 'b'));
+    ASSERT_TRUE(feed(r, a[0], &out));
+    // 不同流（例如发布者重启）的序号互不影响
+    ASSERT_TRUE(feed(r, b[0], &out));
+}
+
+TEST(UdpTransportTest, InvalidDatagramRejected) {
+    UdpReassembler r;
+    std::string out;
+    std::string junk(8, '\0');
+    EXPECT_FALSE(feed(r, junk, &out));
+    EXPECT_EQ(r.stats().dropped_invalid, 1u);
+}
+
+TEST(UdpTransportTest, ForgedFragmentCountRejected) {
+    UdpReassembler r;
+    std::string out;
+
+    // 分片数与消息长度不符：约 5KB 的消息声称有 65535 个分片
+    auto dgrams = udp::fragment(1, 1, makeFrame(5000, 'f'));
+    std::string forged = dgrams[0];
+    forged[14] = '\xff';
+    forged[15] = '\xff';
+    EXPECT_FALSE(feed(r, forged, &out));
+    EXPECT_EQ(r.stats().dropped_invalid, 1u);
+
+    // 合法分片仍能完整重组
+    for (size_t i = 0; i + 1 < dgrams.size(); ++i) EXPECT_FALSE(feed(r, dgrams[i], &out));
+    EXPECT_TRUE(feed(r, dgrams.back(), &out));
+}
+
+TEST(UdpTransportTest, MessageAboveConfiguredLimitRejected) {
+    UdpReassembler r(4096);
+    std::string out;
+    auto dgrams = udp::fragment(1, 1, makeFrame(5000, 'l'));
+    EXPECT_FALSE(feed(r, dgrams[0], &out));
+    EXPECT_EQ(r.stats().dropped_invalid, 1u);
+
+    auto small = udp::fragment(1, 2, makeFrame(3000, 's'));
+    for (size_t i = 0; i + 1 < small.size(); ++i) EXPECT_FALSE(feed(r, small[i], &out));
+    EXPECT_TRUE(feed(r, small.back(), &out));
+}
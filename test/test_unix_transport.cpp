@@ -0,0 +1,68 @@
+#include "unix_transport.h"
+#include "wire_format.h"
+#include <gtest/gtest.h>
+#include <muduo/net/EventLoop.h>
+#include <muduo/net/Buffer.h>
+#include <muduo/base/Logging.h>
+#include <unistd.h>
+#include <atomic>
+#include <string>
+#include <thread>
+
+// ---------------- 测试 ----------------
+TEST(UnixTransportTest, ClientSendAndServerParse) {
+    const std::string path = "@simple_ros_test/" + std::to_string(::getpid());
+    const std::string frame = wire::encodeFrame("unix_topic", "example.SensorData", "payload");
+
+    // ---------------- 服务端 ----------------
+    muduo::net::EventLoop serverLoop;
+    UnixServer server(&serverLoop, path, "TestUnixServer");
+
+    std::string topic, msg_name, data;
+    server.setMessageCallback([&](const muduo::net::TcpConnectionPtr&, muduo::net::Buffer* buf, muduo::Timestamp) {
+        if (size_t n = wire::decodeFrame(buf->peek(), buf->readableBytes(), &topic, &msg_name, &data)) {
+            buf->retrieve(n);
+            serverLoop.quit();
+        }
+    });
+    ASSERT_TRUE(server.start());
+
+    // ---------------- 客户端线程 ----------------
+    std::atomic<bool> connected(false);
+    std::thread clientThread([&]() {
+        muduo::net::EventLoop clientLoop;
+        UnixClient client(&clientLoop, path, "TestUnixClient");
+        client.setConnectionCallback([&](const muduo::net::TcpConnectionPtr& conn) {
+            if (conn->connected()) {
+                connected = true;
+                conn->send(frame);
+            }
+        });
+        if (client.connect()) {
+            clientLoop.runAfter(1.0, [&clientLoop]() { clientLoop.quit(); });
+            clientLoop.loop();
+        }
+    });
+
+    // 超时保护
+    serverLoop.runAfter(2.0, [&serverLoop]() { serverLoop.quit(); });
+    serverLoop.loop();
+    clientThread.join();
+
+    EXPECT_TRUE(connected);
+    EXPECT_EQ(topic, "unix_topic");
+    EXPECT_EQ(msg_name, "example.SensorData");
+    EXPECT_EQ(data, "payload");
+}
+
+TEST(UnixTransportTest, ConnectToMissingPathFails) {
+    muduo::net::EventLoop loop;
+    UnixClient client(&loop, "@simple_ros_test/does-not-exist", "TestUnixClient");
+    // 对端不存在时立即失败，发布者据此回退到 TCP
+    EXPECT_FALSE(client.connect());
+}
+
+TEST(UnixTransportTest, HostIdAndDefaultPath) {
+    EXPECT_FALSE(unix_transport::localHostId().empty());
+    EXPECT_EQ(unix_transport::defaultSocketPath(60000).front(), '@');
+}
@@ -0,0 +1,106 @@
+#include "global_init.h"
+#include "component_container.h"
+#include <muduo/base/Logging.h>
+
+#include <fstream>
+#include <iostream>
+#include <string>
+
+// 在一个进程中运行配置文件里的所有组件，共享监听端点、EventLoop 与消息队列
+
+void printUsage(const char* program_name) {
+    std::cout << "Usage: " << program_name << " <config.json> [OPTIONS]\n"
+              << "Options:\n"
+              << "  -n, --name NAME      Container node name (default: config \"container.name\" or component_container)\n"
+              << "  -j, --threads N      Number of spin threads (default: config \"container.threads\" or 1)\n"
+              << "  --list-types         Print registered component types after loading libraries and exit\n"
+              << "  --help               Show this help message\n"
+              << "\n"
+              << "Config example:\n"
+              << "  {\n"
+              << "    \"container\": {\"name\": \"quad_container\", \"threads\": 2},\n"
+              << "    \"libraries\": [\"./libquad_components.so\"],\n"
+              << "    \"components\": [\n"
+              << "      {\"type\": \"QuadSimulator\", \"name\": \"quad_sim\", \"params\": {}}\n"
+              << "    ]\n"
+              << "  }\n";
+}
+
+int main(int argc, char* argv[]) {
+    std::string config_path;
+    std::string name;
+    int threads = 0;
+    bool list_types = false;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--help" || arg == "-h") {
+            printUsage(argv[0]);
+            return 0;
+        } else if (arg == "-n" || arg == "--name") {
+            if (i + 1 < argc) name = argv[++i];
+            else { std::cerr << "Error: -n/--name requires a node name\n"; return 1; }
+        } else if (arg == "-j" || arg == "--threads") {
+            if (i + 1 < argc) threads = std::stoi(argv[++i]);
+            else { std::cerr << "Error: -j/--threads requires a number\n"; return 1; }
+        } else if (arg == "--list-types") {
+            list_types = true;
+        } else if (config_path.empty()) {
+            config_path = arg;
+        } else {
+            std::cerr << "Error: unexpected argument " << arg << "\n";
+            return 1;
+        }
+    }
+    if (config_path.empty()) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    std::ifstream in(config_path);
+    if (!in) {
+        std::cerr << "Error: cannot open " << config_path << "\n";
+        return 1;
+    }
+    nlohmann::json config = nlohmann::json::parse(in, nullptr, false);
+    if (config.is_discarded() || !config.is_object()) {
+        std::cerr << "Error: invalid JSON in " << config_path << "\n";
+        return 1;
+    }
+
+    if (list_types) {
+        if (config.contains("libraries")) {
+            for (const auto& lib : config["libraries"]) {
+                if (lib.is_string()) ComponentContainer::loadLibrary(lib.get<std::string>());
+            }
+        }
+        for (const auto& type : ComponentRegistry::instance().types()) {
+            std::cout << type << std::endl;
+        }
+        return 0;
+    }
+
+    const nlohmann::json container_cfg = config.value("container", nlohmann::json::object());
+    if (name.empty()) name = container_cfg.value("name", std::string("component_container"));
+    if (threads <= 0) threads = container_cfg.value("threads", 1);
+
+    try {
+        auto& sys = SystemManager::instance();
+        sys.init(name);
+
+        ComponentContainer container;
+        size_t loaded = container.loadConfig(config);
+        if (loaded == 0) {
+            std::cerr << "Error: no component loaded from " << config_path << "\n";
+            sys.shutdown();
+            return 1;
+        }
+        std::cout << "Container " << name << " running " << loaded << " component(s) with "
+                  << threads << " spin thread(s)" << std::endl;
+        sys.spin(threads);
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -8,6 +8,7 @@
 #include <csignal>
 #include <atomic>
 #include <sstream>
+#include <algorithm>
 
 #include "ros_rpc_client.h" // 使用 RPC 直接查询话题
 
@@ -28,8 +29,16 @@ void printUsage(const char* program_name) {
               << "  -t, --topics TOPICS    Comma-separated list of topics to subscribe (topic:type) [Note: manual subscribe not supported in this bridge build]\n"
               << "  -q, --queue-size SIZE  Queue size for topic subscriptions (default: 10)\n"
               << "  -l, --list-topics      List available topics and exit\n"
+              << "  --encoding ENC         Default channel encoding: protobuf or json (default: protobuf)\n"
+              << "  --json TOPICS          Comma-separated topics to bridge as JSON instead of protobuf\n"
+              << "  --max-rate HZ          Default max output rate per topic, 0 = unlimited (default: 0)\n"
+              << "  --rate TOPIC=HZ,...    Per-topic max output rate, overrides --max-rate\n"
               << "  --no-auto-discovery    Disable automatic topic discovery (NOT supported in current FoxgloveBridge)\n"
-              << "  --discovery-interval MS Discovery interval in milliseconds (ignored; bridge handles discovery internally)\n"
+              << "  --discovery-interval MS Topic discovery interval in milliseconds (default: 1000)\n"
+              << "  --workers N            Conversion worker threads, 0 = auto (default: 0)\n"
+              << "  --path-tolerance M     Simplify sealed chunks of permanent paths, 0 = off (default: 0)\n"
+              << "  --cache-mb MB          Memory for last messages replayed to new clients, 0 = off (default: 64)\n"
+              << "  --stats-interval S     Publish bridge stats on /foxglove_bridge/stats every S seconds, 0 = off (default: 1)\n"
               << "  --help                 Show this help message\n"
               << "\n";
 }
@@ -44,7 +53,15 @@ struct BridgeConfig {
     uint32_t queue_size = 10;
     bool list_topics = false;
     bool auto_discovery = true;  // 默认启用自动发现
-    int discovery_interval = 1000;  // 5秒间隔 (仅为兼容选项)
+    int discovery_interval = 1000;  // 话题发现间隔（毫秒）
+    size_t workers = 0;  // 转换线程数，0 自动
+    double path_tolerance = 0.0;  // 永久轨迹旧分段的简化容差（米），0 不简化
+    double cache_mb = 64.0;  // 最后状态缓存上限（MiB），0 不缓存
+    double stats_interval = 1.0;  // 统计话题发布间隔（秒），0 不发布
+    FoxgloveEncoding encoding = FoxgloveEncoding::PROTOBUF;
+    std::vector<std::string> json_topics;  // 使用 JSON 编码的话题
+    double max_rate = 0.0;  // 默认输出限速（Hz），0 不限速
+    std::vector<std::pair<std::string, double>> topic_rates;  // 单独限速的话题
 };
 
 BridgeConfig parseArguments(int argc, char* argv[]) {
@@ -89,6 +106,50 @@ BridgeConfig parseArguments(int argc, char* argv[]) {
             else { std::cerr << "Error: -q/--queue-size requires a number\n"; exit(1); }
         } else if (arg == "-l" || arg == "--list-topics") {
             config.list_topics = true;
+        } else if (arg == "--encoding") {
+            if (i + 1 < argc) {
+                std::string enc = argv[++i];
+                if (enc == "protobuf") config.encoding = FoxgloveEncoding::PROTOBUF;
+                else if (enc == "json") config.encoding = FoxgloveEncoding::JSON;
+                else { std::cerr << "Error: --encoding must be protobuf or json\n"; exit(1); }
+            } else { std::cerr << "Error: --encoding requires protobuf or json\n"; exit(1); }
+        } else if (arg == "--json") {
+            if (i + 1 < argc) {
+                std::stringstream ss(argv[++i]);
+                std::string topic;
+                while (std::getline(ss, topic, ',')) {
+                    if (!topic.empty()) config.json_topics.push_back(topic);
+                }
+            } else { std::cerr << "Error: --json requires a comma-separated list\n"; exit(1); }
+        } else if (arg == "--max-rate") {
+            if (i + 1 < argc) config.max_rate = std::stod(argv[++i]);
+            else { std::cerr << "Error: --max-rate requires a number\n"; exit(1); }
+        } else if (arg == "--rate") {
+            if (i + 1 < argc) {
+                std::stringstream ss(argv[++i]);
+                std::string item;
+                while (std::getline(ss, item, ',')) {
+                    size_t eq_pos = item.rfind('=');
+                    if (eq_pos == std::string::npos || eq_pos == 0) {
+                        std::cerr << "Error: Invalid rate format: " << item
+                                  << ". Expected format: topic=hz\n";
+                        exit(1);
+                    }
+                    config.topic_rates.emplace_back(item.substr(0, eq_pos), std::stod(item.substr(eq_pos + 1)));
+                }
+            } else { std::cerr << "Error: --rate requires a comma-separated list\n"; exit(1); }
+        } else if (arg == "--workers") {
+            if (i + 1 < argc) config.workers = std::stoul(argv[++i]);
+            else { std::cerr << "Error: --workers requires a number\n"; exit(1); }
+        } else if (arg == "--cache-mb") {
+            if (i + 1 < argc) config.cache_mb = std::stod(argv[++i]);
+            else { std::cerr << "Error: --cache-mb requires a number\n"; exit(1); }
+        } else if (arg == "--stats-interval") {
+            if (i + 1 < argc) config.stats_interval = std::stod(argv[++i]);
+            else { std::cerr << "Error: --stats-interval requires a number\n"; exit(1); }
+        } else if (arg == "--path-tolerance") {
+            if (i + 1 < argc) config.path_tolerance = std::stod(argv[++i]);
+            else { std::cerr << "Error: --path-tolerance requires a number\n"; exit(1); }
         } else if (arg == "--no-auto-discovery") {
             config.auto_discovery = false;
         } else if (arg == "--discovery-interval") {
@@ -133,7 +194,7 @@ void listTopics(const std::string& rpc_address) {
 void showStatusInfo() {
     std::cout << "Foxglove Bridge is running!\n"
               << " - Visualizations: publish visualization_msgs::Marker/MarkerArray to create visuals\n"
-              << " - Other messages are bridged to Foxglove as JSON (if schema available)\n\n";
+              << " - Other messages are bridged to Foxglove as protobuf (use --json for JSON channels)\n\n";
 }
 
 int main(int argc, char* argv[]) {
@@ -157,6 +218,22 @@ int main(int argc, char* argv[]) {
     // 创建桥接器（构造参数: rpc_address, foxglove host, foxglove port）
     g_bridge = std::make_unique<FoxgloveBridge>(rpc_address, config.foxglove_host, static_cast<uint16_t>(config.foxglove_port));
 
+    g_bridge->setDefaultEncoding(config.encoding);
+    for (const auto& topic : config.json_topics) {
+        g_bridge->setTopicEncoding(topic, FoxgloveEncoding::JSON);
+    }
+    g_bridge->setConversionThreads(config.workers);
+    g_bridge->setDiscoveryInterval(std::chrono::milliseconds(config.discovery_interval));
+    simple_ros::TrajectoryBuffer::Options trajectory_options;
+    trajectory_options.simplify_tolerance = config.path_tolerance;
+    g_bridge->setTrajectoryOptions(trajectory_options);
+    g_bridge->setLastMessageCacheBytes(static_cast<size_t>(std::max(0.0, config.cache_mb) * 1024 * 1024));
+    g_bridge->setStatsInterval(std::max(0.0, config.stats_interval));
+    g_bridge->setDefaultMaxRate(config.max_rate);
+    for (const auto& item : config.topic_rates) {
+        g_bridge->setTopicMaxRate(item.first, item.second);
+    }
+
     // 初始化并启动桥接器
     if (!g_bridge->init()) {
         std::cerr << "Failed to initialize Foxglove Bridge\n";
@@ -68,6 +68,9 @@ int main(int argc, char** argv) {
         std::cout << "Node: " << response.node_info().node_name() << std::endl;
         std::cout << " - IP: " << response.node_info().ip() << std::endl;
         std::cout << " - Port: " << response.node_info().port() << std::endl;
+        if (!response.node_info().unix_path().empty()) {
+            std::cout << " - Unix socket: " << response.node_info().unix_path() << std::endl;
+        }
         
         std::cout << "Published topics: " << std::endl;
         if (response.publishes_size() == 0) {